@@ -0,0 +1,22 @@
+#version 450
+
+layout(location = 0) in vec3 InPosition;
+layout(location = 2) in vec4 InInstance0;
+layout(location = 3) in vec4 InInstance1;
+layout(location = 4) in vec4 InInstance2;
+layout(location = 5) in vec4 InInstance3;
+
+layout(set = 0, binding = 0) uniform LightData
+{
+    mat4 LightViewProj;
+    mat4 ViewProj;
+} ubo;
+
+/* Must match Triangle.vert exactly, the colour pass tests EQUAL. */
+invariant gl_Position;
+
+void main()
+{
+    mat4 model = mat4(InInstance0, InInstance1, InInstance2, InInstance3);
+    gl_Position = ubo.ViewProj * model * vec4(InPosition, 1.0);
+}
@@ -0,0 +1,26 @@
+#version 450
+
+layout(input_attachment_index = 0, set = 0, binding = 0) uniform subpassInputMS AccumInput;
+layout(input_attachment_index = 1, set = 0, binding = 1) uniform subpassInputMS RevealageInput;
+
+layout(location = 0) out vec4 OutColor;
+
+/* Matches the MSAA sample count of the main render pass. */
+const int kSampleCount = 4;
+
+void main()
+{
+    vec4 accum = vec4(0.0);
+    float revealage = 0.0;
+    for (int sampleIndex = 0; sampleIndex < kSampleCount; ++sampleIndex)
+    {
+        accum += subpassLoad(AccumInput, sampleIndex);
+        revealage += subpassLoad(RevealageInput, sampleIndex).r;
+    }
+    accum /= float(kSampleCount);
+    revealage /= float(kSampleCount);
+
+    /* Weighted average colour, blended over opaque with coverage 1 - revealage. */
+    vec3 color = accum.rgb / clamp(accum.a, 1e-4, 5e4);
+    OutColor = vec4(color, 1.0 - revealage);
+}
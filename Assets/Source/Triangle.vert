@@ -22,6 +22,9 @@ layout(push_constant) uniform PushConstants
     vec4 AlphaModePadding;
 } pc;
 
+/* Shared with DepthPrepass.vert so the EQUAL depth test holds. */
+invariant gl_Position;
+
 void main()
 {
     int mode = int(pc.AlphaModePadding.y);
@@ -0,0 +1,34 @@
+#version 450
+
+layout(location = 0) in vec2 vUV;
+
+layout(location = 0) out vec4 OutAccum;
+layout(location = 1) out float OutRevealage;
+
+layout(set = 0, binding = 1) uniform sampler2D DiffuseTexture;
+
+layout(push_constant) uniform PushConstants
+{
+    vec4 BaseColorAmbient;
+    vec4 AlphaModePadding;
+} pc;
+
+void main()
+{
+    vec4 texColor = texture(DiffuseTexture, vUV);
+    float ambient = 0.55;
+    vec3 litColor = texColor.rgb * (1.0 + ambient);
+    vec3 srgbColor = pow(clamp(litColor, 0.0, 1.0), vec3(1.0 / 2.2));
+    srgbColor = mix(srgbColor, vec3(1.0), 0.15);
+    float alpha = pc.AlphaModePadding.x;
+
+    /* Depth weight from McGuire and Bavoil, near and opaque fragments dominate. */
+    float z = gl_FragCoord.z;
+    float weight = clamp(
+        pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - z * 0.9, 3.0),
+        1e-2,
+        3e3);
+
+    OutAccum = vec4(srgbColor * alpha, alpha) * weight;
+    OutRevealage = alpha;
+}
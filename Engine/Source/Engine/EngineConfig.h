@@ -28,6 +28,8 @@
 #include "EngineState.h"
 
 #include <cstdint>
+#include <string>
+#include <vector>
 
 /* Configurable engine startup parameters. */
 struct EngineConfig
@@ -35,10 +37,52 @@ struct EngineConfig
     /* Prefer FIFO (vsync) or mailbox/immediate (uncapped). */
     bool EnableVsync = true;
 
+    /* Cull entities hidden behind meshes flagged as occluders. */
+    /* Off by default: it only pays off in scenes with large occluders. */
+    bool EnableOcclusionCulling = false;
+
+    /* Render opaque depth first, then shade with an EQUAL depth test. */
+    /* Opaque batches then sort by state alone; faster when overdraw is high. */
+    bool EnableDepthPrepass = false;
+
+    /* Composite transparency with weighted blended OIT instead of sorting it. */
+    /* Transparent items then batch and instance like opaque ones. When off */
+    /* the render pass has no OIT subpasses and no OIT targets are allocated. */
+    bool EnableWeightedOIT = false;
+
+    /* Frustum-cull opaque instances in a compute pass and draw them with one */
+    /* indirect draw per mesh, the draw count read back on the GPU when the */
+    /* device supports it (Vulkan 1.2 drawIndirectCount). */
+    bool EnableGpuCulling = false;
+
+    /* Frames the CPU may record while the GPU still renders earlier ones. */
+    /* Each has its own command buffer, sync objects and buffer slices. */
+    std::uint32_t FramesInFlight = 2;
+
+    /* Threads recording stage command buffers in parallel, 0 for one per core. */
+    /* Small frames and cache misses alone record on the render thread. */
+    std::uint32_t RecordWorkers = 0;
+
+    /* Relative screen-size band a mesh must cross to change LOD level. */
+    float LODHysteresis = 0.15f;
+
+    /* OBJ files imported with their LOD chains when the scene is built. */
+    /* They are placed in a row in front of the camera. */
+    std::vector<std::string> SceneMeshes;
+
     /* Initial engine state. */
     EngineState InitialState = EngineState::Editor;
 
     /* Fallback swapchain dimensions if the window is minimized. */
     std::uint32_t FallbackWidth = 1280;
     std::uint32_t FallbackHeight = 720;
+
+    /* Render into device images with no window, surface or swapchain. */
+    /* Initialize then takes a null window; frames are read back on request. */
+    /* Runs on software Vulkan ICDs, e.g. to benchmark DrawFrame anywhere. */
+    bool Headless = false;
+
+    /* Offscreen image dimensions when headless. */
+    std::uint32_t HeadlessWidth = 1280;
+    std::uint32_t HeadlessHeight = 720;
 };
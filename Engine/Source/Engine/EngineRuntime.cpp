@@ -26,19 +26,27 @@
 #include "EngineRuntime.h"
 
 #include "Engine/EngineState.h"
+#include "Engine/WorkerPool.h"
+#include "Renderer/PngWriter.h"
+#include "Renderer/Vulkan/Core/VulkanPipelineCache.h"
 #include "Scene/Collision/AABB.h"
 
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.h>
 
+#include <algorithm>
+#include <cctype>
 #include <cstdio>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
 
 namespace
 {
     /* Simple scene configuration. */
     constexpr bool kEnableCube = false;
     constexpr float kCubeForwardOffset = 6.0f;
+    constexpr float kSceneMeshSpacing = 3.0f;
     constexpr float kCameraCollisionRadius = 0.25f;
 
     /* Delta time clamp values. */
@@ -60,14 +68,6 @@ namespace
 
         return value;
     }
-
-    /* Check if a point lies inside an axis-aligned bounding box. */
-    bool IsPointInsideAABB(const Vec3& point, const AABB& bounds)
-    {
-        return point.x >= bounds.Min.x && point.x <= bounds.Max.x &&
-            point.y >= bounds.Min.y && point.y <= bounds.Max.y &&
-            point.z >= bounds.Min.z && point.z <= bounds.Max.z;
-    }
 }
 
 /* Initialize runtime defaults. */
@@ -78,6 +78,7 @@ EngineRuntime::EngineRuntime()
     , DeviceCreated(false)
     , SurfaceCreated(false)
     , SwapchainCreated(false)
+    , OffscreenTargetCreated(false)
     , RenderPassCreated(false)
     , RendererCreated(false)
     , Initialized(false)
@@ -96,7 +97,7 @@ bool EngineRuntime::Initialize(GLFWwindow* windowHandle, const EngineConfig& con
 {
     Shutdown();
 
-    if (!windowHandle)
+    if (!windowHandle && !config.Headless)
     {
         std::fprintf(stderr, "EngineRuntime::Initialize: missing window handle\n");
         return false;
@@ -106,6 +107,9 @@ bool EngineRuntime::Initialize(GLFWwindow* windowHandle, const EngineConfig& con
     Config = config;
     g_CurrentEngineState = Config.InitialState;
 
+    /* Parallel passes share these threads for the life of the process. */
+    g_WorkerPool.Start(0);
+
     if (!CreateVulkanResources())
     {
         DestroyVulkanResources();
@@ -147,7 +151,8 @@ void EngineRuntime::Shutdown()
     DestroyVulkanResources();
 
     WindowHandle = nullptr;
-    RenderItems.clear();
+    RenderItems.Clear();
+    ShadowCasterItems.Clear();
     SceneEntities.clear();
     WorldScene = Scene();
     SelectedEntity = Entity();
@@ -196,6 +201,73 @@ bool EngineRuntime::IsInitialized() const
     return Initialized;
 }
 
+/* Read the last headless frame back as tightly packed RGBA8 rows. */
+bool EngineRuntime::ReadbackFrame(
+    std::vector<std::uint8_t>& outPixels,
+    std::uint32_t& outWidth,
+    std::uint32_t& outHeight)
+{
+    if (!Initialized || !OffscreenTargetCreated)
+    {
+        std::fprintf(stderr, "EngineRuntime::ReadbackFrame: runtime is not headless\n");
+        return false;
+    }
+
+    const std::uint32_t imageIndex = Renderer.GetLastImageIndex();
+    if (imageIndex == UINT32_MAX)
+    {
+        std::fprintf(stderr, "EngineRuntime::ReadbackFrame: no frame rendered yet\n");
+        return false;
+    }
+
+    if (!OffscreenTarget.Readback(
+        Device.GetDevice(),
+        Device.GetGraphicsQueue(),
+        imageIndex,
+        outPixels))
+    {
+        std::fprintf(stderr, "EngineRuntime::ReadbackFrame: readback failed\n");
+        return false;
+    }
+
+    outWidth = OffscreenTarget.GetExtent().width;
+    outHeight = OffscreenTarget.GetExtent().height;
+    return true;
+}
+
+/* Save the last headless frame: PNG for a .png path, raw RGBA8 otherwise. */
+bool EngineRuntime::SaveFrame(const std::string& path)
+{
+    std::vector<std::uint8_t> pixels;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    if (!ReadbackFrame(pixels, width, height))
+    {
+        return false;
+    }
+
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (extension == ".png")
+    {
+        return WritePng(path.c_str(), width, height, pixels);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::fprintf(stderr, "EngineRuntime::SaveFrame: failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    file.write(
+        reinterpret_cast<const char*>(pixels.data()),
+        static_cast<std::streamsize>(pixels.size()));
+    return static_cast<bool>(file);
+}
+
 void EngineRuntime::TickSimulation(float deltaTime)
 {
     const float clampedDeltaTime = ClampFloat(deltaTime, kMinDeltaTime, kMaxDeltaTime);
@@ -206,29 +278,49 @@ void EngineRuntime::TickSimulation(float deltaTime)
     /* Update the camera controller with the real delta time. */
     Renderer.UpdateCamera(clampedDeltaTime);
 
-    /* Prevent entering the cube while in the game state. */
-    if (kEnableCube && g_CurrentEngineState == EngineState::Game)
+    /* Step rigid bodies first, then sweep the camera against their new */
+    /* bounds and slide along contacts. */
+    if (g_CurrentEngineState == EngineState::Game)
     {
-        AABB cubeBounds{};
-        cubeBounds.Min = Vec3(-0.5f, -0.5f, -0.5f) + CubePosition;
-        cubeBounds.Max = Vec3(0.5f, 0.5f, 0.5f) + CubePosition;
-
-        const Vec3 padding(
-            kCameraCollisionRadius,
-            kCameraCollisionRadius,
-            kCameraCollisionRadius);
-        AABB paddedBounds{};
-        paddedBounds.Min = cubeBounds.Min - padding;
-        paddedBounds.Max = cubeBounds.Max + padding;
+        Physics.Step(WorldScene, clampedDeltaTime);
+        Renderer.SetCameraPosition(CameraController.Move(
+            WorldScene,
+            previousCameraPosition,
+            Renderer.GetCameraPosition()));
+    }
 
-        if (IsPointInsideAABB(Renderer.GetCameraPosition(), paddedBounds))
-        {
-            Renderer.SetCameraPosition(previousCameraPosition);
-        }
+    /* Build render items for this frame, culled against the camera frustum. */
+    const Mat4 viewProjection = Renderer.GetCameraViewProj();
+    OcclusionBuffer* occlusion = nullptr;
+    if (Config.EnableOcclusionCulling)
+    {
+        Occlusion.Begin(viewProjection);
+        occlusion = &Occlusion;
     }
 
-    /* Build render items for this frame. */
-    WorldScene.BuildRenderList(RenderItems);
+    /* LOD chains pick a level per instance from projected size. */
+    LODView lodView{};
+    lodView.CameraPosition = Renderer.GetCameraPosition();
+    lodView.ProjectionScale = Renderer.GetCameraProjectionScale();
+    lodView.Hysteresis = Config.LODHysteresis;
+
+    RenderCullStats cullStats{};
+    WorldScene.BuildRenderList(
+        RenderItems,
+        Frustum::FromViewProjection(viewProjection),
+        cullStats,
+        occlusion,
+        &lodView);
+    Renderer.SetCullStats(cullStats.Submitted, cullStats.Culled, cullStats.Occluded);
+
+    /* Shadow casters are culled against the light, not the camera. */
+    RenderCullStats shadowCullStats{};
+    WorldScene.BuildRenderList(
+        ShadowCasterItems,
+        Frustum::FromViewProjection(Renderer.GetLightViewProj()),
+        shadowCullStats,
+        nullptr,
+        &lodView);
 }
 
 void EngineRuntime::TickEditorSyncPreRender()
@@ -308,6 +400,8 @@ void EngineRuntime::TickEditorSyncPostRender()
             transform->Rotation = Vec3(edit.Rotation[0], edit.Rotation[1], edit.Rotation[2]);
             transform->Scale = Vec3(edit.Scale[0], edit.Scale[1], edit.Scale[2]);
             WorldScene.MarkTransformDirty(edit.Target);
+
+            /* A rigid body picks the edit up when physics next syncs. */
         }
     }
 }
@@ -317,12 +411,15 @@ bool EngineRuntime::TickRender(float deltaTime)
     Renderer.SetOverlayTiming(deltaTime);
 
     /* Skip rendering when the swapchain is effectively minimized. */
-    if (Swapchain.GetExtent().width == 0 || Swapchain.GetExtent().height == 0)
+    const VkExtent2D targetExtent = GetTargetExtent();
+    if (targetExtent.width == 0 || targetExtent.height == 0)
     {
         return false;
     }
 
-    Renderer.SetRenderItems(RenderItems);
+    Renderer.SetRenderResources(&WorldScene.GetRenderResources());
+    Renderer.SetRenderItems(&RenderItems);
+    Renderer.SetShadowCasters(&ShadowCasterItems);
     Renderer.DrawFrame(Device.GetDevice(), Device.GetGraphicsQueue());
     return true;
 }
@@ -332,7 +429,15 @@ bool EngineRuntime::CreateVulkanResources()
 {
     std::int32_t windowWidth = 0;
     std::int32_t windowHeight = 0;
-    glfwGetFramebufferSize(WindowHandle, &windowWidth, &windowHeight);
+    if (Config.Headless)
+    {
+        windowWidth = static_cast<std::int32_t>(Config.HeadlessWidth);
+        windowHeight = static_cast<std::int32_t>(Config.HeadlessHeight);
+    }
+    else
+    {
+        glfwGetFramebufferSize(WindowHandle, &windowWidth, &windowHeight);
+    }
 
     if (windowWidth <= 0 || windowHeight <= 0)
     {
@@ -340,6 +445,7 @@ bool EngineRuntime::CreateVulkanResources()
         windowHeight = static_cast<std::int32_t>(Config.FallbackHeight);
     }
 
+    /* Headless runs pass a null window and skip the surface extensions. */
     if (!Instance.Create("Editor", WindowHandle))
     {
         std::fprintf(stderr, "EngineRuntime::CreateVulkanResources: failed to create instance\n");
@@ -348,7 +454,7 @@ bool EngineRuntime::CreateVulkanResources()
 
     InstanceCreated = true;
 
-    if (!Device.Create(Instance.GetHandle()))
+    if (!Device.Create(Instance.GetHandle(), !Config.Headless))
     {
         std::fprintf(stderr, "EngineRuntime::CreateVulkanResources: failed to create device\n");
         return false;
@@ -356,30 +462,57 @@ bool EngineRuntime::CreateVulkanResources()
 
     DeviceCreated = true;
 
-    if (!Surface.Create(Instance.GetHandle(), WindowHandle))
+    if (Config.Headless)
     {
-        std::fprintf(stderr, "EngineRuntime::CreateVulkanResources: failed to create surface\n");
-        return false;
+        /* One offscreen image per frame in flight stands in for the swapchain. */
+        if (!OffscreenTarget.Create(
+            Device.GetDevice(),
+            Device.GetGraphicsQueueFamily(),
+            static_cast<std::uint32_t>(windowWidth),
+            static_cast<std::uint32_t>(windowHeight),
+            std::max<std::uint32_t>(Config.FramesInFlight, 1)))
+        {
+            std::fprintf(stderr, "EngineRuntime::CreateVulkanResources: failed to create offscreen target\n");
+            return false;
+        }
+
+        OffscreenTargetCreated = true;
     }
+    else
+    {
+        if (!Surface.Create(Instance.GetHandle(), WindowHandle))
+        {
+            std::fprintf(stderr, "EngineRuntime::CreateVulkanResources: failed to create surface\n");
+            return false;
+        }
 
-    SurfaceCreated = true;
+        SurfaceCreated = true;
 
-    if (!Swapchain.Create(
-        Device.GetPhysicalDevice(),
-        Device.GetDevice(),
-        Surface.GetHandle(),
-        Device.GetGraphicsQueueFamily(),
-        static_cast<std::uint32_t>(windowWidth),
-        static_cast<std::uint32_t>(windowHeight),
-        Config.EnableVsync))
-    {
-        std::fprintf(stderr, "EngineRuntime::CreateVulkanResources: failed to create swapchain\n");
-        return false;
+        if (!Swapchain.Create(
+            Device.GetPhysicalDevice(),
+            Device.GetDevice(),
+            Surface.GetHandle(),
+            Device.GetGraphicsQueueFamily(),
+            static_cast<std::uint32_t>(windowWidth),
+            static_cast<std::uint32_t>(windowHeight),
+            Config.EnableVsync))
+        {
+            std::fprintf(stderr, "EngineRuntime::CreateVulkanResources: failed to create swapchain\n");
+            return false;
+        }
+
+        SwapchainCreated = true;
     }
 
-    SwapchainCreated = true;
+    /* Offscreen images stay transfer sources between frames for readback. */
+    const VkFormat targetFormat = Config.Headless ?
+        OffscreenTarget.GetImageFormat() :
+        Swapchain.GetImageFormat();
+    const VkImageLayout targetLayout = Config.Headless ?
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL :
+        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
-    if (!RenderPass.Create(Device.GetDevice(), Swapchain.GetImageFormat()))
+    if (!RenderPass.Create(Device.GetDevice(), targetFormat, targetLayout, Config.EnableWeightedOIT))
     {
         std::fprintf(stderr, "EngineRuntime::CreateVulkanResources: failed to create render pass\n");
         return false;
@@ -387,15 +520,19 @@ bool EngineRuntime::CreateVulkanResources()
 
     RenderPassCreated = true;
 
+    Renderer.SetFramesInFlight(Config.FramesInFlight);
+    Renderer.SetRecordWorkers(Config.RecordWorkers);
+    Renderer.SetGpuCullingEnabled(Config.EnableGpuCulling, Device.SupportsDrawIndirectCount());
+    Renderer.SetWeightedOITEnabled(RenderPass.HasWeightedOIT());
     if (!Renderer.Create(
         Device.GetDevice(),
         Device.GetPhysicalDevice(),
         Device.GetGraphicsQueueFamily(),
         Device.GetGraphicsQueue(),
         RenderPass.GetHandle(),
-        Swapchain.GetImageFormat(),
-        Swapchain.GetImageViews(),
-        Swapchain.GetExtent(),
+        targetFormat,
+        Config.Headless ? OffscreenTarget.GetImageViews() : Swapchain.GetImageViews(),
+        GetTargetExtent(),
         Swapchain.GetHandle()))
     {
         std::fprintf(stderr, "EngineRuntime::CreateVulkanResources: failed to create renderer\n");
@@ -403,6 +540,11 @@ bool EngineRuntime::CreateVulkanResources()
     }
 
     RendererCreated = true;
+
+    /* Startup pipelines are built or compiling, close the cache timing */
+    /* window once the background variants finish. */
+    g_VulkanPipelineCache.EndStartup();
+    Renderer.SetDepthPrepassEnabled(Config.EnableDepthPrepass);
     Renderer.InitializeOverlay(WindowHandle);
     return true;
 }
@@ -429,6 +571,12 @@ void EngineRuntime::DestroyVulkanResources()
         SwapchainCreated = false;
     }
 
+    if (OffscreenTargetCreated)
+    {
+        OffscreenTarget.Destroy(Device.GetDevice());
+        OffscreenTargetCreated = false;
+    }
+
     if (DeviceCreated)
     {
         Device.Destroy();
@@ -452,14 +600,17 @@ void EngineRuntime::DestroyVulkanResources()
 void EngineRuntime::CreateScene()
 {
     WorldScene = Scene();
-    RenderItems.clear();
-    RenderItems.reserve(1024);
+    RenderItems.Clear();
+    RenderItems.Items.reserve(1024);
+    ShadowCasterItems.Clear();
+    ShadowCasterItems.Items.reserve(1024);
     SceneEntities.clear();
     SelectedEntity = Entity();
     InspectorState = InspectorData();
 
     CubePosition =
         Renderer.GetCameraPosition() + Vec3(0.0f, 0.0f, -kCubeForwardOffset);
+    CameraController.SetRadius(kCameraCollisionRadius);
 
     if (kEnableCube)
     {
@@ -474,16 +625,56 @@ void EngineRuntime::CreateScene()
         MaterialComponent& material = WorldScene.AddMaterial(cubeEntity);
         material.MaterialPtr = Renderer.GetCubeMaterial();
     }
+
+    for (std::size_t index = 0; index < Config.SceneMeshes.size(); ++index)
+    {
+        const float offset =
+            (static_cast<float>(index) - 0.5f * static_cast<float>(Config.SceneMeshes.size() - 1)) * kSceneMeshSpacing;
+        ImportMesh(Config.SceneMeshes[index], CubePosition + Vec3(offset, 0.0f, 0.0f));
+    }
+}
+
+/* Import an OBJ with its LOD chain and add it to the scene. */
+Entity EngineRuntime::ImportMesh(const std::string& path, const Vec3& position)
+{
+    MeshLODChain* chain = Renderer.ImportMesh(path);
+    if (!chain)
+    {
+        return Entity();
+    }
+
+    const Entity entity = WorldScene.CreateEntity();
+
+    TransformComponent& transform = WorldScene.AddTransform(entity);
+    transform.Position = position;
+
+    /* Queries use level 0, which carries the triangle BVH. */
+    MeshComponent& mesh = WorldScene.AddMesh(entity);
+    mesh.LODChain = chain;
+
+    MaterialComponent& material = WorldScene.AddMaterial(entity);
+    material.MaterialPtr = Renderer.GetCubeMaterial();
+
+    return entity;
 }
 
 /* Draw the first frame to avoid blank flashes. */
 void EngineRuntime::BuildFirstFrame()
 {
     WorldScene.BuildRenderList(RenderItems);
-    Renderer.SetRenderItems(RenderItems);
+    Renderer.SetRenderResources(&WorldScene.GetRenderResources());
+    Renderer.SetRenderItems(&RenderItems);
+    ShadowCasterItems = RenderItems;
+    Renderer.SetShadowCasters(&ShadowCasterItems);
     WorldScene.GetEntities(SceneEntities);
     Renderer.SetEditorEntities(SceneEntities);
     Renderer.SetEditorSelection(SelectedEntity);
     Renderer.SetInspectorData(InspectorState);
     Renderer.DrawFrame(Device.GetDevice(), Device.GetGraphicsQueue());
 }
+
+/* Extent of the swapchain, or of the offscreen target when headless. */
+VkExtent2D EngineRuntime::GetTargetExtent() const
+{
+    return OffscreenTargetCreated ? OffscreenTarget.GetExtent() : Swapchain.GetExtent();
+}
@@ -27,16 +27,20 @@
 
 #include "Engine/EngineConfig.h"
 #include "Math/MathVector.h"
+#include "Physics/PhysicsWorld.h"
 #include "Renderer/RenderItem.h"
 #include "Renderer/Vulkan/Core/VulkanDevice.h"
 #include "Renderer/Vulkan/Core/VulkanInstance.h"
 #include "Renderer/Vulkan/Render/VulkanRenderer.h"
 #include "Renderer/Vulkan/Render/VulkanRenderPass.h"
+#include "Renderer/Vulkan/Swapchain/VulkanOffscreenTarget.h"
 #include "Renderer/Vulkan/Swapchain/VulkanSurface.h"
 #include "Renderer/Vulkan/Swapchain/VulkanSwapchain.h"
 #include "Scene/Scene.h"
+#include "Scene/Collision/CharacterController.h"
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 struct GLFWwindow;
@@ -52,6 +56,7 @@ public:
     ~EngineRuntime();
 
     /* Initialize the engine using a host-provided window. */
+    /* The window may be null when config.Headless is set. */
     bool Initialize(GLFWwindow* windowHandle, const EngineConfig& config);
 
     /* Update and render a single frame. */
@@ -66,6 +71,19 @@ public:
     /* Query whether the runtime is initialized. */
     bool IsInitialized() const;
 
+    /* Read the last headless frame back as tightly packed RGBA8 rows. */
+    bool ReadbackFrame(
+        std::vector<std::uint8_t>& outPixels,
+        std::uint32_t& outWidth,
+        std::uint32_t& outHeight);
+
+    /* Save the last headless frame: PNG for a .png path, raw RGBA8 otherwise. */
+    bool SaveFrame(const std::string& path);
+
+    /* Import an OBJ with its LOD chain and add it to the scene. */
+    /* Returns an invalid entity when the file fails to load. */
+    Entity ImportMesh(const std::string& path, const Vec3& position);
+
 private:
     /* Create Vulkan and render resources. */
     bool CreateVulkanResources();
@@ -91,6 +109,9 @@ private:
     /* Draw the first frame to avoid blank flashes. */
     void BuildFirstFrame();
 
+    /* Extent of the swapchain, or of the offscreen target when headless. */
+    VkExtent2D GetTargetExtent() const;
+
     GLFWwindow* WindowHandle;
     EngineConfig Config;
 
@@ -98,21 +119,27 @@ private:
     VulkanDevice Device;
     VulkanSurface Surface;
     VulkanSwapchain Swapchain;
+    VulkanOffscreenTarget OffscreenTarget;
     VulkanRenderPass RenderPass;
     VulkanRenderer Renderer;
 
     Scene WorldScene;
-    std::vector<RenderItem> RenderItems;
+    PhysicsWorld Physics;
+    OcclusionBuffer Occlusion;
+    RenderList RenderItems;
+    RenderList ShadowCasterItems;
     std::vector<Entity> SceneEntities;
     Entity SelectedEntity;
     InspectorData InspectorState;
 
     Vec3 CubePosition;
+    CharacterController CameraController;
 
     bool InstanceCreated;
     bool DeviceCreated;
     bool SurfaceCreated;
     bool SwapchainCreated;
+    bool OffscreenTargetCreated;
     bool RenderPassCreated;
     bool RendererCreated;
     bool Initialized;
@@ -0,0 +1,90 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+/* Pick how many workers a range of items should be split across. */
+inline std::uint32_t GetParallelWorkerCount(
+    std::uint32_t count,
+    std::uint32_t minItemsPerWorker)
+{
+    /* Small ranges are cheaper to run on the calling thread. */
+    if (minItemsPerWorker == 0 || count < minItemsPerWorker * 2)
+    {
+        return 1;
+    }
+
+    std::uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    if (hardwareThreads == 0)
+    {
+        hardwareThreads = 1;
+    }
+
+    /* Never spawn workers that would receive less than the minimum. */
+    const std::uint32_t byCount = count / minItemsPerWorker;
+    return std::max(1u, std::min(hardwareThreads, byCount));
+}
+
+/* Split [0, count) into contiguous ranges and run them on the worker pool. */
+/* Func is called as func(workerIndex, begin, end); ranges are deterministic, */
+/* and each worker index runs exactly once, though not on a fixed thread. */
+template <typename Func>
+void ParallelFor(std::uint32_t count, std::uint32_t workerCount, Func&& func)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (workerCount <= 1)
+    {
+        func(0u, 0u, count);
+        return;
+    }
+
+    /* Range boundaries depend only on count and worker count. */
+    struct RangeJob
+    {
+        Func* Body;
+        std::uint32_t Count;
+        std::uint32_t Chunk;
+    };
+
+    RangeJob job{ &func, count, (count + workerCount - 1) / workerCount };
+
+    g_WorkerPool.Run(workerCount, [](void* context, std::uint32_t worker)
+    {
+        const RangeJob& range = *static_cast<const RangeJob*>(context);
+        const std::uint32_t begin = std::min(range.Count, worker * range.Chunk);
+        const std::uint32_t end = std::min(range.Count, begin + range.Chunk);
+        (*range.Body)(worker, begin, end);
+    }, &job);
+}
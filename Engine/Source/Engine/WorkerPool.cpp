@@ -0,0 +1,309 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "WorkerPool.h"
+
+WorkerPool g_WorkerPool;
+
+namespace
+{
+    /* Set on pool threads, and on a caller while it runs a job, so */
+    /* nested ParallelFor calls run inline. */
+    thread_local bool t_InsideJob = false;
+
+    /* Run every task on the calling thread. */
+    void RunInline(std::uint32_t taskCount, WorkerPool::TaskFunc func, void* context)
+    {
+        for (std::uint32_t task = 0; task < taskCount; ++task)
+        {
+            func(context, task);
+        }
+    }
+}
+
+/* Initialize an empty pool, threads are created by Start. */
+WorkerPool::WorkerPool()
+    : JobFunc(nullptr)
+    , JobContext(nullptr)
+    , JobTaskCount(0)
+    , Generation(0)
+    , JobOpen(false)
+    , Stopping(false)
+    , NextTask(0)
+    , PendingTasks(0)
+    , ActiveWorkers(0)
+    , BackgroundPending(0)
+    , ThreadCount(0)
+{
+}
+
+/* Join any running threads. */
+WorkerPool::~WorkerPool()
+{
+    Stop();
+}
+
+/* Create the worker threads, 0 for one per core besides the caller. */
+void WorkerPool::Start(std::uint32_t threadCount)
+{
+    std::lock_guard<std::mutex> lifetime(LifetimeMutex);
+    if (!Threads.empty())
+    {
+        return;
+    }
+
+    if (threadCount == 0)
+    {
+        const std::uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Stopping = false;
+    }
+
+    Threads.reserve(threadCount);
+    for (std::uint32_t i = 0; i < threadCount; ++i)
+    {
+        Threads.emplace_back(&WorkerPool::WorkerMain, this);
+    }
+
+    ThreadCount.store(threadCount, std::memory_order_release);
+}
+
+/* Wake and join all worker threads. */
+void WorkerPool::Stop()
+{
+    std::lock_guard<std::mutex> lifetime(LifetimeMutex);
+    if (Threads.empty())
+    {
+        return;
+    }
+
+    /* Let a job in flight finish before the workers leave. */
+    std::lock_guard<std::mutex> submit(SubmitMutex);
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Stopping = true;
+    }
+    WakeCondition.notify_all();
+
+    for (std::thread& thread : Threads)
+    {
+        thread.join();
+    }
+
+    Threads.clear();
+    ThreadCount.store(0, std::memory_order_release);
+
+    /* Workers drain the queue before leaving; a task that raced the */
+    /* shutdown still runs here. */
+    std::unique_lock<std::mutex> lock(Mutex);
+    while (!Background.empty())
+    {
+        const BackgroundTask task = Background.front();
+        Background.pop_front();
+        lock.unlock();
+        task.Func(task.Context, 0);
+        lock.lock();
+        --BackgroundPending;
+    }
+    lock.unlock();
+    DoneCondition.notify_all();
+}
+
+/* Run tasks [0, taskCount) across the workers and the calling thread. */
+void WorkerPool::Run(std::uint32_t taskCount, TaskFunc func, void* context)
+{
+    if (taskCount == 0)
+    {
+        return;
+    }
+
+    if (taskCount == 1 || t_InsideJob)
+    {
+        RunInline(taskCount, func, context);
+        return;
+    }
+
+    if (ThreadCount.load(std::memory_order_acquire) == 0)
+    {
+        Start(0);
+    }
+
+    /* Another thread owns the pool, or there is nobody to share with. */
+    std::unique_lock<std::mutex> submit(SubmitMutex, std::try_to_lock);
+    if (!submit.owns_lock() || ThreadCount.load(std::memory_order_acquire) == 0)
+    {
+        RunInline(taskCount, func, context);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        JobFunc = func;
+        JobContext = context;
+        JobTaskCount = taskCount;
+        NextTask.store(0, std::memory_order_relaxed);
+        PendingTasks.store(taskCount, std::memory_order_relaxed);
+        JobOpen = true;
+        ++Generation;
+    }
+    WakeCondition.notify_all();
+
+    /* The caller works too instead of only waiting. */
+    t_InsideJob = true;
+    RunTasks();
+    t_InsideJob = false;
+
+    /* Close the job so late wakers skip it, then wait for workers still */
+    /* inside it; only then may the next job reuse the job fields. */
+    std::unique_lock<std::mutex> lock(Mutex);
+    JobOpen = false;
+    DoneCondition.wait(lock, [this]()
+    {
+        return PendingTasks.load(std::memory_order_acquire) == 0 && ActiveWorkers == 0;
+    });
+}
+
+/* Queue func(context, 0) for the next idle worker and return at once. */
+void WorkerPool::Submit(TaskFunc func, void* context)
+{
+    if (ThreadCount.load(std::memory_order_acquire) == 0)
+    {
+        Start(0);
+    }
+
+    if (ThreadCount.load(std::memory_order_acquire) == 0)
+    {
+        func(context, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        BackgroundTask task{};
+        task.Func = func;
+        task.Context = context;
+        Background.push_back(task);
+        ++BackgroundPending;
+    }
+    WakeCondition.notify_all();
+}
+
+/* Block until every task queued by Submit has finished. */
+void WorkerPool::WaitForSubmitted()
+{
+    std::unique_lock<std::mutex> lock(Mutex);
+    DoneCondition.wait(lock, [this]()
+    {
+        return BackgroundPending == 0;
+    });
+}
+
+/* Worker threads currently running, excluding callers. */
+std::uint32_t WorkerPool::GetThreadCount() const
+{
+    return ThreadCount.load(std::memory_order_acquire);
+}
+
+/* Worker thread loop. */
+void WorkerPool::WorkerMain()
+{
+    t_InsideJob = true;
+    std::uint64_t seenGeneration = 0;
+
+    for (;;)
+    {
+        BackgroundTask background{};
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            WakeCondition.wait(lock, [this, seenGeneration]()
+            {
+                return Stopping || (JobOpen && Generation != seenGeneration) || !Background.empty();
+            });
+
+            /* A frame job outranks background work; the queue is drained */
+            /* before a stopping worker leaves. */
+            if (JobOpen && Generation != seenGeneration)
+            {
+                seenGeneration = Generation;
+                ++ActiveWorkers;
+            }
+            else if (!Background.empty())
+            {
+                background = Background.front();
+                Background.pop_front();
+            }
+            else
+            {
+                return;
+            }
+        }
+
+        if (background.Func)
+        {
+            /* Not counted in ActiveWorkers, so jobs never wait on it. */
+            background.Func(background.Context, 0);
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                --BackgroundPending;
+            }
+            DoneCondition.notify_all();
+            continue;
+        }
+
+        RunTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            --ActiveWorkers;
+        }
+        DoneCondition.notify_all();
+    }
+}
+
+/* Claim and run tasks of the current job until none are left. */
+void WorkerPool::RunTasks()
+{
+    for (;;)
+    {
+        const std::uint32_t task = NextTask.fetch_add(1, std::memory_order_relaxed);
+        if (task >= JobTaskCount)
+        {
+            return;
+        }
+
+        JobFunc(JobContext, task);
+
+        if (PendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            /* Last task: take the mutex so the caller cannot miss the wake-up. */
+            std::lock_guard<std::mutex> lock(Mutex);
+            DoneCondition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Persistent worker threads shared by every ParallelFor call. */
+/* Threads are created once and sleep between jobs, so per-frame parallel */
+/* passes pay a wake-up instead of thread creation. One job runs at a time; */
+/* a nested call or a call racing another job runs inline on its thread. */
+/* Submit queues long-running background tasks that idle workers pick up */
+/* between jobs. */
+class WorkerPool
+{
+public:
+    /* Task callback, called once per task index. */
+    using TaskFunc = void (*)(void* context, std::uint32_t taskIndex);
+
+    /* Initialize an empty pool, threads are created by Start. */
+    WorkerPool();
+
+    /* Join any running threads. */
+    ~WorkerPool();
+
+    /* Create the worker threads, 0 for one per core besides the caller. */
+    /* Later calls while running are ignored. */
+    void Start(std::uint32_t threadCount);
+
+    /* Wake and join all worker threads. */
+    void Stop();
+
+    /* Run tasks [0, taskCount) across the workers and the calling thread. */
+    /* Returns once every task has finished; starts the pool on first use. */
+    void Run(std::uint32_t taskCount, TaskFunc func, void* context);
+
+    /* Queue func(context, 0) for the next idle worker and return at once. */
+    /* Jobs from Run are served first; without workers it runs inline. */
+    void Submit(TaskFunc func, void* context);
+
+    /* Block until every task queued by Submit has finished. */
+    void WaitForSubmitted();
+
+    /* Worker threads currently running, excluding callers. */
+    std::uint32_t GetThreadCount() const;
+
+private:
+    /* Worker thread loop. */
+    void WorkerMain();
+
+    /* Claim and run tasks of the current job until none are left. */
+    void RunTasks();
+
+private:
+    struct BackgroundTask
+    {
+        TaskFunc Func = nullptr;
+        void* Context = nullptr;
+    };
+
+    std::vector<std::thread> Threads;
+
+    /* Serializes Start/Stop against each other. */
+    std::mutex LifetimeMutex;
+
+    /* Held by the caller for the whole job; a busy pool runs callers inline. */
+    std::mutex SubmitMutex;
+
+    /* Guards job publication, worker wake-up and completion. */
+    std::mutex Mutex;
+    std::condition_variable WakeCondition;
+    std::condition_variable DoneCondition;
+
+    /* Current job, published under Mutex before Generation changes. */
+    TaskFunc JobFunc;
+    void* JobContext;
+    std::uint32_t JobTaskCount;
+    std::uint64_t Generation;
+    bool JobOpen;
+    bool Stopping;
+
+    /* Next unclaimed task, tasks not yet finished, and workers inside RunTasks. */
+    std::atomic<std::uint32_t> NextTask;
+    std::atomic<std::uint32_t> PendingTasks;
+    std::uint32_t ActiveWorkers;
+
+    /* Submitted tasks not yet claimed, and those queued or running, under Mutex. */
+    std::deque<BackgroundTask> Background;
+    std::uint32_t BackgroundPending;
+
+    std::atomic<std::uint32_t> ThreadCount;
+};
+
+extern WorkerPool g_WorkerPool;
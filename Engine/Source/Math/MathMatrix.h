@@ -121,4 +121,59 @@ struct Mat4
 
         return Result;
     }
+
+    /* Transforms a point, assuming an affine matrix. */
+    Vec3 TransformPoint(const Vec3& Point) const
+    {
+        return Vec3(
+            m[0] * Point.x + m[4] * Point.y + m[8] * Point.z + m[12],
+            m[1] * Point.x + m[5] * Point.y + m[9] * Point.z + m[13],
+            m[2] * Point.x + m[6] * Point.y + m[10] * Point.z + m[14]);
+    }
+
+    /* Transforms a direction, ignoring translation. */
+    Vec3 TransformDirection(const Vec3& Direction) const
+    {
+        return Vec3(
+            m[0] * Direction.x + m[4] * Direction.y + m[8] * Direction.z,
+            m[1] * Direction.x + m[5] * Direction.y + m[9] * Direction.z,
+            m[2] * Direction.x + m[6] * Direction.y + m[10] * Direction.z);
+    }
+
+    /* Returns the inverse of an affine matrix, or identity when singular. */
+    Mat4 InverseAffine() const
+    {
+        /* Cofactors of the upper 3x3 block. */
+        const float C00 = m[5] * m[10] - m[9] * m[6];
+        const float C01 = m[9] * m[2] - m[1] * m[10];
+        const float C02 = m[1] * m[6] - m[5] * m[2];
+
+        const float Det = m[0] * C00 + m[4] * C01 + m[8] * C02;
+        if (std::fabs(Det) < 1e-12f)
+        {
+            return Identity();
+        }
+
+        const float InvDet = 1.0f / Det;
+
+        Mat4 Result = Identity();
+        Result.m[0] = C00 * InvDet;
+        Result.m[1] = C01 * InvDet;
+        Result.m[2] = C02 * InvDet;
+        Result.m[4] = (m[8] * m[6] - m[4] * m[10]) * InvDet;
+        Result.m[5] = (m[0] * m[10] - m[8] * m[2]) * InvDet;
+        Result.m[6] = (m[4] * m[2] - m[0] * m[6]) * InvDet;
+        Result.m[8] = (m[4] * m[9] - m[8] * m[5]) * InvDet;
+        Result.m[9] = (m[8] * m[1] - m[0] * m[9]) * InvDet;
+        Result.m[10] = (m[0] * m[5] - m[4] * m[1]) * InvDet;
+
+        /* Inverse translation is -R^-1 * t. */
+        const Vec3 Translation(m[12], m[13], m[14]);
+        const Vec3 Inverted = Result.TransformDirection(Translation);
+        Result.m[12] = -Inverted.x;
+        Result.m[13] = -Inverted.y;
+        Result.m[14] = -Inverted.z;
+
+        return Result;
+    }
 };
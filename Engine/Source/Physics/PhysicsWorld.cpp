@@ -0,0 +1,725 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "PhysicsWorld.h"
+
+#include "Engine/ParallelFor.h"
+#include "Scene/Scene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <utility>
+
+/* Local helpers. */
+namespace
+{
+    /* Bounds padding so resting contacts persist between substeps. */
+    constexpr float kContactMargin = 0.02f;
+
+    /* Penetration allowed before position correction kicks in. */
+    constexpr float kPenetrationSlop = 0.005f;
+
+    /* Share of penetration removed per substep. */
+    constexpr float kBaumgarteFactor = 0.2f;
+
+    /* Approach speed below which contacts do not bounce. */
+    constexpr float kRestitutionThreshold = 1.0f;
+
+    /* Cap on substeps per frame so a stall cannot spiral. */
+    constexpr std::uint32_t kMaxSubsteps = 4;
+}
+
+/* Initialize an empty world with a sweep-and-prune broadphase. */
+PhysicsWorld::PhysicsWorld()
+    : broadphase(CreateBroadphase(BroadphaseType::SweepAndPrune))
+{
+}
+
+/* World cleanup handled by containers. */
+PhysicsWorld::~PhysicsWorld()
+{
+}
+
+/* Create a body from the entity transform, the box follows its scale. */
+bool PhysicsWorld::AddBody(Scene& scene, Entity entity, const RigidBodyComponent& component)
+{
+    const TransformComponent* transform = scene.GetTransform(entity);
+    if (!transform)
+    {
+        std::fprintf(stderr, "PhysicsWorld::AddBody: entity has no transform\n");
+        return false;
+    }
+
+    /* Re-adding replaces the previous body. */
+    RemoveBody(entity);
+
+    const std::uint32_t id = entity.GetId();
+    if (id >= bodyIndexByEntity.size())
+    {
+        bodyIndexByEntity.resize(static_cast<std::size_t>(id) + 1, kInvalidIndex);
+    }
+
+    const bool isStatic = component.Mass <= 0.0f;
+    const Vec3 velocity = isStatic ? Vec3(0.0f, 0.0f, 0.0f) : component.LinearVelocity;
+
+    const float position[3] = { transform->Position.x, transform->Position.y, transform->Position.z };
+    const float scale[3] = { transform->Scale.x, transform->Scale.y, transform->Scale.z };
+    const float linearVelocity[3] = { velocity.x, velocity.y, velocity.z };
+
+    const std::uint32_t body = static_cast<std::uint32_t>(entityIds.size());
+    entityIds.push_back(id);
+    for (std::uint32_t axis = 0; axis < 3; ++axis)
+    {
+        positions[axis].push_back(position[axis]);
+        velocities[axis].push_back(linearVelocity[axis]);
+        halfExtents[axis].push_back(std::fabs(scale[axis]) * 0.5f);
+    }
+    inverseMasses.push_back(isStatic ? 0.0f : 1.0f / component.Mass);
+    restitutions.push_back(std::max(0.0f, component.Restitution));
+    frictions.push_back(std::max(0.0f, component.Friction));
+
+    bodyIndexByEntity[id] = body;
+
+    /* Static proxies never move, so they are only inserted once. */
+    broadphase->SetBounds(id, GetBodyBounds(body, 0.0f));
+    return true;
+}
+
+/* Mirror the scene's rigid body components and external transform edits. */
+void PhysicsWorld::SyncBodies(Scene& scene)
+{
+    /* Walk backwards so swap-removal only moves visited bodies. */
+    for (std::uint32_t body = static_cast<std::uint32_t>(entityIds.size()); body-- > 0;)
+    {
+        const Entity entity(entityIds[body]);
+        const TransformComponent* transform = scene.GetTransform(entity);
+        if (!transform || !scene.HasComponent<RigidBodyComponent>(entity))
+        {
+            RemoveBody(entity);
+            continue;
+        }
+
+        /* Only WriteBack moves transforms of bodies, any other change is an edit. */
+        const float position[3] = { transform->Position.x, transform->Position.y, transform->Position.z };
+        const float scale[3] = { transform->Scale.x, transform->Scale.y, transform->Scale.z };
+
+        bool edited = false;
+        for (std::uint32_t axis = 0; axis < 3; ++axis)
+        {
+            edited = edited ||
+                positions[axis][body] != position[axis] ||
+                halfExtents[axis][body] != std::fabs(scale[axis]) * 0.5f;
+        }
+
+        if (!edited)
+        {
+            continue;
+        }
+
+        /* Teleport the body, dropping velocity it built up before the edit. */
+        for (std::uint32_t axis = 0; axis < 3; ++axis)
+        {
+            positions[axis][body] = position[axis];
+            velocities[axis][body] = 0.0f;
+            halfExtents[axis][body] = std::fabs(scale[axis]) * 0.5f;
+        }
+        broadphase->SetBounds(entityIds[body], GetBodyBounds(body, 0.0f));
+    }
+
+    /* Register components that have no body yet. */
+    scene.GetComponentEntities<RigidBodyComponent>(componentEntityIds);
+    for (const std::uint32_t id : componentEntityIds)
+    {
+        const Entity entity(id);
+        if (HasBody(entity) || !scene.GetTransform(entity))
+        {
+            continue;
+        }
+
+        AddBody(scene, entity, *scene.GetComponent<RigidBodyComponent>(entity));
+    }
+
+    stats.BodyCount = static_cast<std::uint32_t>(entityIds.size());
+}
+
+/* Remove a body, ignoring entities without one. */
+void PhysicsWorld::RemoveBody(Entity entity)
+{
+    const std::uint32_t id = entity.GetId();
+    if (id >= bodyIndexByEntity.size() || bodyIndexByEntity[id] == kInvalidIndex)
+    {
+        return;
+    }
+
+    RemoveBodyAt(bodyIndexByEntity[id]);
+}
+
+/* Check whether an entity owns a body. */
+bool PhysicsWorld::HasBody(Entity entity) const
+{
+    const std::uint32_t id = entity.GetId();
+    return id < bodyIndexByEntity.size() && bodyIndexByEntity[id] != kInvalidIndex;
+}
+
+/* Remove every body. */
+void PhysicsWorld::Clear()
+{
+    entityIds.clear();
+    for (std::uint32_t axis = 0; axis < 3; ++axis)
+    {
+        positions[axis].clear();
+        velocities[axis].clear();
+        halfExtents[axis].clear();
+    }
+    inverseMasses.clear();
+    restitutions.clear();
+    frictions.clear();
+    bodyIndexByEntity.clear();
+    broadphase->Clear();
+    accumulator = 0.0f;
+    stats = PhysicsStats{};
+}
+
+/* Linear velocity access. */
+void PhysicsWorld::SetLinearVelocity(Entity entity, const Vec3& velocity)
+{
+    if (!HasBody(entity))
+    {
+        return;
+    }
+
+    /* Static bodies stay at rest. */
+    const std::uint32_t body = bodyIndexByEntity[entity.GetId()];
+    if (inverseMasses[body] == 0.0f)
+    {
+        return;
+    }
+
+    velocities[0][body] = velocity.x;
+    velocities[1][body] = velocity.y;
+    velocities[2][body] = velocity.z;
+}
+
+/* Linear velocity access. */
+Vec3 PhysicsWorld::GetLinearVelocity(Entity entity) const
+{
+    if (!HasBody(entity))
+    {
+        return Vec3(0.0f, 0.0f, 0.0f);
+    }
+
+    const std::uint32_t body = bodyIndexByEntity[entity.GetId()];
+    return Vec3(velocities[0][body], velocities[1][body], velocities[2][body]);
+}
+
+/* World settings. */
+void PhysicsWorld::SetGravity(const Vec3& newGravity)
+{
+    gravity = newGravity;
+}
+
+/* World settings. */
+void PhysicsWorld::SetFixedTimeStep(float newTimeStep)
+{
+    if (newTimeStep > 0.0f)
+    {
+        fixedTimeStep = newTimeStep;
+    }
+}
+
+/* World settings. */
+void PhysicsWorld::SetSolverIterations(std::uint32_t newIterations)
+{
+    solverIterations = std::max(1u, newIterations);
+}
+
+/* Minimum items per worker before a stage goes parallel. */
+void PhysicsWorld::SetMinItemsPerWorker(std::uint32_t count)
+{
+    minItemsPerWorker = std::max(1u, count);
+}
+
+/* Sync bodies, advance by real time in fixed substeps and write back transforms. */
+void PhysicsWorld::Step(Scene& scene, float deltaTime)
+{
+    SyncBodies(scene);
+    stats.SubstepCount = 0;
+
+    if (entityIds.empty())
+    {
+        accumulator = 0.0f;
+        return;
+    }
+
+    accumulator += std::max(0.0f, deltaTime);
+    while (accumulator >= fixedTimeStep && stats.SubstepCount < kMaxSubsteps)
+    {
+        Simulate(fixedTimeStep);
+        accumulator -= fixedTimeStep;
+        ++stats.SubstepCount;
+    }
+
+    /* Drop backlog the substep cap could not absorb. */
+    if (accumulator >= fixedTimeStep)
+    {
+        accumulator = 0.0f;
+    }
+
+    if (stats.SubstepCount > 0)
+    {
+        WriteBack(scene);
+    }
+}
+
+/* Counters from the most recent step. */
+const PhysicsStats& PhysicsWorld::GetStats() const
+{
+    return stats;
+}
+
+/* One fixed substep of the pipeline. */
+void PhysicsWorld::Simulate(float timeStep)
+{
+    IntegrateVelocities(timeStep);
+    UpdateBroadphase(timeStep);
+
+    broadphase->FindPairs(pairs);
+    GenerateContacts();
+    BuildIslands();
+
+    /* Balance workers by contact count, islands never share dynamic bodies. */
+    const std::uint32_t contactCount = static_cast<std::uint32_t>(contacts.size());
+    const std::uint32_t islandCount = static_cast<std::uint32_t>(islands.size());
+    const std::uint32_t workerCount = std::min(
+        std::max(1u, islandCount),
+        GetParallelWorkerCount(contactCount, minItemsPerWorker));
+
+    workerIslandStarts.assign(static_cast<std::size_t>(workerCount) + 1, islandCount);
+    workerIslandStarts[0] = 0;
+    std::uint32_t worker = 1;
+    std::uint32_t assigned = 0;
+    for (std::uint32_t island = 0; island < islandCount && worker < workerCount; ++island)
+    {
+        assigned += islands[island].ContactCount;
+        if (static_cast<std::uint64_t>(assigned) * workerCount >=
+            static_cast<std::uint64_t>(contactCount) * worker)
+        {
+            workerIslandStarts[worker++] = island + 1;
+        }
+    }
+
+    ParallelFor(workerCount, workerCount,
+        [this, timeStep](std::uint32_t, std::uint32_t begin, std::uint32_t end)
+        {
+            for (std::uint32_t index = begin; index < end; ++index)
+            {
+                for (std::uint32_t island = workerIslandStarts[index];
+                    island < workerIslandStarts[index + 1];
+                    ++island)
+                {
+                    SolveIsland(islands[island], timeStep);
+                }
+            }
+        });
+
+    IntegratePositions(timeStep);
+
+    stats.ContactCount = contactCount;
+    stats.IslandCount = islandCount;
+}
+
+/* Apply gravity to dynamic bodies. */
+void PhysicsWorld::IntegrateVelocities(float timeStep)
+{
+    const std::uint32_t count = static_cast<std::uint32_t>(entityIds.size());
+    const float delta[3] = { gravity.x * timeStep, gravity.y * timeStep, gravity.z * timeStep };
+
+    ParallelFor(count, GetParallelWorkerCount(count, minItemsPerWorker),
+        [this, &delta](std::uint32_t, std::uint32_t begin, std::uint32_t end)
+        {
+            for (std::uint32_t axis = 0; axis < 3; ++axis)
+            {
+                float* velocity = velocities[axis].data();
+                for (std::uint32_t body = begin; body < end; ++body)
+                {
+                    if (inverseMasses[body] > 0.0f)
+                    {
+                        velocity[body] += delta[axis];
+                    }
+                }
+            }
+        });
+}
+
+/* Refresh proxies with bounds grown by the motion of this substep. */
+void PhysicsWorld::UpdateBroadphase(float timeStep)
+{
+    const std::uint32_t count = static_cast<std::uint32_t>(entityIds.size());
+    for (std::uint32_t body = 0; body < count; ++body)
+    {
+        if (inverseMasses[body] > 0.0f)
+        {
+            broadphase->SetBounds(entityIds[body], GetBodyBounds(body, timeStep));
+        }
+    }
+
+    broadphase->Update();
+}
+
+/* Turn broadphase pairs into axis contacts. */
+void PhysicsWorld::GenerateContacts()
+{
+    const std::uint32_t pairCount = static_cast<std::uint32_t>(pairs.size());
+    contacts.resize(pairCount);
+
+    ParallelFor(pairCount, GetParallelWorkerCount(pairCount, minItemsPerWorker),
+        [this](std::uint32_t, std::uint32_t begin, std::uint32_t end)
+        {
+            for (std::uint32_t index = begin; index < end; ++index)
+            {
+                Contact& contact = contacts[index];
+                contact = Contact{};
+
+                const std::uint32_t bodyA = bodyIndexByEntity[pairs[index].A];
+                const std::uint32_t bodyB = bodyIndexByEntity[pairs[index].B];
+
+                /* Static pairs never need a response. */
+                const float inverseMassSum = inverseMasses[bodyA] + inverseMasses[bodyB];
+                if (inverseMassSum <= 0.0f)
+                {
+                    continue;
+                }
+
+                /* The axis of least overlap separates the boxes. */
+                float bestOverlap = 0.0f;
+                for (std::uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    const float delta = positions[axis][bodyB] - positions[axis][bodyA];
+                    const float overlap =
+                        halfExtents[axis][bodyA] + halfExtents[axis][bodyB] - std::fabs(delta);
+                    if (axis == 0 || overlap < bestOverlap)
+                    {
+                        bestOverlap = overlap;
+                        contact.Axis = axis;
+                        contact.Sign = delta < 0.0f ? -1.0f : 1.0f;
+                    }
+                }
+
+                /* Positive separation becomes a speculative contact. */
+                contact.BodyA = bodyA;
+                contact.BodyB = bodyB;
+                contact.Separation = -bestOverlap;
+                contact.Friction = std::sqrt(frictions[bodyA] * frictions[bodyB]);
+                contact.Restitution = std::max(restitutions[bodyA], restitutions[bodyB]);
+                contact.EffectiveMass = 1.0f / inverseMassSum;
+                contact.Valid = true;
+            }
+        });
+
+    /* Compact in pair order so results do not depend on worker count. */
+    std::size_t write = 0;
+    for (std::size_t read = 0; read < contacts.size(); ++read)
+    {
+        if (contacts[read].Valid)
+        {
+            contacts[write++] = contacts[read];
+        }
+    }
+    contacts.resize(write);
+}
+
+/* Group contacts into islands joined by dynamic bodies. */
+void PhysicsWorld::BuildIslands()
+{
+    const std::uint32_t bodyCount = static_cast<std::uint32_t>(entityIds.size());
+    islandParents.resize(bodyCount);
+    std::iota(islandParents.begin(), islandParents.end(), 0u);
+
+    /* Static bodies are read-only, so they never merge islands. */
+    for (const Contact& contact : contacts)
+    {
+        if (inverseMasses[contact.BodyA] == 0.0f || inverseMasses[contact.BodyB] == 0.0f)
+        {
+            continue;
+        }
+
+        const std::uint32_t rootA = FindIslandRoot(contact.BodyA);
+        const std::uint32_t rootB = FindIslandRoot(contact.BodyB);
+        if (rootA != rootB)
+        {
+            islandParents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+    }
+
+    /* Number islands in order of first contact. */
+    islandByRoot.assign(bodyCount, kInvalidIndex);
+    contactIslands.resize(contacts.size());
+    islands.clear();
+
+    for (std::size_t index = 0; index < contacts.size(); ++index)
+    {
+        const Contact& contact = contacts[index];
+        const std::uint32_t dynamicBody =
+            inverseMasses[contact.BodyA] > 0.0f ? contact.BodyA : contact.BodyB;
+        const std::uint32_t root = FindIslandRoot(dynamicBody);
+
+        if (islandByRoot[root] == kInvalidIndex)
+        {
+            islandByRoot[root] = static_cast<std::uint32_t>(islands.size());
+            islands.emplace_back();
+        }
+
+        contactIslands[index] = islandByRoot[root];
+        ++islands[islandByRoot[root]].ContactCount;
+    }
+
+    /* Stable counting sort so every island owns a contiguous range. */
+    std::uint32_t offset = 0;
+    for (Island& island : islands)
+    {
+        island.FirstContact = offset;
+        offset += island.ContactCount;
+        island.ContactCount = 0;
+    }
+
+    sortedContacts.resize(contacts.size());
+    for (std::size_t index = 0; index < contacts.size(); ++index)
+    {
+        Island& island = islands[contactIslands[index]];
+        sortedContacts[island.FirstContact + island.ContactCount++] = contacts[index];
+    }
+    contacts.swap(sortedContacts);
+}
+
+/* Sequential impulse solve of one island. */
+void PhysicsWorld::SolveIsland(const Island& island, float timeStep)
+{
+    Contact* first = contacts.data() + island.FirstContact;
+    Contact* last = first + island.ContactCount;
+    const float inverseTimeStep = 1.0f / timeStep;
+
+    /* Resolve target normal speeds from the pre-solve velocities. */
+    for (Contact* contact = first; contact != last; ++contact)
+    {
+        const float* velocity = velocities[contact->Axis].data();
+        const float normalSpeed =
+            contact->Sign * (velocity[contact->BodyB] - velocity[contact->BodyA]);
+
+        if (contact->Separation > 0.0f)
+        {
+            /* Allow closing the gap this substep but no further. */
+            contact->TargetVelocity = -contact->Separation * inverseTimeStep;
+        }
+        else
+        {
+            const float penetration = std::max(0.0f, -contact->Separation - kPenetrationSlop);
+            contact->TargetVelocity = kBaumgarteFactor * penetration * inverseTimeStep;
+        }
+
+        if (contact->Separation <= kPenetrationSlop && normalSpeed < -kRestitutionThreshold)
+        {
+            contact->TargetVelocity =
+                std::max(contact->TargetVelocity, -contact->Restitution * normalSpeed);
+        }
+    }
+
+    for (std::uint32_t iteration = 0; iteration < solverIterations; ++iteration)
+    {
+        for (Contact* contact = first; contact != last; ++contact)
+        {
+            const float inverseMassA = inverseMasses[contact->BodyA];
+            const float inverseMassB = inverseMasses[contact->BodyB];
+
+            /* Friction along the two tangent axes, bounded by the normal impulse. */
+            const float maxFriction = contact->Friction * contact->NormalImpulse;
+            for (std::uint32_t tangent = 0; tangent < 2; ++tangent)
+            {
+                float* velocity = velocities[(contact->Axis + 1 + tangent) % 3].data();
+                const float tangentSpeed = velocity[contact->BodyB] - velocity[contact->BodyA];
+
+                const float previous = contact->TangentImpulse[tangent];
+                contact->TangentImpulse[tangent] = std::clamp(
+                    previous - contact->EffectiveMass * tangentSpeed,
+                    -maxFriction,
+                    maxFriction);
+                const float impulse = contact->TangentImpulse[tangent] - previous;
+
+                /* Static velocities are shared across islands and never written. */
+                if (inverseMassA > 0.0f)
+                {
+                    velocity[contact->BodyA] -= impulse * inverseMassA;
+                }
+                if (inverseMassB > 0.0f)
+                {
+                    velocity[contact->BodyB] += impulse * inverseMassB;
+                }
+            }
+
+            /* Non-penetration along the contact normal. */
+            float* velocity = velocities[contact->Axis].data();
+            const float normalSpeed =
+                contact->Sign * (velocity[contact->BodyB] - velocity[contact->BodyA]);
+
+            const float previous = contact->NormalImpulse;
+            contact->NormalImpulse = std::max(
+                0.0f,
+                previous + contact->EffectiveMass * (contact->TargetVelocity - normalSpeed));
+            const float impulse = (contact->NormalImpulse - previous) * contact->Sign;
+
+            if (inverseMassA > 0.0f)
+            {
+                velocity[contact->BodyA] -= impulse * inverseMassA;
+            }
+            if (inverseMassB > 0.0f)
+            {
+                velocity[contact->BodyB] += impulse * inverseMassB;
+            }
+        }
+    }
+}
+
+/* Move dynamic bodies by their solved velocities. */
+void PhysicsWorld::IntegratePositions(float timeStep)
+{
+    const std::uint32_t count = static_cast<std::uint32_t>(entityIds.size());
+
+    ParallelFor(count, GetParallelWorkerCount(count, minItemsPerWorker),
+        [this, timeStep](std::uint32_t, std::uint32_t begin, std::uint32_t end)
+        {
+            for (std::uint32_t axis = 0; axis < 3; ++axis)
+            {
+                float* position = positions[axis].data();
+                const float* velocity = velocities[axis].data();
+                for (std::uint32_t body = begin; body < end; ++body)
+                {
+                    /* Static bodies carry zero velocity, so no branch is needed. */
+                    position[body] += velocity[body] * timeStep;
+                }
+            }
+        });
+}
+
+/* Copy dynamic body positions into transforms, velocities into components. */
+void PhysicsWorld::WriteBack(Scene& scene)
+{
+    /* Walk backwards so swap-removal only moves visited bodies. */
+    for (std::uint32_t body = static_cast<std::uint32_t>(entityIds.size()); body-- > 0;)
+    {
+        const Entity entity(entityIds[body]);
+        TransformComponent* transform = scene.GetTransform(entity);
+        if (!transform)
+        {
+            /* The entity or its transform went away, drop the body. */
+            RemoveBodyAt(body);
+            continue;
+        }
+
+        if (inverseMasses[body] == 0.0f)
+        {
+            continue;
+        }
+
+        transform->Position = Vec3(positions[0][body], positions[1][body], positions[2][body]);
+        scene.MarkTransformDirty(entity);
+
+        /* Components only report velocity, the body never reads it back. */
+        RigidBodyComponent* component = scene.GetComponent<RigidBodyComponent>(entity);
+        if (component)
+        {
+            component->LinearVelocity = Vec3(velocities[0][body], velocities[1][body], velocities[2][body]);
+        }
+    }
+
+    stats.BodyCount = static_cast<std::uint32_t>(entityIds.size());
+}
+
+/* Swap-remove one body from the SoA arrays. */
+void PhysicsWorld::RemoveBodyAt(std::uint32_t index)
+{
+    const std::uint32_t last = static_cast<std::uint32_t>(entityIds.size()) - 1;
+
+    broadphase->Remove(entityIds[index]);
+    bodyIndexByEntity[entityIds[index]] = kInvalidIndex;
+
+    if (index != last)
+    {
+        entityIds[index] = entityIds[last];
+        for (std::uint32_t axis = 0; axis < 3; ++axis)
+        {
+            positions[axis][index] = positions[axis][last];
+            velocities[axis][index] = velocities[axis][last];
+            halfExtents[axis][index] = halfExtents[axis][last];
+        }
+        inverseMasses[index] = inverseMasses[last];
+        restitutions[index] = restitutions[last];
+        frictions[index] = frictions[last];
+
+        bodyIndexByEntity[entityIds[index]] = index;
+    }
+
+    entityIds.pop_back();
+    for (std::uint32_t axis = 0; axis < 3; ++axis)
+    {
+        positions[axis].pop_back();
+        velocities[axis].pop_back();
+        halfExtents[axis].pop_back();
+    }
+    inverseMasses.pop_back();
+    restitutions.pop_back();
+    frictions.pop_back();
+}
+
+/* Union-find root with path halving. */
+std::uint32_t PhysicsWorld::FindIslandRoot(std::uint32_t body)
+{
+    while (islandParents[body] != body)
+    {
+        islandParents[body] = islandParents[islandParents[body]];
+        body = islandParents[body];
+    }
+
+    return body;
+}
+
+/* Body bounds grown by a per-axis margin. */
+AABB PhysicsWorld::GetBodyBounds(std::uint32_t body, float timeStep) const
+{
+    float minValue[3];
+    float maxValue[3];
+    for (std::uint32_t axis = 0; axis < 3; ++axis)
+    {
+        /* Grow by this substep's travel so fast bodies still get contacts. */
+        const float margin =
+            halfExtents[axis][body] + kContactMargin + std::fabs(velocities[axis][body]) * timeStep;
+        minValue[axis] = positions[axis][body] - margin;
+        maxValue[axis] = positions[axis][body] + margin;
+    }
+
+    return AABB{
+        Vec3(minValue[0], minValue[1], minValue[2]),
+        Vec3(maxValue[0], maxValue[1], maxValue[2]) };
+}
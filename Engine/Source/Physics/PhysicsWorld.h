@@ -0,0 +1,195 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Math/MathTypes.h"
+#include "Scene/Collision/Broadphase.h"
+#include "Scene/Components/RigidBodyComponent.h"
+#include "Scene/Entity.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Scene;
+
+/* Counters from the most recent step. */
+struct PhysicsStats
+{
+    std::uint32_t BodyCount = 0;
+    std::uint32_t ContactCount = 0;
+    std::uint32_t IslandCount = 0;
+    std::uint32_t SubstepCount = 0;
+};
+
+/* Fixed-step rigid body world for axis-aligned boxes. */
+/* Body state lives in SoA arrays, contact islands are solved on worker threads. */
+/* Bodies mirror the scene's RigidBodyComponents, synced at the start of each step. */
+class PhysicsWorld
+{
+public:
+    PhysicsWorld();
+    ~PhysicsWorld();
+    PhysicsWorld(const PhysicsWorld& other) = delete;
+    PhysicsWorld& operator=(const PhysicsWorld& other) = delete;
+
+    /* Register bodies for new RigidBodyComponents, drop bodies whose */
+    /* component or transform went away, and pull in transforms edited */
+    /* outside the simulation (editor, scripts), resetting their velocity. */
+    void SyncBodies(Scene& scene);
+
+    /* Remove a body, ignoring entities without one. While the entity */
+    /* keeps its component the next sync registers it again, picking up */
+    /* edited component parameters. */
+    void RemoveBody(Entity entity);
+
+    /* Check whether an entity owns a body. */
+    bool HasBody(Entity entity) const;
+
+    /* Remove every body. */
+    void Clear();
+
+    /* Linear velocity access. */
+    void SetLinearVelocity(Entity entity, const Vec3& velocity);
+    Vec3 GetLinearVelocity(Entity entity) const;
+
+    /* World settings. */
+    void SetGravity(const Vec3& newGravity);
+    void SetFixedTimeStep(float newTimeStep);
+    void SetSolverIterations(std::uint32_t newIterations);
+
+    /* Minimum items per worker before a stage goes parallel. */
+    void SetMinItemsPerWorker(std::uint32_t count);
+
+    /* Sync bodies, advance by real time in fixed substeps and write back */
+    /* transforms and velocities. */
+    void Step(Scene& scene, float deltaTime);
+
+    /* Counters from the most recent step. */
+    const PhysicsStats& GetStats() const;
+
+private:
+    /* Axis-aligned contact between two bodies, normal points from A to B. */
+    struct Contact
+    {
+        std::uint32_t BodyA = 0;
+        std::uint32_t BodyB = 0;
+        std::uint32_t Axis = 0;
+        float Sign = 1.0f;
+        float Separation = 0.0f;
+        float Friction = 0.0f;
+        float Restitution = 0.0f;
+        float EffectiveMass = 0.0f;
+        float TargetVelocity = 0.0f;
+        float NormalImpulse = 0.0f;
+        float TangentImpulse[2] = { 0.0f, 0.0f };
+        bool Valid = false;
+    };
+
+    /* Contiguous range of contacts sharing dynamic bodies. */
+    struct Island
+    {
+        std::uint32_t FirstContact = 0;
+        std::uint32_t ContactCount = 0;
+    };
+
+    /* Create a body from the entity transform, the box follows its scale. */
+    bool AddBody(Scene& scene, Entity entity, const RigidBodyComponent& component);
+
+    /* One fixed substep of the pipeline. */
+    void Simulate(float timeStep);
+
+    /* Apply gravity to dynamic bodies. */
+    void IntegrateVelocities(float timeStep);
+
+    /* Refresh proxies with bounds grown by the motion of this substep. */
+    void UpdateBroadphase(float timeStep);
+
+    /* Turn broadphase pairs into axis contacts. */
+    void GenerateContacts();
+
+    /* Group contacts into islands joined by dynamic bodies. */
+    void BuildIslands();
+
+    /* Sequential impulse solve of one island. */
+    void SolveIsland(const Island& island, float timeStep);
+
+    /* Move dynamic bodies by their solved velocities. */
+    void IntegratePositions(float timeStep);
+
+    /* Copy dynamic body positions into scene transforms and velocities */
+    /* into their rigid body components. */
+    void WriteBack(Scene& scene);
+
+    /* Swap-remove one body from the SoA arrays. */
+    void RemoveBodyAt(std::uint32_t index);
+
+    /* Union-find root with path halving. */
+    std::uint32_t FindIslandRoot(std::uint32_t body);
+
+    /* Body bounds grown by a per-axis margin. */
+    AABB GetBodyBounds(std::uint32_t body, float timeStep) const;
+
+private:
+    /* Invalid index sentinel for sparse mapping. */
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    /* Body state, one entry per body in each array. */
+    std::vector<std::uint32_t> entityIds;
+    std::vector<float> positions[3];
+    std::vector<float> velocities[3];
+    std::vector<float> halfExtents[3];
+    std::vector<float> inverseMasses;
+    std::vector<float> restitutions;
+    std::vector<float> frictions;
+
+    /* Sparse lookup from entity id to body index. */
+    std::vector<std::uint32_t> bodyIndexByEntity;
+
+    /* Entities holding a RigidBodyComponent, reused across syncs. */
+    std::vector<std::uint32_t> componentEntityIds;
+
+    /* Broadphase keyed by entity id. */
+    std::unique_ptr<IBroadphase> broadphase;
+    std::vector<BroadphasePair> pairs;
+
+    /* Per-substep contact and island scratch, reused across steps. */
+    std::vector<Contact> contacts;
+    std::vector<Contact> sortedContacts;
+    std::vector<std::uint32_t> islandParents;
+    std::vector<std::uint32_t> islandByRoot;
+    std::vector<std::uint32_t> contactIslands;
+    std::vector<Island> islands;
+    std::vector<std::uint32_t> workerIslandStarts;
+
+    Vec3 gravity = Vec3(0.0f, -9.81f, 0.0f);
+    float fixedTimeStep = 1.0f / 60.0f;
+    float accumulator = 0.0f;
+    std::uint32_t solverIterations = 8;
+    std::uint32_t minItemsPerWorker = 1024;
+
+    PhysicsStats stats;
+};
@@ -0,0 +1,619 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+
+/* Local helpers. */
+namespace
+{
+    /* Weight of the planes pinning open boundary edges in place. */
+    constexpr double kBoundaryWeight = 1000.0;
+
+    /* Smallest cosine between a face normal before and after a collapse. */
+    constexpr float kMinNormalDot = 0.2f;
+
+    /* Optimal placements are rejected for near-singular quadrics. */
+    constexpr double kMinRelativeDeterminant = 1e-9;
+
+    /* Symmetric 4x4 plane quadric, upper triangle only. */
+    struct Quadric
+    {
+        double XX = 0.0;
+        double XY = 0.0;
+        double XZ = 0.0;
+        double XW = 0.0;
+        double YY = 0.0;
+        double YZ = 0.0;
+        double YW = 0.0;
+        double ZZ = 0.0;
+        double ZW = 0.0;
+        double WW = 0.0;
+
+        /* Accumulate the squared distance to plane ax + by + cz + d = 0. */
+        void AddPlane(double a, double b, double c, double d, double weight)
+        {
+            XX += weight * a * a;
+            XY += weight * a * b;
+            XZ += weight * a * c;
+            XW += weight * a * d;
+            YY += weight * b * b;
+            YZ += weight * b * c;
+            YW += weight * b * d;
+            ZZ += weight * c * c;
+            ZW += weight * c * d;
+            WW += weight * d * d;
+        }
+
+        void Add(const Quadric& other)
+        {
+            XX += other.XX;
+            XY += other.XY;
+            XZ += other.XZ;
+            XW += other.XW;
+            YY += other.YY;
+            YZ += other.YZ;
+            YW += other.YW;
+            ZZ += other.ZZ;
+            ZW += other.ZW;
+            WW += other.WW;
+        }
+
+        /* Weighted sum of squared plane distances at a point. */
+        double Evaluate(const Vec3& point) const
+        {
+            const double x = point.x;
+            const double y = point.y;
+            const double z = point.z;
+            return XX * x * x + 2.0 * XY * x * y + 2.0 * XZ * x * z + 2.0 * XW * x +
+                YY * y * y + 2.0 * YZ * y * z + 2.0 * YW * y +
+                ZZ * z * z + 2.0 * ZW * z + WW;
+        }
+
+        /* Point minimizing the error, false when the system is near singular. */
+        bool SolveOptimal(Vec3& outPoint) const
+        {
+            const double c00 = YY * ZZ - YZ * YZ;
+            const double c01 = XZ * YZ - XY * ZZ;
+            const double c02 = XY * YZ - XZ * YY;
+            const double det = XX * c00 + XY * c01 + XZ * c02;
+
+            const double scale = XX + YY + ZZ;
+            if (std::fabs(det) <= kMinRelativeDeterminant * scale * scale * scale)
+            {
+                return false;
+            }
+
+            const double c11 = XX * ZZ - XZ * XZ;
+            const double c12 = XY * XZ - XX * YZ;
+            const double c22 = XX * YY - XY * XY;
+            const double invDet = 1.0 / det;
+
+            outPoint = Vec3(
+                static_cast<float>(-(c00 * XW + c01 * YW + c02 * ZW) * invDet),
+                static_cast<float>(-(c01 * XW + c11 * YW + c12 * ZW) * invDet),
+                static_cast<float>(-(c02 * XW + c12 * YW + c22 * ZW) * invDet));
+            return true;
+        }
+    };
+
+    /* Candidate edge collapse, stale once either vertex version moves on. */
+    struct Collapse
+    {
+        double Cost = 0.0;
+        std::uint32_t Keep = 0;
+        std::uint32_t Remove = 0;
+        std::uint32_t KeepVersion = 0;
+        std::uint32_t RemoveVersion = 0;
+        Vec3 Target;
+    };
+
+    /* Min-heap ordering on cost. */
+    struct CollapseGreater
+    {
+        bool operator()(const Collapse& left, const Collapse& right) const
+        {
+            return left.Cost > right.Cost;
+        }
+    };
+
+    /* Exact bit pattern of a position, used for welding. */
+    struct PositionKey
+    {
+        std::uint32_t Bits[3] = {};
+
+        bool operator==(const PositionKey& other) const
+        {
+            return Bits[0] == other.Bits[0] && Bits[1] == other.Bits[1] && Bits[2] == other.Bits[2];
+        }
+    };
+
+    struct PositionKeyHash
+    {
+        std::size_t operator()(const PositionKey& key) const
+        {
+            std::uint64_t hash = 1469598103934665603ull;
+            for (std::uint32_t bits : key.Bits)
+            {
+                hash = (hash ^ bits) * 1099511628211ull;
+            }
+            return static_cast<std::size_t>(hash);
+        }
+    };
+
+    /* Undirected edge key, smaller index in the high half. */
+    std::uint64_t EdgeKey(std::uint32_t a, std::uint32_t b)
+    {
+        const std::uint32_t low = a < b ? a : b;
+        const std::uint32_t high = a < b ? b : a;
+        return (static_cast<std::uint64_t>(low) << 32) | high;
+    }
+
+    double Dot(const Vec3& a, const Vec3& b)
+    {
+        return static_cast<double>(a.x) * b.x + static_cast<double>(a.y) * b.y +
+            static_cast<double>(a.z) * b.z;
+    }
+
+    /* Mutable mesh state for one simplification run. */
+    struct SimplifyContext
+    {
+        std::vector<Vec3> positions;
+        std::vector<Quadric> quadrics;
+        std::vector<std::uint32_t> versions;
+        std::vector<std::uint8_t> removed;
+
+        /* Triangle corners and liveness, plus per-vertex incident triangles. */
+        std::vector<std::uint32_t> triangles;
+        std::vector<std::uint8_t> triangleAlive;
+        std::vector<std::vector<std::uint32_t>> vertexTriangles;
+        std::uint32_t liveTriangles = 0;
+
+        std::priority_queue<Collapse, std::vector<Collapse>, CollapseGreater> heap;
+
+        /* Neighbor scratch for the link test. */
+        std::vector<std::uint32_t> keepNeighbors;
+        std::vector<std::uint32_t> removeNeighbors;
+
+        bool TriangleHas(std::uint32_t triangle, std::uint32_t vertex) const
+        {
+            const std::uint32_t* corners = &triangles[triangle * 3];
+            return corners[0] == vertex || corners[1] == vertex || corners[2] == vertex;
+        }
+
+        /* Sorted unique vertices sharing a live triangle with vertex. */
+        void GatherNeighbors(std::uint32_t vertex, std::vector<std::uint32_t>& outNeighbors) const
+        {
+            outNeighbors.clear();
+            for (std::uint32_t triangle : vertexTriangles[vertex])
+            {
+                if (!triangleAlive[triangle])
+                {
+                    continue;
+                }
+
+                for (std::uint32_t corner = 0; corner < 3; ++corner)
+                {
+                    const std::uint32_t other = triangles[triangle * 3 + corner];
+                    if (other != vertex)
+                    {
+                        outNeighbors.push_back(other);
+                    }
+                }
+            }
+
+            std::sort(outNeighbors.begin(), outNeighbors.end());
+            outNeighbors.erase(
+                std::unique(outNeighbors.begin(), outNeighbors.end()),
+                outNeighbors.end());
+        }
+
+        /* Queue the cheapest placement for collapsing an edge. */
+        void PushEdge(std::uint32_t keep, std::uint32_t remove)
+        {
+            Quadric quadric = quadrics[keep];
+            quadric.Add(quadrics[remove]);
+
+            const Vec3& a = positions[keep];
+            const Vec3& b = positions[remove];
+            const Vec3 midpoint = (a + b) * 0.5f;
+
+            Collapse collapse{};
+            collapse.Keep = keep;
+            collapse.Remove = remove;
+            collapse.KeepVersion = versions[keep];
+            collapse.RemoveVersion = versions[remove];
+            collapse.Target = midpoint;
+            collapse.Cost = quadric.Evaluate(midpoint);
+
+            const Vec3 endpoints[2] = { a, b };
+            for (const Vec3& endpoint : endpoints)
+            {
+                const double cost = quadric.Evaluate(endpoint);
+                if (cost < collapse.Cost)
+                {
+                    collapse.Cost = cost;
+                    collapse.Target = endpoint;
+                }
+            }
+
+            /* Trust the optimum only when it stays near the edge. */
+            Vec3 optimal;
+            if (quadric.SolveOptimal(optimal) &&
+                (optimal - midpoint).Length() <= (b - a).Length() * 2.0f)
+            {
+                const double cost = quadric.Evaluate(optimal);
+                if (cost < collapse.Cost)
+                {
+                    collapse.Cost = cost;
+                    collapse.Target = optimal;
+                }
+            }
+
+            collapse.Cost = collapse.Cost > 0.0 ? collapse.Cost : 0.0;
+            heap.push(collapse);
+        }
+
+        /* Reject collapses that flip faces or break the local manifold. */
+        bool IsCollapseValid(const Collapse& collapse)
+        {
+            const std::uint32_t ends[2] = { collapse.Keep, collapse.Remove };
+            for (std::uint32_t side = 0; side < 2; ++side)
+            {
+                const std::uint32_t moved = ends[side];
+                const std::uint32_t other = ends[1 - side];
+
+                for (std::uint32_t triangle : vertexTriangles[moved])
+                {
+                    /* Triangles on the edge itself disappear. */
+                    if (!triangleAlive[triangle] || TriangleHas(triangle, other))
+                    {
+                        continue;
+                    }
+
+                    Vec3 before[3];
+                    Vec3 after[3];
+                    for (std::uint32_t corner = 0; corner < 3; ++corner)
+                    {
+                        const std::uint32_t vertex = triangles[triangle * 3 + corner];
+                        before[corner] = positions[vertex];
+                        after[corner] = vertex == moved ? collapse.Target : positions[vertex];
+                    }
+
+                    const Vec3 oldNormal = Vec3::Cross(before[1] - before[0], before[2] - before[0]);
+                    const Vec3 newNormal = Vec3::Cross(after[1] - after[0], after[2] - after[0]);
+                    const double oldLength = oldNormal.Length();
+                    const double newLength = newNormal.Length();
+
+                    /* Slivers in the source place no constraint. */
+                    if (oldLength <= 0.0)
+                    {
+                        continue;
+                    }
+
+                    if (Dot(oldNormal, newNormal) <= kMinNormalDot * oldLength * newLength)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            /* Link condition, the edge's own triangles are the only shared fans. */
+            std::uint32_t sharedTriangles = 0;
+            for (std::uint32_t triangle : vertexTriangles[collapse.Keep])
+            {
+                if (triangleAlive[triangle] && TriangleHas(triangle, collapse.Remove))
+                {
+                    ++sharedTriangles;
+                }
+            }
+
+            if (sharedTriangles == 0)
+            {
+                return false;
+            }
+
+            GatherNeighbors(collapse.Keep, keepNeighbors);
+            GatherNeighbors(collapse.Remove, removeNeighbors);
+
+            std::uint32_t sharedNeighbors = 0;
+            std::size_t left = 0;
+            std::size_t right = 0;
+            while (left < keepNeighbors.size() && right < removeNeighbors.size())
+            {
+                if (keepNeighbors[left] < removeNeighbors[right])
+                {
+                    ++left;
+                }
+                else if (removeNeighbors[right] < keepNeighbors[left])
+                {
+                    ++right;
+                }
+                else
+                {
+                    ++sharedNeighbors;
+                    ++left;
+                    ++right;
+                }
+            }
+
+            return sharedNeighbors == sharedTriangles;
+        }
+
+        /* Merge Remove into Keep and requeue the edges around Keep. */
+        void ApplyCollapse(const Collapse& collapse)
+        {
+            const std::uint32_t keep = collapse.Keep;
+            const std::uint32_t remove = collapse.Remove;
+
+            positions[keep] = collapse.Target;
+            quadrics[keep].Add(quadrics[remove]);
+
+            for (std::uint32_t triangle : vertexTriangles[remove])
+            {
+                if (!triangleAlive[triangle])
+                {
+                    continue;
+                }
+
+                if (TriangleHas(triangle, keep))
+                {
+                    triangleAlive[triangle] = 0;
+                    --liveTriangles;
+                    continue;
+                }
+
+                std::uint32_t* corners = &triangles[triangle * 3];
+                for (std::uint32_t corner = 0; corner < 3; ++corner)
+                {
+                    if (corners[corner] == remove)
+                    {
+                        corners[corner] = keep;
+                    }
+                }
+                vertexTriangles[keep].push_back(triangle);
+            }
+
+            vertexTriangles[remove].clear();
+            removed[remove] = 1;
+            ++versions[keep];
+
+            std::vector<std::uint32_t>& keepTriangles = vertexTriangles[keep];
+            keepTriangles.erase(
+                std::remove_if(
+                    keepTriangles.begin(),
+                    keepTriangles.end(),
+                    [this](std::uint32_t triangle) { return !triangleAlive[triangle]; }),
+                keepTriangles.end());
+
+            GatherNeighbors(keep, keepNeighbors);
+            for (std::uint32_t neighbor : keepNeighbors)
+            {
+                PushEdge(keep, neighbor);
+            }
+        }
+    };
+}
+
+bool SimplifyMesh(
+    const std::vector<Vec3>& positions,
+    const std::vector<std::uint32_t>& indices,
+    std::uint32_t targetTriangleCount,
+    std::vector<Vec3>& outPositions,
+    std::vector<std::uint32_t>& outIndices,
+    MeshSimplifyStats* outStats)
+{
+    outPositions.clear();
+    outIndices.clear();
+
+    const std::size_t vertexCount = positions.size();
+    SimplifyContext context;
+
+    /* Weld identical positions so seams collapse as one surface. */
+    std::vector<std::uint32_t> canonical(vertexCount);
+    {
+        std::unordered_map<PositionKey, std::uint32_t, PositionKeyHash> firstByPosition;
+        firstByPosition.reserve(vertexCount);
+        for (std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            PositionKey key;
+            std::memcpy(key.Bits, &positions[vertex].x, sizeof(float));
+            std::memcpy(key.Bits + 1, &positions[vertex].y, sizeof(float));
+            std::memcpy(key.Bits + 2, &positions[vertex].z, sizeof(float));
+            canonical[vertex] = firstByPosition.emplace(
+                key,
+                static_cast<std::uint32_t>(vertex)).first->second;
+        }
+    }
+
+    /* Keep valid, non-degenerate triangles over welded corners. */
+    context.triangles.reserve(indices.size());
+    for (std::size_t base = 0; base + 2 < indices.size(); base += 3)
+    {
+        if (indices[base + 0] >= vertexCount ||
+            indices[base + 1] >= vertexCount ||
+            indices[base + 2] >= vertexCount)
+        {
+            continue;
+        }
+
+        const std::uint32_t a = canonical[indices[base + 0]];
+        const std::uint32_t b = canonical[indices[base + 1]];
+        const std::uint32_t c = canonical[indices[base + 2]];
+        if (a == b || b == c || a == c)
+        {
+            continue;
+        }
+
+        context.triangles.push_back(a);
+        context.triangles.push_back(b);
+        context.triangles.push_back(c);
+    }
+
+    const std::uint32_t triangleCount = static_cast<std::uint32_t>(context.triangles.size() / 3);
+    if (triangleCount == 0)
+    {
+        return false;
+    }
+
+    context.positions = positions;
+    context.quadrics.resize(vertexCount);
+    context.versions.assign(vertexCount, 0);
+    context.removed.assign(vertexCount, 0);
+    context.triangleAlive.assign(triangleCount, 1);
+    context.vertexTriangles.resize(vertexCount);
+    context.liveTriangles = triangleCount;
+
+    /* Area-weighted face planes, plus edge use counts for boundaries. */
+    std::unordered_map<std::uint64_t, std::uint32_t> edgeUses;
+    edgeUses.reserve(static_cast<std::size_t>(triangleCount) * 2);
+    std::vector<Vec3> faceNormals(triangleCount);
+
+    for (std::uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        const std::uint32_t* corners = &context.triangles[triangle * 3];
+        const Vec3& a = positions[corners[0]];
+        const Vec3& b = positions[corners[1]];
+        const Vec3& c = positions[corners[2]];
+
+        const Vec3 normal = Vec3::Cross(b - a, c - a);
+        const float length = normal.Length();
+        faceNormals[triangle] = normal.Normalized();
+
+        if (length > 0.0f)
+        {
+            const Vec3& unit = faceNormals[triangle];
+            const double d = -Dot(unit, a);
+            for (std::uint32_t corner = 0; corner < 3; ++corner)
+            {
+                context.quadrics[corners[corner]].AddPlane(unit.x, unit.y, unit.z, d, length * 0.5);
+            }
+        }
+
+        for (std::uint32_t corner = 0; corner < 3; ++corner)
+        {
+            context.vertexTriangles[corners[corner]].push_back(triangle);
+            ++edgeUses[EdgeKey(corners[corner], corners[(corner + 1) % 3])];
+        }
+    }
+
+    /* Pin open edges with perpendicular planes so silhouettes hold. */
+    for (std::uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        const std::uint32_t* corners = &context.triangles[triangle * 3];
+        for (std::uint32_t corner = 0; corner < 3; ++corner)
+        {
+            const std::uint32_t from = corners[corner];
+            const std::uint32_t to = corners[(corner + 1) % 3];
+            if (edgeUses[EdgeKey(from, to)] != 1)
+            {
+                continue;
+            }
+
+            const Vec3 edge = positions[to] - positions[from];
+            const Vec3 plane = Vec3::Cross(edge, faceNormals[triangle]).Normalized();
+            const double d = -Dot(plane, positions[from]);
+            const double weight = kBoundaryWeight * Dot(edge, edge);
+            context.quadrics[from].AddPlane(plane.x, plane.y, plane.z, d, weight);
+            context.quadrics[to].AddPlane(plane.x, plane.y, plane.z, d, weight);
+        }
+    }
+
+    /* Seed every edge once, in a stable order. */
+    std::vector<std::uint64_t> edges;
+    edges.reserve(edgeUses.size());
+    for (const auto& entry : edgeUses)
+    {
+        edges.push_back(entry.first);
+    }
+    std::sort(edges.begin(), edges.end());
+
+    for (std::uint64_t edge : edges)
+    {
+        context.PushEdge(
+            static_cast<std::uint32_t>(edge >> 32),
+            static_cast<std::uint32_t>(edge & 0xFFFFFFFFull));
+    }
+
+    /* Collapse cheapest edges until the budget is met or nothing is legal. */
+    double maxError = 0.0;
+    while (context.liveTriangles > targetTriangleCount && !context.heap.empty())
+    {
+        const Collapse collapse = context.heap.top();
+        context.heap.pop();
+
+        if (context.removed[collapse.Keep] || context.removed[collapse.Remove] ||
+            context.versions[collapse.Keep] != collapse.KeepVersion ||
+            context.versions[collapse.Remove] != collapse.RemoveVersion)
+        {
+            continue;
+        }
+
+        if (!context.IsCollapseValid(collapse))
+        {
+            continue;
+        }
+
+        context.ApplyCollapse(collapse);
+        maxError = collapse.Cost > maxError ? collapse.Cost : maxError;
+    }
+
+    /* Compact surviving vertices in first-use order. */
+    std::vector<std::uint32_t> remap(vertexCount, 0xFFFFFFFFu);
+    outIndices.reserve(static_cast<std::size_t>(context.liveTriangles) * 3);
+    for (std::uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        if (!context.triangleAlive[triangle])
+        {
+            continue;
+        }
+
+        for (std::uint32_t corner = 0; corner < 3; ++corner)
+        {
+            const std::uint32_t vertex = context.triangles[triangle * 3 + corner];
+            if (remap[vertex] == 0xFFFFFFFFu)
+            {
+                remap[vertex] = static_cast<std::uint32_t>(outPositions.size());
+                outPositions.push_back(context.positions[vertex]);
+            }
+            outIndices.push_back(remap[vertex]);
+        }
+    }
+
+    if (outStats)
+    {
+        outStats->SourceTriangles = triangleCount;
+        outStats->ResultTriangles = context.liveTriangles;
+        outStats->MaxError = static_cast<float>(maxError);
+    }
+
+    return true;
+}
@@ -0,0 +1,55 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "../Math/MathTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+/* Outcome of one simplification run. */
+struct MeshSimplifyStats
+{
+    std::uint32_t SourceTriangles = 0;
+    std::uint32_t ResultTriangles = 0;
+
+    /* Largest quadric error accepted by a collapse. */
+    float MaxError = 0.0f;
+};
+
+/* Quadric error metric edge-collapse simplification (Garland-Heckbert). */
+/* Vertices at identical positions are welded first, boundaries are */
+/* held with penalty planes, and collapses that flip faces or pinch the */
+/* surface into non-manifold fans are rejected. */
+/* Returns false when the input has no valid triangles. */
+bool SimplifyMesh(
+    const std::vector<Vec3>& positions,
+    const std::vector<std::uint32_t>& indices,
+    std::uint32_t targetTriangleCount,
+    std::vector<Vec3>& outPositions,
+    std::vector<std::uint32_t>& outIndices,
+    MeshSimplifyStats* outStats = nullptr);
@@ -0,0 +1,681 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "PngReader.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+/* Local helpers. */
+namespace
+{
+    /* PNG file signature. */
+    constexpr std::uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    /* Largest accepted width or height, keeps the pixel buffer sane. */
+    constexpr std::uint32_t kMaxDimension = 16384;
+
+    /* Deflate code lengths never exceed 15 bits. */
+    constexpr std::uint32_t kMaxCodeBits = 15;
+
+    /* Base lengths and extra bits of length symbols 257..285. */
+    constexpr std::uint16_t kLengthBase[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    constexpr std::uint8_t kLengthExtra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+    /* Base distances and extra bits of distance symbols 0..29. */
+    constexpr std::uint16_t kDistanceBase[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+        8193, 12289, 16385, 24577 };
+    constexpr std::uint8_t kDistanceExtra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    /* Order in which code length code lengths are stored. */
+    constexpr std::uint8_t kCodeLengthOrder[19] = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    /* Read a 32-bit big-endian value. */
+    std::uint32_t ReadBigEndian(const std::uint8_t* data)
+    {
+        return (static_cast<std::uint32_t>(data[0]) << 24) |
+            (static_cast<std::uint32_t>(data[1]) << 16) |
+            (static_cast<std::uint32_t>(data[2]) << 8) |
+            static_cast<std::uint32_t>(data[3]);
+    }
+
+    /* LSB-first bit reader over a deflate stream. */
+    struct BitReader
+    {
+        const std::uint8_t* Data = nullptr;
+        std::size_t Size = 0;
+        std::size_t BytePos = 0;
+        std::uint32_t BitBuffer = 0;
+        std::uint32_t BitCount = 0;
+        bool Overrun = false;
+
+        /* Next count bits (count <= 16), zero past the end with Overrun set. */
+        std::uint32_t Read(std::uint32_t count)
+        {
+            while (BitCount < count)
+            {
+                if (BytePos < Size)
+                {
+                    BitBuffer |= static_cast<std::uint32_t>(Data[BytePos++]) << BitCount;
+                }
+                else
+                {
+                    Overrun = true;
+                }
+                BitCount += 8;
+            }
+
+            const std::uint32_t value = BitBuffer & ((1u << count) - 1u);
+            BitBuffer >>= count;
+            BitCount -= count;
+            return value;
+        }
+
+        /* Drop the bits left in the current byte. */
+        void AlignToByte()
+        {
+            BitBuffer = 0;
+            BitCount = 0;
+        }
+    };
+
+    /* Canonical Huffman decoding table: symbol counts per length and */
+    /* symbols sorted by code. */
+    struct Huffman
+    {
+        std::uint16_t Counts[kMaxCodeBits + 1] = {};
+        std::uint16_t Symbols[288] = {};
+
+        /* Build from code lengths; false when the lengths oversubscribe. */
+        bool Build(const std::uint8_t* lengths, std::uint32_t count)
+        {
+            std::memset(Counts, 0, sizeof(Counts));
+            for (std::uint32_t symbol = 0; symbol < count; ++symbol)
+            {
+                ++Counts[lengths[symbol]];
+            }
+            Counts[0] = 0;
+
+            std::int32_t left = 1;
+            for (std::uint32_t bits = 1; bits <= kMaxCodeBits; ++bits)
+            {
+                left = (left << 1) - Counts[bits];
+                if (left < 0)
+                {
+                    return false;
+                }
+            }
+
+            std::uint16_t offsets[kMaxCodeBits + 1] = {};
+            for (std::uint32_t bits = 1; bits < kMaxCodeBits; ++bits)
+            {
+                offsets[bits + 1] = static_cast<std::uint16_t>(offsets[bits] + Counts[bits]);
+            }
+
+            for (std::uint32_t symbol = 0; symbol < count; ++symbol)
+            {
+                if (lengths[symbol] != 0)
+                {
+                    Symbols[offsets[lengths[symbol]]++] = static_cast<std::uint16_t>(symbol);
+                }
+            }
+
+            return true;
+        }
+
+        /* Decode one symbol, or -1 on an invalid code. */
+        std::int32_t Decode(BitReader& reader) const
+        {
+            std::int32_t code = 0;
+            std::int32_t first = 0;
+            std::int32_t index = 0;
+            for (std::uint32_t bits = 1; bits <= kMaxCodeBits; ++bits)
+            {
+                code |= static_cast<std::int32_t>(reader.Read(1));
+                const std::int32_t count = Counts[bits];
+                if (code - first < count)
+                {
+                    return Symbols[index + code - first];
+                }
+
+                index += count;
+                first = (first + count) << 1;
+                code <<= 1;
+            }
+
+            return -1;
+        }
+    };
+
+    /* Decode one Huffman-coded block into out. */
+    bool InflateCodes(
+        BitReader& reader,
+        const Huffman& lengthCodes,
+        const Huffman& distanceCodes,
+        std::vector<std::uint8_t>& out)
+    {
+        for (;;)
+        {
+            const std::int32_t symbol = lengthCodes.Decode(reader);
+            if (symbol < 0 || reader.Overrun)
+            {
+                return false;
+            }
+
+            if (symbol < 256)
+            {
+                out.push_back(static_cast<std::uint8_t>(symbol));
+                continue;
+            }
+
+            if (symbol == 256)
+            {
+                return true;
+            }
+
+            const std::int32_t lengthIndex = symbol - 257;
+            if (lengthIndex >= 29)
+            {
+                return false;
+            }
+
+            const std::size_t length =
+                kLengthBase[lengthIndex] + reader.Read(kLengthExtra[lengthIndex]);
+
+            const std::int32_t distanceSymbol = distanceCodes.Decode(reader);
+            if (distanceSymbol < 0 || distanceSymbol >= 30)
+            {
+                return false;
+            }
+
+            const std::size_t distance =
+                kDistanceBase[distanceSymbol] + reader.Read(kDistanceExtra[distanceSymbol]);
+            if (distance > out.size() || reader.Overrun)
+            {
+                return false;
+            }
+
+            /* Byte by byte: the copy may overlap the bytes it produces. */
+            const std::size_t start = out.size() - distance;
+            for (std::size_t offset = 0; offset < length; ++offset)
+            {
+                out.push_back(out[start + offset]);
+            }
+        }
+    }
+
+    /* Read the code lengths of a dynamic block and build its tables. */
+    bool ReadDynamicTables(BitReader& reader, Huffman& lengthCodes, Huffman& distanceCodes)
+    {
+        const std::uint32_t lengthCount = reader.Read(5) + 257;
+        const std::uint32_t distanceCount = reader.Read(5) + 1;
+        const std::uint32_t codeLengthCount = reader.Read(4) + 4;
+        if (lengthCount > 286 || distanceCount > 30)
+        {
+            return false;
+        }
+
+        std::uint8_t codeLengths[19] = {};
+        for (std::uint32_t index = 0; index < codeLengthCount; ++index)
+        {
+            codeLengths[kCodeLengthOrder[index]] = static_cast<std::uint8_t>(reader.Read(3));
+        }
+
+        Huffman codeLengthCodes;
+        if (!codeLengthCodes.Build(codeLengths, 19))
+        {
+            return false;
+        }
+
+        /* Literal/length and distance lengths form one run-length coded list. */
+        std::uint8_t lengths[286 + 30] = {};
+        std::uint32_t index = 0;
+        while (index < lengthCount + distanceCount)
+        {
+            const std::int32_t symbol = codeLengthCodes.Decode(reader);
+            if (symbol < 0 || reader.Overrun)
+            {
+                return false;
+            }
+
+            if (symbol < 16)
+            {
+                lengths[index++] = static_cast<std::uint8_t>(symbol);
+                continue;
+            }
+
+            std::uint8_t value = 0;
+            std::uint32_t repeat = 0;
+            if (symbol == 16)
+            {
+                if (index == 0)
+                {
+                    return false;
+                }
+                value = lengths[index - 1];
+                repeat = 3 + reader.Read(2);
+            }
+            else if (symbol == 17)
+            {
+                repeat = 3 + reader.Read(3);
+            }
+            else
+            {
+                repeat = 11 + reader.Read(7);
+            }
+
+            if (index + repeat > lengthCount + distanceCount)
+            {
+                return false;
+            }
+
+            while (repeat-- > 0)
+            {
+                lengths[index++] = value;
+            }
+        }
+
+        /* A block without an end-of-block code cannot terminate. */
+        if (lengths[256] == 0)
+        {
+            return false;
+        }
+
+        return lengthCodes.Build(lengths, lengthCount) &&
+            distanceCodes.Build(lengths + lengthCount, distanceCount);
+    }
+
+    /* Inflate a zlib stream (header, deflate blocks, ignored checksum). */
+    bool Inflate(const std::vector<std::uint8_t>& input, std::vector<std::uint8_t>& out)
+    {
+        if (input.size() < 2 ||
+            (input[0] & 0x0F) != 8 ||
+            ((static_cast<std::uint32_t>(input[0]) << 8) | input[1]) % 31 != 0 ||
+            (input[1] & 0x20) != 0)
+        {
+            return false;
+        }
+
+        BitReader reader;
+        reader.Data = input.data() + 2;
+        reader.Size = input.size() - 2;
+
+        bool lastBlock = false;
+        while (!lastBlock)
+        {
+            lastBlock = reader.Read(1) != 0;
+            const std::uint32_t type = reader.Read(2);
+
+            if (type == 0)
+            {
+                reader.AlignToByte();
+                if (reader.BytePos + 4 > reader.Size)
+                {
+                    return false;
+                }
+
+                const std::uint8_t* header = reader.Data + reader.BytePos;
+                const std::uint32_t length = header[0] | (header[1] << 8);
+                const std::uint32_t complement = header[2] | (header[3] << 8);
+                reader.BytePos += 4;
+                if ((length ^ 0xFFFFu) != complement || reader.BytePos + length > reader.Size)
+                {
+                    return false;
+                }
+
+                out.insert(out.end(), header + 4, header + 4 + length);
+                reader.BytePos += length;
+            }
+            else if (type == 1)
+            {
+                static const std::pair<Huffman, Huffman> fixedCodes = []()
+                {
+                    std::uint8_t lengths[288 + 30] = {};
+                    std::memset(lengths, 8, 144);
+                    std::memset(lengths + 144, 9, 112);
+                    std::memset(lengths + 256, 7, 24);
+                    std::memset(lengths + 280, 8, 8);
+                    std::memset(lengths + 288, 5, 30);
+
+                    std::pair<Huffman, Huffman> codes;
+                    codes.first.Build(lengths, 288);
+                    codes.second.Build(lengths + 288, 30);
+                    return codes;
+                }();
+
+                if (!InflateCodes(reader, fixedCodes.first, fixedCodes.second, out))
+                {
+                    return false;
+                }
+            }
+            else if (type == 2)
+            {
+                Huffman lengthCodes;
+                Huffman distanceCodes;
+                if (!ReadDynamicTables(reader, lengthCodes, distanceCodes) ||
+                    !InflateCodes(reader, lengthCodes, distanceCodes, out))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+
+            if (reader.Overrun)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /* Paeth predictor from the PNG specification. */
+    std::uint8_t Paeth(std::int32_t left, std::int32_t up, std::int32_t upLeft)
+    {
+        const std::int32_t estimate = left + up - upLeft;
+        const std::int32_t distanceLeft = estimate > left ? estimate - left : left - estimate;
+        const std::int32_t distanceUp = estimate > up ? estimate - up : up - estimate;
+        const std::int32_t distanceUpLeft =
+            estimate > upLeft ? estimate - upLeft : upLeft - estimate;
+
+        if (distanceLeft <= distanceUp && distanceLeft <= distanceUpLeft)
+        {
+            return static_cast<std::uint8_t>(left);
+        }
+
+        return static_cast<std::uint8_t>(distanceUp <= distanceUpLeft ? up : upLeft);
+    }
+
+    /* Undo the per-scanline filters into rows packed without filter bytes. */
+    bool Unfilter(
+        const std::vector<std::uint8_t>& filtered,
+        std::uint32_t height,
+        std::size_t rowBytes,
+        std::size_t pixelBytes,
+        std::vector<std::uint8_t>& outRows)
+    {
+        if (filtered.size() < (rowBytes + 1) * height)
+        {
+            return false;
+        }
+
+        outRows.assign(rowBytes * height, 0);
+        for (std::uint32_t row = 0; row < height; ++row)
+        {
+            const std::uint8_t filter = filtered[row * (rowBytes + 1)];
+            const std::uint8_t* source = filtered.data() + row * (rowBytes + 1) + 1;
+            std::uint8_t* target = outRows.data() + row * rowBytes;
+            const std::uint8_t* previous = row > 0 ? target - rowBytes : nullptr;
+
+            for (std::size_t index = 0; index < rowBytes; ++index)
+            {
+                const std::int32_t left = index >= pixelBytes ? target[index - pixelBytes] : 0;
+                const std::int32_t up = previous ? previous[index] : 0;
+                const std::int32_t upLeft =
+                    previous && index >= pixelBytes ? previous[index - pixelBytes] : 0;
+
+                std::int32_t predictor = 0;
+                switch (filter)
+                {
+                case 0:
+                    break;
+                case 1:
+                    predictor = left;
+                    break;
+                case 2:
+                    predictor = up;
+                    break;
+                case 3:
+                    predictor = (left + up) >> 1;
+                    break;
+                case 4:
+                    predictor = Paeth(left, up, upLeft);
+                    break;
+                default:
+                    return false;
+                }
+
+                target[index] = static_cast<std::uint8_t>(source[index] + predictor);
+            }
+        }
+
+        return true;
+    }
+}
+
+/* Decode a PNG byte stream into RGBA8 pixels. */
+bool DecodePng(
+    const std::vector<std::uint8_t>& bytes,
+    std::uint32_t& outWidth,
+    std::uint32_t& outHeight,
+    std::vector<std::uint8_t>& outPixels)
+{
+    outWidth = 0;
+    outHeight = 0;
+    outPixels.clear();
+
+    if (bytes.size() < sizeof(kSignature) ||
+        std::memcmp(bytes.data(), kSignature, sizeof(kSignature)) != 0)
+    {
+        std::fprintf(stderr, "DecodePng: Missing PNG signature\n");
+        return false;
+    }
+
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint8_t colorType = 0;
+    bool sawHeader = false;
+    bool sawEnd = false;
+    std::vector<std::uint8_t> palette;
+    std::vector<std::uint8_t> paletteAlpha;
+    std::vector<std::uint8_t> compressed;
+
+    /* Walk the chunks: length, type, data, CRC. */
+    std::size_t offset = sizeof(kSignature);
+    while (!sawEnd)
+    {
+        if (offset + 12 > bytes.size())
+        {
+            std::fprintf(stderr, "DecodePng: Truncated chunk\n");
+            return false;
+        }
+
+        const std::uint32_t length = ReadBigEndian(bytes.data() + offset);
+        const std::uint8_t* type = bytes.data() + offset + 4;
+        const std::uint8_t* data = type + 4;
+        if (length > bytes.size() - offset - 12)
+        {
+            std::fprintf(stderr, "DecodePng: Truncated chunk\n");
+            return false;
+        }
+
+        if (std::memcmp(type, "IHDR", 4) == 0)
+        {
+            if (length != 13)
+            {
+                std::fprintf(stderr, "DecodePng: Invalid header\n");
+                return false;
+            }
+
+            width = ReadBigEndian(data);
+            height = ReadBigEndian(data + 4);
+            colorType = data[9];
+
+            /* Bit depth 8, deflate, adaptive filtering, no interlace. */
+            const bool knownColor = colorType == 0 || colorType == 2 ||
+                colorType == 3 || colorType == 4 || colorType == 6;
+            if (width == 0 || height == 0 ||
+                width > kMaxDimension || height > kMaxDimension ||
+                data[8] != 8 || !knownColor ||
+                data[10] != 0 || data[11] != 0 || data[12] != 0)
+            {
+                std::fprintf(stderr, "DecodePng: Unsupported PNG format\n");
+                return false;
+            }
+
+            sawHeader = true;
+        }
+        else if (std::memcmp(type, "PLTE", 4) == 0)
+        {
+            palette.assign(data, data + length);
+        }
+        else if (std::memcmp(type, "tRNS", 4) == 0)
+        {
+            paletteAlpha.assign(data, data + length);
+        }
+        else if (std::memcmp(type, "IDAT", 4) == 0)
+        {
+            compressed.insert(compressed.end(), data, data + length);
+        }
+        else if (std::memcmp(type, "IEND", 4) == 0)
+        {
+            sawEnd = true;
+        }
+
+        offset += 12 + static_cast<std::size_t>(length);
+    }
+
+    if (!sawHeader || compressed.empty())
+    {
+        std::fprintf(stderr, "DecodePng: Missing header or image data\n");
+        return false;
+    }
+
+    if (colorType == 3 && (palette.empty() || palette.size() % 3 != 0))
+    {
+        std::fprintf(stderr, "DecodePng: Missing palette\n");
+        return false;
+    }
+
+    std::vector<std::uint8_t> filtered;
+    if (!Inflate(compressed, filtered))
+    {
+        std::fprintf(stderr, "DecodePng: Corrupt image data\n");
+        return false;
+    }
+
+    /* Channels per color type 0..6; 1 and 5 are never valid. */
+    constexpr std::uint8_t kChannels[7] = { 1, 0, 3, 1, 2, 0, 4 };
+    const std::size_t pixelBytes = kChannels[colorType];
+    const std::size_t rowBytes = static_cast<std::size_t>(width) * pixelBytes;
+
+    std::vector<std::uint8_t> rows;
+    if (!Unfilter(filtered, height, rowBytes, pixelBytes, rows))
+    {
+        std::fprintf(stderr, "DecodePng: Corrupt scanlines\n");
+        return false;
+    }
+
+    /* Expand to RGBA. */
+    const std::size_t pixelCount = static_cast<std::size_t>(width) * height;
+    outPixels.resize(pixelCount * 4);
+    const std::size_t paletteSize = palette.size() / 3;
+    for (std::size_t pixel = 0; pixel < pixelCount; ++pixel)
+    {
+        const std::uint8_t* source = rows.data() + pixel * pixelBytes;
+        std::uint8_t* target = outPixels.data() + pixel * 4;
+
+        switch (colorType)
+        {
+        case 0:
+            target[0] = target[1] = target[2] = source[0];
+            target[3] = 255;
+            break;
+        case 2:
+            target[0] = source[0];
+            target[1] = source[1];
+            target[2] = source[2];
+            target[3] = 255;
+            break;
+        case 3:
+        {
+            const std::size_t entry = source[0];
+            if (entry >= paletteSize)
+            {
+                std::fprintf(stderr, "DecodePng: Palette index out of range\n");
+                outPixels.clear();
+                return false;
+            }
+            target[0] = palette[entry * 3];
+            target[1] = palette[entry * 3 + 1];
+            target[2] = palette[entry * 3 + 2];
+            target[3] = entry < paletteAlpha.size() ? paletteAlpha[entry] : 255;
+            break;
+        }
+        case 4:
+            target[0] = target[1] = target[2] = source[0];
+            target[3] = source[1];
+            break;
+        default:
+            std::memcpy(target, source, 4);
+            break;
+        }
+    }
+
+    outWidth = width;
+    outHeight = height;
+    return true;
+}
+
+/* Read and decode a PNG file. */
+bool ReadPng(
+    const char* path,
+    std::uint32_t& outWidth,
+    std::uint32_t& outHeight,
+    std::vector<std::uint8_t>& outPixels)
+{
+    outWidth = 0;
+    outHeight = 0;
+    outPixels.clear();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::fprintf(stderr, "ReadPng: Failed to open %s\n", path);
+        return false;
+    }
+
+    const std::vector<std::uint8_t> bytes(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+
+    return DecodePng(bytes, outWidth, outHeight, outPixels);
+}
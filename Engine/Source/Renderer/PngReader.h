@@ -0,0 +1,45 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/* Decode a non-interlaced 8-bit PNG (gray, gray-alpha, RGB, RGBA or */
+/* palette) into RGBA8 pixels, rows top to bottom. Chunk CRCs and the */
+/* zlib checksum are not verified; malformed streams return false. */
+bool DecodePng(
+    const std::vector<std::uint8_t>& bytes,
+    std::uint32_t& outWidth,
+    std::uint32_t& outHeight,
+    std::vector<std::uint8_t>& outPixels);
+
+/* Read a PNG file and decode it as above. */
+bool ReadPng(
+    const char* path,
+    std::uint32_t& outWidth,
+    std::uint32_t& outHeight,
+    std::vector<std::uint8_t>& outPixels);
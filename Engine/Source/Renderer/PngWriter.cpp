@@ -0,0 +1,243 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "PngWriter.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+
+/* Local helpers. */
+namespace
+{
+    /* Bytes per RGBA8 pixel. */
+    constexpr std::uint64_t kBytesPerPixel = 4;
+
+    /* Largest payload of one stored deflate block. */
+    constexpr std::size_t kMaxStoredBlock = 65535;
+
+    /* Adler-32 modulus. */
+    constexpr std::uint32_t kAdlerModulus = 65521;
+
+    /* PNG file signature. */
+    constexpr std::uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    /* Reflected CRC-32 table (polynomial 0xEDB88320) used by PNG chunks. */
+    struct CrcTable
+    {
+        std::uint32_t Entries[256] = {};
+
+        CrcTable()
+        {
+            for (std::uint32_t index = 0; index < 256; ++index)
+            {
+                std::uint32_t value = index;
+                for (std::uint32_t bit = 0; bit < 8; ++bit)
+                {
+                    value = (value & 1u) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                }
+                Entries[index] = value;
+            }
+        }
+    };
+
+    /* CRC-32 of a byte range. */
+    std::uint32_t ComputeCrc(const std::uint8_t* data, std::size_t size)
+    {
+        static const CrcTable table;
+
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            crc = table.Entries[(crc ^ data[index]) & 0xFFu] ^ (crc >> 8);
+        }
+
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    /* Append a 32-bit big-endian value. */
+    void AppendBigEndian(std::vector<std::uint8_t>& out, std::uint32_t value)
+    {
+        out.push_back(static_cast<std::uint8_t>(value >> 24));
+        out.push_back(static_cast<std::uint8_t>(value >> 16));
+        out.push_back(static_cast<std::uint8_t>(value >> 8));
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    /* Append a chunk: length, type, data, then the CRC of type and data. */
+    void AppendChunk(
+        std::vector<std::uint8_t>& out,
+        const char* type,
+        const std::vector<std::uint8_t>& data)
+    {
+        AppendBigEndian(out, static_cast<std::uint32_t>(data.size()));
+
+        const std::size_t typeOffset = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+
+        AppendBigEndian(out, ComputeCrc(out.data() + typeOffset, out.size() - typeOffset));
+    }
+
+    /* Adler-32 of a byte range, the zlib stream checksum. */
+    std::uint32_t ComputeAdler(const std::uint8_t* data, std::size_t size)
+    {
+        /* Largest run whose sums cannot overflow before the modulo. */
+        constexpr std::size_t kAdlerRun = 5552;
+
+        std::uint32_t low = 1;
+        std::uint32_t high = 0;
+        while (size > 0)
+        {
+            const std::size_t run = std::min(size, kAdlerRun);
+            for (std::size_t index = 0; index < run; ++index)
+            {
+                low += data[index];
+                high += low;
+            }
+
+            low %= kAdlerModulus;
+            high %= kAdlerModulus;
+            data += run;
+            size -= run;
+        }
+
+        return (high << 16) | low;
+    }
+
+    /* Zlib stream of unfiltered scanlines in stored deflate blocks. */
+    void BuildImageData(
+        std::uint32_t width,
+        std::uint32_t height,
+        const std::vector<std::uint8_t>& pixels,
+        std::vector<std::uint8_t>& out)
+    {
+        /* Each scanline starts with filter type 0 (none). */
+        const std::size_t rowBytes = static_cast<std::size_t>(width * kBytesPerPixel);
+        std::vector<std::uint8_t> scanlines;
+        scanlines.reserve((rowBytes + 1) * height);
+        for (std::uint32_t row = 0; row < height; ++row)
+        {
+            const std::uint8_t* source = pixels.data() + row * rowBytes;
+            scanlines.push_back(0);
+            scanlines.insert(scanlines.end(), source, source + rowBytes);
+        }
+
+        const std::size_t blockCount = (scanlines.size() + kMaxStoredBlock - 1) / kMaxStoredBlock;
+        out.clear();
+        out.reserve(2 + scanlines.size() + blockCount * 5 + 4);
+
+        /* Deflate with a 32K window, no preset dictionary, fastest level. */
+        out.push_back(0x78);
+        out.push_back(0x01);
+
+        for (std::size_t offset = 0; offset < scanlines.size(); offset += kMaxStoredBlock)
+        {
+            const std::size_t blockSize = std::min(kMaxStoredBlock, scanlines.size() - offset);
+            const bool lastBlock = offset + blockSize == scanlines.size();
+
+            /* Block header, then the length and its complement, little-endian. */
+            out.push_back(lastBlock ? 1 : 0);
+            out.push_back(static_cast<std::uint8_t>(blockSize));
+            out.push_back(static_cast<std::uint8_t>(blockSize >> 8));
+            out.push_back(static_cast<std::uint8_t>(~blockSize));
+            out.push_back(static_cast<std::uint8_t>(~blockSize >> 8));
+            out.insert(
+                out.end(),
+                scanlines.begin() + static_cast<std::ptrdiff_t>(offset),
+                scanlines.begin() + static_cast<std::ptrdiff_t>(offset + blockSize));
+        }
+
+        AppendBigEndian(out, ComputeAdler(scanlines.data(), scanlines.size()));
+    }
+}
+
+/* Encode RGBA8 pixels as a PNG byte stream. */
+bool EncodePng(
+    std::uint32_t width,
+    std::uint32_t height,
+    const std::vector<std::uint8_t>& pixels,
+    std::vector<std::uint8_t>& outBytes)
+{
+    outBytes.clear();
+
+    if (width == 0 || height == 0 ||
+        pixels.size() < static_cast<std::uint64_t>(width) * height * kBytesPerPixel)
+    {
+        std::fprintf(stderr, "EncodePng: Invalid image data\n");
+        return false;
+    }
+
+    /* Width, height, 8 bits per channel, RGBA, deflate, adaptive, no interlace. */
+    std::vector<std::uint8_t> header;
+    AppendBigEndian(header, width);
+    AppendBigEndian(header, height);
+    header.push_back(8);
+    header.push_back(6);
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+
+    std::vector<std::uint8_t> imageData;
+    BuildImageData(width, height, pixels, imageData);
+
+    outBytes.reserve(sizeof(kSignature) + 25 + imageData.size() + 12 + 12);
+    outBytes.insert(outBytes.end(), kSignature, kSignature + sizeof(kSignature));
+    AppendChunk(outBytes, "IHDR", header);
+    AppendChunk(outBytes, "IDAT", imageData);
+    AppendChunk(outBytes, "IEND", std::vector<std::uint8_t>());
+    return true;
+}
+
+/* Encode RGBA8 pixels and write the PNG to disk. */
+bool WritePng(
+    const char* path,
+    std::uint32_t width,
+    std::uint32_t height,
+    const std::vector<std::uint8_t>& pixels)
+{
+    std::vector<std::uint8_t> bytes;
+    if (!EncodePng(width, height, pixels, bytes))
+    {
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::fprintf(stderr, "WritePng: Failed to open %s\n", path);
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file)
+    {
+        std::fprintf(stderr, "WritePng: Failed to write %s\n", path);
+        return false;
+    }
+
+    return true;
+}
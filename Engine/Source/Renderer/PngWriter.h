@@ -0,0 +1,46 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/* Encode RGBA8 pixels, rows top to bottom, as an 8-bit RGBA PNG. */
+/* Scanlines are stored unfiltered in uncompressed deflate blocks, so the */
+/* result is about the size of the raw pixels but needs no image library. */
+/* Returns false when a dimension is zero or the pixels are short. */
+bool EncodePng(
+    std::uint32_t width,
+    std::uint32_t height,
+    const std::vector<std::uint8_t>& pixels,
+    std::vector<std::uint8_t>& outBytes);
+
+/* Encode RGBA8 pixels as above and write them to a file. */
+bool WritePng(
+    const char* path,
+    std::uint32_t width,
+    std::uint32_t height,
+    const std::vector<std::uint8_t>& pixels);
@@ -27,6 +27,9 @@
 
 #include "../Math/MathTypes.h"
 
+#include <cstdint>
+#include <vector>
+
 struct Mesh;
 
 /* Simple material definition. */
@@ -40,17 +43,45 @@ struct Material
 
     /* Base alpha for simple transparency. */
     float Alpha = 1.0f;
+
+    /* Render resource handle, also the sort key id, 0 until registered. */
+    std::uint32_t Handle = 0;
 };
 
-/* Render submission item. */
+/* Render submission item, handles resolve through a RenderResourceTable. */
+/* Kept small so sort, batch and instance passes move compact records. */
 struct RenderItem
 {
-    /* Mesh to render. */
-    Mesh* MeshPtr = nullptr;
+    /* Mesh to render, 0 for none. */
+    std::uint32_t MeshHandle = 0;
+
+    /* Material to apply, 0 for the default material. */
+    std::uint32_t MaterialHandle = 0;
+
+    /* Index of the model matrix in the owning list's transforms. */
+    std::uint32_t TransformIndex = 0;
+};
+
+static_assert(sizeof(RenderItem) <= 16, "RenderItem should stay a compact record");
+
+/* Render submission list: compact items plus the transforms they index. */
+/* Transforms is borrowed from the producer (the scene's packed model cache), */
+/* so matrices are copied once, by the renderer, into the instance buffer. */
+struct RenderList
+{
+    std::vector<RenderItem> Items;
+    const Mat4* Transforms = nullptr;
 
-    /* Material to apply. */
-    Material* MaterialPtr = nullptr;
+    /* Leading items that are opaque and already grouped by material then */
+    /* mesh, coarsely near to far inside each group (retained proxy order); */
+    /* the renderer batches them unsorted. */
+    std::uint32_t SortedCount = 0;
 
-    /* Model transform matrix. */
-    Mat4 Model = Mat4::Identity();
+    /* Drop items and the borrowed transforms, keeping capacity. */
+    void Clear()
+    {
+        Items.clear();
+        Transforms = nullptr;
+        SortedCount = 0;
+    }
 };
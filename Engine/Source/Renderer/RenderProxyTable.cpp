@@ -0,0 +1,249 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "RenderProxyTable.h"
+
+#include <algorithm>
+#include <cstring>
+
+/* Local helpers. */
+namespace
+{
+    /* Float bits below the exponent and its top mantissa bit. */
+    constexpr std::uint32_t kDepthBucketShift = 22;
+}
+
+std::uint16_t RenderProxyTable::ComputeDepthBucket(float DistanceSq)
+{
+    /* Non-negative float bits order like integers. */
+    if (!(DistanceSq > 0.0f))
+    {
+        return 0;
+    }
+
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &DistanceSq, sizeof(bits));
+    return static_cast<std::uint16_t>(bits >> kDepthBucketShift);
+}
+
+void RenderProxyTable::Set(const RenderProxy& Proxy)
+{
+    if (Proxy.EntityId >= SlotByEntity.size())
+    {
+        SlotByEntity.resize(Proxy.EntityId + 1, kInvalidSlot);
+    }
+
+    std::uint32_t slot = SlotByEntity[Proxy.EntityId];
+    if (slot == kInvalidSlot)
+    {
+        if (!FreeSlots.empty())
+        {
+            slot = FreeSlots.back();
+            FreeSlots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<std::uint32_t>(Proxies.size());
+            Proxies.emplace_back();
+            States.push_back(Clean);
+        }
+
+        SlotByEntity[Proxy.EntityId] = slot;
+        ++Count;
+    }
+
+    Proxies[slot] = Proxy;
+
+    /* Queue each slot once; it leaves the order and is merged back in Update. */
+    if (States[slot] == Clean)
+    {
+        ChangedSlots.push_back(slot);
+    }
+
+    States[slot] = Changed;
+}
+
+void RenderProxyTable::SetDepthBucket(std::uint32_t EntityId, std::uint16_t Bucket)
+{
+    if (EntityId >= SlotByEntity.size() || SlotByEntity[EntityId] == kInvalidSlot)
+    {
+        return;
+    }
+
+    const std::uint32_t slot = SlotByEntity[EntityId];
+    if (Proxies[slot].DepthBucket == Bucket)
+    {
+        return;
+    }
+
+    Proxies[slot].DepthBucket = Bucket;
+
+    if (States[slot] == Clean)
+    {
+        ChangedSlots.push_back(slot);
+        States[slot] = Changed;
+    }
+}
+
+void RenderProxyTable::Remove(std::uint32_t EntityId)
+{
+    if (EntityId >= SlotByEntity.size() || SlotByEntity[EntityId] == kInvalidSlot)
+    {
+        return;
+    }
+
+    const std::uint32_t slot = SlotByEntity[EntityId];
+    SlotByEntity[EntityId] = kInvalidSlot;
+    --Count;
+
+    if (States[slot] == Clean)
+    {
+        ChangedSlots.push_back(slot);
+    }
+
+    /* The slot is recycled once Update has dropped it from the orders. */
+    States[slot] = Released;
+}
+
+void RenderProxyTable::Clear()
+{
+    Proxies.clear();
+    States.clear();
+    FreeSlots.clear();
+    SlotByEntity.clear();
+    SortedSlots.clear();
+    UnsortedSlots.clear();
+    ChangedSlots.clear();
+    Count = 0;
+}
+
+void RenderProxyTable::Update()
+{
+    if (ChangedSlots.empty())
+    {
+        return;
+    }
+
+    /* Drop touched slots from both orders in one pass each. */
+    auto isTouched = [this](std::uint32_t slot)
+    {
+        return States[slot] != Clean;
+    };
+
+    SortedSlots.erase(
+        std::remove_if(SortedSlots.begin(), SortedSlots.end(), isTouched),
+        SortedSlots.end());
+    UnsortedSlots.erase(
+        std::remove_if(UnsortedSlots.begin(), UnsortedSlots.end(), isTouched),
+        UnsortedSlots.end());
+
+    /* Reuse the change list for the sorted inserts. */
+    std::size_t insertCount = 0;
+    for (std::uint32_t slot : ChangedSlots)
+    {
+        const std::uint8_t state = States[slot];
+        States[slot] = Clean;
+
+        if (state == Released)
+        {
+            FreeSlots.push_back(slot);
+            continue;
+        }
+
+        if (IsSorted(Proxies[slot]))
+        {
+            ChangedSlots[insertCount++] = slot;
+        }
+        else
+        {
+            UnsortedSlots.push_back(slot);
+        }
+    }
+
+    ChangedSlots.resize(insertCount);
+
+    auto lessThan = [this](std::uint32_t left, std::uint32_t right)
+    {
+        const std::uint64_t leftKey = GetStateKey(left);
+        const std::uint64_t rightKey = GetStateKey(right);
+        if (leftKey != rightKey)
+        {
+            return leftKey < rightKey;
+        }
+
+        const std::uint16_t leftBucket = Proxies[left].DepthBucket;
+        const std::uint16_t rightBucket = Proxies[right].DepthBucket;
+        return leftBucket != rightBucket ? leftBucket < rightBucket : left < right;
+    };
+
+    /* Sort the k inserts and merge: O(n + k log k), nothing when idle. */
+    if (!ChangedSlots.empty())
+    {
+        std::sort(ChangedSlots.begin(), ChangedSlots.end(), lessThan);
+
+        MergeScratch.resize(SortedSlots.size() + ChangedSlots.size());
+        std::merge(
+            SortedSlots.begin(), SortedSlots.end(),
+            ChangedSlots.begin(), ChangedSlots.end(),
+            MergeScratch.begin(),
+            lessThan);
+        SortedSlots.swap(MergeScratch);
+    }
+
+    ChangedSlots.clear();
+}
+
+const std::vector<std::uint32_t>& RenderProxyTable::GetSortedSlots() const
+{
+    return SortedSlots;
+}
+
+const std::vector<std::uint32_t>& RenderProxyTable::GetUnsortedSlots() const
+{
+    return UnsortedSlots;
+}
+
+const RenderProxy& RenderProxyTable::GetProxy(std::uint32_t Slot) const
+{
+    return Proxies[Slot];
+}
+
+std::uint32_t RenderProxyTable::GetCount() const
+{
+    return Count;
+}
+
+std::uint64_t RenderProxyTable::GetStateKey(std::uint32_t Slot) const
+{
+    const RenderProxy& proxy = Proxies[Slot];
+    return (static_cast<std::uint64_t>(proxy.MaterialHandle) << 32) |
+        proxy.MeshHandle;
+}
+
+bool RenderProxyTable::IsSorted(const RenderProxy& Proxy) const
+{
+    return !Proxy.Transparent && Proxy.MeshHandle != 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/* Retained draw state for one renderable entity. */
+struct RenderProxy
+{
+    /* Owning entity id. */
+    std::uint32_t EntityId = 0;
+
+    /* Mesh handle, 0 when the mesh is picked per frame (LOD chains). */
+    std::uint32_t MeshHandle = 0;
+
+    /* Material handle, 0 for the default material. */
+    std::uint32_t MaterialHandle = 0;
+
+    /* Coarse view distance from ComputeDepthBucket, nearer first inside */
+    /* a material and mesh group. */
+    std::uint16_t DepthBucket = 0;
+
+    /* Blended material, sorted by depth every frame. */
+    bool Transparent = false;
+};
+
+/* Persistent render proxies kept in draw order between frames. */
+/* Opaque proxies with a fixed mesh stay sorted by material, mesh, then */
+/* depth bucket; changes are merged in by Update, so a static world costs */
+/* nothing. */
+class RenderProxyTable
+{
+public:
+    /* Bucket of a squared view distance: the float exponent and one */
+    /* mantissa bit, so each bucket spans 15-22% of the distance. */
+    static std::uint16_t ComputeDepthBucket(float DistanceSq);
+
+    /* Add or replace the proxy of an entity. */
+    void Set(const RenderProxy& Proxy);
+
+    /* Move an entity's proxy to another depth bucket, if it has one. */
+    /* Only a changed bucket queues the proxy for the next Update. */
+    void SetDepthBucket(std::uint32_t EntityId, std::uint16_t Bucket);
+
+    /* Drop the proxy of an entity, if any. */
+    void Remove(std::uint32_t EntityId);
+
+    /* Drop every proxy. */
+    void Clear();
+
+    /* Merge proxies changed since the last call into the retained order. */
+    void Update();
+
+    /* Opaque fixed-mesh proxy slots ordered by material, mesh, then bucket. */
+    const std::vector<std::uint32_t>& GetSortedSlots() const;
+
+    /* Remaining proxy slots, ordered per frame by the renderer. */
+    const std::vector<std::uint32_t>& GetUnsortedSlots() const;
+
+    /* Proxy stored in a slot. */
+    const RenderProxy& GetProxy(std::uint32_t Slot) const;
+
+    /* Number of live proxies. */
+    std::uint32_t GetCount() const;
+
+private:
+    /* Invalid index sentinel for slot lookups. */
+    static constexpr std::uint32_t kInvalidSlot = 0xFFFFFFFFu;
+
+    /* Slot state between updates. */
+    enum SlotState : std::uint8_t
+    {
+        Clean = 0,
+        Changed,
+        Released
+    };
+
+    /* Order key, state first; the bucket and then the slot break ties. */
+    std::uint64_t GetStateKey(std::uint32_t Slot) const;
+    bool IsSorted(const RenderProxy& Proxy) const;
+
+    /* Proxy storage, slots are reused after release. */
+    std::vector<RenderProxy> Proxies;
+    std::vector<std::uint8_t> States;
+    std::vector<std::uint32_t> FreeSlots;
+
+    /* Sparse lookup from entity id to slot. */
+    std::vector<std::uint32_t> SlotByEntity;
+
+    /* Retained orders and the slots touched since the last update. */
+    std::vector<std::uint32_t> SortedSlots;
+    std::vector<std::uint32_t> UnsortedSlots;
+    std::vector<std::uint32_t> ChangedSlots;
+    std::vector<std::uint32_t> MergeScratch;
+
+    /* Live proxy count. */
+    std::uint32_t Count = 0;
+};
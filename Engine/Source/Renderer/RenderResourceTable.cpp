@@ -0,0 +1,95 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "RenderResourceTable.h"
+
+#include "RenderItem.h"
+#include "Vulkan/Render/Mesh.h"
+
+RenderResourceTable::RenderResourceTable()
+    : Meshes(1, nullptr)
+    , Materials(1, nullptr)
+{
+}
+
+std::uint32_t RenderResourceTable::RegisterMesh(Mesh* MeshPtr)
+{
+    if (!MeshPtr)
+    {
+        return 0;
+    }
+
+    /* A handle from this table resolves back to the same mesh. */
+    if (MeshPtr->Handle != 0 &&
+        MeshPtr->Handle < Meshes.size() &&
+        Meshes[MeshPtr->Handle] == MeshPtr)
+    {
+        return MeshPtr->Handle;
+    }
+
+    MeshPtr->Handle = static_cast<std::uint32_t>(Meshes.size());
+    Meshes.push_back(MeshPtr);
+    return MeshPtr->Handle;
+}
+
+std::uint32_t RenderResourceTable::RegisterMaterial(Material* MaterialPtr)
+{
+    if (!MaterialPtr)
+    {
+        return 0;
+    }
+
+    if (MaterialPtr->Handle != 0 &&
+        MaterialPtr->Handle < Materials.size() &&
+        Materials[MaterialPtr->Handle] == MaterialPtr)
+    {
+        return MaterialPtr->Handle;
+    }
+
+    MaterialPtr->Handle = static_cast<std::uint32_t>(Materials.size());
+    Materials.push_back(MaterialPtr);
+    return MaterialPtr->Handle;
+}
+
+Mesh* RenderResourceTable::GetMesh(std::uint32_t Handle) const
+{
+    return Handle < Meshes.size() ? Meshes[Handle] : nullptr;
+}
+
+Material* RenderResourceTable::GetMaterial(std::uint32_t Handle) const
+{
+    return Handle < Materials.size() ? Materials[Handle] : nullptr;
+}
+
+std::uint32_t RenderResourceTable::GetMeshCount() const
+{
+    return static_cast<std::uint32_t>(Meshes.size() - 1);
+}
+
+std::uint32_t RenderResourceTable::GetMaterialCount() const
+{
+    return static_cast<std::uint32_t>(Materials.size() - 1);
+}
@@ -0,0 +1,62 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct Mesh;
+struct Material;
+
+/* Maps 32-bit render handles to meshes and materials. */
+/* Handles are assigned on first registration and stored on the resource, */
+/* so they double as compact sort key ids. Handle 0 means none. */
+class RenderResourceTable
+{
+public:
+    /* Reserve the null slot. */
+    RenderResourceTable();
+
+    /* Handle for a mesh, registering it on first use. */
+    std::uint32_t RegisterMesh(Mesh* MeshPtr);
+
+    /* Handle for a material, registering it on first use. */
+    std::uint32_t RegisterMaterial(Material* MaterialPtr);
+
+    /* Resolve handles, null for 0 or unknown handles. */
+    Mesh* GetMesh(std::uint32_t Handle) const;
+    Material* GetMaterial(std::uint32_t Handle) const;
+
+    /* Registered resource counts, excluding the null slot. */
+    std::uint32_t GetMeshCount() const;
+    std::uint32_t GetMaterialCount() const;
+
+private:
+    /* Indexed by handle, slot 0 stays null. */
+    std::vector<Mesh*> Meshes;
+    std::vector<Material*> Materials;
+};
@@ -0,0 +1,227 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "RenderSortKey.h"
+
+#include <cstring>
+#include <utility>
+
+/* Local helpers. */
+namespace
+{
+    /* Digit width and bucket count for the radix passes. */
+    constexpr std::uint32_t kRadixBits = 8;
+    constexpr std::uint32_t kRadixBuckets = 1u << kRadixBits;
+    constexpr std::uint32_t kRadixPasses = 64 / kRadixBits;
+
+    /* Widest depth field, the float bits below the sign. */
+    constexpr std::uint32_t kMaxDepthBits = 31;
+
+    /* Index of a field in the layout arrays. */
+    std::uint32_t FieldIndex(SortKeyField field)
+    {
+        return static_cast<std::uint32_t>(field);
+    }
+
+    /* Mask with the low bit count set. */
+    std::uint64_t LowMask(std::uint32_t bits)
+    {
+        return bits >= 64 ? ~0ull : ((1ull << bits) - 1ull);
+    }
+}
+
+/* State changes first, depth only breaks ties (opaque). */
+RenderSortKeyLayout RenderSortKeyLayout::StateFirst()
+{
+    return RenderSortKeyLayout{};
+}
+
+/* Far to near first, state only breaks ties (blended). */
+RenderSortKeyLayout RenderSortKeyLayout::DepthFirst()
+{
+    RenderSortKeyLayout layout{};
+    layout.Order[0] = SortKeyField::Depth;
+    layout.Order[1] = SortKeyField::Pipeline;
+    layout.Order[2] = SortKeyField::Material;
+    layout.Order[3] = SortKeyField::Mesh;
+    layout.Bits[FieldIndex(SortKeyField::Depth)] = 24;
+    layout.Bits[FieldIndex(SortKeyField::Material)] = 14;
+    layout.Bits[FieldIndex(SortKeyField::Mesh)] = 14;
+    layout.InvertDepth = true;
+    return layout;
+}
+
+/* State only, no depth bits (opaque after a depth pre-pass). */
+RenderSortKeyLayout RenderSortKeyLayout::StateOnly()
+{
+    /* Depth order buys nothing once early-z is exact, widen the ids instead. */
+    RenderSortKeyLayout layout{};
+    layout.Bits[FieldIndex(SortKeyField::Depth)] = 0;
+    layout.Bits[FieldIndex(SortKeyField::Material)] = 24;
+    layout.Bits[FieldIndex(SortKeyField::Mesh)] = 24;
+    return layout;
+}
+
+/* Every field used once and the widths fit below the stage bits. */
+bool RenderSortKeyLayout::IsValid() const
+{
+    bool seen[kFieldCount] = {};
+    std::uint32_t totalBits = 0;
+    for (std::uint32_t slot = 0; slot < kFieldCount; ++slot)
+    {
+        const std::uint32_t field = FieldIndex(Order[slot]);
+        if (field >= kFieldCount || seen[field])
+        {
+            return false;
+        }
+
+        seen[field] = true;
+        totalBits += Bits[field];
+    }
+
+    return Bits[FieldIndex(SortKeyField::Depth)] <= kMaxDepthBits &&
+        totalBits <= 64 - RenderSortKeyEncoder::kStageBits;
+}
+
+/* Default encoder uses the state-first layout. */
+RenderSortKeyEncoder::RenderSortKeyEncoder()
+    : RenderSortKeyEncoder(RenderSortKeyLayout::StateFirst())
+{
+}
+
+/* Precompute field shifts from most to least significant. */
+RenderSortKeyEncoder::RenderSortKeyEncoder(const RenderSortKeyLayout& layout)
+{
+    const RenderSortKeyLayout& source =
+        layout.IsValid() ? layout : RenderSortKeyLayout::StateFirst();
+
+    std::uint32_t shift = 64 - kStageBits;
+    for (std::uint32_t slot = 0; slot < kFieldCount; ++slot)
+    {
+        const std::uint32_t field = FieldIndex(source.Order[slot]);
+        const std::uint32_t bits = source.Bits[field];
+
+        shift -= bits;
+        shifts[field] = static_cast<std::uint8_t>(shift);
+        masks[field] = LowMask(bits);
+    }
+
+    depthBits = source.Bits[FieldIndex(SortKeyField::Depth)];
+    invertDepth = source.InvertDepth;
+}
+
+/* Build a key, ids wrap to their field width. */
+std::uint64_t RenderSortKeyEncoder::Encode(
+    RenderStage stage,
+    std::uint32_t pipelineId,
+    std::uint32_t materialId,
+    std::uint32_t meshId,
+    float depthSq) const
+{
+    /* Non-negative float bits order like integers, keep the top depth bits. */
+    std::uint32_t depthBitsRaw = 0;
+    std::memcpy(&depthBitsRaw, &depthSq, sizeof(depthBitsRaw));
+    std::uint64_t depth = 0;
+    if (depthBits > 0 && depthSq > 0.0f)
+    {
+        depth = (depthBitsRaw & 0x7FFFFFFFu) >> (kMaxDepthBits - depthBits);
+    }
+    if (invertDepth)
+    {
+        depth = masks[FieldIndex(SortKeyField::Depth)] - depth;
+    }
+
+    const std::uint64_t values[kFieldCount] = { pipelineId, materialId, meshId, depth };
+
+    std::uint64_t key = static_cast<std::uint64_t>(stage) << (64 - kStageBits);
+    for (std::uint32_t field = 0; field < kFieldCount; ++field)
+    {
+        key |= (values[field] & masks[field]) << shifts[field];
+    }
+
+    return key;
+}
+
+/* Stable LSD radix sort on Key, 8 bits per pass. */
+void RadixSortRenderEntries(
+    std::vector<RenderSortEntry>& entries,
+    std::vector<RenderSortEntry>& scratch)
+{
+    const std::size_t count = entries.size();
+    if (count < 2)
+    {
+        return;
+    }
+
+    /* Histogram every digit in a single read of the keys. */
+    std::uint32_t histograms[kRadixPasses][kRadixBuckets] = {};
+    for (const RenderSortEntry& entry : entries)
+    {
+        for (std::uint32_t pass = 0; pass < kRadixPasses; ++pass)
+        {
+            ++histograms[pass][(entry.Key >> (pass * kRadixBits)) & (kRadixBuckets - 1)];
+        }
+    }
+
+    scratch.resize(count);
+    RenderSortEntry* source = entries.data();
+    RenderSortEntry* target = scratch.data();
+
+    for (std::uint32_t pass = 0; pass < kRadixPasses; ++pass)
+    {
+        std::uint32_t* histogram = histograms[pass];
+        const std::uint32_t shift = pass * kRadixBits;
+
+        /* A digit shared by every key cannot change the order. */
+        const std::uint32_t firstDigit = static_cast<std::uint32_t>((source[0].Key >> shift) & (kRadixBuckets - 1));
+        if (histogram[firstDigit] == count)
+        {
+            continue;
+        }
+
+        /* Exclusive prefix sum turns counts into write offsets. */
+        std::uint32_t offset = 0;
+        for (std::uint32_t bucket = 0; bucket < kRadixBuckets; ++bucket)
+        {
+            const std::uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            const RenderSortEntry& entry = source[index];
+            target[histogram[(entry.Key >> shift) & (kRadixBuckets - 1)]++] = entry;
+        }
+
+        std::swap(source, target);
+    }
+
+    /* An odd number of passes leaves the result in scratch. */
+    if (source != entries.data())
+    {
+        entries.swap(scratch);
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/* Render stages, the stage always occupies the top bits of a key. */
+enum class RenderStage : std::uint8_t
+{
+    Opaque = 0,
+    Transparent = 1,
+    Count
+};
+
+/* Fields packed below the stage bits of a sort key. */
+enum class SortKeyField : std::uint8_t
+{
+    Pipeline = 0,
+    Material,
+    Mesh,
+    Depth,
+    Count
+};
+
+/* Order and width of the key fields for one stage. */
+struct RenderSortKeyLayout
+{
+    /* Number of configurable fields. */
+    static constexpr std::uint32_t kFieldCount = static_cast<std::uint32_t>(SortKeyField::Count);
+
+    /* Fields from most to least significant. */
+    SortKeyField Order[kFieldCount] = {
+        SortKeyField::Pipeline,
+        SortKeyField::Material,
+        SortKeyField::Mesh,
+        SortKeyField::Depth };
+
+    /* Bit width per field, indexed by SortKeyField. */
+    std::uint8_t Bits[kFieldCount] = { 8, 16, 16, 20 };
+
+    /* Sort depth far to near instead of near to far. */
+    bool InvertDepth = false;
+
+    /* State changes first, depth only breaks ties (opaque). */
+    static RenderSortKeyLayout StateFirst();
+
+    /* Far to near first, state only breaks ties (blended). */
+    static RenderSortKeyLayout DepthFirst();
+
+    /* State only, no depth bits (opaque after a depth pre-pass). */
+    static RenderSortKeyLayout StateOnly();
+
+    /* Every field used once and the widths fit below the stage bits. */
+    bool IsValid() const;
+};
+
+/* Packs per-item values into 64-bit keys for one stage layout. */
+class RenderSortKeyEncoder
+{
+public:
+    /* Bits reserved for the stage at the top of every key. */
+    static constexpr std::uint32_t kStageBits = 4;
+
+    RenderSortKeyEncoder();
+    explicit RenderSortKeyEncoder(const RenderSortKeyLayout& layout);
+
+    /* Build a key, ids wrap to their field width. */
+    /* DepthSq is a non-negative squared view distance. */
+    std::uint64_t Encode(
+        RenderStage stage,
+        std::uint32_t pipelineId,
+        std::uint32_t materialId,
+        std::uint32_t meshId,
+        float depthSq) const;
+
+private:
+    static constexpr std::uint32_t kFieldCount = RenderSortKeyLayout::kFieldCount;
+
+    std::uint8_t shifts[kFieldCount] = {};
+    std::uint64_t masks[kFieldCount] = {};
+    std::uint32_t depthBits = 0;
+    bool invertDepth = false;
+};
+
+/* Sortable key plus the index of the item it was built from. */
+struct RenderSortEntry
+{
+    std::uint64_t Key = 0;
+    std::uint32_t Index = 0;
+};
+
+/* Stable LSD radix sort on Key, 8 bits per pass. */
+/* Passes whose digit is shared by every key are skipped; scratch is reused. */
+void RadixSortRenderEntries(
+    std::vector<RenderSortEntry>& entries,
+    std::vector<RenderSortEntry>& scratch);
@@ -25,6 +25,9 @@
 
 #pragma once
 
+#include "VulkanMemoryAllocator.h"
+#include "VulkanUploadManager.h"
+
 #include <vulkan/vulkan.h>
 #include <cstdint>
 
@@ -39,26 +42,18 @@ public:
     /* Release buffer resources. */
     ~VulkanBuffer();
 
-    /* Create vertex buffer with staging transfer. */
+    /* Create vertex buffer, contents arrive through the upload manager. */
     bool CreateVertexBuffer(
-        VkPhysicalDevice PhysicalDevice,
-        VkDevice Device,
-        VkQueue Queue,
-        uint32_t QueueFamily,
         const void* Data,
         VkDeviceSize Size);
 
-    /* Create index buffer with staging transfer. */
+    /* Create index buffer, contents arrive through the upload manager. */
     bool CreateIndexBuffer(
-        VkPhysicalDevice PhysicalDevice,
-        VkDevice Device,
-        VkQueue Queue,
-        uint32_t QueueFamily,
         const uint32_t* Indices,
         uint32_t IndexCount);
 
     /* Destroy buffer resources. */
-    void Destroy(VkDevice Device);
+    void Destroy();
 
     /* Get buffer handle. */
     VkBuffer GetBuffer() const;
@@ -66,36 +61,17 @@ public:
     /* Get memory handle. */
     VkDeviceMemory GetMemory() const;
 
-    /* Create buffer with memory allocation. */
+    /* Create buffer with memory from the shared allocator. */
     bool CreateBuffer(
-        VkPhysicalDevice PhysicalDevice,
-        VkDevice Device,
         VkDeviceSize Size,
         VkBufferUsageFlags Usage,
         VkMemoryPropertyFlags Properties,
         VkBuffer& OutBuffer,
-        VkDeviceMemory& OutMemory);
-
-private:
-    /* Find suitable memory type for requirements. */
-    uint32_t FindMemoryType(
-        VkPhysicalDevice PhysicalDevice,
-        uint32_t TypeFilter,
-        VkMemoryPropertyFlags Properties);
-
-    /* Copy buffer contents using command buffer. */
-    void CopyBuffer(
-        VkDevice Device,
-        VkQueue Queue,
-        uint32_t QueueFamily,
-        VkBuffer SrcBuffer,
-        VkBuffer DstBuffer,
-        VkDeviceSize Size);
+        VulkanAllocation& OutAllocation);
 
 private:
     VkBuffer Buffer;
-    VkDeviceMemory Memory;
-    VkCommandPool CommandPool;
-    VkDevice DeviceHandle;
+    VulkanAllocation Allocation;
     VkDeviceSize BufferSize;
+    UploadToken UploadTokenValue;
 };
@@ -24,6 +24,9 @@
  */
 
 #include "VulkanDevice.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanUploadManager.h"
 
 #include <cstdio>
 #include <vector>
@@ -32,7 +35,11 @@ VulkanDevice::VulkanDevice()
     : PhysicalDevice(VK_NULL_HANDLE),
     Device(VK_NULL_HANDLE),
     GraphicsQueue(VK_NULL_HANDLE),
-    GraphicsQueueFamily(UINT32_MAX)
+    GraphicsQueueFamily(UINT32_MAX),
+    TransferQueue(VK_NULL_HANDLE),
+    TransferQueueFamily(UINT32_MAX),
+    DrawIndirectCount(false),
+    SwapchainEnabled(false)
 {
     /* Initialize to null state. */
 }
@@ -43,8 +50,10 @@ VulkanDevice::~VulkanDevice()
     Destroy();
 }
 
-bool VulkanDevice::Create(VkInstance Instance)
+bool VulkanDevice::Create(VkInstance Instance, bool EnableSwapchain)
 {
+    SwapchainEnabled = EnableSwapchain;
+
     /* Select suitable physical device. */
     if (!PickPhysicalDevice(Instance))
     {
@@ -59,6 +68,9 @@ bool VulkanDevice::Create(VkInstance Instance)
         return false;
     }
 
+    /* Pick the family uploads are submitted on. */
+    FindTransferQueueFamily(PhysicalDevice);
+
     /* Create logical device and queues. */
     if (!CreateLogicalDevice())
     {
@@ -66,6 +78,32 @@ bool VulkanDevice::Create(VkInstance Instance)
         return false;
     }
 
+    /* Create the shared memory allocator for this device. */
+    if (!g_VulkanAllocator.Create(PhysicalDevice, Device))
+    {
+        std::fprintf(stderr, "VulkanDevice::Create: VulkanMemoryAllocator::Create failed\n");
+        return false;
+    }
+
+    /* Create the shared upload manager on the transfer queue. */
+    if (!g_VulkanUploader.Create(
+        Device,
+        GraphicsQueue,
+        GraphicsQueueFamily,
+        TransferQueue,
+        TransferQueueFamily))
+    {
+        std::fprintf(stderr, "VulkanDevice::Create: VulkanUploadManager::Create failed\n");
+        return false;
+    }
+
+    /* Load the shared pipeline cache saved by the last run on this device. */
+    if (!g_VulkanPipelineCache.Create(PhysicalDevice, Device, "../Temp/PipelineCache.bin"))
+    {
+        std::fprintf(stderr, "VulkanDevice::Create: VulkanPipelineCache::Create failed\n");
+        return false;
+    }
+
     return true;
 }
 
@@ -74,6 +112,11 @@ void VulkanDevice::Destroy()
     /* Destroy logical device. */
     if (Device != VK_NULL_HANDLE)
     {
+        /* Save the pipeline cache, finish pending uploads, then release pooled memory blocks. */
+        g_VulkanPipelineCache.Destroy();
+        g_VulkanUploader.Destroy();
+        g_VulkanAllocator.Destroy();
+
         vkDestroyDevice(Device, nullptr);
         Device = VK_NULL_HANDLE;
     }
@@ -82,6 +125,10 @@ void VulkanDevice::Destroy()
     PhysicalDevice = VK_NULL_HANDLE;
     GraphicsQueue = VK_NULL_HANDLE;
     GraphicsQueueFamily = UINT32_MAX;
+    TransferQueue = VK_NULL_HANDLE;
+    TransferQueueFamily = UINT32_MAX;
+    DrawIndirectCount = false;
+    SwapchainEnabled = false;
 }
 
 VkPhysicalDevice VulkanDevice::GetPhysicalDevice() const
@@ -108,6 +155,24 @@ uint32_t VulkanDevice::GetGraphicsQueueFamily() const
     return GraphicsQueueFamily;
 }
 
+VkQueue VulkanDevice::GetTransferQueue() const
+{
+    /* Return transfer queue handle. */
+    return TransferQueue;
+}
+
+uint32_t VulkanDevice::GetTransferQueueFamily() const
+{
+    /* Return transfer queue family index. */
+    return TransferQueueFamily;
+}
+
+bool VulkanDevice::SupportsDrawIndirectCount() const
+{
+    /* Return whether indirect draws may take a GPU-written count. */
+    return DrawIndirectCount;
+}
+
 bool VulkanDevice::PickPhysicalDevice(VkInstance Instance)
 {
     /* Enumerate available physical devices. */
@@ -164,20 +229,86 @@ bool VulkanDevice::FindGraphicsQueueFamily(VkPhysicalDevice InPhysicalDevice)
     return false;
 }
 
+void VulkanDevice::FindTransferQueueFamily(VkPhysicalDevice InPhysicalDevice)
+{
+    /* Query available queue families. */
+    uint32_t QueueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(InPhysicalDevice, &QueueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> Families(QueueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(InPhysicalDevice, &QueueFamilyCount, Families.data());
+
+    /* Prefer a pure DMA family, then any transfer family without graphics. */
+    uint32_t Fallback = UINT32_MAX;
+    for (uint32_t Index = 0; Index < QueueFamilyCount; ++Index)
+    {
+        const VkQueueFlags Flags = Families[Index].queueFlags;
+        if (!(Flags & VK_QUEUE_TRANSFER_BIT) || (Flags & VK_QUEUE_GRAPHICS_BIT))
+        {
+            continue;
+        }
+
+        if (!(Flags & VK_QUEUE_COMPUTE_BIT))
+        {
+            TransferQueueFamily = Index;
+            return;
+        }
+
+        if (Fallback == UINT32_MAX)
+        {
+            Fallback = Index;
+        }
+    }
+
+    /* Graphics families always support transfers. */
+    TransferQueueFamily = Fallback != UINT32_MAX ? Fallback : GraphicsQueueFamily;
+}
+
 bool VulkanDevice::CreateLogicalDevice()
 {
     /* Configure graphics queue creation. */
     float QueuePriority = 1.0f;
 
-    VkDeviceQueueCreateInfo QueueInfo{};
-    QueueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    QueueInfo.queueFamilyIndex = GraphicsQueueFamily;
-    QueueInfo.queueCount = 1;
-    QueueInfo.pQueuePriorities = &QueuePriority;
+    VkDeviceQueueCreateInfo QueueInfos[2]{};
+    QueueInfos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    QueueInfos[0].queueFamilyIndex = GraphicsQueueFamily;
+    QueueInfos[0].queueCount = 1;
+    QueueInfos[0].pQueuePriorities = &QueuePriority;
+
+    /* Separate transfer family gets its own queue. */
+    uint32_t QueueInfoCount = 1;
+    if (TransferQueueFamily != GraphicsQueueFamily)
+    {
+        QueueInfos[1] = QueueInfos[0];
+        QueueInfos[1].queueFamilyIndex = TransferQueueFamily;
+        QueueInfoCount = 2;
+    }
 
     /* Enable basic device features. */
     VkPhysicalDeviceFeatures Features{};
 
+    /* GPU-driven drawing reads its draw count from a buffer when the */
+    /* device offers it; it is core, but optional, from Vulkan 1.2. */
+    VkPhysicalDeviceProperties Properties{};
+    vkGetPhysicalDeviceProperties(PhysicalDevice, &Properties);
+
+    VkPhysicalDeviceVulkan12Features Features12{};
+    Features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    const bool Vulkan12 = Properties.apiVersion >= VK_API_VERSION_1_2;
+    if (Vulkan12)
+    {
+        VkPhysicalDeviceFeatures2 Supported{};
+        Supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        Supported.pNext = &Features12;
+        vkGetPhysicalDeviceFeatures2(PhysicalDevice, &Supported);
+
+        /* Request only what is used, not everything reported. */
+        const VkBool32 SupportedDrawIndirectCount = Features12.drawIndirectCount;
+        Features12 = VkPhysicalDeviceVulkan12Features{};
+        Features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        Features12.drawIndirectCount = SupportedDrawIndirectCount;
+    }
+
     /* Required device extensions for swapchain support. */
     const char* DeviceExtensions[] =
     {
@@ -186,13 +317,15 @@ bool VulkanDevice::CreateLogicalDevice()
 
     VkDeviceCreateInfo CreateInfo{};
     CreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    CreateInfo.queueCreateInfoCount = 1;
-    CreateInfo.pQueueCreateInfos = &QueueInfo;
+    CreateInfo.queueCreateInfoCount = QueueInfoCount;
+    CreateInfo.pQueueCreateInfos = QueueInfos;
     CreateInfo.pEnabledFeatures = &Features;
+    CreateInfo.pNext = Vulkan12 ? &Features12 : nullptr;
 
-    /* Enable required extensions. */
-    CreateInfo.enabledExtensionCount = 1;
-    CreateInfo.ppEnabledExtensionNames = DeviceExtensions;
+    /* Enable required extensions, none when rendering offscreen so software */
+    /* ICDs without presentation support still qualify. */
+    CreateInfo.enabledExtensionCount = SwapchainEnabled ? 1 : 0;
+    CreateInfo.ppEnabledExtensionNames = SwapchainEnabled ? DeviceExtensions : nullptr;
 
 #if defined(_DEBUG)
     /* Enable validation layer on device for debugging. */
@@ -211,8 +344,13 @@ bool VulkanDevice::CreateLogicalDevice()
         return false;
     }
 
+    DrawIndirectCount = Vulkan12 && Features12.drawIndirectCount == VK_TRUE;
+
     /* Retrieve graphics queue handle. */
     vkGetDeviceQueue(Device, GraphicsQueueFamily, 0, &GraphicsQueue);
 
+    /* Retrieve transfer queue handle, shared with graphics when families match. */
+    vkGetDeviceQueue(Device, TransferQueueFamily, 0, &TransferQueue);
+
     return true;
 }
@@ -40,7 +40,8 @@ public:
     ~VulkanDevice();
 
     /* Select physical device and create logical device. */
-    bool Create(VkInstance Instance);
+    /* Headless devices skip the swapchain extension and never present. */
+    bool Create(VkInstance Instance, bool EnableSwapchain);
 
     /* Destroy logical device. */
     void Destroy();
@@ -57,6 +58,15 @@ public:
     /* Get graphics queue family index. */
     uint32_t GetGraphicsQueueFamily() const;
 
+    /* Get upload queue handle, the graphics queue when no transfer family exists. */
+    VkQueue GetTransferQueue() const;
+
+    /* Get upload queue family index. */
+    uint32_t GetTransferQueueFamily() const;
+
+    /* True when vkCmdDraw*IndirectCount was enabled (Vulkan 1.2 devices). */
+    bool SupportsDrawIndirectCount() const;
+
 private:
     /* Select suitable physical device. */
     bool PickPhysicalDevice(VkInstance Instance);
@@ -64,6 +74,9 @@ private:
     /* Find graphics-capable queue family. */
     bool FindGraphicsQueueFamily(VkPhysicalDevice PhysicalDevice);
 
+    /* Find a transfer-only queue family, falling back to graphics. */
+    void FindTransferQueueFamily(VkPhysicalDevice PhysicalDevice);
+
     /* Create logical device and queues. */
     bool CreateLogicalDevice();
 
@@ -79,4 +92,16 @@ private:
 
     /* Graphics queue family index. */
     uint32_t GraphicsQueueFamily;
+
+    /* Transfer queue handle, DMA engine when the device exposes one. */
+    VkQueue TransferQueue;
+
+    /* Transfer queue family index. */
+    uint32_t TransferQueueFamily;
+
+    /* Optional features enabled on the logical device. */
+    bool DrawIndirectCount;
+
+    /* True when VK_KHR_swapchain is enabled on the logical device. */
+    bool SwapchainEnabled;
 };
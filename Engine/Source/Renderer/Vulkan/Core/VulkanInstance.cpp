@@ -178,11 +178,13 @@ bool VulkanInstance::CheckValidationLayerSupport() const
 
 std::vector<const char*> VulkanInstance::GetRequiredExtensions(GLFWwindow* WindowHandle) const
 {
-    /* Get GLFW-required extensions for windowing. */
-    (void)WindowHandle;
-
+    /* Get GLFW-required extensions for windowing, none when headless. */
     uint32_t Count = 0;
-    const char** GlfwExtensions = glfwGetRequiredInstanceExtensions(&Count);
+    const char** GlfwExtensions = nullptr;
+    if (WindowHandle)
+    {
+        GlfwExtensions = glfwGetRequiredInstanceExtensions(&Count);
+    }
 
     std::vector<const char*> Extensions;
     Extensions.reserve(Count + 2);
@@ -41,7 +41,7 @@ public:
     /* Release instance resources. */
     ~VulkanInstance();
 
-    /* Create VkInstance and optional debug messenger. */
+    /* Create VkInstance and optional debug messenger, windowless when null. */
     bool Create(const char* AppName, GLFWwindow* WindowHandle);
 
     /* Destroy debug messenger and instance. */
@@ -0,0 +1,595 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "VulkanMemoryAllocator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+VulkanMemoryAllocator g_VulkanAllocator;
+
+namespace
+{
+    /* Smallest node is 256 bytes, blocks are 64 MiB on full-size heaps. */
+    const std::uint32_t kMinOrder = 8;
+    const std::uint32_t kMaxBlockOrder = 26;
+
+    /* Small heaps (ReBAR windows, integrated carve-outs) use an eighth per block. */
+    const VkDeviceSize kHeapBlockDivisor = 8;
+
+    /* Smallest order whose node holds Size bytes. */
+    std::uint32_t OrderForSize(VkDeviceSize Size)
+    {
+        std::uint32_t order = kMinOrder;
+        while (order < 63 && (VkDeviceSize(1) << order) < Size)
+        {
+            ++order;
+        }
+
+        return order;
+    }
+
+    /* Largest order whose node fits in Size bytes. */
+    std::uint32_t FloorOrder(VkDeviceSize Size)
+    {
+        std::uint32_t order = 0;
+        while (order < 63 && (VkDeviceSize(1) << (order + 1)) <= Size)
+        {
+            ++order;
+        }
+
+        return order;
+    }
+}
+
+VulkanMemoryAllocator::VulkanMemoryAllocator()
+    : DeviceHandle(VK_NULL_HANDLE)
+    , MemoryProperties{}
+{
+    /* Initialize to null state. */
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator()
+{
+    /* Blocks are freed by Destroy() before the device goes away. */
+}
+
+bool VulkanMemoryAllocator::Create(VkPhysicalDevice PhysicalDevice, VkDevice Device)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    if (PhysicalDevice == VK_NULL_HANDLE || Device == VK_NULL_HANDLE)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::Create: invalid device\n");
+        return false;
+    }
+
+    DeviceHandle = Device;
+    vkGetPhysicalDeviceMemoryProperties(PhysicalDevice, &MemoryProperties);
+
+    Pools.clear();
+    Pools.resize(static_cast<std::size_t>(MemoryProperties.memoryTypeCount) * 2);
+
+    for (std::uint32_t type = 0; type < MemoryProperties.memoryTypeCount; ++type)
+    {
+        const VkDeviceSize heapSize =
+            MemoryProperties.memoryHeaps[MemoryProperties.memoryTypes[type].heapIndex].size;
+
+        /* Keep blocks a small fraction of their heap, never below one node. */
+        std::uint32_t blockOrder = std::min(kMaxBlockOrder, FloorOrder(heapSize / kHeapBlockDivisor));
+        blockOrder = std::max(blockOrder, kMinOrder);
+
+        for (std::uint32_t kind = 0; kind < 2; ++kind)
+        {
+            MemoryPool& pool = Pools[type * 2 + kind];
+            pool.MemoryType = type;
+            pool.BlockOrder = blockOrder;
+        }
+    }
+
+    Stats = VulkanMemoryStats{};
+    return true;
+}
+
+void VulkanMemoryAllocator::Destroy()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    if (DeviceHandle == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    if (Stats.AllocationCount > 0)
+    {
+        std::fprintf(
+            stderr,
+            "VulkanMemoryAllocator::Destroy: %u allocations still live\n",
+            Stats.AllocationCount);
+    }
+
+    for (MemoryPool& pool : Pools)
+    {
+        for (MemoryBlock& block : pool.Blocks)
+        {
+            DestroyBlock(block);
+        }
+    }
+
+    /* Dedicated allocations are owned by their resources; leaked ones */
+    /* are reclaimed by vkDestroyDevice and reported above. */
+    Pools.clear();
+    Stats = VulkanMemoryStats{};
+    DeviceHandle = VK_NULL_HANDLE;
+}
+
+std::uint32_t VulkanMemoryAllocator::FindMemoryType(
+    std::uint32_t TypeFilter,
+    VkMemoryPropertyFlags Properties) const
+{
+    for (std::uint32_t i = 0; i < MemoryProperties.memoryTypeCount; ++i)
+    {
+        if ((TypeFilter & (1u << i)) &&
+            (MemoryProperties.memoryTypes[i].propertyFlags & Properties) == Properties)
+        {
+            return i;
+        }
+    }
+
+    return UINT32_MAX;
+}
+
+bool VulkanMemoryAllocator::Allocate(
+    const VkMemoryRequirements& Requirements,
+    VkMemoryPropertyFlags Properties,
+    bool Linear,
+    bool Dedicated,
+    VulkanAllocation& OutAllocation)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    OutAllocation = VulkanAllocation{};
+
+    if (DeviceHandle == VK_NULL_HANDLE)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::Allocate: allocator not created\n");
+        return false;
+    }
+
+    const std::uint32_t memoryType = FindMemoryType(Requirements.memoryTypeBits, Properties);
+    if (memoryType == UINT32_MAX)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::Allocate: no suitable memory type\n");
+        return false;
+    }
+
+    /* Node offsets are multiples of their size, so covering the */
+    /* (power-of-two) alignment as well keeps every node aligned. */
+    const std::uint32_t order = OrderForSize(std::max(Requirements.size, Requirements.alignment));
+    MemoryPool& pool = Pools[memoryType * 2 + (Linear ? 0 : 1)];
+
+    if (Dedicated || order >= pool.BlockOrder)
+    {
+        return AllocateDedicated(Requirements.size, memoryType, OutAllocation);
+    }
+
+    OutAllocation.Size = Requirements.size;
+    if (AllocateFromPool(pool, order, OutAllocation))
+    {
+        return true;
+    }
+
+    /* Pool could not grow (heap nearly full), try an exact-size allocation. */
+    return AllocateDedicated(Requirements.size, memoryType, OutAllocation);
+}
+
+void VulkanMemoryAllocator::Free(VulkanAllocation& Allocation)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    if (Allocation.Memory == VK_NULL_HANDLE || DeviceHandle == VK_NULL_HANDLE)
+    {
+        Allocation = VulkanAllocation{};
+        return;
+    }
+
+    if (Allocation.Pool == UINT32_MAX)
+    {
+        if (Allocation.Mapped)
+        {
+            vkUnmapMemory(DeviceHandle, Allocation.Memory);
+        }
+
+        vkFreeMemory(DeviceHandle, Allocation.Memory, nullptr);
+
+        --Stats.DedicatedCount;
+        --Stats.AllocationCount;
+        Stats.ReservedBytes -= Allocation.Size;
+        Stats.UsedBytes -= Allocation.Size;
+
+        Allocation = VulkanAllocation{};
+        return;
+    }
+
+    MemoryPool& pool = Pools[Allocation.Pool];
+    MemoryBlock& block = pool.Blocks[Allocation.Block];
+
+    ReturnNode(block, pool.BlockOrder, Allocation.Order, Allocation.Offset);
+    --block.LiveCount;
+
+    const VkDeviceSize nodeSize = VkDeviceSize(1) << Allocation.Order;
+    --Stats.AllocationCount;
+    Stats.UsedBytes -= Allocation.Size;
+    Stats.WastedBytes -= nodeSize - Allocation.Size;
+    Stats.FreeBytes += nodeSize;
+
+    /* Keep one empty block per pool to absorb load/unload churn. */
+    if (block.LiveCount == 0)
+    {
+        for (std::size_t i = 0; i < pool.Blocks.size(); ++i)
+        {
+            const MemoryBlock& other = pool.Blocks[i];
+            if (i != Allocation.Block && other.Memory != VK_NULL_HANDLE && other.LiveCount == 0)
+            {
+                const VkDeviceSize blockSize = VkDeviceSize(1) << pool.BlockOrder;
+                DestroyBlock(block);
+                --Stats.BlockCount;
+                Stats.ReservedBytes -= blockSize;
+                Stats.FreeBytes -= blockSize;
+                break;
+            }
+        }
+    }
+
+    Allocation = VulkanAllocation{};
+}
+
+bool VulkanMemoryAllocator::CreateBuffer(
+    VkDeviceSize Size,
+    VkBufferUsageFlags Usage,
+    VkMemoryPropertyFlags Properties,
+    VkBuffer& OutBuffer,
+    VulkanAllocation& OutAllocation)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = Size;
+    bufferInfo.usage = Usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(DeviceHandle, &bufferInfo, nullptr, &OutBuffer) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::CreateBuffer: vkCreateBuffer failed\n");
+        OutBuffer = VK_NULL_HANDLE;
+        return false;
+    }
+
+    VkMemoryRequirements requirements{};
+    vkGetBufferMemoryRequirements(DeviceHandle, OutBuffer, &requirements);
+
+    if (!Allocate(requirements, Properties, true, false, OutAllocation))
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::CreateBuffer: Allocate failed\n");
+        vkDestroyBuffer(DeviceHandle, OutBuffer, nullptr);
+        OutBuffer = VK_NULL_HANDLE;
+        return false;
+    }
+
+    if (vkBindBufferMemory(DeviceHandle, OutBuffer, OutAllocation.Memory, OutAllocation.Offset) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::CreateBuffer: vkBindBufferMemory failed\n");
+        DestroyBuffer(OutBuffer, OutAllocation);
+        return false;
+    }
+
+    return true;
+}
+
+bool VulkanMemoryAllocator::CreateImage(
+    const VkImageCreateInfo& ImageInfo,
+    VkMemoryPropertyFlags Properties,
+    VkImage& OutImage,
+    VulkanAllocation& OutAllocation)
+{
+    if (vkCreateImage(DeviceHandle, &ImageInfo, nullptr, &OutImage) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::CreateImage: vkCreateImage failed\n");
+        OutImage = VK_NULL_HANDLE;
+        return false;
+    }
+
+    VkMemoryRequirements requirements{};
+    vkGetImageMemoryRequirements(DeviceHandle, OutImage, &requirements);
+
+    /* Attachments are recreated with the swapchain, give them their own */
+    /* memory so resizes hand it straight back instead of fragmenting blocks. */
+    const VkImageUsageFlags attachmentUsage =
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    const bool dedicated = (ImageInfo.usage & attachmentUsage) != 0;
+    const bool linear = ImageInfo.tiling == VK_IMAGE_TILING_LINEAR;
+
+    if (!Allocate(requirements, Properties, linear, dedicated, OutAllocation))
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::CreateImage: Allocate failed\n");
+        vkDestroyImage(DeviceHandle, OutImage, nullptr);
+        OutImage = VK_NULL_HANDLE;
+        return false;
+    }
+
+    if (vkBindImageMemory(DeviceHandle, OutImage, OutAllocation.Memory, OutAllocation.Offset) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::CreateImage: vkBindImageMemory failed\n");
+        DestroyImage(OutImage, OutAllocation);
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanMemoryAllocator::DestroyBuffer(VkBuffer& Buffer, VulkanAllocation& Allocation)
+{
+    if (Buffer != VK_NULL_HANDLE)
+    {
+        vkDestroyBuffer(DeviceHandle, Buffer, nullptr);
+        Buffer = VK_NULL_HANDLE;
+    }
+
+    Free(Allocation);
+}
+
+void VulkanMemoryAllocator::DestroyImage(VkImage& Image, VulkanAllocation& Allocation)
+{
+    if (Image != VK_NULL_HANDLE)
+    {
+        vkDestroyImage(DeviceHandle, Image, nullptr);
+        Image = VK_NULL_HANDLE;
+    }
+
+    Free(Allocation);
+}
+
+VulkanMemoryStats VulkanMemoryAllocator::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Stats;
+}
+
+bool VulkanMemoryAllocator::AllocateDedicated(
+    VkDeviceSize Size,
+    std::uint32_t MemoryType,
+    VulkanAllocation& OutAllocation)
+{
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = Size;
+    allocInfo.memoryTypeIndex = MemoryType;
+
+    VulkanAllocation allocation{};
+    if (vkAllocateMemory(DeviceHandle, &allocInfo, nullptr, &allocation.Memory) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::AllocateDedicated: vkAllocateMemory failed\n");
+        return false;
+    }
+
+    if (IsHostVisible(MemoryType) &&
+        vkMapMemory(DeviceHandle, allocation.Memory, 0, VK_WHOLE_SIZE, 0, &allocation.Mapped) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::AllocateDedicated: vkMapMemory failed\n");
+        vkFreeMemory(DeviceHandle, allocation.Memory, nullptr);
+        return false;
+    }
+
+    allocation.Size = Size;
+    OutAllocation = allocation;
+
+    ++Stats.DedicatedCount;
+    ++Stats.AllocationCount;
+    Stats.ReservedBytes += Size;
+    Stats.UsedBytes += Size;
+    return true;
+}
+
+bool VulkanMemoryAllocator::AllocateFromPool(
+    MemoryPool& Pool,
+    std::uint32_t Order,
+    VulkanAllocation& OutAllocation)
+{
+    const std::uint32_t poolIndex = static_cast<std::uint32_t>(&Pool - Pools.data());
+
+    std::size_t blockIndex = 0;
+    VkDeviceSize offset = 0;
+    bool found = false;
+
+    for (; blockIndex < Pool.Blocks.size(); ++blockIndex)
+    {
+        MemoryBlock& block = Pool.Blocks[blockIndex];
+        if (block.Memory != VK_NULL_HANDLE && TakeNode(block, Pool.BlockOrder, Order, offset))
+        {
+            found = true;
+            break;
+        }
+    }
+
+    if (!found)
+    {
+        /* Reuse a released slot so live allocations keep their indices. */
+        blockIndex = 0;
+        while (blockIndex < Pool.Blocks.size() && Pool.Blocks[blockIndex].Memory != VK_NULL_HANDLE)
+        {
+            ++blockIndex;
+        }
+
+        if (blockIndex == Pool.Blocks.size())
+        {
+            Pool.Blocks.emplace_back();
+        }
+
+        if (!CreateBlock(Pool, Pool.Blocks[blockIndex]))
+        {
+            return false;
+        }
+
+        const VkDeviceSize blockSize = VkDeviceSize(1) << Pool.BlockOrder;
+        ++Stats.BlockCount;
+        Stats.ReservedBytes += blockSize;
+        Stats.FreeBytes += blockSize;
+
+        TakeNode(Pool.Blocks[blockIndex], Pool.BlockOrder, Order, offset);
+    }
+
+    MemoryBlock& block = Pool.Blocks[blockIndex];
+    ++block.LiveCount;
+
+    const VkDeviceSize nodeSize = VkDeviceSize(1) << Order;
+    OutAllocation.Memory = block.Memory;
+    OutAllocation.Offset = offset;
+    OutAllocation.Mapped = block.Mapped ? static_cast<char*>(block.Mapped) + offset : nullptr;
+    OutAllocation.Pool = poolIndex;
+    OutAllocation.Block = static_cast<std::uint32_t>(blockIndex);
+    OutAllocation.Order = Order;
+
+    ++Stats.AllocationCount;
+    Stats.UsedBytes += OutAllocation.Size;
+    Stats.WastedBytes += nodeSize - OutAllocation.Size;
+    Stats.FreeBytes -= nodeSize;
+    return true;
+}
+
+bool VulkanMemoryAllocator::CreateBlock(MemoryPool& Pool, MemoryBlock& OutBlock)
+{
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = VkDeviceSize(1) << Pool.BlockOrder;
+    allocInfo.memoryTypeIndex = Pool.MemoryType;
+
+    MemoryBlock block{};
+    if (vkAllocateMemory(DeviceHandle, &allocInfo, nullptr, &block.Memory) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::CreateBlock: vkAllocateMemory failed\n");
+        return false;
+    }
+
+    if (IsHostVisible(Pool.MemoryType) &&
+        vkMapMemory(DeviceHandle, block.Memory, 0, VK_WHOLE_SIZE, 0, &block.Mapped) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanMemoryAllocator::CreateBlock: vkMapMemory failed\n");
+        vkFreeMemory(DeviceHandle, block.Memory, nullptr);
+        return false;
+    }
+
+    /* The whole block starts as one free node of the top order. */
+    block.FreeNodes.resize(Pool.BlockOrder - kMinOrder + 1);
+    block.FreeNodes.back().push_back(0);
+
+    OutBlock = std::move(block);
+    return true;
+}
+
+void VulkanMemoryAllocator::DestroyBlock(MemoryBlock& Block)
+{
+    if (Block.Memory != VK_NULL_HANDLE)
+    {
+        if (Block.Mapped)
+        {
+            vkUnmapMemory(DeviceHandle, Block.Memory);
+        }
+
+        vkFreeMemory(DeviceHandle, Block.Memory, nullptr);
+    }
+
+    Block = MemoryBlock{};
+}
+
+bool VulkanMemoryAllocator::TakeNode(
+    MemoryBlock& Block,
+    std::uint32_t BlockOrder,
+    std::uint32_t Order,
+    VkDeviceSize& OutOffset)
+{
+    /* Smallest free node that fits. */
+    std::uint32_t order = Order;
+    while (order <= BlockOrder && Block.FreeNodes[order - kMinOrder].empty())
+    {
+        ++order;
+    }
+
+    if (order > BlockOrder)
+    {
+        return false;
+    }
+
+    std::vector<VkDeviceSize>& nodes = Block.FreeNodes[order - kMinOrder];
+    const VkDeviceSize offset = nodes.back();
+    nodes.pop_back();
+
+    /* Split down, keeping the lower half and freeing each upper buddy. */
+    while (order > Order)
+    {
+        --order;
+        Block.FreeNodes[order - kMinOrder].push_back(offset + (VkDeviceSize(1) << order));
+    }
+
+    OutOffset = offset;
+    return true;
+}
+
+void VulkanMemoryAllocator::ReturnNode(
+    MemoryBlock& Block,
+    std::uint32_t BlockOrder,
+    std::uint32_t Order,
+    VkDeviceSize Offset)
+{
+    std::uint32_t order = Order;
+    VkDeviceSize offset = Offset;
+
+    while (order < BlockOrder)
+    {
+        const VkDeviceSize buddy = offset ^ (VkDeviceSize(1) << order);
+        std::vector<VkDeviceSize>& nodes = Block.FreeNodes[order - kMinOrder];
+
+        auto it = std::find(nodes.begin(), nodes.end(), buddy);
+        if (it == nodes.end())
+        {
+            break;
+        }
+
+        *it = nodes.back();
+        nodes.pop_back();
+
+        offset = std::min(offset, buddy);
+        ++order;
+    }
+
+    Block.FreeNodes[order - kMinOrder].push_back(offset);
+}
+
+bool VulkanMemoryAllocator::IsHostVisible(std::uint32_t MemoryType) const
+{
+    return (MemoryProperties.memoryTypes[MemoryType].propertyFlags &
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/* Memory backing one buffer or image: a buddy node inside a pooled block, */
+/* or its own VkDeviceMemory when Pool is UINT32_MAX (dedicated). */
+struct VulkanAllocation
+{
+    VkDeviceMemory Memory = VK_NULL_HANDLE;
+    VkDeviceSize Offset = 0;
+    VkDeviceSize Size = 0;
+    void* Mapped = nullptr;
+    std::uint32_t Pool = UINT32_MAX;
+    std::uint32_t Block = 0;
+    std::uint32_t Order = 0;
+};
+
+/* Round Value up to a multiple of Alignment. */
+inline VkDeviceSize AlignUp(VkDeviceSize Value, VkDeviceSize Alignment)
+{
+    return (Value + Alignment - 1) / Alignment * Alignment;
+}
+
+/* Snapshot of allocator usage. */
+struct VulkanMemoryStats
+{
+    /* Pooled blocks and dedicated allocations currently held. */
+    std::uint32_t BlockCount = 0;
+    std::uint32_t DedicatedCount = 0;
+
+    /* Live sub-allocations plus dedicated allocations. */
+    std::uint32_t AllocationCount = 0;
+
+    /* Device memory held, bytes requested by resources, bytes lost to */
+    /* power-of-two rounding, and bytes still free inside blocks. */
+    VkDeviceSize ReservedBytes = 0;
+    VkDeviceSize UsedBytes = 0;
+    VkDeviceSize WastedBytes = 0;
+    VkDeviceSize FreeBytes = 0;
+};
+
+/* Pooled device memory allocator. */
+/* Each memory type has two block pools, one for buffers and linear images */
+/* and one for optimal images, so neighbours never share a granularity page. */
+/* Blocks are carved by a buddy allocator; render targets and resources */
+/* larger than half a block get a dedicated allocation instead. */
+/* Host-visible memory is mapped once for the lifetime of its block. */
+class VulkanMemoryAllocator
+{
+public:
+    /* Initialize empty allocator state. */
+    VulkanMemoryAllocator();
+
+    /* Release allocator resources. */
+    ~VulkanMemoryAllocator();
+
+    /* Query memory types and heaps, blocks are created on demand. */
+    bool Create(VkPhysicalDevice PhysicalDevice, VkDevice Device);
+
+    /* Free every block and dedicated allocation. */
+    void Destroy();
+
+    /* First memory type in TypeFilter with Properties, UINT32_MAX if none. */
+    std::uint32_t FindMemoryType(std::uint32_t TypeFilter, VkMemoryPropertyFlags Properties) const;
+
+    /* Reserve memory for Requirements; Linear selects the buffer pool. */
+    bool Allocate(
+        const VkMemoryRequirements& Requirements,
+        VkMemoryPropertyFlags Properties,
+        bool Linear,
+        bool Dedicated,
+        VulkanAllocation& OutAllocation);
+
+    /* Return memory to its block or to the driver, resets Allocation. */
+    void Free(VulkanAllocation& Allocation);
+
+    /* Create a buffer bound to pooled memory. */
+    bool CreateBuffer(
+        VkDeviceSize Size,
+        VkBufferUsageFlags Usage,
+        VkMemoryPropertyFlags Properties,
+        VkBuffer& OutBuffer,
+        VulkanAllocation& OutAllocation);
+
+    /* Create an image bound to pooled or, for attachments, dedicated memory. */
+    bool CreateImage(
+        const VkImageCreateInfo& ImageInfo,
+        VkMemoryPropertyFlags Properties,
+        VkImage& OutImage,
+        VulkanAllocation& OutAllocation);
+
+    /* Destroy a resource and free its memory, null handles are ignored. */
+    void DestroyBuffer(VkBuffer& Buffer, VulkanAllocation& Allocation);
+    void DestroyImage(VkImage& Image, VulkanAllocation& Allocation);
+
+    /* Current usage totals. */
+    VulkanMemoryStats GetStats() const;
+
+private:
+    /* One VkDeviceMemory carved into power-of-two nodes. */
+    struct MemoryBlock
+    {
+        VkDeviceMemory Memory = VK_NULL_HANDLE;
+        void* Mapped = nullptr;
+
+        /* Free node offsets per order, index 0 is kMinOrder. */
+        std::vector<std::vector<VkDeviceSize>> FreeNodes;
+        std::uint32_t LiveCount = 0;
+    };
+
+    /* Blocks of one memory type and resource kind, empty slots are reused. */
+    struct MemoryPool
+    {
+        std::uint32_t MemoryType = 0;
+        std::uint32_t BlockOrder = 0;
+        std::vector<MemoryBlock> Blocks;
+    };
+
+    bool AllocateDedicated(
+        VkDeviceSize Size,
+        std::uint32_t MemoryType,
+        VulkanAllocation& OutAllocation);
+
+    bool AllocateFromPool(
+        MemoryPool& Pool,
+        std::uint32_t Order,
+        VulkanAllocation& OutAllocation);
+
+    bool CreateBlock(MemoryPool& Pool, MemoryBlock& OutBlock);
+    void DestroyBlock(MemoryBlock& Block);
+
+    /* Split a free node of at least Order down to Order, false when full. */
+    bool TakeNode(MemoryBlock& Block, std::uint32_t BlockOrder, std::uint32_t Order, VkDeviceSize& OutOffset);
+
+    /* Return a node and merge it with free buddies. */
+    void ReturnNode(MemoryBlock& Block, std::uint32_t BlockOrder, std::uint32_t Order, VkDeviceSize Offset);
+
+    bool IsHostVisible(std::uint32_t MemoryType) const;
+
+private:
+    VkDevice DeviceHandle;
+    VkPhysicalDeviceMemoryProperties MemoryProperties;
+
+    /* Two pools per memory type: [type * 2] linear, [type * 2 + 1] optimal. */
+    std::vector<MemoryPool> Pools;
+
+    VulkanMemoryStats Stats;
+
+    /* Upload and recording threads may allocate concurrently. */
+    mutable std::mutex Mutex;
+};
+
+/* Allocator shared by every Vulkan resource, created with VulkanDevice. */
+extern VulkanMemoryAllocator g_VulkanAllocator;
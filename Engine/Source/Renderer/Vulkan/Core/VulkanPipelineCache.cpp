@@ -0,0 +1,413 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "VulkanPipelineCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+VulkanPipelineCache g_VulkanPipelineCache;
+
+namespace
+{
+    /* "CBPC" followed by the layout version of the header below. */
+    const std::uint32_t kFileMagic = 0x43504243u;
+    const std::uint32_t kFileVersion = 1;
+
+    /* Header written ahead of the driver's cache blob. */
+    struct CacheFileHeader
+    {
+        std::uint32_t Magic;
+        std::uint32_t Version;
+        std::uint32_t VendorID;
+        std::uint32_t DeviceID;
+        std::uint32_t DriverVersion;
+        std::uint8_t PipelineCacheUUID[VK_UUID_SIZE];
+        std::uint64_t DataSize;
+        std::uint64_t Checksum;
+
+        /* Startup creation time and pipeline count of the last cold start. */
+        double ColdMilliseconds;
+        std::uint32_t ColdPipelineCount;
+        std::uint32_t Reserved;
+    };
+
+    /* VkPipelineCacheHeaderVersionOne is 16 bytes of ids plus the UUID. */
+    const std::size_t kDriverHeaderSize = 16 + VK_UUID_SIZE;
+
+    /* FNV-1a over the driver blob, catches truncated or damaged files. */
+    std::uint64_t HashBytes(const std::uint8_t* Data, std::size_t Size)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            hash ^= Data[i];
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    std::uint32_t ReadU32(const std::uint8_t* Data)
+    {
+        std::uint32_t value = 0;
+        std::memcpy(&value, Data, sizeof(value));
+        return value;
+    }
+}
+
+VulkanPipelineCache::VulkanPipelineCache()
+    : DeviceHandle(VK_NULL_HANDLE)
+    , Cache(VK_NULL_HANDLE)
+    , DeviceProperties{}
+    , Warm(false)
+    , StartupOpen(true)
+    , StartupClosing(false)
+    , BackgroundCompiles(0)
+    , LoadedBytes(0)
+    , PipelineCount(0)
+    , CreationMilliseconds(0.0)
+    , StartupMilliseconds(0.0)
+    , ColdMilliseconds(0.0)
+    , ColdPipelineCount(0)
+{
+    /* Initialize to null state. */
+}
+
+VulkanPipelineCache::~VulkanPipelineCache()
+{
+    /* The cache is destroyed by Destroy() before the device goes away. */
+}
+
+bool VulkanPipelineCache::Create(VkPhysicalDevice PhysicalDevice, VkDevice Device, const std::string& Path)
+{
+    DeviceHandle = Device;
+    FilePath = Path;
+    vkGetPhysicalDeviceProperties(PhysicalDevice, &DeviceProperties);
+
+    Warm = false;
+    StartupOpen = true;
+    StartupClosing = false;
+    BackgroundCompiles = 0;
+    LoadedBytes = 0;
+    PipelineCount = 0;
+    CreationMilliseconds = 0.0;
+    StartupMilliseconds = 0.0;
+    ColdMilliseconds = 0.0;
+    ColdPipelineCount = 0;
+
+    /* Seed from disk, a stale or foreign file just means a cold start. */
+    std::vector<std::uint8_t> initialData;
+    if (ReadCacheFile(initialData))
+    {
+        Warm = true;
+        LoadedBytes = initialData.size();
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = initialData.size();
+    cacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    if (vkCreatePipelineCache(Device, &cacheInfo, nullptr, &Cache) != VK_SUCCESS)
+    {
+        /* The driver may still refuse data it wrote itself, retry empty. */
+        Warm = false;
+        LoadedBytes = 0;
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        if (vkCreatePipelineCache(Device, &cacheInfo, nullptr, &Cache) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VulkanPipelineCache::Create: vkCreatePipelineCache failed\n");
+            Cache = VK_NULL_HANDLE;
+            DeviceHandle = VK_NULL_HANDLE;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void VulkanPipelineCache::Destroy()
+{
+    if (Cache == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    /* Keep what this run compiled for the next startup. */
+    EndStartup();
+    Save();
+
+    vkDestroyPipelineCache(DeviceHandle, Cache, nullptr);
+    Cache = VK_NULL_HANDLE;
+    DeviceHandle = VK_NULL_HANDLE;
+}
+
+bool VulkanPipelineCache::Save()
+{
+    if (Cache == VK_NULL_HANDLE || FilePath.empty())
+    {
+        return false;
+    }
+
+    std::size_t dataSize = 0;
+    if (vkGetPipelineCacheData(DeviceHandle, Cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+    {
+        std::fprintf(stderr, "VulkanPipelineCache::Save: vkGetPipelineCacheData (size) failed\n");
+        return false;
+    }
+
+    std::vector<std::uint8_t> data(dataSize);
+    if (vkGetPipelineCacheData(DeviceHandle, Cache, &dataSize, data.data()) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanPipelineCache::Save: vkGetPipelineCacheData failed\n");
+        return false;
+    }
+
+    data.resize(dataSize);
+
+    CacheFileHeader header{};
+    header.Magic = kFileMagic;
+    header.Version = kFileVersion;
+    header.VendorID = DeviceProperties.vendorID;
+    header.DeviceID = DeviceProperties.deviceID;
+    header.DriverVersion = DeviceProperties.driverVersion;
+    std::memcpy(header.PipelineCacheUUID, DeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+    header.DataSize = data.size();
+    header.Checksum = HashBytes(data.data(), data.size());
+
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        header.ColdMilliseconds = ColdMilliseconds;
+        header.ColdPipelineCount = ColdPipelineCount;
+    }
+
+    std::error_code error;
+    const std::filesystem::path path(FilePath);
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    std::ofstream file(FilePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::fprintf(stderr, "VulkanPipelineCache::Save: Failed to open %s\n", FilePath.c_str());
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    if (!file.good())
+    {
+        std::fprintf(stderr, "VulkanPipelineCache::Save: Failed to write %s\n", FilePath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+VkResult VulkanPipelineCache::CreateGraphicsPipelines(
+    VkDevice Device,
+    std::uint32_t Count,
+    const VkGraphicsPipelineCreateInfo* Infos,
+    VkPipeline* OutPipelines)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const VkResult result = vkCreateGraphicsPipelines(Device, Cache, Count, Infos, nullptr, OutPipelines);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    RecordCreation(Count, elapsed.count());
+    return result;
+}
+
+VkResult VulkanPipelineCache::CreateComputePipelines(
+    VkDevice Device,
+    std::uint32_t Count,
+    const VkComputePipelineCreateInfo* Infos,
+    VkPipeline* OutPipelines)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const VkResult result = vkCreateComputePipelines(Device, Cache, Count, Infos, nullptr, OutPipelines);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    RecordCreation(Count, elapsed.count());
+    return result;
+}
+
+void VulkanPipelineCache::EndStartup()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    StartupClosing = true;
+    if (StartupOpen && BackgroundCompiles == 0)
+    {
+        CloseStartup();
+    }
+}
+
+void VulkanPipelineCache::BeginBackgroundCompile()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    ++BackgroundCompiles;
+}
+
+void VulkanPipelineCache::EndBackgroundCompile()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (BackgroundCompiles > 0)
+    {
+        --BackgroundCompiles;
+    }
+
+    /* The last startup worker closes a window EndStartup left open. */
+    if (StartupOpen && StartupClosing && BackgroundCompiles == 0)
+    {
+        CloseStartup();
+    }
+}
+
+void VulkanPipelineCache::CloseStartup()
+{
+    StartupOpen = false;
+    StartupMilliseconds = CreationMilliseconds;
+
+    /* A cold start is the baseline later warm starts are measured against. */
+    if (!Warm)
+    {
+        ColdMilliseconds = StartupMilliseconds;
+        ColdPipelineCount = PipelineCount;
+    }
+}
+
+VkPipelineCache VulkanPipelineCache::GetHandle() const
+{
+    return Cache;
+}
+
+VulkanPipelineCacheStats VulkanPipelineCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    VulkanPipelineCacheStats stats;
+    stats.Warm = Warm;
+    stats.LoadedBytes = LoadedBytes;
+    stats.PipelineCount = PipelineCount;
+    stats.StartupMilliseconds = StartupOpen ? CreationMilliseconds : StartupMilliseconds;
+    stats.ColdMilliseconds = ColdMilliseconds;
+    stats.StartupComplete = !StartupOpen;
+
+    /* Only compare like with like: the same pipeline set, built warm. */
+    if (Warm && !StartupOpen && ColdPipelineCount == PipelineCount)
+    {
+        stats.SavedMilliseconds = std::max(0.0, ColdMilliseconds - StartupMilliseconds);
+    }
+
+    return stats;
+}
+
+bool VulkanPipelineCache::ReadCacheFile(std::vector<std::uint8_t>& OutData)
+{
+    OutData.clear();
+    if (FilePath.empty())
+    {
+        return false;
+    }
+
+    std::ifstream file(FilePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    CacheFileHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file.good() || header.Magic != kFileMagic || header.Version != kFileVersion)
+    {
+        std::fprintf(stderr, "VulkanPipelineCache::Create: Ignoring %s (unknown format)\n", FilePath.c_str());
+        return false;
+    }
+
+    /* Drivers only promise to reuse data from the same device and version. */
+    if (header.VendorID != DeviceProperties.vendorID ||
+        header.DeviceID != DeviceProperties.deviceID ||
+        header.DriverVersion != DeviceProperties.driverVersion ||
+        std::memcmp(header.PipelineCacheUUID, DeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        std::fprintf(stderr, "VulkanPipelineCache::Create: Ignoring %s (device or driver changed)\n", FilePath.c_str());
+        return false;
+    }
+
+    if (header.DataSize < kDriverHeaderSize || header.DataSize > (std::uint64_t(1) << 31))
+    {
+        std::fprintf(stderr, "VulkanPipelineCache::Create: Ignoring %s (bad size)\n", FilePath.c_str());
+        return false;
+    }
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(header.DataSize));
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file.good() || HashBytes(data.data(), data.size()) != header.Checksum)
+    {
+        std::fprintf(stderr, "VulkanPipelineCache::Create: Ignoring %s (damaged)\n", FilePath.c_str());
+        return false;
+    }
+
+    /* The driver blob carries its own header, check it agrees as well. */
+    const std::uint32_t driverHeaderSize = ReadU32(data.data());
+    const std::uint32_t driverHeaderVersion = ReadU32(data.data() + 4);
+    if (driverHeaderSize < kDriverHeaderSize ||
+        driverHeaderSize > data.size() ||
+        driverHeaderVersion != static_cast<std::uint32_t>(VK_PIPELINE_CACHE_HEADER_VERSION_ONE) ||
+        ReadU32(data.data() + 8) != DeviceProperties.vendorID ||
+        ReadU32(data.data() + 12) != DeviceProperties.deviceID ||
+        std::memcmp(data.data() + 16, DeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        std::fprintf(stderr, "VulkanPipelineCache::Create: Ignoring %s (driver header mismatch)\n", FilePath.c_str());
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        ColdMilliseconds = header.ColdMilliseconds;
+        ColdPipelineCount = header.ColdPipelineCount;
+    }
+
+    OutData = std::move(data);
+    return true;
+}
+
+void VulkanPipelineCache::RecordCreation(std::uint32_t Count, double Milliseconds)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    PipelineCount += Count;
+    CreationMilliseconds += Milliseconds;
+}
@@ -0,0 +1,146 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* Snapshot of pipeline cache usage, reported by the overlay. */
+struct VulkanPipelineCacheStats
+{
+    /* True when a valid cache file for this device was loaded. */
+    bool Warm = false;
+
+    /* Bytes of driver cache data accepted from disk. */
+    std::size_t LoadedBytes = 0;
+
+    /* Pipelines created through the cache so far. */
+    std::uint32_t PipelineCount = 0;
+
+    /* Time spent creating pipelines during startup, and the same figure */
+    /* measured on the last cold start of this device and driver. */
+    double StartupMilliseconds = 0.0;
+    double ColdMilliseconds = 0.0;
+
+    /* Cold minus startup time on a warm start, 0 otherwise. */
+    double SavedMilliseconds = 0.0;
+
+    /* False while startup pipelines are still compiling in the background. */
+    bool StartupComplete = false;
+};
+
+/* Persistent VkPipelineCache shared by every pipeline. */
+/* The file carries the device vendor, id, driver version and cache UUID */
+/* ahead of the driver blob; anything that does not match the running */
+/* device, or fails its checksum, is dropped and the cache starts empty. */
+/* Pipeline creation goes through the wrappers below so startup time can */
+/* be compared against the last cold start. */
+class VulkanPipelineCache
+{
+public:
+    /* Initialize empty cache state. */
+    VulkanPipelineCache();
+
+    /* Release cache resources. */
+    ~VulkanPipelineCache();
+
+    /* Create the cache, seeded from Path when it holds data for this device. */
+    bool Create(VkPhysicalDevice PhysicalDevice, VkDevice Device, const std::string& Path);
+
+    /* Write the cache back to disk and destroy it. */
+    void Destroy();
+
+    /* Write the current cache contents to the file given to Create. */
+    bool Save();
+
+    /* vkCreateGraphicsPipelines/vkCreateComputePipelines against the cache, timed. */
+    VkResult CreateGraphicsPipelines(
+        VkDevice Device,
+        std::uint32_t Count,
+        const VkGraphicsPipelineCreateInfo* Infos,
+        VkPipeline* OutPipelines);
+
+    VkResult CreateComputePipelines(
+        VkDevice Device,
+        std::uint32_t Count,
+        const VkComputePipelineCreateInfo* Infos,
+        VkPipeline* OutPipelines);
+
+    /* Close the startup window, creation time after this is not reported. */
+    /* Background compiles started before the call still count toward it. */
+    void EndStartup();
+
+    /* Bracket pipeline work running on a worker thread. */
+    void BeginBackgroundCompile();
+    void EndBackgroundCompile();
+
+    /* Cache handle, VK_NULL_HANDLE before Create. */
+    VkPipelineCache GetHandle() const;
+
+    /* Current usage figures. */
+    VulkanPipelineCacheStats GetStats() const;
+
+private:
+    /* Parse a cache file, false when it does not belong to this device. */
+    bool ReadCacheFile(std::vector<std::uint8_t>& OutData);
+
+    /* Add one creation call to the running totals. */
+    void RecordCreation(std::uint32_t Count, double Milliseconds);
+
+    /* Snapshot startup figures, caller holds the mutex. */
+    void CloseStartup();
+
+private:
+    VkDevice DeviceHandle;
+    VkPipelineCache Cache;
+    std::string FilePath;
+
+    /* Identity of the device the cache belongs to. */
+    VkPhysicalDeviceProperties DeviceProperties;
+
+    bool Warm;
+    bool StartupOpen;
+    bool StartupClosing;
+    std::uint32_t BackgroundCompiles;
+    std::size_t LoadedBytes;
+    std::uint32_t PipelineCount;
+    double CreationMilliseconds;
+    double StartupMilliseconds;
+    double ColdMilliseconds;
+    std::uint32_t ColdPipelineCount;
+
+    /* Guards the timing totals, creation may run on worker threads. */
+    mutable std::mutex Mutex;
+};
+
+/* Pipeline cache shared by every pipeline, created with VulkanDevice. */
+extern VulkanPipelineCache g_VulkanPipelineCache;
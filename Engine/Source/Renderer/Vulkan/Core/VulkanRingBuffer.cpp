@@ -0,0 +1,320 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "VulkanRingBuffer.h"
+#include "VulkanMemoryAllocator.h"
+
+#include <cstdio>
+
+VulkanRingBuffer::VulkanRingBuffer()
+    : DeviceHandle(VK_NULL_HANDLE)
+    , BufferUsage(0)
+    , Head(0)
+    , FrameIndex(0)
+    , FrameCounter(0)
+{
+}
+
+VulkanRingBuffer::~VulkanRingBuffer()
+{
+    Destroy(DeviceHandle);
+}
+
+bool VulkanRingBuffer::Create(
+    VkDevice Device,
+    VkDeviceSize Capacity,
+    VkBufferUsageFlags Usage,
+    std::uint32_t FrameCount)
+{
+    Destroy(Device);
+
+    DeviceHandle = Device;
+    BufferUsage = Usage;
+    Regions.assign(FrameCount > 0 ? FrameCount : 1, FrameRegion{});
+    Head = 0;
+    FrameIndex = 0;
+    FrameCounter = 0;
+
+    if (!CreateBlock(Capacity, Current))
+    {
+        std::fprintf(stderr, "VulkanRingBuffer::Create: block creation failed\n");
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanRingBuffer::Destroy(VkDevice Device)
+{
+    VkDevice activeDevice = Device != VK_NULL_HANDLE ? Device : DeviceHandle;
+    if (activeDevice == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    DestroyBlock(Current);
+    for (RetiredBlock& retired : Retired)
+    {
+        DestroyBlock(retired.Storage);
+    }
+    Retired.clear();
+    Regions.clear();
+
+    Head = 0;
+    DeviceHandle = VK_NULL_HANDLE;
+}
+
+void VulkanRingBuffer::BeginFrame(std::uint32_t FrameIndex)
+{
+    if (Regions.empty())
+    {
+        return;
+    }
+
+    this->FrameIndex = FrameIndex % static_cast<std::uint32_t>(Regions.size());
+    ++FrameCounter;
+
+    /* The caller waited on this slot's fence, so its old region is free. */
+    Regions[this->FrameIndex].Used = false;
+
+    /* Outgrown blocks go once the last frame that used them has retired. */
+    for (std::size_t index = 0; index < Retired.size();)
+    {
+        if (Retired[index].ReleaseFrame <= FrameCounter)
+        {
+            DestroyBlock(Retired[index].Storage);
+            Retired[index] = Retired.back();
+            Retired.pop_back();
+        }
+        else
+        {
+            ++index;
+        }
+    }
+
+    /* With nothing in flight the ring restarts at the front. */
+    VkDeviceSize tail = 0;
+    if (!FindTail(tail))
+    {
+        Head = 0;
+    }
+}
+
+bool VulkanRingBuffer::Allocate(
+    VkDeviceSize Size,
+    VkDeviceSize Alignment,
+    RingAllocation& OutAllocation)
+{
+    if (Current.Buffer == VK_NULL_HANDLE || Regions.empty() || Size == 0)
+    {
+        return false;
+    }
+
+    const VkDeviceSize alignment = Alignment > 0 ? Alignment : 1;
+
+    /* Second pass runs after growing into an empty block. */
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        VkDeviceSize tail = 0;
+        const bool inFlight = FindTail(tail);
+        VkDeviceSize offset = AlignUp(Head, alignment);
+        bool fits = false;
+
+        if (!inFlight)
+        {
+            if (offset + Size > Current.Capacity)
+            {
+                offset = 0;
+            }
+            fits = offset + Size <= Current.Capacity;
+        }
+        else if (Head >= tail)
+        {
+            /* Free space is the end of the block, then the front up to tail. */
+            if (offset + Size > Current.Capacity)
+            {
+                offset = 0;
+                fits = Size < tail;
+            }
+            else
+            {
+                fits = true;
+            }
+        }
+        else
+        {
+            /* Wrapped: free space ends just before the oldest region. */
+            fits = offset + Size < tail;
+        }
+
+        if (fits)
+        {
+            FrameRegion& region = Regions[FrameIndex];
+            if (!region.Used)
+            {
+                region.Used = true;
+                region.Begin = offset;
+            }
+
+            Head = offset + Size;
+
+            OutAllocation.Buffer = Current.Buffer;
+            OutAllocation.Offset = offset;
+            OutAllocation.Mapped = static_cast<std::uint8_t*>(Current.Mapped) + offset;
+            return true;
+        }
+
+        if (!Grow(Size + alignment))
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+VkBuffer VulkanRingBuffer::GetBuffer() const
+{
+    return Current.Buffer;
+}
+
+VkDeviceSize VulkanRingBuffer::GetCapacity() const
+{
+    return Current.Capacity;
+}
+
+bool VulkanRingBuffer::IsDeviceLocal() const
+{
+    return Current.DeviceLocal;
+}
+
+bool VulkanRingBuffer::CreateBlock(VkDeviceSize Capacity, Block& OutBlock)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = Capacity;
+    bufferInfo.usage = BufferUsage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    if (vkCreateBuffer(DeviceHandle, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanRingBuffer::CreateBlock: vkCreateBuffer failed\n");
+        return false;
+    }
+
+    VkMemoryRequirements memRequirements{};
+    vkGetBufferMemoryRequirements(DeviceHandle, buffer, &memRequirements);
+
+    /* ReBAR and UMA expose device-local memory the CPU can write directly; */
+    /* the BAR heap may be small, so fall back to system memory on failure. */
+    /* Host-visible allocations come back mapped for their whole lifetime. */
+    const VkMemoryPropertyFlags hostFlags =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    const VkMemoryPropertyFlags localFlags = hostFlags | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    VulkanAllocation allocation{};
+    bool deviceLocal = false;
+
+    if (g_VulkanAllocator.FindMemoryType(memRequirements.memoryTypeBits, localFlags) != UINT32_MAX &&
+        g_VulkanAllocator.Allocate(memRequirements, localFlags, true, false, allocation))
+    {
+        deviceLocal = true;
+    }
+    else if (!g_VulkanAllocator.Allocate(memRequirements, hostFlags, true, false, allocation))
+    {
+        std::fprintf(stderr, "VulkanRingBuffer::CreateBlock: Allocate failed\n");
+        vkDestroyBuffer(DeviceHandle, buffer, nullptr);
+        return false;
+    }
+
+    if (vkBindBufferMemory(DeviceHandle, buffer, allocation.Memory, allocation.Offset) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanRingBuffer::CreateBlock: vkBindBufferMemory failed\n");
+        g_VulkanAllocator.DestroyBuffer(buffer, allocation);
+        return false;
+    }
+
+    OutBlock.Buffer = buffer;
+    OutBlock.Allocation = allocation;
+    OutBlock.Mapped = allocation.Mapped;
+    OutBlock.Capacity = Capacity;
+    OutBlock.DeviceLocal = deviceLocal;
+    return true;
+}
+
+void VulkanRingBuffer::DestroyBlock(Block& Storage)
+{
+    g_VulkanAllocator.DestroyBuffer(Storage.Buffer, Storage.Allocation);
+    Storage = Block{};
+}
+
+bool VulkanRingBuffer::Grow(VkDeviceSize MinCapacity)
+{
+    VkDeviceSize capacity = Current.Capacity > 0 ? Current.Capacity * 2 : MinCapacity;
+    while (capacity < MinCapacity)
+    {
+        capacity *= 2;
+    }
+
+    Block grown{};
+    if (!CreateBlock(capacity, grown))
+    {
+        return false;
+    }
+
+    /* Frames up to this one may still read the old block. */
+    RetiredBlock retired{};
+    retired.Storage = Current;
+    retired.ReleaseFrame = FrameCounter + Regions.size();
+    Retired.push_back(retired);
+
+    /* Earlier allocations stay in the old block, so the new one starts empty. */
+    Current = grown;
+    for (FrameRegion& region : Regions)
+    {
+        region.Used = false;
+    }
+    Head = 0;
+    return true;
+}
+
+bool VulkanRingBuffer::FindTail(VkDeviceSize& OutTail) const
+{
+    /* Slots after the current one are older, oldest first. */
+    const std::size_t count = Regions.size();
+    for (std::size_t step = 1; step <= count; ++step)
+    {
+        const FrameRegion& region = Regions[(FrameIndex + step) % count];
+        if (region.Used)
+        {
+            OutTail = region.Begin;
+            return true;
+        }
+    }
+
+    return false;
+}
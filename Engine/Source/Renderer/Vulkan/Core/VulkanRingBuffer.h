@@ -0,0 +1,126 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "VulkanMemoryAllocator.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+/* Sub-range handed out by VulkanRingBuffer, valid for the current frame. */
+struct RingAllocation
+{
+    VkBuffer Buffer = VK_NULL_HANDLE;
+    VkDeviceSize Offset = 0;
+    void* Mapped = nullptr;
+};
+
+/* Linear ring allocator over one persistently mapped buffer. */
+/* A frame's allocations form one region tagged with its frame slot, */
+/* reclaimed when that slot begins again (its fence has been waited). */
+/* Running out grows the buffer geometrically; the old buffer is only */
+/* released once every frame that could still read it has retired. */
+class VulkanRingBuffer
+{
+public:
+    /* Initialize empty ring state. */
+    VulkanRingBuffer();
+
+    /* Release ring resources. */
+    ~VulkanRingBuffer();
+
+    /* Create the first block; prefers device-local host-visible memory. */
+    bool Create(
+        VkDevice Device,
+        VkDeviceSize Capacity,
+        VkBufferUsageFlags Usage,
+        std::uint32_t FrameCount);
+
+    /* Destroy the current and retired blocks. */
+    void Destroy(VkDevice Device);
+
+    /* Reclaim the region of a frame slot after its fence was waited. */
+    void BeginFrame(std::uint32_t FrameIndex);
+
+    /* Reserve Size bytes at an Alignment multiple, growing if needed. */
+    bool Allocate(VkDeviceSize Size, VkDeviceSize Alignment, RingAllocation& OutAllocation);
+
+    /* Current block state. */
+    VkBuffer GetBuffer() const;
+    VkDeviceSize GetCapacity() const;
+
+    /* True when the block lives in device-local memory (ReBAR or UMA). */
+    bool IsDeviceLocal() const;
+
+private:
+    /* One buffer with its memory, mapped for its lifetime. */
+    struct Block
+    {
+        VkBuffer Buffer = VK_NULL_HANDLE;
+        VulkanAllocation Allocation;
+        void* Mapped = nullptr;
+        VkDeviceSize Capacity = 0;
+        bool DeviceLocal = false;
+    };
+
+    /* Outgrown block and the frame from which no frame can read it. */
+    struct RetiredBlock
+    {
+        Block Storage;
+        std::uint64_t ReleaseFrame = 0;
+    };
+
+    /* Ring span written by one frame slot, Begin may lie past End once wrapped. */
+    struct FrameRegion
+    {
+        VkDeviceSize Begin = 0;
+        bool Used = false;
+    };
+
+    bool CreateBlock(VkDeviceSize Capacity, Block& OutBlock);
+    void DestroyBlock(Block& Storage);
+
+    /* Replace the current block with one holding at least MinCapacity. */
+    bool Grow(VkDeviceSize MinCapacity);
+
+    /* Start of the oldest region still in flight, false when none is. */
+    bool FindTail(VkDeviceSize& OutTail) const;
+
+private:
+    VkDevice DeviceHandle;
+    VkBufferUsageFlags BufferUsage;
+
+    Block Current;
+    std::vector<RetiredBlock> Retired;
+    std::vector<FrameRegion> Regions;
+
+    VkDeviceSize Head;
+    std::uint32_t FrameIndex;
+    std::uint64_t FrameCounter;
+};
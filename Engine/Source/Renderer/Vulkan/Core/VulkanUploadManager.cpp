@@ -0,0 +1,778 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "VulkanUploadManager.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+VulkanUploadManager g_VulkanUploader;
+
+namespace
+{
+    /* Shared staging ring size, larger uploads get one-off staging. */
+    const VkDeviceSize kStagingCapacity = 32 * 1024 * 1024;
+
+    /* Covers texel size and the 4-byte rule for buffer-to-image copies. */
+    const VkDeviceSize kStagingAlignment = 16;
+
+    bool CreateCommandPool(VkDevice Device, std::uint32_t QueueFamily, VkCommandPool& OutPool)
+    {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags =
+            VK_COMMAND_POOL_CREATE_TRANSIENT_BIT |
+            VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = QueueFamily;
+
+        return vkCreateCommandPool(Device, &poolInfo, nullptr, &OutPool) == VK_SUCCESS;
+    }
+}
+
+VulkanUploadManager::VulkanUploadManager()
+    : DeviceHandle(VK_NULL_HANDLE)
+    , GraphicsQueue(VK_NULL_HANDLE)
+    , TransferQueue(VK_NULL_HANDLE)
+    , GraphicsFamily(UINT32_MAX)
+    , TransferFamily(UINT32_MAX)
+    , TransferPool(VK_NULL_HANDLE)
+    , AcquirePool(VK_NULL_HANDLE)
+    , StagingBuffer(VK_NULL_HANDLE)
+    , StagingCapacity(0)
+    , StagingHead(0)
+    , StagingUsed(0)
+    , OpenActive(false)
+    , NextToken(1)
+    , CompletedToken(0)
+{
+    /* Initialize to null state. */
+}
+
+VulkanUploadManager::~VulkanUploadManager()
+{
+    /* Resources are destroyed by VulkanDevice via Destroy(). */
+}
+
+bool VulkanUploadManager::Create(
+    VkDevice Device,
+    VkQueue InGraphicsQueue,
+    std::uint32_t GraphicsQueueFamily,
+    VkQueue InTransferQueue,
+    std::uint32_t TransferQueueFamily)
+{
+    Destroy();
+
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    DeviceHandle = Device;
+    GraphicsQueue = InGraphicsQueue;
+    GraphicsFamily = GraphicsQueueFamily;
+    TransferQueue = InTransferQueue != VK_NULL_HANDLE ? InTransferQueue : InGraphicsQueue;
+    TransferFamily = InTransferQueue != VK_NULL_HANDLE ? TransferQueueFamily : GraphicsQueueFamily;
+
+    if (!CreateCommandPool(Device, TransferFamily, TransferPool))
+    {
+        std::fprintf(stderr, "VulkanUploadManager::Create: vkCreateCommandPool (transfer) failed\n");
+        return false;
+    }
+
+    if (TransferFamily != GraphicsFamily && !CreateCommandPool(Device, GraphicsFamily, AcquirePool))
+    {
+        std::fprintf(stderr, "VulkanUploadManager::Create: vkCreateCommandPool (acquire) failed\n");
+        return false;
+    }
+
+    if (!g_VulkanAllocator.CreateBuffer(
+        kStagingCapacity,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        StagingBuffer,
+        StagingAllocation))
+    {
+        std::fprintf(stderr, "VulkanUploadManager::Create: staging ring allocation failed\n");
+        return false;
+    }
+
+    StagingCapacity = kStagingCapacity;
+    StagingHead = 0;
+    StagingUsed = 0;
+    return true;
+}
+
+void VulkanUploadManager::Destroy()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    if (DeviceHandle == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    /* Submit whatever is recorded so every batch retires through its fence. */
+    if (OpenActive && Open.CopyCount > 0)
+    {
+        SubmitBatch();
+    }
+
+    while (!InFlight.empty())
+    {
+        RetireBatches(true);
+    }
+
+    if (OpenActive)
+    {
+        ReleaseLargeStaging(Open);
+        FreeBatches.push_back(std::move(Open));
+        Open = UploadBatch{};
+        OpenActive = false;
+    }
+
+    for (UploadBatch& batch : FreeBatches)
+    {
+        if (batch.Fence != VK_NULL_HANDLE)
+        {
+            vkDestroyFence(DeviceHandle, batch.Fence, nullptr);
+        }
+
+        if (batch.TransferDone != VK_NULL_HANDLE)
+        {
+            vkDestroySemaphore(DeviceHandle, batch.TransferDone, nullptr);
+        }
+    }
+
+    FreeBatches.clear();
+
+    /* Destroying the pools frees their command buffers. */
+    if (TransferPool != VK_NULL_HANDLE)
+    {
+        vkDestroyCommandPool(DeviceHandle, TransferPool, nullptr);
+        TransferPool = VK_NULL_HANDLE;
+    }
+
+    if (AcquirePool != VK_NULL_HANDLE)
+    {
+        vkDestroyCommandPool(DeviceHandle, AcquirePool, nullptr);
+        AcquirePool = VK_NULL_HANDLE;
+    }
+
+    g_VulkanAllocator.DestroyBuffer(StagingBuffer, StagingAllocation);
+
+    StagingCapacity = 0;
+    StagingHead = 0;
+    StagingUsed = 0;
+    DeviceHandle = VK_NULL_HANDLE;
+    GraphicsQueue = VK_NULL_HANDLE;
+    TransferQueue = VK_NULL_HANDLE;
+    GraphicsFamily = UINT32_MAX;
+    TransferFamily = UINT32_MAX;
+}
+
+UploadToken VulkanUploadManager::UploadBuffer(
+    VkBuffer DstBuffer,
+    VkDeviceSize DstOffset,
+    const void* Data,
+    VkDeviceSize Size,
+    VkPipelineStageFlags DstStage,
+    VkAccessFlags DstAccess)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    if (DeviceHandle == VK_NULL_HANDLE || DstBuffer == VK_NULL_HANDLE || Size == 0)
+    {
+        return 0;
+    }
+
+    VkBuffer srcBuffer = VK_NULL_HANDLE;
+    VkDeviceSize srcOffset = 0;
+    void* mapped = nullptr;
+    if (!AllocateStaging(Size, srcBuffer, srcOffset, mapped))
+    {
+        std::fprintf(stderr, "VulkanUploadManager::UploadBuffer: staging allocation failed\n");
+        return 0;
+    }
+
+    std::memcpy(mapped, Data, static_cast<std::size_t>(Size));
+
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = srcOffset;
+    copyRegion.dstOffset = DstOffset;
+    copyRegion.size = Size;
+    vkCmdCopyBuffer(Open.TransferCommands, srcBuffer, DstBuffer, 1, &copyRegion);
+
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = DstAccess;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = DstBuffer;
+    barrier.offset = DstOffset;
+    barrier.size = Size;
+
+    if (TransferFamily == GraphicsFamily)
+    {
+        vkCmdPipelineBarrier(
+            Open.TransferCommands,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            DstStage,
+            0,
+            0, nullptr,
+            1, &barrier,
+            0, nullptr);
+    }
+    else
+    {
+        /* Release on the transfer queue, acquire on the graphics queue. */
+        barrier.srcQueueFamilyIndex = TransferFamily;
+        barrier.dstQueueFamilyIndex = GraphicsFamily;
+        barrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(
+            Open.TransferCommands,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0, nullptr,
+            1, &barrier,
+            0, nullptr);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = DstAccess;
+        vkCmdPipelineBarrier(
+            Open.AcquireCommands,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            DstStage,
+            0,
+            0, nullptr,
+            1, &barrier,
+            0, nullptr);
+    }
+
+    ++Open.CopyCount;
+    return Open.Token;
+}
+
+UploadToken VulkanUploadManager::UploadImage(
+    VkImage DstImage,
+    const void* Data,
+    VkDeviceSize Size,
+    std::uint32_t Width,
+    std::uint32_t Height,
+    std::uint32_t LayerCount)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    if (DeviceHandle == VK_NULL_HANDLE || DstImage == VK_NULL_HANDLE || Size == 0)
+    {
+        return 0;
+    }
+
+    VkBuffer srcBuffer = VK_NULL_HANDLE;
+    VkDeviceSize srcOffset = 0;
+    void* mapped = nullptr;
+    if (!AllocateStaging(Size, srcBuffer, srcOffset, mapped))
+    {
+        std::fprintf(stderr, "VulkanUploadManager::UploadImage: staging allocation failed\n");
+        return 0;
+    }
+
+    std::memcpy(mapped, Data, static_cast<std::size_t>(Size));
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = DstImage;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = LayerCount;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(
+        Open.TransferCommands,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0, nullptr,
+        0, nullptr,
+        1, &barrier);
+
+    /* Layers are packed back to back, one region covers them all. */
+    VkBufferImageCopy region{};
+    region.bufferOffset = srcOffset;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = LayerCount;
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = { Width, Height, 1 };
+
+    vkCmdCopyBufferToImage(
+        Open.TransferCommands,
+        srcBuffer,
+        DstImage,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &region);
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    if (TransferFamily == GraphicsFamily)
+    {
+        vkCmdPipelineBarrier(
+            Open.TransferCommands,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+    }
+    else
+    {
+        /* The layout change is part of the release/acquire pair, */
+        /* both barriers must describe it identically. */
+        barrier.srcQueueFamilyIndex = TransferFamily;
+        barrier.dstQueueFamilyIndex = GraphicsFamily;
+        barrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(
+            Open.TransferCommands,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(
+            Open.AcquireCommands,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+    }
+
+    ++Open.CopyCount;
+    return Open.Token;
+}
+
+UploadToken VulkanUploadManager::Flush()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    if (DeviceHandle == VK_NULL_HANDLE)
+    {
+        return 0;
+    }
+
+    RetireBatches(false);
+
+    if (!OpenActive || Open.CopyCount == 0)
+    {
+        return 0;
+    }
+
+    const UploadToken token = Open.Token;
+    return SubmitBatch() ? token : 0;
+}
+
+void VulkanUploadManager::Wait(UploadToken Token)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    if (Token <= CompletedToken || DeviceHandle == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    if (OpenActive && Open.Token == Token && Open.CopyCount > 0)
+    {
+        SubmitBatch();
+    }
+
+    while (CompletedToken < Token && !InFlight.empty())
+    {
+        RetireBatches(true);
+    }
+}
+
+bool VulkanUploadManager::BeginBatch()
+{
+    if (OpenActive)
+    {
+        return true;
+    }
+
+    UploadBatch batch;
+    if (!FreeBatches.empty())
+    {
+        batch = std::move(FreeBatches.back());
+        FreeBatches.pop_back();
+    }
+    else if (!CreateBatchObjects(batch))
+    {
+        return false;
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    /* Pools allow per-buffer reset, so begin resets recycled buffers. */
+    if (vkBeginCommandBuffer(batch.TransferCommands, &beginInfo) != VK_SUCCESS ||
+        (batch.AcquireCommands != VK_NULL_HANDLE &&
+            vkBeginCommandBuffer(batch.AcquireCommands, &beginInfo) != VK_SUCCESS))
+    {
+        std::fprintf(stderr, "VulkanUploadManager::BeginBatch: vkBeginCommandBuffer failed\n");
+        FreeBatches.push_back(std::move(batch));
+        return false;
+    }
+
+    batch.Token = NextToken++;
+    batch.CopyCount = 0;
+    batch.StagingBytes = 0;
+    batch.StagingStart = StagingHead;
+
+    Open = std::move(batch);
+    OpenActive = true;
+    return true;
+}
+
+bool VulkanUploadManager::AllocateStaging(
+    VkDeviceSize Size,
+    VkBuffer& OutBuffer,
+    VkDeviceSize& OutOffset,
+    void*& OutMapped)
+{
+    RetireBatches(false);
+
+    /* Too big for the ring: stage through memory owned by the batch. */
+    if (Size > StagingCapacity)
+    {
+        if (!BeginBatch())
+        {
+            return false;
+        }
+
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VulkanAllocation allocation;
+        if (!g_VulkanAllocator.CreateBuffer(
+            Size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            buffer,
+            allocation))
+        {
+            return false;
+        }
+
+        OutBuffer = buffer;
+        OutOffset = 0;
+        OutMapped = allocation.Mapped;
+        Open.LargeBuffers.push_back(buffer);
+        Open.LargeAllocations.push_back(allocation);
+        return true;
+    }
+
+    for (;;)
+    {
+        if (!BeginBatch())
+        {
+            return false;
+        }
+
+        /* Free space runs from the head up to the oldest in-flight batch. */
+        if (StagingUsed == 0)
+        {
+            StagingHead = 0;
+        }
+
+        VkDeviceSize offset = AlignUp(StagingHead, kStagingAlignment);
+        VkDeviceSize padding = offset - StagingHead;
+        if (offset + Size > StagingCapacity)
+        {
+            /* Skip the tail end and wrap to the start. */
+            padding = StagingCapacity - StagingHead;
+            offset = 0;
+        }
+
+        const VkDeviceSize needed = padding + Size;
+        if (StagingUsed + needed <= StagingCapacity)
+        {
+            StagingHead = offset + Size;
+            StagingUsed += needed;
+            Open.StagingBytes += needed;
+
+            OutBuffer = StagingBuffer;
+            OutOffset = offset;
+            OutMapped = static_cast<char*>(StagingAllocation.Mapped) + offset;
+            return true;
+        }
+
+        /* Ring is full: send what is recorded, then wait for the oldest batch. */
+        if (Open.CopyCount > 0)
+        {
+            if (!SubmitBatch())
+            {
+                return false;
+            }
+            continue;
+        }
+
+        if (InFlight.empty())
+        {
+            return false;
+        }
+
+        RetireBatches(true);
+    }
+}
+
+bool VulkanUploadManager::SubmitBatch()
+{
+    if (!OpenActive)
+    {
+        return true;
+    }
+
+    /* Set once the transfer half is queued, so a failed acquire can drain it. */
+    bool transferQueued = false;
+    bool submitted = false;
+
+    VkSubmitInfo transferSubmit{};
+    transferSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    transferSubmit.commandBufferCount = 1;
+    transferSubmit.pCommandBuffers = &Open.TransferCommands;
+
+    if (vkEndCommandBuffer(Open.TransferCommands) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanUploadManager::SubmitBatch: vkEndCommandBuffer failed\n");
+    }
+    else if (TransferFamily == GraphicsFamily)
+    {
+        submitted = vkQueueSubmit(TransferQueue, 1, &transferSubmit, Open.Fence) == VK_SUCCESS;
+        if (!submitted)
+        {
+            std::fprintf(stderr, "VulkanUploadManager::SubmitBatch: vkQueueSubmit failed\n");
+        }
+    }
+    else if (vkEndCommandBuffer(Open.AcquireCommands) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanUploadManager::SubmitBatch: vkEndCommandBuffer (acquire) failed\n");
+    }
+    else
+    {
+        transferSubmit.signalSemaphoreCount = 1;
+        transferSubmit.pSignalSemaphores = &Open.TransferDone;
+        transferQueued = vkQueueSubmit(TransferQueue, 1, &transferSubmit, VK_NULL_HANDLE) == VK_SUCCESS;
+        if (!transferQueued)
+        {
+            std::fprintf(stderr, "VulkanUploadManager::SubmitBatch: vkQueueSubmit (transfer) failed\n");
+        }
+        else
+        {
+            /* Queued ahead of the next frame, whose commands the acquire */
+            /* barriers already order against. */
+            const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+            VkSubmitInfo acquireSubmit{};
+            acquireSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            acquireSubmit.waitSemaphoreCount = 1;
+            acquireSubmit.pWaitSemaphores = &Open.TransferDone;
+            acquireSubmit.pWaitDstStageMask = &waitStage;
+            acquireSubmit.commandBufferCount = 1;
+            acquireSubmit.pCommandBuffers = &Open.AcquireCommands;
+            submitted = vkQueueSubmit(GraphicsQueue, 1, &acquireSubmit, Open.Fence) == VK_SUCCESS;
+            if (!submitted)
+            {
+                std::fprintf(stderr, "VulkanUploadManager::SubmitBatch: vkQueueSubmit (acquire) failed\n");
+            }
+        }
+    }
+
+    if (submitted)
+    {
+        InFlight.push_back(std::move(Open));
+        Open = UploadBatch{};
+        OpenActive = false;
+        return true;
+    }
+
+    /* The fence will never signal, so the batch is dropped rather than */
+    /* left in flight: its copies are lost and its staging returns to the */
+    /* ring. It was the newest allocation, so the head rolls back over it. */
+    StagingHead = Open.StagingStart;
+    StagingUsed -= Open.StagingBytes;
+
+    /* A queued transfer still signals TransferDone; once the queue drains */
+    /* the semaphore is replaced, since nothing will ever wait on it. */
+    if (transferQueued)
+    {
+        vkQueueWaitIdle(TransferQueue);
+        DestroyBatchObjects(Open);
+    }
+    else
+    {
+        ReleaseLargeStaging(Open);
+        FreeBatches.push_back(std::move(Open));
+    }
+
+    Open = UploadBatch{};
+    OpenActive = false;
+    return false;
+}
+
+void VulkanUploadManager::RetireBatches(bool WaitOldest)
+{
+    while (!InFlight.empty())
+    {
+        UploadBatch& batch = InFlight.front();
+
+        if (WaitOldest)
+        {
+            vkWaitForFences(DeviceHandle, 1, &batch.Fence, VK_TRUE, UINT64_MAX);
+            WaitOldest = false;
+        }
+        else if (vkGetFenceStatus(DeviceHandle, batch.Fence) != VK_SUCCESS)
+        {
+            break;
+        }
+
+        /* Batches finish in submission order, so their ring spans free from the tail. */
+        StagingUsed -= batch.StagingBytes;
+        CompletedToken = batch.Token;
+
+        ReleaseLargeStaging(batch);
+        vkResetFences(DeviceHandle, 1, &batch.Fence);
+
+        FreeBatches.push_back(std::move(batch));
+        InFlight.pop_front();
+    }
+}
+
+bool VulkanUploadManager::CreateBatchObjects(UploadBatch& Batch)
+{
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = TransferPool;
+    allocInfo.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(DeviceHandle, &allocInfo, &Batch.TransferCommands) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanUploadManager::CreateBatchObjects: vkAllocateCommandBuffers failed\n");
+        return false;
+    }
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    if (vkCreateFence(DeviceHandle, &fenceInfo, nullptr, &Batch.Fence) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanUploadManager::CreateBatchObjects: vkCreateFence failed\n");
+        vkFreeCommandBuffers(DeviceHandle, TransferPool, 1, &Batch.TransferCommands);
+        Batch = UploadBatch{};
+        return false;
+    }
+
+    if (TransferFamily == GraphicsFamily)
+    {
+        return true;
+    }
+
+    allocInfo.commandPool = AcquirePool;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    if (vkAllocateCommandBuffers(DeviceHandle, &allocInfo, &Batch.AcquireCommands) != VK_SUCCESS ||
+        vkCreateSemaphore(DeviceHandle, &semaphoreInfo, nullptr, &Batch.TransferDone) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanUploadManager::CreateBatchObjects: acquire objects failed\n");
+        if (Batch.AcquireCommands != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(DeviceHandle, AcquirePool, 1, &Batch.AcquireCommands);
+        }
+        vkFreeCommandBuffers(DeviceHandle, TransferPool, 1, &Batch.TransferCommands);
+        vkDestroyFence(DeviceHandle, Batch.Fence, nullptr);
+        Batch = UploadBatch{};
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanUploadManager::ReleaseLargeStaging(UploadBatch& Batch)
+{
+    for (std::size_t i = 0; i < Batch.LargeBuffers.size(); ++i)
+    {
+        g_VulkanAllocator.DestroyBuffer(Batch.LargeBuffers[i], Batch.LargeAllocations[i]);
+    }
+
+    Batch.LargeBuffers.clear();
+    Batch.LargeAllocations.clear();
+}
+
+void VulkanUploadManager::DestroyBatchObjects(UploadBatch& Batch)
+{
+    ReleaseLargeStaging(Batch);
+
+    if (Batch.TransferCommands != VK_NULL_HANDLE)
+    {
+        vkFreeCommandBuffers(DeviceHandle, TransferPool, 1, &Batch.TransferCommands);
+    }
+
+    if (Batch.AcquireCommands != VK_NULL_HANDLE)
+    {
+        vkFreeCommandBuffers(DeviceHandle, AcquirePool, 1, &Batch.AcquireCommands);
+    }
+
+    if (Batch.Fence != VK_NULL_HANDLE)
+    {
+        vkDestroyFence(DeviceHandle, Batch.Fence, nullptr);
+    }
+
+    if (Batch.TransferDone != VK_NULL_HANDLE)
+    {
+        vkDestroySemaphore(DeviceHandle, Batch.TransferDone, nullptr);
+    }
+
+    Batch = UploadBatch{};
+}
@@ -0,0 +1,169 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "VulkanMemoryAllocator.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/* Submission serial of an upload batch, 0 means nothing to wait for. */
+using UploadToken = std::uint64_t;
+
+/* Batched asynchronous uploads through a shared staging ring. */
+/* Copies queue up in an open batch and go out in one submission on Flush(), */
+/* on the transfer queue when the device has one. Ownership moves to the */
+/* graphics family with a release/acquire barrier pair, and the acquire */
+/* is submitted to the graphics queue ahead of any later frame, so callers */
+/* can draw with the resource without waiting on the CPU. Tokens complete */
+/* when the batch fence signals, which also recycles its staging space. */
+class VulkanUploadManager
+{
+public:
+    /* Initialize empty uploader state. */
+    VulkanUploadManager();
+
+    /* Release uploader resources. */
+    ~VulkanUploadManager();
+
+    /* Create command pools and the staging ring. */
+    bool Create(
+        VkDevice Device,
+        VkQueue GraphicsQueue,
+        std::uint32_t GraphicsQueueFamily,
+        VkQueue TransferQueue,
+        std::uint32_t TransferQueueFamily);
+
+    /* Wait for every batch and destroy uploader resources. */
+    void Destroy();
+
+    /* Copy Data into a buffer range, visible to DstStage/DstAccess once flushed. */
+    UploadToken UploadBuffer(
+        VkBuffer DstBuffer,
+        VkDeviceSize DstOffset,
+        const void* Data,
+        VkDeviceSize Size,
+        VkPipelineStageFlags DstStage,
+        VkAccessFlags DstAccess);
+
+    /* Copy tightly packed texels into every layer of a colour image, */
+    /* leaving it in SHADER_READ_ONLY_OPTIMAL for fragment sampling. */
+    UploadToken UploadImage(
+        VkImage DstImage,
+        const void* Data,
+        VkDeviceSize Size,
+        std::uint32_t Width,
+        std::uint32_t Height,
+        std::uint32_t LayerCount);
+
+    /* Submit the open batch, returns its token, or 0 if the submit failed. */
+    UploadToken Flush();
+
+    /* Block until Token completes, flushing it first if still open. */
+    void Wait(UploadToken Token);
+
+private:
+    /* Command buffers and sync for one submission, recycled once retired. */
+    struct UploadBatch
+    {
+        VkCommandBuffer TransferCommands = VK_NULL_HANDLE;
+        VkCommandBuffer AcquireCommands = VK_NULL_HANDLE;
+        VkSemaphore TransferDone = VK_NULL_HANDLE;
+        VkFence Fence = VK_NULL_HANDLE;
+        UploadToken Token = 0;
+        std::uint32_t CopyCount = 0;
+
+        /* Ring head when the batch opened, and the bytes it holds from */
+        /* there, including wrap padding. */
+        VkDeviceSize StagingStart = 0;
+        VkDeviceSize StagingBytes = 0;
+
+        /* One-off staging for uploads larger than the ring. */
+        std::vector<VkBuffer> LargeBuffers;
+        std::vector<VulkanAllocation> LargeAllocations;
+    };
+
+    /* Open the current batch if needed, false on command buffer failure. */
+    bool BeginBatch();
+
+    /* Reserve staging space in the open batch, may flush and wait for room. */
+    bool AllocateStaging(
+        VkDeviceSize Size,
+        VkBuffer& OutBuffer,
+        VkDeviceSize& OutOffset,
+        void*& OutMapped);
+
+    /* Submit the open batch, caller holds the mutex. On failure the */
+    /* batch is dropped and its staging released, so nothing waits on it. */
+    bool SubmitBatch();
+
+    /* Recycle finished batches in submission order. */
+    void RetireBatches(bool WaitOldest);
+
+    bool CreateBatchObjects(UploadBatch& Batch);
+    void ReleaseLargeStaging(UploadBatch& Batch);
+
+    /* Free a batch's command buffers and sync objects for good. */
+    void DestroyBatchObjects(UploadBatch& Batch);
+
+private:
+    VkDevice DeviceHandle;
+    VkQueue GraphicsQueue;
+    VkQueue TransferQueue;
+    std::uint32_t GraphicsFamily;
+    std::uint32_t TransferFamily;
+
+    VkCommandPool TransferPool;
+    VkCommandPool AcquirePool;
+
+    /* Staging ring, persistently mapped host memory. */
+    VkBuffer StagingBuffer;
+    VulkanAllocation StagingAllocation;
+    VkDeviceSize StagingCapacity;
+    VkDeviceSize StagingHead;
+    VkDeviceSize StagingUsed;
+
+    /* Batch being recorded, submitted batches, and recycled ones. */
+    UploadBatch Open;
+    bool OpenActive;
+    std::deque<UploadBatch> InFlight;
+    std::vector<UploadBatch> FreeBatches;
+
+    UploadToken NextToken;
+    UploadToken CompletedToken;
+
+    /* Guards batch state; submissions still belong to the thread */
+    /* that owns the graphics queue (the render thread). */
+    std::mutex Mutex;
+};
+
+/* Uploader shared by every loader, created with VulkanDevice. */
+extern VulkanUploadManager g_VulkanUploader;
@@ -25,6 +25,11 @@
 
 #include "VulkanPipeline.h"
 
+#include "Engine/WorkerPool.h"
+#include "Renderer/Vulkan/Core/VulkanPipelineCache.h"
+#include "Renderer/Vulkan/Render/VulkanRenderPass.h"
+
+#include <cstdint>
 #include <cstdio>
 #include <fstream>
 #include <vector>
@@ -37,10 +42,12 @@ namespace
         float AlphaModePadding[4];
     };
 
-    struct ShadowPushConstants
+    /* Culling push constants: frustum planes and the instance count. */
+    struct CullPushConstants
     {
-        float LightViewProj[16];
-        float Model[16];
+        float Planes[6][4];
+        std::uint32_t InstanceCount;
+        std::uint32_t Padding[3];
     };
 
     bool ReadFile(const char* path, std::vector<char>& outData)
@@ -83,389 +90,402 @@ namespace
         }
         return shaderModule;
     }
+
+    /* Read and wrap one SPIR-V file, VK_NULL_HANDLE on failure. */
+    VkShaderModule LoadShaderModule(VkDevice device, const char* path)
+    {
+        std::vector<char> code;
+        if (!ReadFile(path, code))
+        {
+            return VK_NULL_HANDLE;
+        }
+
+        return CreateShaderModule(device, code);
+    }
+
+    VkPipelineShaderStageCreateInfo MakeStage(VkShaderStageFlagBits stage, VkShaderModule module)
+    {
+        VkPipelineShaderStageCreateInfo stageInfo{};
+        stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stageInfo.stage = stage;
+        stageInfo.module = module;
+        stageInfo.pName = "main";
+        return stageInfo;
+    }
+
+    /* Fixed-function state shared by the world, shadow, pre-pass and OIT */
+    /* pipelines. It points into itself, so each thread builds its own copy */
+    /* in place instead of copying one. */
+    struct PipelineStateSet
+    {
+        VkVertexInputBindingDescription Bindings[2]{};
+        VkVertexInputAttributeDescription Attributes[6]{};
+        VkVertexInputAttributeDescription ShadowAttributes[5]{};
+        VkPipelineVertexInputStateCreateInfo VertexInput{};
+        VkPipelineVertexInputStateCreateInfo ShadowVertexInput{};
+        VkPipelineInputAssemblyStateCreateInfo InputAssembly{};
+        VkViewport Viewport{};
+        VkRect2D Scissor{};
+        VkPipelineViewportStateCreateInfo ViewportState{};
+        VkPipelineRasterizationStateCreateInfo Rasterizer{};
+        VkPipelineMultisampleStateCreateInfo Multisampling{};
+        VkPipelineMultisampleStateCreateInfo ShadowMultisampling{};
+        VkPipelineColorBlendAttachmentState ColorBlendAttachment{};
+        VkPipelineColorBlendStateCreateInfo ColorBlending{};
+        VkPipelineColorBlendAttachmentState AlphaBlendAttachment{};
+        VkPipelineColorBlendStateCreateInfo AlphaBlending{};
+        VkDynamicState DynamicStates[2]{};
+        VkPipelineDynamicStateCreateInfo DynamicState{};
+
+        /* Depth test and write with LESS, as used by shadow and pre-pass. */
+        VkPipelineDepthStencilStateCreateInfo DepthWrite{};
+
+        PipelineStateSet()
+        {
+            Bindings[0].binding = 0;
+            Bindings[0].stride = sizeof(float) * 5;
+            Bindings[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+            Bindings[1].binding = 1;
+            Bindings[1].stride = sizeof(float) * 16;
+            Bindings[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+            Attributes[0].location = 0;
+            Attributes[0].binding = 0;
+            Attributes[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+            Attributes[0].offset = 0;
+
+            Attributes[1].location = 1;
+            Attributes[1].binding = 0;
+            Attributes[1].format = VK_FORMAT_R32G32_SFLOAT;
+            Attributes[1].offset = sizeof(float) * 3;
+
+            /* Per-instance model matrix rows. */
+            for (std::uint32_t row = 0; row < 4; ++row)
+            {
+                Attributes[2 + row].location = 2 + row;
+                Attributes[2 + row].binding = 1;
+                Attributes[2 + row].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+                Attributes[2 + row].offset = sizeof(float) * 4 * row;
+            }
+
+            VertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+            VertexInput.vertexBindingDescriptionCount = 2;
+            VertexInput.pVertexBindingDescriptions = Bindings;
+            VertexInput.vertexAttributeDescriptionCount = 6;
+            VertexInput.pVertexAttributeDescriptions = Attributes;
+
+            /* Shadow pass reads position plus the same per-instance model rows. */
+            ShadowAttributes[0] = Attributes[0];
+            ShadowAttributes[1] = Attributes[2];
+            ShadowAttributes[2] = Attributes[3];
+            ShadowAttributes[3] = Attributes[4];
+            ShadowAttributes[4] = Attributes[5];
+
+            ShadowVertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+            ShadowVertexInput.vertexBindingDescriptionCount = 2;
+            ShadowVertexInput.pVertexBindingDescriptions = Bindings;
+            ShadowVertexInput.vertexAttributeDescriptionCount = 5;
+            ShadowVertexInput.pVertexAttributeDescriptions = ShadowAttributes;
+
+            InputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+            InputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            InputAssembly.primitiveRestartEnable = VK_FALSE;
+
+            Viewport.x = 0.0f;
+            Viewport.y = 0.0f;
+            Viewport.width = 1.0f;
+            Viewport.height = 1.0f;
+            Viewport.minDepth = 0.0f;
+            Viewport.maxDepth = 1.0f;
+
+            Scissor.offset = { 0, 0 };
+            Scissor.extent = { 1, 1 };
+
+            ViewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+            ViewportState.viewportCount = 1;
+            ViewportState.pViewports = &Viewport;
+            ViewportState.scissorCount = 1;
+            ViewportState.pScissors = &Scissor;
+
+            Rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+            Rasterizer.depthClampEnable = VK_FALSE;
+            Rasterizer.rasterizerDiscardEnable = VK_FALSE;
+            Rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+            Rasterizer.lineWidth = 1.0f;
+            Rasterizer.cullMode = VK_CULL_MODE_NONE;
+            Rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+            Rasterizer.depthBiasEnable = VK_FALSE;
+
+            Multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+            Multisampling.sampleShadingEnable = VK_FALSE;
+            Multisampling.rasterizationSamples = VK_SAMPLE_COUNT_4_BIT;
+
+            ShadowMultisampling = Multisampling;
+            ShadowMultisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+            ColorBlendAttachment.colorWriteMask =
+                VK_COLOR_COMPONENT_R_BIT |
+                VK_COLOR_COMPONENT_G_BIT |
+                VK_COLOR_COMPONENT_B_BIT |
+                VK_COLOR_COMPONENT_A_BIT;
+            ColorBlendAttachment.blendEnable = VK_FALSE;
+
+            ColorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+            ColorBlending.logicOpEnable = VK_FALSE;
+            ColorBlending.attachmentCount = 1;
+            ColorBlending.pAttachments = &ColorBlendAttachment;
+
+            AlphaBlendAttachment = ColorBlendAttachment;
+            AlphaBlendAttachment.blendEnable = VK_TRUE;
+            AlphaBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            AlphaBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            AlphaBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+            AlphaBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+            AlphaBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+            AlphaBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+            AlphaBlending = ColorBlending;
+            AlphaBlending.pAttachments = &AlphaBlendAttachment;
+
+            DynamicStates[0] = VK_DYNAMIC_STATE_VIEWPORT;
+            DynamicStates[1] = VK_DYNAMIC_STATE_SCISSOR;
+
+            DynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+            DynamicState.dynamicStateCount = 2;
+            DynamicState.pDynamicStates = DynamicStates;
+
+            DepthWrite.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+            DepthWrite.depthTestEnable = VK_TRUE;
+            DepthWrite.depthWriteEnable = VK_TRUE;
+            DepthWrite.depthCompareOp = VK_COMPARE_OP_LESS;
+            DepthWrite.depthBoundsTestEnable = VK_FALSE;
+            DepthWrite.stencilTestEnable = VK_FALSE;
+        }
+
+        PipelineStateSet(const PipelineStateSet&) = delete;
+        PipelineStateSet& operator=(const PipelineStateSet&) = delete;
+
+        /* Main-pass pipeline with the given stages, depth and blend state. */
+        VkGraphicsPipelineCreateInfo MakeWorldInfo(
+            const VkPipelineShaderStageCreateInfo* stages,
+            std::uint32_t stageCount,
+            const VkPipelineDepthStencilStateCreateInfo* depthStencil,
+            const VkPipelineColorBlendStateCreateInfo* blendState,
+            VkPipelineLayout layout,
+            VkRenderPass renderPass) const
+        {
+            VkGraphicsPipelineCreateInfo pipelineInfo{};
+            pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+            pipelineInfo.stageCount = stageCount;
+            pipelineInfo.pStages = stages;
+            pipelineInfo.pVertexInputState = &VertexInput;
+            pipelineInfo.pInputAssemblyState = &InputAssembly;
+            pipelineInfo.pViewportState = &ViewportState;
+            pipelineInfo.pRasterizationState = &Rasterizer;
+            pipelineInfo.pMultisampleState = &Multisampling;
+            pipelineInfo.pDepthStencilState = depthStencil;
+            pipelineInfo.pColorBlendState = blendState;
+            pipelineInfo.pDynamicState = &DynamicState;
+            pipelineInfo.layout = layout;
+            pipelineInfo.renderPass = renderPass;
+            pipelineInfo.subpass = 0;
+            return pipelineInfo;
+        }
+    };
+
+    VkPipelineDepthStencilStateCreateInfo MakeDepthState(
+        VkBool32 depthTest,
+        VkBool32 depthWrite,
+        VkCompareOp depthCompare)
+    {
+        VkPipelineDepthStencilStateCreateInfo depthStencil{};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = depthTest;
+        depthStencil.depthWriteEnable = depthWrite;
+        depthStencil.depthCompareOp = depthCompare;
+        depthStencil.depthBoundsTestEnable = VK_FALSE;
+        depthStencil.stencilTestEnable = VK_FALSE;
+        return depthStencil;
+    }
 }
 
 VulkanPipeline::VulkanPipeline()
     : SkyPipeline(VK_NULL_HANDLE)
     , WorldPipeline(VK_NULL_HANDLE)
+    , WorldEqualPipeline(VK_NULL_HANDLE)
+    , DepthPrepassPipeline(VK_NULL_HANDLE)
+    , WeightedBlendPipeline(VK_NULL_HANDLE)
+    , CompositePipeline(VK_NULL_HANDLE)
     , ShadowPipeline(VK_NULL_HANDLE)
+    , CullPipeline(VK_NULL_HANDLE)
     , PipelineLayout(VK_NULL_HANDLE)
     , ShadowPipelineLayout(VK_NULL_HANDLE)
+    , CompositePipelineLayout(VK_NULL_HANDLE)
+    , CullPipelineLayout(VK_NULL_HANDLE)
 {
+    for (std::atomic<bool>& ready : VariantReady)
+    {
+        ready.store(false);
+    }
 }
 
 VulkanPipeline::~VulkanPipeline()
 {
+    /* Workers reference this object, never let one outlive it. */
+    WaitForVariants();
 }
 
 bool VulkanPipeline::Create(
     VkDevice Device,
     VkRenderPass RenderPass,
     VkRenderPass ShadowRenderPass,
-    VkDescriptorSetLayout DescriptorSetLayout)
+    VkDescriptorSetLayout DescriptorSetLayout,
+    VkDescriptorSetLayout CompositeSetLayout,
+    VkDescriptorSetLayout CullSetLayout)
 {
-    if (SkyPipeline != VK_NULL_HANDLE)
-    {
-        vkDestroyPipeline(Device, SkyPipeline, nullptr);
-        SkyPipeline = VK_NULL_HANDLE;
-    }
-    if (WorldPipeline != VK_NULL_HANDLE)
-    {
-        vkDestroyPipeline(Device, WorldPipeline, nullptr);
-        WorldPipeline = VK_NULL_HANDLE;
-    }
-    if (ShadowPipeline != VK_NULL_HANDLE)
-    {
-        vkDestroyPipeline(Device, ShadowPipeline, nullptr);
-        ShadowPipeline = VK_NULL_HANDLE;
-    }
-    if (PipelineLayout != VK_NULL_HANDLE)
-    {
-        vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
-        PipelineLayout = VK_NULL_HANDLE;
-    }
-    if (ShadowPipelineLayout != VK_NULL_HANDLE)
-    {
-        vkDestroyPipelineLayout(Device, ShadowPipelineLayout, nullptr);
-        ShadowPipelineLayout = VK_NULL_HANDLE;
-    }
-
-    std::vector<char> vertShaderCode;
-    std::vector<char> fragShaderCode;
-    if (!ReadFile("../Assets/Ready/Triangle.vert.spv", vertShaderCode) ||
-        !ReadFile("../Assets/Ready/Triangle.frag.spv", fragShaderCode))
-    {
-        return false;
-    }
-
-    VkShaderModule vertShaderModule = CreateShaderModule(Device, vertShaderCode);
-    VkShaderModule fragShaderModule = CreateShaderModule(Device, fragShaderCode);
-    if (vertShaderModule == VK_NULL_HANDLE || fragShaderModule == VK_NULL_HANDLE)
-    {
-        if (vertShaderModule != VK_NULL_HANDLE)
-        {
-            vkDestroyShaderModule(Device, vertShaderModule, nullptr);
-        }
-        if (fragShaderModule != VK_NULL_HANDLE)
-        {
-            vkDestroyShaderModule(Device, fragShaderModule, nullptr);
-        }
-        std::fprintf(stderr, "VulkanPipeline::Create: Failed to create shader modules\n");
-        return false;
-    }
-
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    vertShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    fragShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo shaderStages[] = {
-        vertShaderStageInfo,
-        fragShaderStageInfo
-    };
-
-    VkVertexInputBindingDescription bindings[2]{};
-    bindings[0].binding = 0;
-    bindings[0].stride = sizeof(float) * 5;
-    bindings[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-    bindings[1].binding = 1;
-    bindings[1].stride = sizeof(float) * 16;
-    bindings[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
-
-    VkVertexInputAttributeDescription attributeDescriptions[6]{};
-    attributeDescriptions[0].location = 0;
-    attributeDescriptions[0].binding = 0;
-    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attributeDescriptions[0].offset = 0;
-
-    attributeDescriptions[1].location = 1;
-    attributeDescriptions[1].binding = 0;
-    attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
-    attributeDescriptions[1].offset = sizeof(float) * 3;
-
-    attributeDescriptions[2].location = 2;
-    attributeDescriptions[2].binding = 1;
-    attributeDescriptions[2].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-    attributeDescriptions[2].offset = 0;
-
-    attributeDescriptions[3].location = 3;
-    attributeDescriptions[3].binding = 1;
-    attributeDescriptions[3].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-    attributeDescriptions[3].offset = sizeof(float) * 4;
-
-    attributeDescriptions[4].location = 4;
-    attributeDescriptions[4].binding = 1;
-    attributeDescriptions[4].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-    attributeDescriptions[4].offset = sizeof(float) * 8;
-
-    attributeDescriptions[5].location = 5;
-    attributeDescriptions[5].binding = 1;
-    attributeDescriptions[5].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-    attributeDescriptions[5].offset = sizeof(float) * 12;
-
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 2;
-    vertexInputInfo.pVertexBindingDescriptions = bindings;
-    vertexInputInfo.vertexAttributeDescriptionCount = 6;
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions;
-
-    VkVertexInputBindingDescription shadowBinding{};
-    shadowBinding.binding = 0;
-    shadowBinding.stride = sizeof(float) * 5;
-    shadowBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    VkVertexInputAttributeDescription shadowAttribute{};
-    shadowAttribute.location = 0;
-    shadowAttribute.binding = 0;
-    shadowAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
-    shadowAttribute.offset = 0;
-
-    VkPipelineVertexInputStateCreateInfo shadowVertexInputInfo{};
-    shadowVertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    shadowVertexInputInfo.vertexBindingDescriptionCount = 1;
-    shadowVertexInputInfo.pVertexBindingDescriptions = &shadowBinding;
-    shadowVertexInputInfo.vertexAttributeDescriptionCount = 1;
-    shadowVertexInputInfo.pVertexAttributeDescriptions = &shadowAttribute;
-
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = 1.0f;
-    viewport.height = 1.0f;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor{};
-    scissor.offset = { 0, 0 };
-    scissor.extent = { 1, 1 };
-
-    VkPipelineViewportStateCreateInfo viewportState{};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer{};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_NONE;
-    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rasterizer.depthBiasEnable = VK_FALSE;
-
-    VkPipelineMultisampleStateCreateInfo multisampling{};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_4_BIT;
-
-    VkPipelineMultisampleStateCreateInfo shadowMultisampling = multisampling;
-    shadowMultisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask =
-        VK_COLOR_COMPONENT_R_BIT |
-        VK_COLOR_COMPONENT_G_BIT |
-        VK_COLOR_COMPONENT_B_BIT |
-        VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
-
-    VkPipelineColorBlendStateCreateInfo colorBlending{};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-
-    VkPipelineColorBlendAttachmentState alphaBlendAttachment = colorBlendAttachment;
-    alphaBlendAttachment.blendEnable = VK_TRUE;
-    alphaBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    alphaBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    alphaBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-    alphaBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    alphaBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-    alphaBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-
-    VkPipelineColorBlendStateCreateInfo alphaBlending = colorBlending;
-    alphaBlending.pAttachments = &alphaBlendAttachment;
-
-    VkDynamicState dynamicStates[] = {
-        VK_DYNAMIC_STATE_VIEWPORT,
-        VK_DYNAMIC_STATE_SCISSOR
-    };
-
-    VkPipelineDynamicStateCreateInfo dynamicState{};
-    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount = 2;
-    dynamicState.pDynamicStates = dynamicStates;
-
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &DescriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
+    /* Release pipelines from a previous create. */
+    Destroy(Device);
 
+    /* Layouts are cheap and shared, so every one is made up front; */
+    /* workers only ever write their own pipeline handles. */
     VkPushConstantRange pushConstantRange{};
     pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
     pushConstantRange.offset = 0;
     pushConstantRange.size = sizeof(PushConstants);
 
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &DescriptorSetLayout;
     pipelineLayoutInfo.pushConstantRangeCount = 1;
     pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
     if (vkCreatePipelineLayout(Device, &pipelineLayoutInfo, nullptr, &PipelineLayout) != VK_SUCCESS)
     {
         std::fprintf(stderr, "VulkanPipeline::Create: vkCreatePipelineLayout failed\n");
-        vkDestroyShaderModule(Device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(Device, vertShaderModule, nullptr);
+        PipelineLayout = VK_NULL_HANDLE;
         return false;
     }
 
+    /* Shadow layout shares the frame set for the light matrix uniform. */
     VkPipelineLayoutCreateInfo shadowLayoutInfo{};
     shadowLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    shadowLayoutInfo.setLayoutCount = 0;
-
-    VkPushConstantRange shadowPushRange{};
-    shadowPushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    shadowPushRange.offset = 0;
-    shadowPushRange.size = sizeof(ShadowPushConstants);
-
-    shadowLayoutInfo.pushConstantRangeCount = 1;
-    shadowLayoutInfo.pPushConstantRanges = &shadowPushRange;
+    shadowLayoutInfo.setLayoutCount = 1;
+    shadowLayoutInfo.pSetLayouts = &DescriptorSetLayout;
+    shadowLayoutInfo.pushConstantRangeCount = 0;
 
     if (vkCreatePipelineLayout(Device, &shadowLayoutInfo, nullptr, &ShadowPipelineLayout) != VK_SUCCESS)
     {
         std::fprintf(stderr, "VulkanPipeline::Create: vkCreatePipelineLayout (shadow) failed\n");
-        vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
-        PipelineLayout = VK_NULL_HANDLE;
-        vkDestroyShaderModule(Device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(Device, vertShaderModule, nullptr);
+        ShadowPipelineLayout = VK_NULL_HANDLE;
+        Destroy(Device);
         return false;
     }
 
-    auto CreateGraphicsPipeline = [&](VkBool32 depthTest,
-        VkBool32 depthWrite,
-        VkCompareOp depthCompare,
-        const VkPipelineColorBlendStateCreateInfo& blendState,
-        VkPipeline& outPipeline) -> bool
+    if (CompositeSetLayout != VK_NULL_HANDLE)
     {
-        VkPipelineDepthStencilStateCreateInfo depthStencil{};
-        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-        depthStencil.depthTestEnable = depthTest;
-        depthStencil.depthWriteEnable = depthWrite;
-        depthStencil.depthCompareOp = depthCompare;
-        depthStencil.depthBoundsTestEnable = VK_FALSE;
-        depthStencil.stencilTestEnable = VK_FALSE;
+        /* Composite reads both OIT targets as multisampled input attachments. */
+        VkPipelineLayoutCreateInfo compositeLayoutInfo{};
+        compositeLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        compositeLayoutInfo.setLayoutCount = 1;
+        compositeLayoutInfo.pSetLayouts = &CompositeSetLayout;
+        compositeLayoutInfo.pushConstantRangeCount = 0;
+
+        if (vkCreatePipelineLayout(Device, &compositeLayoutInfo, nullptr, &CompositePipelineLayout) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VulkanPipeline::Create: vkCreatePipelineLayout (composite) failed\n");
+            CompositePipelineLayout = VK_NULL_HANDLE;
+            Destroy(Device);
+            return false;
+        }
+    }
 
-        VkGraphicsPipelineCreateInfo pipelineInfo{};
-        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineInfo.stageCount = 2;
-        pipelineInfo.pStages = shaderStages;
-        pipelineInfo.pVertexInputState = &vertexInputInfo;
-        pipelineInfo.pInputAssemblyState = &inputAssembly;
-        pipelineInfo.pViewportState = &viewportState;
-        pipelineInfo.pRasterizationState = &rasterizer;
-        pipelineInfo.pMultisampleState = &multisampling;
-        pipelineInfo.pDepthStencilState = &depthStencil;
-        pipelineInfo.pColorBlendState = &blendState;
-        pipelineInfo.pDynamicState = &dynamicState;
-        pipelineInfo.layout = PipelineLayout;
-        pipelineInfo.renderPass = RenderPass;
-        pipelineInfo.subpass = 0;
-
-        if (vkCreateGraphicsPipelines(Device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &outPipeline) != VK_SUCCESS)
+    if (CullSetLayout != VK_NULL_HANDLE)
+    {
+        /* Culling reads instances and writes indirect draws through storage buffers. */
+        VkPushConstantRange cullPushRange{};
+        cullPushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        cullPushRange.offset = 0;
+        cullPushRange.size = sizeof(CullPushConstants);
+
+        VkPipelineLayoutCreateInfo cullLayoutInfo{};
+        cullLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        cullLayoutInfo.setLayoutCount = 1;
+        cullLayoutInfo.pSetLayouts = &CullSetLayout;
+        cullLayoutInfo.pushConstantRangeCount = 1;
+        cullLayoutInfo.pPushConstantRanges = &cullPushRange;
+
+        if (vkCreatePipelineLayout(Device, &cullLayoutInfo, nullptr, &CullPipelineLayout) != VK_SUCCESS)
         {
+            std::fprintf(stderr, "VulkanPipeline::Create: vkCreatePipelineLayout (cull) failed\n");
+            CullPipelineLayout = VK_NULL_HANDLE;
+            Destroy(Device);
             return false;
         }
+    }
 
-        return true;
+    /* Sky, world and shadow pipelines draw every frame, build them now. */
+    VkShaderModule vertShaderModule = LoadShaderModule(Device, "../Assets/Ready/Triangle.vert.spv");
+    VkShaderModule fragShaderModule = LoadShaderModule(Device, "../Assets/Ready/Triangle.frag.spv");
+    VkShaderModule shadowVertModule = LoadShaderModule(Device, "../Assets/Ready/Shadow.vert.spv");
+    auto destroyModules = [&]()
+    {
+        for (VkShaderModule module : { vertShaderModule, fragShaderModule, shadowVertModule })
+        {
+            if (module != VK_NULL_HANDLE)
+            {
+                vkDestroyShaderModule(Device, module, nullptr);
+            }
+        }
     };
 
-    if (!CreateGraphicsPipeline(VK_TRUE, VK_FALSE, VK_COMPARE_OP_ALWAYS, colorBlending, SkyPipeline))
+    if (vertShaderModule == VK_NULL_HANDLE ||
+        fragShaderModule == VK_NULL_HANDLE ||
+        shadowVertModule == VK_NULL_HANDLE)
     {
-        std::fprintf(stderr, "VulkanPipeline::Create: vkCreateGraphicsPipelines (sky) failed\n");
-        vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
-        PipelineLayout = VK_NULL_HANDLE;
-        vkDestroyShaderModule(Device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(Device, vertShaderModule, nullptr);
+        std::fprintf(stderr, "VulkanPipeline::Create: Failed to create shader modules\n");
+        destroyModules();
+        Destroy(Device);
         return false;
     }
 
-    if (!CreateGraphicsPipeline(VK_TRUE, VK_TRUE, VK_COMPARE_OP_LESS, alphaBlending, WorldPipeline))
-    {
-        std::fprintf(stderr, "VulkanPipeline::Create: vkCreateGraphicsPipelines (world) failed\n");
-        vkDestroyPipeline(Device, SkyPipeline, nullptr);
-        SkyPipeline = VK_NULL_HANDLE;
-        vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
-        PipelineLayout = VK_NULL_HANDLE;
-        vkDestroyShaderModule(Device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(Device, vertShaderModule, nullptr);
-        return false;
-    }
+    const PipelineStateSet states;
+
+    const VkPipelineShaderStageCreateInfo shaderStages[] = {
+        MakeStage(VK_SHADER_STAGE_VERTEX_BIT, vertShaderModule),
+        MakeStage(VK_SHADER_STAGE_FRAGMENT_BIT, fragShaderModule)
+    };
 
-    std::vector<char> shadowVertCode;
-    if (!ReadFile("../Assets/Ready/Shadow.vert.spv", shadowVertCode))
+    const VkPipelineDepthStencilStateCreateInfo skyDepth =
+        MakeDepthState(VK_TRUE, VK_FALSE, VK_COMPARE_OP_ALWAYS);
+    const VkGraphicsPipelineCreateInfo skyInfo = states.MakeWorldInfo(
+        shaderStages, 2, &skyDepth, &states.ColorBlending, PipelineLayout, RenderPass);
+
+    if (g_VulkanPipelineCache.CreateGraphicsPipelines(Device, 1, &skyInfo, &SkyPipeline) != VK_SUCCESS)
     {
-        std::fprintf(stderr, "VulkanPipeline::Create: Failed to load shadow vertex shader\n");
-        vkDestroyPipeline(Device, SkyPipeline, nullptr);
-        vkDestroyPipeline(Device, WorldPipeline, nullptr);
+        std::fprintf(stderr, "VulkanPipeline::Create: vkCreateGraphicsPipelines (sky) failed\n");
         SkyPipeline = VK_NULL_HANDLE;
-        WorldPipeline = VK_NULL_HANDLE;
-        vkDestroyPipelineLayout(Device, ShadowPipelineLayout, nullptr);
-        ShadowPipelineLayout = VK_NULL_HANDLE;
-        vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
-        PipelineLayout = VK_NULL_HANDLE;
-        vkDestroyShaderModule(Device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(Device, vertShaderModule, nullptr);
+        destroyModules();
+        Destroy(Device);
         return false;
     }
 
-    VkShaderModule shadowVertModule = CreateShaderModule(Device, shadowVertCode);
-    if (shadowVertModule == VK_NULL_HANDLE)
+    /* Generic opaque and transparent pipeline, also the fallback while */
+    /* the pre-pass and OIT variants are still compiling. */
+    const VkGraphicsPipelineCreateInfo worldInfo = states.MakeWorldInfo(
+        shaderStages, 2, &states.DepthWrite, &states.AlphaBlending, PipelineLayout, RenderPass);
+
+    if (g_VulkanPipelineCache.CreateGraphicsPipelines(Device, 1, &worldInfo, &WorldPipeline) != VK_SUCCESS)
     {
-        std::fprintf(stderr, "VulkanPipeline::Create: Failed to create shadow shader module\n");
-        vkDestroyPipeline(Device, SkyPipeline, nullptr);
-        vkDestroyPipeline(Device, WorldPipeline, nullptr);
-        SkyPipeline = VK_NULL_HANDLE;
+        std::fprintf(stderr, "VulkanPipeline::Create: vkCreateGraphicsPipelines (world) failed\n");
         WorldPipeline = VK_NULL_HANDLE;
-        vkDestroyPipelineLayout(Device, ShadowPipelineLayout, nullptr);
-        ShadowPipelineLayout = VK_NULL_HANDLE;
-        vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
-        PipelineLayout = VK_NULL_HANDLE;
-        vkDestroyShaderModule(Device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(Device, vertShaderModule, nullptr);
+        destroyModules();
+        Destroy(Device);
         return false;
     }
 
-    VkPipelineShaderStageCreateInfo shadowStage{};
-    shadowStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    shadowStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    shadowStage.module = shadowVertModule;
-    shadowStage.pName = "main";
-
-    VkPipelineShaderStageCreateInfo shadowStages[] = { shadowStage };
-
-    VkPipelineDepthStencilStateCreateInfo shadowDepth{};
-    shadowDepth.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    shadowDepth.depthTestEnable = VK_TRUE;
-    shadowDepth.depthWriteEnable = VK_TRUE;
-    shadowDepth.depthCompareOp = VK_COMPARE_OP_LESS;
-    shadowDepth.depthBoundsTestEnable = VK_FALSE;
-    shadowDepth.stencilTestEnable = VK_FALSE;
+    const VkPipelineShaderStageCreateInfo shadowStage =
+        MakeStage(VK_SHADER_STAGE_VERTEX_BIT, shadowVertModule);
 
     VkPipelineColorBlendStateCreateInfo shadowBlend{};
     shadowBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
@@ -473,48 +493,46 @@ bool VulkanPipeline::Create(
     shadowBlend.attachmentCount = 0;
     shadowBlend.pAttachments = nullptr;
 
-    VkGraphicsPipelineCreateInfo shadowInfo{};
-    shadowInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    shadowInfo.stageCount = 1;
-    shadowInfo.pStages = shadowStages;
-    shadowInfo.pVertexInputState = &shadowVertexInputInfo;
-    shadowInfo.pInputAssemblyState = &inputAssembly;
-    shadowInfo.pViewportState = &viewportState;
-    shadowInfo.pRasterizationState = &rasterizer;
-    shadowInfo.pMultisampleState = &shadowMultisampling;
-    shadowInfo.pDepthStencilState = &shadowDepth;
-    shadowInfo.pColorBlendState = &shadowBlend;
-    shadowInfo.pDynamicState = &dynamicState;
-    shadowInfo.layout = ShadowPipelineLayout;
-    shadowInfo.renderPass = ShadowRenderPass;
-    shadowInfo.subpass = 0;
-
-    if (vkCreateGraphicsPipelines(Device, VK_NULL_HANDLE, 1, &shadowInfo, nullptr, &ShadowPipeline) != VK_SUCCESS)
+    VkGraphicsPipelineCreateInfo shadowInfo = states.MakeWorldInfo(
+        &shadowStage, 1, &states.DepthWrite, &shadowBlend, ShadowPipelineLayout, ShadowRenderPass);
+    shadowInfo.pVertexInputState = &states.ShadowVertexInput;
+    shadowInfo.pMultisampleState = &states.ShadowMultisampling;
+
+    const VkResult shadowResult =
+        g_VulkanPipelineCache.CreateGraphicsPipelines(Device, 1, &shadowInfo, &ShadowPipeline);
+    destroyModules();
+    if (shadowResult != VK_SUCCESS)
     {
         std::fprintf(stderr, "VulkanPipeline::Create: vkCreateGraphicsPipelines (shadow) failed\n");
-        vkDestroyShaderModule(Device, shadowVertModule, nullptr);
-        vkDestroyPipeline(Device, SkyPipeline, nullptr);
-        vkDestroyPipeline(Device, WorldPipeline, nullptr);
-        SkyPipeline = VK_NULL_HANDLE;
-        WorldPipeline = VK_NULL_HANDLE;
-        vkDestroyPipelineLayout(Device, ShadowPipelineLayout, nullptr);
-        ShadowPipelineLayout = VK_NULL_HANDLE;
-        vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
-        PipelineLayout = VK_NULL_HANDLE;
-        vkDestroyShaderModule(Device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(Device, vertShaderModule, nullptr);
+        ShadowPipeline = VK_NULL_HANDLE;
+        Destroy(Device);
         return false;
     }
 
-    vkDestroyShaderModule(Device, shadowVertModule, nullptr);
+    /* Optional variants compile on workers; the renderer keeps drawing */
+    /* with the pipelines above until each one reports ready. */
+    StartVariant(Device, RenderPass, PipelineVariant::DepthPrepass);
+    if (CompositePipelineLayout != VK_NULL_HANDLE)
+    {
+        StartVariant(Device, RenderPass, PipelineVariant::WeightedOIT);
+    }
+    if (CullPipelineLayout != VK_NULL_HANDLE)
+    {
+        StartVariant(Device, RenderPass, PipelineVariant::Cull);
+    }
 
-    vkDestroyShaderModule(Device, fragShaderModule, nullptr);
-    vkDestroyShaderModule(Device, vertShaderModule, nullptr);
     return true;
 }
 
 void VulkanPipeline::Destroy(VkDevice Device)
 {
+    /* Pipelines still compiling are finished before anything is released. */
+    WaitForVariants();
+    for (std::atomic<bool>& ready : VariantReady)
+    {
+        ready.store(false);
+    }
+
     if (SkyPipeline != VK_NULL_HANDLE)
     {
         vkDestroyPipeline(Device, SkyPipeline, nullptr);
@@ -525,11 +543,36 @@ void VulkanPipeline::Destroy(VkDevice Device)
         vkDestroyPipeline(Device, WorldPipeline, nullptr);
         WorldPipeline = VK_NULL_HANDLE;
     }
+    if (WorldEqualPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(Device, WorldEqualPipeline, nullptr);
+        WorldEqualPipeline = VK_NULL_HANDLE;
+    }
+    if (DepthPrepassPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(Device, DepthPrepassPipeline, nullptr);
+        DepthPrepassPipeline = VK_NULL_HANDLE;
+    }
+    if (WeightedBlendPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(Device, WeightedBlendPipeline, nullptr);
+        WeightedBlendPipeline = VK_NULL_HANDLE;
+    }
+    if (CompositePipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(Device, CompositePipeline, nullptr);
+        CompositePipeline = VK_NULL_HANDLE;
+    }
     if (ShadowPipeline != VK_NULL_HANDLE)
     {
         vkDestroyPipeline(Device, ShadowPipeline, nullptr);
         ShadowPipeline = VK_NULL_HANDLE;
     }
+    if (CullPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(Device, CullPipeline, nullptr);
+        CullPipeline = VK_NULL_HANDLE;
+    }
     if (PipelineLayout != VK_NULL_HANDLE)
     {
         vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
@@ -540,6 +583,285 @@ void VulkanPipeline::Destroy(VkDevice Device)
         vkDestroyPipelineLayout(Device, ShadowPipelineLayout, nullptr);
         ShadowPipelineLayout = VK_NULL_HANDLE;
     }
+    if (CompositePipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(Device, CompositePipelineLayout, nullptr);
+        CompositePipelineLayout = VK_NULL_HANDLE;
+    }
+    if (CullPipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(Device, CullPipelineLayout, nullptr);
+        CullPipelineLayout = VK_NULL_HANDLE;
+    }
+}
+
+bool VulkanPipeline::IsVariantReady(PipelineVariant Variant) const
+{
+    /* Acquire pairs with the worker's release, so the handles are visible. */
+    return VariantReady[static_cast<std::size_t>(Variant)].load(std::memory_order_acquire);
+}
+
+void VulkanPipeline::WaitForVariants()
+{
+    /* The pool's queue is shared, so this also waits on other submitters. */
+    g_WorkerPool.WaitForSubmitted();
+}
+
+void VulkanPipeline::StartVariant(VkDevice Device, VkRenderPass RenderPass, PipelineVariant Variant)
+{
+    /* Counted as startup pipeline time until the worker finishes. */
+    g_VulkanPipelineCache.BeginBackgroundCompile();
+
+    VariantJob& job = VariantJobs[static_cast<std::size_t>(Variant)];
+    job.Owner = this;
+    job.Device = Device;
+    job.RenderPass = RenderPass;
+    job.Variant = Variant;
+    g_WorkerPool.Submit(&VulkanPipeline::CompileVariantTask, &job);
+}
+
+void VulkanPipeline::CompileVariantTask(void* Context, std::uint32_t TaskIndex)
+{
+    (void)TaskIndex;
+    const VariantJob& job = *static_cast<const VariantJob*>(Context);
+    VulkanPipeline& pipeline = *job.Owner;
+
+    bool created = false;
+    switch (job.Variant)
+    {
+    case PipelineVariant::DepthPrepass:
+        created = pipeline.CreateDepthPrepassVariant(job.Device, job.RenderPass);
+        break;
+    case PipelineVariant::WeightedOIT:
+        created = pipeline.CreateWeightedOITVariant(job.Device, job.RenderPass);
+        break;
+    case PipelineVariant::Cull:
+        created = pipeline.CreateCullVariant(job.Device);
+        break;
+    default:
+        break;
+    }
+
+    /* A failed variant never turns ready, its feature stays on the fallback. */
+    if (created)
+    {
+        pipeline.VariantReady[static_cast<std::size_t>(job.Variant)].store(true, std::memory_order_release);
+    }
+
+    g_VulkanPipelineCache.EndBackgroundCompile();
+}
+
+bool VulkanPipeline::CreateDepthPrepassVariant(VkDevice Device, VkRenderPass RenderPass)
+{
+    VkShaderModule vertShaderModule = LoadShaderModule(Device, "../Assets/Ready/Triangle.vert.spv");
+    VkShaderModule fragShaderModule = LoadShaderModule(Device, "../Assets/Ready/Triangle.frag.spv");
+    VkShaderModule prepassVertModule = LoadShaderModule(Device, "../Assets/Ready/DepthPrepass.vert.spv");
+    auto destroyModules = [&]()
+    {
+        for (VkShaderModule module : { vertShaderModule, fragShaderModule, prepassVertModule })
+        {
+            if (module != VK_NULL_HANDLE)
+            {
+                vkDestroyShaderModule(Device, module, nullptr);
+            }
+        }
+    };
+
+    if (vertShaderModule == VK_NULL_HANDLE ||
+        fragShaderModule == VK_NULL_HANDLE ||
+        prepassVertModule == VK_NULL_HANDLE)
+    {
+        std::fprintf(stderr, "VulkanPipeline::Create: Failed to create depth pre-pass shader modules\n");
+        destroyModules();
+        return false;
+    }
+
+    const PipelineStateSet states;
+
+    /* Opaque colour after a depth pre-pass: depth is final, test EQUAL without writing. */
+    const VkPipelineShaderStageCreateInfo shaderStages[] = {
+        MakeStage(VK_SHADER_STAGE_VERTEX_BIT, vertShaderModule),
+        MakeStage(VK_SHADER_STAGE_FRAGMENT_BIT, fragShaderModule)
+    };
+
+    const VkPipelineDepthStencilStateCreateInfo equalDepth =
+        MakeDepthState(VK_TRUE, VK_FALSE, VK_COMPARE_OP_EQUAL);
+    const VkGraphicsPipelineCreateInfo equalInfo = states.MakeWorldInfo(
+        shaderStages, 2, &equalDepth, &states.ColorBlending, PipelineLayout, RenderPass);
+
+    VkPipeline worldEqual = VK_NULL_HANDLE;
+    if (g_VulkanPipelineCache.CreateGraphicsPipelines(Device, 1, &equalInfo, &worldEqual) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanPipeline::Create: vkCreateGraphicsPipelines (world equal) failed\n");
+        destroyModules();
+        return false;
+    }
+
+    /* Depth only: the colour attachment stays bound but is never written. */
+    VkPipelineColorBlendAttachmentState prepassBlendAttachment{};
+    prepassBlendAttachment.colorWriteMask = 0;
+    prepassBlendAttachment.blendEnable = VK_FALSE;
+
+    VkPipelineColorBlendStateCreateInfo prepassBlend = states.ColorBlending;
+    prepassBlend.pAttachments = &prepassBlendAttachment;
+
+    /* Shares the world layout so the frame set stays bound into the colour pass. */
+    const VkPipelineShaderStageCreateInfo prepassStage =
+        MakeStage(VK_SHADER_STAGE_VERTEX_BIT, prepassVertModule);
+    VkGraphicsPipelineCreateInfo prepassInfo = states.MakeWorldInfo(
+        &prepassStage, 1, &states.DepthWrite, &prepassBlend, PipelineLayout, RenderPass);
+    prepassInfo.pVertexInputState = &states.ShadowVertexInput;
+
+    VkPipeline prepass = VK_NULL_HANDLE;
+    const VkResult prepassResult =
+        g_VulkanPipelineCache.CreateGraphicsPipelines(Device, 1, &prepassInfo, &prepass);
+    destroyModules();
+    if (prepassResult != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanPipeline::Create: vkCreateGraphicsPipelines (depth pre-pass) failed\n");
+        vkDestroyPipeline(Device, worldEqual, nullptr);
+        return false;
+    }
+
+    WorldEqualPipeline = worldEqual;
+    DepthPrepassPipeline = prepass;
+    return true;
+}
+
+bool VulkanPipeline::CreateWeightedOITVariant(VkDevice Device, VkRenderPass RenderPass)
+{
+    VkShaderModule vertShaderModule = LoadShaderModule(Device, "../Assets/Ready/Triangle.vert.spv");
+    VkShaderModule blendFragModule = LoadShaderModule(Device, "../Assets/Ready/WeightedBlend.frag.spv");
+    VkShaderModule compositeVertModule = LoadShaderModule(Device, "../Assets/Ready/OitComposite.vert.spv");
+    VkShaderModule compositeFragModule = LoadShaderModule(Device, "../Assets/Ready/OitComposite.frag.spv");
+    auto destroyModules = [&]()
+    {
+        for (VkShaderModule module : { vertShaderModule, blendFragModule, compositeVertModule, compositeFragModule })
+        {
+            if (module != VK_NULL_HANDLE)
+            {
+                vkDestroyShaderModule(Device, module, nullptr);
+            }
+        }
+    };
+
+    if (vertShaderModule == VK_NULL_HANDLE ||
+        blendFragModule == VK_NULL_HANDLE ||
+        compositeVertModule == VK_NULL_HANDLE ||
+        compositeFragModule == VK_NULL_HANDLE)
+    {
+        std::fprintf(stderr, "VulkanPipeline::Create: Failed to create weighted blend shader modules\n");
+        destroyModules();
+        return false;
+    }
+
+    const PipelineStateSet states;
+
+    /* Weighted blended OIT accumulation: world vertex shader, OIT fragment shader. */
+    const VkPipelineShaderStageCreateInfo blendStages[] = {
+        MakeStage(VK_SHADER_STAGE_VERTEX_BIT, vertShaderModule),
+        MakeStage(VK_SHADER_STAGE_FRAGMENT_BIT, blendFragModule)
+    };
+
+    /* Accumulation sums weighted colour, revealage multiplies by 1 - alpha. */
+    VkPipelineColorBlendAttachmentState oitBlendAttachments[2]{};
+    oitBlendAttachments[0].colorWriteMask = states.ColorBlendAttachment.colorWriteMask;
+    oitBlendAttachments[0].blendEnable = VK_TRUE;
+    oitBlendAttachments[0].srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    oitBlendAttachments[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    oitBlendAttachments[0].colorBlendOp = VK_BLEND_OP_ADD;
+    oitBlendAttachments[0].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    oitBlendAttachments[0].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    oitBlendAttachments[0].alphaBlendOp = VK_BLEND_OP_ADD;
+
+    oitBlendAttachments[1].colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+    oitBlendAttachments[1].blendEnable = VK_TRUE;
+    oitBlendAttachments[1].srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+    oitBlendAttachments[1].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+    oitBlendAttachments[1].colorBlendOp = VK_BLEND_OP_ADD;
+    oitBlendAttachments[1].srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    oitBlendAttachments[1].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    oitBlendAttachments[1].alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo oitBlending = states.ColorBlending;
+    oitBlending.attachmentCount = 2;
+    oitBlending.pAttachments = oitBlendAttachments;
+
+    /* Tested against opaque depth but never written, so draw order is free. */
+    const VkPipelineDepthStencilStateCreateInfo oitDepth =
+        MakeDepthState(VK_TRUE, VK_FALSE, VK_COMPARE_OP_LESS);
+
+    VkGraphicsPipelineCreateInfo blendInfo = states.MakeWorldInfo(
+        blendStages, 2, &oitDepth, &oitBlending, PipelineLayout, RenderPass);
+    blendInfo.subpass = VulkanRenderPass::kAccumulateSubpass;
+
+    VkPipeline weightedBlend = VK_NULL_HANDLE;
+    if (g_VulkanPipelineCache.CreateGraphicsPipelines(Device, 1, &blendInfo, &weightedBlend) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanPipeline::Create: vkCreateGraphicsPipelines (weighted blend) failed\n");
+        destroyModules();
+        return false;
+    }
+
+    /* Composite reads both OIT targets, a full-screen triangle from the vertex index. */
+    const VkPipelineShaderStageCreateInfo compositeStages[] = {
+        MakeStage(VK_SHADER_STAGE_VERTEX_BIT, compositeVertModule),
+        MakeStage(VK_SHADER_STAGE_FRAGMENT_BIT, compositeFragModule)
+    };
+
+    VkPipelineVertexInputStateCreateInfo compositeVertexInput{};
+    compositeVertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    const VkPipelineDepthStencilStateCreateInfo compositeDepth =
+        MakeDepthState(VK_FALSE, VK_FALSE, VK_COMPARE_OP_LESS);
+
+    VkGraphicsPipelineCreateInfo compositeInfo = states.MakeWorldInfo(
+        compositeStages, 2, &compositeDepth, &states.AlphaBlending, CompositePipelineLayout, RenderPass);
+    compositeInfo.pVertexInputState = &compositeVertexInput;
+    compositeInfo.subpass = VulkanRenderPass::kCompositeSubpass;
+
+    VkPipeline composite = VK_NULL_HANDLE;
+    const VkResult compositeResult =
+        g_VulkanPipelineCache.CreateGraphicsPipelines(Device, 1, &compositeInfo, &composite);
+    destroyModules();
+    if (compositeResult != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanPipeline::Create: vkCreateGraphicsPipelines (composite) failed\n");
+        vkDestroyPipeline(Device, weightedBlend, nullptr);
+        return false;
+    }
+
+    WeightedBlendPipeline = weightedBlend;
+    CompositePipeline = composite;
+    return true;
+}
+
+bool VulkanPipeline::CreateCullVariant(VkDevice Device)
+{
+    VkShaderModule cullModule = LoadShaderModule(Device, "../Assets/Ready/Cull.comp.spv");
+    if (cullModule == VK_NULL_HANDLE)
+    {
+        std::fprintf(stderr, "VulkanPipeline::Create: Failed to create cull shader module\n");
+        return false;
+    }
+
+    VkComputePipelineCreateInfo cullInfo{};
+    cullInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    cullInfo.stage = MakeStage(VK_SHADER_STAGE_COMPUTE_BIT, cullModule);
+    cullInfo.layout = CullPipelineLayout;
+
+    VkPipeline cull = VK_NULL_HANDLE;
+    const VkResult cullResult =
+        g_VulkanPipelineCache.CreateComputePipelines(Device, 1, &cullInfo, &cull);
+    vkDestroyShaderModule(Device, cullModule, nullptr);
+    if (cullResult != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanPipeline::Create: vkCreateComputePipelines (cull) failed\n");
+        return false;
+    }
+
+    CullPipeline = cull;
+    return true;
 }
 
 VkPipeline VulkanPipeline::GetSkyHandle() const
@@ -552,6 +874,31 @@ VkPipeline VulkanPipeline::GetWorldHandle() const
     return WorldPipeline;
 }
 
+VkPipeline VulkanPipeline::GetWorldEqualHandle() const
+{
+    return WorldEqualPipeline;
+}
+
+VkPipeline VulkanPipeline::GetDepthPrepassHandle() const
+{
+    return DepthPrepassPipeline;
+}
+
+VkPipeline VulkanPipeline::GetWeightedBlendHandle() const
+{
+    return WeightedBlendPipeline;
+}
+
+VkPipeline VulkanPipeline::GetCompositeHandle() const
+{
+    return CompositePipeline;
+}
+
+VkPipelineLayout VulkanPipeline::GetCompositeLayout() const
+{
+    return CompositePipelineLayout;
+}
+
 VkPipelineLayout VulkanPipeline::GetLayout() const
 {
     return PipelineLayout;
@@ -566,3 +913,13 @@ VkPipelineLayout VulkanPipeline::GetShadowLayout() const
 {
     return ShadowPipelineLayout;
 }
+
+VkPipeline VulkanPipeline::GetCullHandle() const
+{
+    return CullPipeline;
+}
+
+VkPipelineLayout VulkanPipeline::GetCullLayout() const
+{
+    return CullPipelineLayout;
+}
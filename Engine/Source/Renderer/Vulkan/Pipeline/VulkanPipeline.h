@@ -27,6 +27,26 @@
 
 #include <vulkan/vulkan.h>
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Optional pipelines compiled on worker threads after Create returns. */
+enum class PipelineVariant : std::uint32_t
+{
+    /* Depth pre-pass plus the EQUAL-tested opaque colour pipeline. */
+    DepthPrepass = 0,
+
+    /* Weighted blended OIT accumulation plus its composite. */
+    WeightedOIT,
+
+    /* Frustum culling compute pipeline. */
+    Cull,
+
+    Count
+};
+
 /* Manages graphics pipelines and layouts. */
 
 class VulkanPipeline
@@ -38,22 +58,48 @@ public:
     /* Release pipeline resources. */
     ~VulkanPipeline();
 
-    /* Create graphics pipelines for main and shadow passes. */
+    /* Create the sky, world and shadow pipelines and every layout, then */
+    /* start compiling the depth pre-pass, OIT and culling variants on worker */
+    /* threads. The OIT variant is only built when CompositeSetLayout is */
+    /* given, which needs a render pass with the OIT subpasses; the culling */
+    /* variant is only built when CullSetLayout is given. */
     bool Create(
         VkDevice Device,
         VkRenderPass RenderPass,
         VkRenderPass ShadowRenderPass,
-        VkDescriptorSetLayout DescriptorSetLayout);
+        VkDescriptorSetLayout DescriptorSetLayout,
+        VkDescriptorSetLayout CompositeSetLayout,
+        VkDescriptorSetLayout CullSetLayout);
 
-    /* Destroy pipeline handles and layouts. */
+    /* Wait for variant workers, then destroy pipeline handles and layouts. */
     void Destroy(VkDevice Device);
 
+    /* True once a variant's pipelines exist; until then draw with the */
+    /* world pipeline or skip the pass. A variant that failed stays false. */
+    bool IsVariantReady(PipelineVariant Variant) const;
+
+    /* Block until every queued variant compile has finished. */
+    void WaitForVariants();
+
     /* Sky rendering pipeline. */
     VkPipeline GetSkyHandle() const;
 
     /* World rendering pipeline. */
     VkPipeline GetWorldHandle() const;
 
+    /* Opaque world pipeline testing EQUAL against pre-pass depth. */
+    VkPipeline GetWorldEqualHandle() const;
+
+    /* Position-only depth pre-pass pipeline, uses the shared layout. */
+    VkPipeline GetDepthPrepassHandle() const;
+
+    /* Weighted blended OIT accumulation pipeline, uses the shared layout. */
+    VkPipeline GetWeightedBlendHandle() const;
+
+    /* Full-screen OIT composite pipeline and its input attachment layout. */
+    VkPipeline GetCompositeHandle() const;
+    VkPipelineLayout GetCompositeLayout() const;
+
     /* Shared pipeline layout. */
     VkPipelineLayout GetLayout() const;
 
@@ -63,15 +109,56 @@ public:
     /* Shadow pipeline layout. */
     VkPipelineLayout GetShadowLayout() const;
 
+    /* Frustum culling compute pipeline writing indirect draws, null until */
+    /* the Cull variant is ready. */
+    VkPipeline GetCullHandle() const;
+    VkPipelineLayout GetCullLayout() const;
+
 private:
+    /* Queue Variant's compile on the shared worker pool. */
+    void StartVariant(VkDevice Device, VkRenderPass RenderPass, PipelineVariant Variant);
+
+    /* Worker pool entry point, context is the variant's VariantJob. */
+    static void CompileVariantTask(void* Context, std::uint32_t TaskIndex);
+
+    /* Variant builders, run on a worker; handles are published on success. */
+    bool CreateDepthPrepassVariant(VkDevice Device, VkRenderPass RenderPass);
+    bool CreateWeightedOITVariant(VkDevice Device, VkRenderPass RenderPass);
+    bool CreateCullVariant(VkDevice Device);
+
     /* Main render pipelines. */
     VkPipeline SkyPipeline = VK_NULL_HANDLE;
     VkPipeline WorldPipeline = VK_NULL_HANDLE;
+    VkPipeline WorldEqualPipeline = VK_NULL_HANDLE;
+    VkPipeline DepthPrepassPipeline = VK_NULL_HANDLE;
+
+    /* Weighted blended OIT pipelines. */
+    VkPipeline WeightedBlendPipeline = VK_NULL_HANDLE;
+    VkPipeline CompositePipeline = VK_NULL_HANDLE;
 
     /* Shadow render pipeline. */
     VkPipeline ShadowPipeline = VK_NULL_HANDLE;
 
+    /* GPU culling compute pipeline. */
+    VkPipeline CullPipeline = VK_NULL_HANDLE;
+
     /* Pipeline layouts. */
     VkPipelineLayout PipelineLayout = VK_NULL_HANDLE;
     VkPipelineLayout ShadowPipelineLayout = VK_NULL_HANDLE;
+    VkPipelineLayout CompositePipelineLayout = VK_NULL_HANDLE;
+    VkPipelineLayout CullPipelineLayout = VK_NULL_HANDLE;
+
+    /* What a queued compile needs, one slot per variant. */
+    struct VariantJob
+    {
+        VulkanPipeline* Owner = nullptr;
+        VkDevice Device = VK_NULL_HANDLE;
+        VkRenderPass RenderPass = VK_NULL_HANDLE;
+        PipelineVariant Variant = PipelineVariant::Count;
+    };
+
+    /* Queued compiles and their ready flags, set with release ordering */
+    /* after the variant's handles are written. */
+    VariantJob VariantJobs[static_cast<std::size_t>(PipelineVariant::Count)];
+    std::atomic<bool> VariantReady[static_cast<std::size_t>(PipelineVariant::Count)];
 };
@@ -26,9 +26,13 @@
 #pragma once
 
 #include "../Core/VulkanBuffer.h"
+#include "../../../Math/MathTypes.h"
+#include "../../../Scene/Collision/AABB.h"
+#include "../../../Scene/Collision/TriangleBVH.h"
 
 #include <vulkan/vulkan.h>
 #include <cstdint>
+#include <vector>
 
 /* GPU mesh data container. */
 struct Mesh
@@ -42,13 +46,135 @@ struct Mesh
     std::uint32_t IndexCount = 0;
     bool HasIndex = false;
 
+    /* CPU-side object-space geometry kept for queries. */
+    /* Indices form a triangle list, empty means unindexed positions. */
+    std::vector<Vec3> Positions;
+    std::vector<std::uint32_t> Indices;
+
+    /* Object-space bounds of Positions. */
+    AABB LocalBounds;
+
+    /* Optional triangle hierarchy for exact queries. */
+    TriangleBVH BVH;
+
+    /* Render resource handle, also the sort key id, 0 until registered. */
+    std::uint32_t Handle = 0;
+
+    /* True when CPU triangle data is available. */
+    bool HasGeometry() const
+    {
+        return !Positions.empty();
+    }
+
+    /* Number of CPU-side triangles. */
+    std::uint32_t GetTriangleCount() const
+    {
+        const std::size_t count = Indices.empty() ? Positions.size() : Indices.size();
+        return static_cast<std::uint32_t>(count / 3);
+    }
+
+    /* Fetch the corner positions of a CPU-side triangle. */
+    void GetTriangle(std::uint32_t Triangle, Vec3& OutA, Vec3& OutB, Vec3& OutC) const
+    {
+        const std::size_t base = static_cast<std::size_t>(Triangle) * 3;
+        if (Indices.empty())
+        {
+            OutA = Positions[base + 0];
+            OutB = Positions[base + 1];
+            OutC = Positions[base + 2];
+            return;
+        }
+
+        OutA = Positions[Indices[base + 0]];
+        OutB = Positions[Indices[base + 1]];
+        OutC = Positions[Indices[base + 2]];
+    }
+
+    /* Recompute LocalBounds from Positions. */
+    void UpdateLocalBounds()
+    {
+        if (Positions.empty())
+        {
+            LocalBounds = AABB{};
+            return;
+        }
+
+        LocalBounds.Min = Positions[0];
+        LocalBounds.Max = Positions[0];
+        for (const Vec3& position : Positions)
+        {
+            LocalBounds.Min = Vec3(
+                position.x < LocalBounds.Min.x ? position.x : LocalBounds.Min.x,
+                position.y < LocalBounds.Min.y ? position.y : LocalBounds.Min.y,
+                position.z < LocalBounds.Min.z ? position.z : LocalBounds.Min.z);
+            LocalBounds.Max = Vec3(
+                position.x > LocalBounds.Max.x ? position.x : LocalBounds.Max.x,
+                position.y > LocalBounds.Max.y ? position.y : LocalBounds.Max.y,
+                position.z > LocalBounds.Max.z ? position.z : LocalBounds.Max.z);
+        }
+    }
+
     /* Release GPU buffers and reset state. */
-    void Destroy(VkDevice Device)
+    void Destroy()
     {
-        VertexBuffer.Destroy(Device);
-        IndexBuffer.Destroy(Device);
+        VertexBuffer.Destroy();
+        IndexBuffer.Destroy();
         VertexCount = 0;
         IndexCount = 0;
         HasIndex = false;
+        Positions.clear();
+        Indices.clear();
+        LocalBounds = AABB{};
+        BVH.Clear();
+    }
+};
+
+/* Discrete levels of detail for one mesh, finest first. */
+struct MeshLODChain
+{
+    /* Upper bound on levels, including the source mesh. */
+    static constexpr std::uint32_t kMaxLevels = 4;
+
+    /* Levels in use, each with its own buffers and render handle. */
+    Mesh Levels[kMaxLevels];
+    std::uint32_t LevelCount = 0;
+
+    /* Projected height, as a fraction of the viewport, below which */
+    /* each level replaces the finer one before it. Entry 0 is unused. */
+    float SwitchScreenSizes[kMaxLevels] = {};
+
+    /* Level for a projected size, starting from the current level. */
+    /* A switch size must be crossed by the hysteresis fraction, so */
+    /* instances hovering at a threshold do not flicker between levels. */
+    std::uint32_t SelectLevel(float ScreenSize, std::uint32_t CurrentLevel, float Hysteresis) const
+    {
+        if (LevelCount == 0)
+        {
+            return 0;
+        }
+
+        std::uint32_t level = CurrentLevel < LevelCount ? CurrentLevel : LevelCount - 1;
+        while (level + 1 < LevelCount &&
+            ScreenSize < SwitchScreenSizes[level + 1] * (1.0f - Hysteresis))
+        {
+            ++level;
+        }
+
+        while (level > 0 && ScreenSize > SwitchScreenSizes[level] * (1.0f + Hysteresis))
+        {
+            --level;
+        }
+
+        return level;
+    }
+
+    /* Release every level and reset state. */
+    void Destroy()
+    {
+        for (std::uint32_t level = 0; level < LevelCount; ++level)
+        {
+            Levels[level].Destroy();
+        }
+        LevelCount = 0;
     }
 };
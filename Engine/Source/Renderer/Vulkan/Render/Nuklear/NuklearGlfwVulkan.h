@@ -261,13 +261,15 @@ nk_glfw3_init(GLFWwindow *win, VkDevice logical_device,
               uint32_t graphics_queue_family_index, VkImageView *image_views,
               uint32_t image_views_len, VkFormat color_format,
               enum nk_glfw_init_state init_state,
-              VkDeviceSize max_vertex_buffer, VkDeviceSize max_element_buffer);
+              VkDeviceSize max_vertex_buffer, VkDeviceSize max_element_buffer,
+              uint32_t frame_count);
 NK_API void nk_glfw3_shutdown(void);
 NK_API void nk_glfw3_font_stash_begin(struct nk_font_atlas **atlas);
 NK_API void nk_glfw3_font_stash_end(VkQueue graphics_queue);
 NK_API void nk_glfw3_new_frame();
 NK_API VkSemaphore nk_glfw3_render(VkQueue graphics_queue,
                                    uint32_t buffer_index,
+                                   uint32_t frame_index,
                                    VkSemaphore wait_semaphore,
                                    enum nk_anti_aliasing AA);
 NK_API void nk_glfw3_resize(uint32_t framebuffer_width,
@@ -278,7 +280,8 @@ NK_API void nk_glfw3_device_create(
     uint32_t graphics_queue_family_index, VkImageView *image_views,
     uint32_t image_views_len, VkFormat color_format,
     VkDeviceSize max_vertex_buffer, VkDeviceSize max_element_buffer,
-    uint32_t framebuffer_width, uint32_t framebuffer_height);
+    uint32_t frame_count, uint32_t framebuffer_width,
+    uint32_t framebuffer_height);
 
 NK_API void nk_glfw3_char_callback(GLFWwindow *win, unsigned int codepoint);
 NK_API void nk_glfw3_key_callback(GLFWwindow *win, int key, int scancode, int action, int mods);
@@ -326,6 +329,21 @@ struct nk_vulkan_texture_descriptor_set {
     VkDescriptorSet descriptor_set;
 };
 
+/* Geometry and projection written each frame, one set per frame in flight
+ * so a frame can be filled while the previous ones are still drawing. */
+struct nk_glfw_frame_resources {
+    VkBuffer vertex_buffer;
+    VkDeviceMemory vertex_memory;
+    void *mapped_vertex;
+    VkBuffer index_buffer;
+    VkDeviceMemory index_memory;
+    void *mapped_index;
+    VkBuffer uniform_buffer;
+    VkDeviceMemory uniform_memory;
+    void *mapped_uniform;
+    VkDescriptorSet uniform_descriptor_set;
+};
+
 struct nk_glfw_device {
     struct nk_buffer cmds;
     struct nk_draw_null_texture tex_null;
@@ -343,19 +361,11 @@ struct nk_glfw_device {
     VkSampler sampler;
     VkCommandPool command_pool;
     VkSemaphore render_completed;
-    VkBuffer vertex_buffer;
-    VkDeviceMemory vertex_memory;
-    void *mapped_vertex;
-    VkBuffer index_buffer;
-    VkDeviceMemory index_memory;
-    void *mapped_index;
-    VkBuffer uniform_buffer;
-    VkDeviceMemory uniform_memory;
-    void *mapped_uniform;
+    struct nk_glfw_frame_resources *frames;
+    uint32_t frames_len;
     VkRenderPass render_pass;
     VkDescriptorPool descriptor_pool;
     VkDescriptorSetLayout uniform_descriptor_set_layout;
-    VkDescriptorSet uniform_descriptor_set;
     VkDescriptorSetLayout texture_descriptor_set_layout;
     struct nk_vulkan_texture_descriptor_set *texture_descriptor_sets;
     uint32_t texture_descriptor_sets_len;
@@ -600,7 +610,7 @@ NK_INTERN void nk_glfw3_create_descriptor_pool(struct nk_glfw_device *dev) {
 
     memset(&pool_sizes, 0, sizeof(VkDescriptorPoolSize) * 2);
     pool_sizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    pool_sizes[0].descriptorCount = 1;
+    pool_sizes[0].descriptorCount = dev->frames_len;
     pool_sizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     pool_sizes[1].descriptorCount = NK_GLFW_MAX_TEXTURES;
 
@@ -608,7 +618,7 @@ NK_INTERN void nk_glfw3_create_descriptor_pool(struct nk_glfw_device *dev) {
     pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     pool_info.poolSizeCount = 2;
     pool_info.pPoolSizes = pool_sizes;
-    pool_info.maxSets = 1 + NK_GLFW_MAX_TEXTURES;
+    pool_info.maxSets = dev->frames_len + NK_GLFW_MAX_TEXTURES;
 
     result = vkCreateDescriptorPool(dev->logical_device, &pool_info, NULL,
                                     &dev->descriptor_pool);
@@ -646,32 +656,38 @@ nk_glfw3_create_and_update_uniform_descriptor_set(struct nk_glfw_device *dev) {
     VkDescriptorBufferInfo buffer_info;
     VkWriteDescriptorSet descriptor_write;
     VkResult result;
+    uint32_t i;
 
-    memset(&allocate_info, 0, sizeof(VkDescriptorSetAllocateInfo));
-    allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocate_info.descriptorPool = dev->descriptor_pool;
-    allocate_info.descriptorSetCount = 1;
-    allocate_info.pSetLayouts = &dev->uniform_descriptor_set_layout;
+    for (i = 0; i < dev->frames_len; i++) {
+        struct nk_glfw_frame_resources *frame = &dev->frames[i];
 
-    result = vkAllocateDescriptorSets(dev->logical_device, &allocate_info,
-                                      &dev->uniform_descriptor_set);
-    NK_ASSERT(result == VK_SUCCESS);
-
-    memset(&buffer_info, 0, sizeof(VkDescriptorBufferInfo));
-    buffer_info.buffer = dev->uniform_buffer;
-    buffer_info.offset = 0;
-    buffer_info.range = sizeof(struct Mat4f);
+        memset(&allocate_info, 0, sizeof(VkDescriptorSetAllocateInfo));
+        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool = dev->descriptor_pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &dev->uniform_descriptor_set_layout;
 
-    memset(&descriptor_write, 0, sizeof(VkWriteDescriptorSet));
-    descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptor_write.dstSet = dev->uniform_descriptor_set;
-    descriptor_write.dstBinding = 0;
-    descriptor_write.dstArrayElement = 0;
-    descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    descriptor_write.descriptorCount = 1;
-    descriptor_write.pBufferInfo = &buffer_info;
+        result = vkAllocateDescriptorSets(dev->logical_device, &allocate_info,
+                                          &frame->uniform_descriptor_set);
+        NK_ASSERT(result == VK_SUCCESS);
 
-    vkUpdateDescriptorSets(dev->logical_device, 1, &descriptor_write, 0, NULL);
+        memset(&buffer_info, 0, sizeof(VkDescriptorBufferInfo));
+        buffer_info.buffer = frame->uniform_buffer;
+        buffer_info.offset = 0;
+        buffer_info.range = sizeof(struct Mat4f);
+
+        memset(&descriptor_write, 0, sizeof(VkWriteDescriptorSet));
+        descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_write.dstSet = frame->uniform_descriptor_set;
+        descriptor_write.dstBinding = 0;
+        descriptor_write.dstArrayElement = 0;
+        descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        descriptor_write.descriptorCount = 1;
+        descriptor_write.pBufferInfo = &buffer_info;
+
+        vkUpdateDescriptorSets(dev->logical_device, 1, &descriptor_write, 0,
+                               NULL);
+    }
 }
 
 NK_INTERN void
@@ -925,8 +941,10 @@ NK_API void nk_glfw3_device_create(
     uint32_t graphics_queue_family_index, VkImageView *image_views,
     uint32_t image_views_len, VkFormat color_format,
     VkDeviceSize max_vertex_buffer, VkDeviceSize max_element_buffer,
-    uint32_t framebuffer_width, uint32_t framebuffer_height) {
+    uint32_t frame_count, uint32_t framebuffer_width,
+    uint32_t framebuffer_height) {
     struct nk_glfw_device *dev = &glfw.vulkan;
+    uint32_t i;
     dev->max_vertex_buffer = max_vertex_buffer;
     dev->max_element_buffer = max_element_buffer;
     nk_buffer_init_default(&dev->cmds);
@@ -943,22 +961,31 @@ NK_API void nk_glfw3_device_create(
     nk_glfw3_create_command_buffers(dev);
     nk_glfw3_create_semaphore(dev);
 
-    nk_glfw3_create_buffer_and_memory(dev, &dev->vertex_buffer,
-                                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                                      &dev->vertex_memory, max_vertex_buffer);
-    nk_glfw3_create_buffer_and_memory(dev, &dev->index_buffer,
-                                      VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                                      &dev->index_memory, max_element_buffer);
-    nk_glfw3_create_buffer_and_memory(
-        dev, &dev->uniform_buffer, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-        &dev->uniform_memory, sizeof(struct Mat4f));
-
-    vkMapMemory(dev->logical_device, dev->vertex_memory, 0, max_vertex_buffer,
-                0, &dev->mapped_vertex);
-    vkMapMemory(dev->logical_device, dev->index_memory, 0, max_element_buffer,
-                0, &dev->mapped_index);
-    vkMapMemory(dev->logical_device, dev->uniform_memory, 0,
-                sizeof(struct Mat4f), 0, &dev->mapped_uniform);
+    dev->frames_len = frame_count > 0 ? frame_count : 1;
+    dev->frames = (struct nk_glfw_frame_resources *)calloc(
+        dev->frames_len, sizeof(struct nk_glfw_frame_resources));
+    for (i = 0; i < dev->frames_len; i++) {
+        struct nk_glfw_frame_resources *frame = &dev->frames[i];
+
+        nk_glfw3_create_buffer_and_memory(dev, &frame->vertex_buffer,
+                                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                          &frame->vertex_memory,
+                                          max_vertex_buffer);
+        nk_glfw3_create_buffer_and_memory(dev, &frame->index_buffer,
+                                          VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                          &frame->index_memory,
+                                          max_element_buffer);
+        nk_glfw3_create_buffer_and_memory(
+            dev, &frame->uniform_buffer, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            &frame->uniform_memory, sizeof(struct Mat4f));
+
+        vkMapMemory(dev->logical_device, frame->vertex_memory, 0,
+                    max_vertex_buffer, 0, &frame->mapped_vertex);
+        vkMapMemory(dev->logical_device, frame->index_memory, 0,
+                    max_element_buffer, 0, &frame->mapped_index);
+        vkMapMemory(dev->logical_device, frame->uniform_memory, 0,
+                    sizeof(struct Mat4f), 0, &frame->mapped_uniform);
+    }
 
     nk_glfw3_create_render_resources(dev, framebuffer_width,
                                      framebuffer_height);
@@ -1190,6 +1217,7 @@ NK_API void nk_glfw3_resize(uint32_t framebuffer_width,
 
 NK_API void nk_glfw3_device_destroy(void) {
     struct nk_glfw_device *dev = &glfw.vulkan;
+    uint32_t i;
 
     vkDeviceWaitIdle(dev->logical_device);
 
@@ -1200,17 +1228,24 @@ NK_API void nk_glfw3_device_destroy(void) {
     vkDestroyCommandPool(dev->logical_device, dev->command_pool, NULL);
     vkDestroySemaphore(dev->logical_device, dev->render_completed, NULL);
 
-    vkUnmapMemory(dev->logical_device, dev->vertex_memory);
-    vkUnmapMemory(dev->logical_device, dev->index_memory);
-    vkUnmapMemory(dev->logical_device, dev->uniform_memory);
+    for (i = 0; i < dev->frames_len; i++) {
+        struct nk_glfw_frame_resources *frame = &dev->frames[i];
 
-    vkFreeMemory(dev->logical_device, dev->vertex_memory, NULL);
-    vkFreeMemory(dev->logical_device, dev->index_memory, NULL);
-    vkFreeMemory(dev->logical_device, dev->uniform_memory, NULL);
+        vkUnmapMemory(dev->logical_device, frame->vertex_memory);
+        vkUnmapMemory(dev->logical_device, frame->index_memory);
+        vkUnmapMemory(dev->logical_device, frame->uniform_memory);
 
-    vkDestroyBuffer(dev->logical_device, dev->vertex_buffer, NULL);
-    vkDestroyBuffer(dev->logical_device, dev->index_buffer, NULL);
-    vkDestroyBuffer(dev->logical_device, dev->uniform_buffer, NULL);
+        vkFreeMemory(dev->logical_device, frame->vertex_memory, NULL);
+        vkFreeMemory(dev->logical_device, frame->index_memory, NULL);
+        vkFreeMemory(dev->logical_device, frame->uniform_memory, NULL);
+
+        vkDestroyBuffer(dev->logical_device, frame->vertex_buffer, NULL);
+        vkDestroyBuffer(dev->logical_device, frame->index_buffer, NULL);
+        vkDestroyBuffer(dev->logical_device, frame->uniform_buffer, NULL);
+    }
+    free(dev->frames);
+    dev->frames = NULL;
+    dev->frames_len = 0;
 
     vkDestroySampler(dev->logical_device, dev->sampler, NULL);
 
@@ -1382,9 +1417,12 @@ NK_INTERN void update_texture_descriptor_set(
 
 NK_API
 VkSemaphore nk_glfw3_render(VkQueue graphics_queue, uint32_t buffer_index,
+                            uint32_t frame_index,
                             VkSemaphore wait_semaphore,
                             enum nk_anti_aliasing AA) {
     struct nk_glfw_device *dev = &glfw.vulkan;
+    struct nk_glfw_frame_resources *frame =
+        &dev->frames[frame_index % dev->frames_len];
     struct nk_buffer vbuf, ebuf;
 
     struct Mat4f projection = {
@@ -1412,7 +1450,7 @@ VkSemaphore nk_glfw3_render(VkQueue graphics_queue, uint32_t buffer_index,
     projection.m[0] /= glfw.width;
     projection.m[5] /= glfw.height;
 
-    memcpy(dev->mapped_uniform, &projection, sizeof(projection));
+    memcpy(frame->mapped_uniform, &projection, sizeof(projection));
 
     memset(&begin_info, 0, sizeof(VkCommandBufferBeginInfo));
     begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -1443,7 +1481,7 @@ VkSemaphore nk_glfw3_render(VkQueue graphics_queue, uint32_t buffer_index,
                       dev->pipeline);
     vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                             dev->pipeline_layout, 0, 1,
-                            &dev->uniform_descriptor_set, 0, NULL);
+                            &frame->uniform_descriptor_set, 0, NULL);
     {
         /* convert from command queue into draw list and draw to screen */
         const struct nk_draw_command *cmd;
@@ -1473,18 +1511,18 @@ VkSemaphore nk_glfw3_render(VkQueue graphics_queue, uint32_t buffer_index,
             config.line_AA = AA;
 
             /* setup buffers to load vertices and elements */
-            nk_buffer_init_fixed(&vbuf, dev->mapped_vertex,
+            nk_buffer_init_fixed(&vbuf, frame->mapped_vertex,
                                  (size_t)dev->max_vertex_buffer);
-            nk_buffer_init_fixed(&ebuf, dev->mapped_index,
+            nk_buffer_init_fixed(&ebuf, frame->mapped_index,
                                  (size_t)dev->max_element_buffer);
             nk_convert(&glfw.ctx, &dev->cmds, &vbuf, &ebuf, &config);
         }
 
         /* iterate over and execute each draw command */
 
-        vkCmdBindVertexBuffers(command_buffer, 0, 1, &dev->vertex_buffer,
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &frame->vertex_buffer,
                                &doffset);
-        vkCmdBindIndexBuffer(command_buffer, dev->index_buffer, 0,
+        vkCmdBindIndexBuffer(command_buffer, frame->index_buffer, 0,
                              VK_INDEX_TYPE_UINT16);
 
         nk_draw_foreach(cmd, &glfw.ctx, &dev->cmds) {
@@ -1686,7 +1724,8 @@ nk_glfw3_init(GLFWwindow *win, VkDevice logical_device,
               uint32_t graphics_queue_family_index, VkImageView *image_views,
               uint32_t image_views_len, VkFormat color_format,
               enum nk_glfw_init_state init_state,
-              VkDeviceSize max_vertex_buffer, VkDeviceSize max_element_buffer) {
+              VkDeviceSize max_vertex_buffer, VkDeviceSize max_element_buffer,
+              uint32_t frame_count) {
     memset(&glfw, 0, sizeof(struct nk_glfw));
     glfw.win = win;
     if (init_state == NK_GLFW3_INSTALL_CALLBACKS) {
@@ -1707,7 +1746,8 @@ nk_glfw3_init(GLFWwindow *win, VkDevice logical_device,
     nk_glfw3_device_create(logical_device, physical_device,
                            graphics_queue_family_index, image_views,
                            image_views_len, color_format, max_vertex_buffer,
-                           max_element_buffer, (uint32_t)glfw.display_width,
+                           max_element_buffer, frame_count,
+                           (uint32_t)glfw.display_width,
                            (uint32_t)glfw.display_height);
 
     glfw.is_double_click_down = nk_false;
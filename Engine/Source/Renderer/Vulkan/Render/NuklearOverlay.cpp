@@ -60,12 +60,22 @@ NuklearOverlay::NuklearOverlay()
     , WindowHandle(nullptr)
     , MaxVertexBuffer(512 * 1024)
     , MaxIndexBuffer(128 * 1024)
+    , FrameCount(1)
     , Initialized(false)
     , LastDeltaTime(0.0f)
     , LastFps(0.0f)
     , LastDrawCalls(0)
     , LastTriangleCount(0)
     , LastVertexCount(0)
+    , LastSubmittedCount(0)
+    , LastCulledCount(0)
+    , LastOccludedCount(0)
+    , LastDrawnCount(0)
+    , PipelineCacheWarm(false)
+    , PipelineStartupComplete(false)
+    , PipelineCount(0)
+    , PipelineStartupMs(0.0f)
+    , PipelineSavedMs(0.0f)
     , SelectedEntity()
     , Inspector()
     , PendingTransformEdit()
@@ -84,7 +94,8 @@ bool NuklearOverlay::Initialize(
     VkQueue graphicsQueue,
     VkFormat colorFormat,
     const std::vector<VkImageView>& imageViews,
-    VkExtent2D extent)
+    VkExtent2D extent,
+    std::uint32_t frameCount)
 {
     if (!windowHandle || device == VK_NULL_HANDLE || physicalDevice == VK_NULL_HANDLE)
     {
@@ -93,6 +104,7 @@ bool NuklearOverlay::Initialize(
 
     WindowHandle = windowHandle;
     SwapchainImageViews = imageViews;
+    FrameCount = frameCount > 0 ? frameCount : 1;
 
     Context = nk_glfw3_init(
         windowHandle,
@@ -104,7 +116,8 @@ bool NuklearOverlay::Initialize(
         colorFormat,
         NK_GLFW3_DEFAULT,
         MaxVertexBuffer,
-        MaxIndexBuffer);
+        MaxIndexBuffer,
+        FrameCount);
 
     if (!Context)
     {
@@ -161,7 +174,7 @@ void NuklearOverlay::BeginFrame(float deltaTime)
     const float selectionInfoHeight = 120.0f;
     const float rightX = std::max(margin, windowWidth - inspectorWidth - margin);
 
-    const struct nk_rect bounds = nk_rect(margin, margin, leftPanelWidth, 110.0f);
+    const struct nk_rect bounds = nk_rect(margin, margin, leftPanelWidth, 172.0f);
     const nk_flags flags = NK_WINDOW_NO_INPUT | NK_WINDOW_NO_SCROLLBAR | NK_WINDOW_BORDER;
 
     if (nk_begin(Context, "Performance", bounds, flags))
@@ -170,13 +183,27 @@ void NuklearOverlay::BeginFrame(float deltaTime)
         nk_labelf(Context, NK_TEXT_LEFT, "FPS: %.1f", LastFps);
         nk_labelf(Context, NK_TEXT_LEFT, "Frame: %.2f ms", LastDeltaTime * 1000.0f);
         nk_labelf(Context, NK_TEXT_LEFT, "Draw Calls: %u", LastDrawCalls);
+        nk_labelf(Context, NK_TEXT_LEFT, "Submitted: %u  Culled: %u", LastSubmittedCount, LastCulledCount);
+        nk_labelf(Context, NK_TEXT_LEFT, "Drawn: %u  Occluded: %u", LastDrawnCount, LastOccludedCount);
         nk_labelf(Context, NK_TEXT_LEFT, "Triangles: %llu", static_cast<unsigned long long>(LastTriangleCount));
         nk_labelf(Context, NK_TEXT_LEFT, "Vertices: %llu", static_cast<unsigned long long>(LastVertexCount));
+        if (!PipelineStartupComplete)
+        {
+            nk_labelf(Context, NK_TEXT_LEFT, "Pipelines: %u in %.0f ms (compiling)", PipelineCount, PipelineStartupMs);
+        }
+        else if (PipelineCacheWarm)
+        {
+            nk_labelf(Context, NK_TEXT_LEFT, "Pipelines: %u in %.0f ms (saved %.0f)", PipelineCount, PipelineStartupMs, PipelineSavedMs);
+        }
+        else
+        {
+            nk_labelf(Context, NK_TEXT_LEFT, "Pipelines: %u in %.0f ms (cold)", PipelineCount, PipelineStartupMs);
+        }
     }
 
     nk_end(Context);
 
-    const struct nk_rect entityBounds = nk_rect(margin, 130.0f, leftPanelWidth, 260.0f);
+    const struct nk_rect entityBounds = nk_rect(margin, 192.0f, leftPanelWidth, 260.0f);
     const nk_flags entityFlags = NK_WINDOW_BORDER | NK_WINDOW_TITLE;
 
     if (nk_begin(Context, "Entities", entityBounds, entityFlags))
@@ -373,9 +400,36 @@ void NuklearOverlay::SetRenderStats(
     LastVertexCount = vertexCount;
 }
 
+void NuklearOverlay::SetCullStats(
+    std::uint32_t submittedCount,
+    std::uint32_t culledCount,
+    std::uint32_t occludedCount,
+    std::uint32_t drawnCount)
+{
+    LastSubmittedCount = submittedCount;
+    LastCulledCount = culledCount;
+    LastOccludedCount = occludedCount;
+    LastDrawnCount = drawnCount;
+}
+
+void NuklearOverlay::SetPipelineCacheStats(
+    bool warm,
+    bool startupComplete,
+    std::uint32_t pipelineCount,
+    float startupMilliseconds,
+    float savedMilliseconds)
+{
+    PipelineCacheWarm = warm;
+    PipelineStartupComplete = startupComplete;
+    PipelineCount = pipelineCount;
+    PipelineStartupMs = startupMilliseconds;
+    PipelineSavedMs = savedMilliseconds;
+}
+
 VkSemaphore NuklearOverlay::Render(
     VkQueue graphicsQueue,
     std::uint32_t imageIndex,
+    std::uint32_t frameIndex,
     VkSemaphore waitSemaphore)
 {
     if (!Initialized)
@@ -386,6 +440,7 @@ VkSemaphore NuklearOverlay::Render(
     return nk_glfw3_render(
         graphicsQueue,
         imageIndex,
+        frameIndex,
         waitSemaphore,
         NK_ANTI_ALIASING_ON);
 }
@@ -416,6 +471,7 @@ void NuklearOverlay::Resize(
         colorFormat,
         MaxVertexBuffer,
         MaxIndexBuffer,
+        FrameCount,
         extent.width,
         extent.height);
 
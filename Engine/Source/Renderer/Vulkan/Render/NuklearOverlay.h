@@ -73,7 +73,8 @@ public:
         VkQueue graphicsQueue,
         VkFormat colorFormat,
         const std::vector<VkImageView>& imageViews,
-        VkExtent2D extent);
+        VkExtent2D extent,
+        std::uint32_t frameCount);
 
     void Shutdown();
 
@@ -91,9 +92,23 @@ public:
         std::uint64_t triangleCount,
         std::uint64_t vertexCount);
 
+    void SetCullStats(
+        std::uint32_t submittedCount,
+        std::uint32_t culledCount,
+        std::uint32_t occludedCount,
+        std::uint32_t drawnCount);
+
+    void SetPipelineCacheStats(
+        bool warm,
+        bool startupComplete,
+        std::uint32_t pipelineCount,
+        float startupMilliseconds,
+        float savedMilliseconds);
+
     VkSemaphore Render(
         VkQueue graphicsQueue,
         std::uint32_t imageIndex,
+        std::uint32_t frameIndex,
         VkSemaphore waitSemaphore);
 
     void Resize(
@@ -115,12 +130,22 @@ private:
     std::vector<VkImageView> SwapchainImageViews;
     VkDeviceSize MaxVertexBuffer;
     VkDeviceSize MaxIndexBuffer;
+    std::uint32_t FrameCount;
     bool Initialized;
     float LastDeltaTime;
     float LastFps;
     std::uint32_t LastDrawCalls;
     std::uint64_t LastTriangleCount;
     std::uint64_t LastVertexCount;
+    std::uint32_t LastSubmittedCount;
+    std::uint32_t LastCulledCount;
+    std::uint32_t LastOccludedCount;
+    std::uint32_t LastDrawnCount;
+    bool PipelineCacheWarm;
+    bool PipelineStartupComplete;
+    std::uint32_t PipelineCount;
+    float PipelineStartupMs;
+    float PipelineSavedMs;
     std::vector<Entity> SceneEntities;
     Entity SelectedEntity;
     InspectorData Inspector;
@@ -26,18 +26,148 @@
 #include "ObjLoader.h"
 
 #include "../../../Math/MathTypes.h"
+#include "../../MeshSimplifier.h"
 
+#include <cmath>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <cstdio>
+#include <utility>
+
+/* Local helpers. */
+namespace
+{
+    /* Meshes this small are left at their last level. */
+    constexpr std::uint32_t kMinLODTriangles = 16;
+
+    /* A level must keep at most this fraction of its parent's triangles. */
+    constexpr float kMinLODReduction = 0.9f;
+
+    /* Cache file for a source mesh, "<name>.<path hash>.bvh". */
+    /* The hash keeps same-named meshes from different folders apart. */
+    std::string GetBVHCachePath(const std::string& directory, const std::string& sourcePath)
+    {
+        std::uint64_t hash = 1469598103934665603ull;
+        for (const char character : sourcePath)
+        {
+            hash = (hash ^ static_cast<unsigned char>(character)) * 1099511628211ull;
+        }
+
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), ".%016llx.bvh", static_cast<unsigned long long>(hash));
+
+        const std::filesystem::path name = std::filesystem::path(sourcePath).filename();
+        return (std::filesystem::path(directory) / name).string() + suffix;
+    }
+}
+
+/* Build normals, upload GPU buffers, and keep CPU geometry. */
+bool ObjLoader::UploadMesh(
+    std::vector<Vec3> positions,
+    const std::vector<uint32_t>& indices,
+    Mesh& mesh)
+{
+    /* Setup mesh counts */
+    mesh.VertexCount = static_cast<uint32_t>(positions.size());
+    mesh.HasIndex = !indices.empty();
+    mesh.IndexCount = static_cast<uint32_t>(indices.size());
+
+    /* Generate per-vertex normals */
+    std::vector<Vec3> normals(positions.size(), Vec3(0.0f, 0.0f, 0.0f));
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        uint32_t ia = indices[i + 0];
+        uint32_t ib = indices[i + 1];
+        uint32_t ic = indices[i + 2];
+
+        if (ia >= positions.size() || ib >= positions.size() || ic >= positions.size())
+        {
+            continue;
+        }
+
+        const Vec3& a = positions[ia];
+        const Vec3& b = positions[ib];
+        const Vec3& c = positions[ic];
+
+        Vec3 ab = b - a;
+        Vec3 ac = c - a;
+        Vec3 n = Vec3::Cross(ab, ac);
+
+        normals[ia] = normals[ia] + n;
+        normals[ib] = normals[ib] + n;
+        normals[ic] = normals[ic] + n;
+    }
+
+    for (Vec3& n : normals)
+    {
+        n = n.Normalized();
+    }
+
+    /* Interleave position and normal data */
+    std::vector<float> vertexData;
+    vertexData.reserve(positions.size() * 6);
+
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        const Vec3& p = positions[i];
+        const Vec3& n = normals[i];
+
+        vertexData.push_back(p.x);
+        vertexData.push_back(p.y);
+        vertexData.push_back(p.z);
+        vertexData.push_back(n.x);
+        vertexData.push_back(n.y);
+        vertexData.push_back(n.z);
+    }
+
+    /* Upload vertex buffer */
+    if (!mesh.VertexBuffer.CreateVertexBuffer(
+        vertexData.data(),
+        vertexData.size() * sizeof(float)))
+    {
+        std::fprintf(stderr, "ObjLoader::UploadMesh: Failed to create vertex buffer\n");
+        mesh.Destroy();
+        return false;
+    }
+
+    /* Upload index buffer if present */
+    if (mesh.HasIndex)
+    {
+        if (!mesh.IndexBuffer.CreateIndexBuffer(
+            indices.data(),
+            mesh.IndexCount))
+        {
+            std::fprintf(stderr, "ObjLoader::UploadMesh: Failed to create index buffer\n");
+            mesh.Destroy();
+            return false;
+        }
+    }
+
+    /* Keep object-space triangles for CPU queries, skipping broken faces. */
+    mesh.Indices.reserve(indices.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        if (indices[i + 0] < positions.size() &&
+            indices[i + 1] < positions.size() &&
+            indices[i + 2] < positions.size())
+        {
+            mesh.Indices.push_back(indices[i + 0]);
+            mesh.Indices.push_back(indices[i + 1]);
+            mesh.Indices.push_back(indices[i + 2]);
+        }
+    }
+    mesh.Positions = std::move(positions);
+    mesh.UpdateLocalBounds();
+
+    return true;
+}
 
 Mesh ObjLoader::LoadOBJ(
     const std::string& Path,
-    VkPhysicalDevice PhysicalDevice,
-    VkDevice Device,
-    VkQueue Queue,
-    uint32_t QueueFamily)
+    const ObjLoadOptions& Options)
 {
     /* Parse OBJ file and build GPU mesh buffers. */
 
@@ -126,90 +256,90 @@ Mesh ObjLoader::LoadOBJ(
         return mesh;
     }
 
-    /* Setup mesh counts */
-    mesh.VertexCount = static_cast<uint32_t>(positions.size());
-    mesh.HasIndex = !indices.empty();
-    mesh.IndexCount = static_cast<uint32_t>(indices.size());
-
-    /* Generate per-vertex normals */
-    std::vector<Vec3> normals(positions.size(), Vec3(0.0f, 0.0f, 0.0f));
+    /* Upload GPU buffers and keep CPU geometry. */
+    if (!UploadMesh(std::move(positions), indices, mesh))
+    {
+        std::fprintf(stderr, "ObjLoader::LoadOBJ: Failed to upload %s\n", Path.c_str());
+        return Mesh{};
+    }
 
-    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    /* Build or reload the triangle hierarchy. */
+    if (Options.BuildTriangleBVH && mesh.GetTriangleCount() > 0)
     {
-        uint32_t ia = indices[i + 0];
-        uint32_t ib = indices[i + 1];
-        uint32_t ic = indices[i + 2];
+        const std::string cachePath = GetBVHCachePath(Options.BVHCacheDirectory, Path);
+        const std::uint64_t sourceHash =
+            TriangleBVH::ComputeSourceHash(mesh.Positions, mesh.Indices);
 
-        if (ia >= positions.size() || ib >= positions.size() || ic >= positions.size())
+        const bool cached =
+            Options.UseBVHCache && mesh.BVH.LoadFromFile(cachePath, sourceHash);
+
+        if (!cached && mesh.BVH.Build(mesh.Positions, mesh.Indices) && Options.UseBVHCache)
         {
-            continue;
+            mesh.BVH.SaveToFile(cachePath);
         }
+    }
 
-        const Vec3& a = positions[ia];
-        const Vec3& b = positions[ib];
-        const Vec3& c = positions[ic];
-
-        Vec3 ab = b - a;
-        Vec3 ac = c - a;
-        Vec3 n = Vec3::Cross(ab, ac);
+    return mesh;
+}
 
-        normals[ia] = normals[ia] + n;
-        normals[ib] = normals[ib] + n;
-        normals[ic] = normals[ic] + n;
-    }
+MeshLODChain ObjLoader::LoadOBJLODChain(
+    const std::string& Path,
+    const ObjLoadOptions& Options)
+{
+    MeshLODChain chain{};
 
-    for (Vec3& n : normals)
+    /* Level 0 is the source mesh, with its BVH when requested. */
+    chain.Levels[0] = LoadOBJ(Path, Options);
+    if (chain.Levels[0].VertexCount == 0)
     {
-        n = n.Normalized();
+        return chain;
     }
+    chain.LevelCount = 1;
 
-    /* Interleave position and normal data */
-    std::vector<float> vertexData;
-    vertexData.reserve(positions.size() * 6);
+    const std::uint32_t levelCount =
+        Options.LODLevelCount < MeshLODChain::kMaxLevels ? Options.LODLevelCount : MeshLODChain::kMaxLevels;
+    const float ratio =
+        Options.LODTriangleRatio > 0.0f && Options.LODTriangleRatio < 1.0f ? Options.LODTriangleRatio : 0.5f;
 
-    for (size_t i = 0; i < positions.size(); ++i)
+    /* Halving triangles roughly tracks halving projected area. */
+    const float sizeStep = std::sqrt(ratio);
+    float switchSize = Options.LODScreenSize;
+
+    /* Each level simplifies the previous one, so errors stay local. */
+    std::vector<Vec3> positions;
+    std::vector<uint32_t> indices;
+    while (chain.LevelCount < levelCount)
     {
-        const Vec3& p = positions[i];
-        const Vec3& n = normals[i];
+        const Mesh& previous = chain.Levels[chain.LevelCount - 1];
+        const std::uint32_t previousTriangles = previous.GetTriangleCount();
+        const std::uint32_t target = static_cast<std::uint32_t>(previousTriangles * ratio);
 
-        vertexData.push_back(p.x);
-        vertexData.push_back(p.y);
-        vertexData.push_back(p.z);
-        vertexData.push_back(n.x);
-        vertexData.push_back(n.y);
-        vertexData.push_back(n.z);
-    }
+        MeshSimplifyStats stats{};
+        if (target < kMinLODTriangles ||
+            !SimplifyMesh(previous.Positions, previous.Indices, target, positions, indices, &stats))
+        {
+            break;
+        }
 
-    /* Upload vertex buffer */
-    if (!mesh.VertexBuffer.CreateVertexBuffer(
-        PhysicalDevice,
-        Device,
-        Queue,
-        QueueFamily,
-        vertexData.data(),
-        vertexData.size() * sizeof(float)))
-    {
-        std::fprintf(stderr, "ObjLoader::LoadOBJ: Failed to create vertex buffer\n");
-        mesh.Destroy(Device);
-        return Mesh{};
-    }
+        /* Stop when the surface refuses to simplify further. */
+        if (stats.ResultTriangles > previousTriangles * kMinLODReduction)
+        {
+            break;
+        }
 
-    /* Upload index buffer if present */
-    if (mesh.HasIndex)
-    {
-        if (!mesh.IndexBuffer.CreateIndexBuffer(
-            PhysicalDevice,
-            Device,
-            Queue,
-            QueueFamily,
-            indices.data(),
-            mesh.IndexCount))
+        Mesh& level = chain.Levels[chain.LevelCount];
+        if (!UploadMesh(std::move(positions), indices, level))
         {
-            std::fprintf(stderr, "ObjLoader::LoadOBJ: Failed to create index buffer\n");
-            mesh.Destroy(Device);
-            return Mesh{};
+            std::fprintf(stderr, "ObjLoader::LoadOBJLODChain: Failed to upload LOD %u of %s\n",
+                chain.LevelCount, Path.c_str());
+            break;
         }
+
+        chain.SwitchScreenSizes[chain.LevelCount] = switchSize;
+        switchSize *= sizeStep;
+        ++chain.LevelCount;
+        positions.clear();
     }
 
-    return mesh;
+    return chain;
 }
@@ -30,6 +30,31 @@
 #include <vulkan/vulkan.h>
 #include <string>
 #include <cstdint>
+#include <vector>
+
+/* Optional processing applied while importing an OBJ. */
+struct ObjLoadOptions
+{
+    /* Build a CPU triangle BVH for exact ray and box queries. */
+    /* Scene picking falls back to testing every triangle without one. */
+    bool BuildTriangleBVH = true;
+
+    /* Reuse or write a BVH cache file in BVHCacheDirectory. */
+    bool UseBVHCache = true;
+
+    /* Cache location, kept out of the asset tree like the pipeline cache. */
+    std::string BVHCacheDirectory = "../Temp/BVH";
+
+    /* Levels produced by LoadOBJLODChain, including the source mesh. */
+    std::uint32_t LODLevelCount = 3;
+
+    /* Triangle budget of each level relative to the previous one. */
+    float LODTriangleRatio = 0.5f;
+
+    /* Projected viewport height below which level 1 takes over. */
+    /* Deeper levels scale it by the square root of the triangle ratio. */
+    float LODScreenSize = 0.25f;
+};
 
  /* Simple OBJ mesh loader with GPU upload. */
 struct ObjLoader
@@ -37,8 +62,18 @@ struct ObjLoader
     /* Load an OBJ file and upload vertex data to GPU buffers. */
     static Mesh LoadOBJ(
         const std::string& Path,
-        VkPhysicalDevice PhysicalDevice,
-        VkDevice Device,
-        VkQueue Queue,
-        std::uint32_t QueueFamily);
+        const ObjLoadOptions& Options = ObjLoadOptions{});
+
+    /* Load an OBJ and derive coarser levels by quadric simplification. */
+    /* Generation stops early once a level no longer saves triangles. */
+    static MeshLODChain LoadOBJLODChain(
+        const std::string& Path,
+        const ObjLoadOptions& Options = ObjLoadOptions{});
+
+private:
+    /* Build normals, upload GPU buffers, and keep CPU geometry. */
+    static bool UploadMesh(
+        std::vector<Vec3> Positions,
+        const std::vector<std::uint32_t>& Indices,
+        Mesh& OutMesh);
 };
@@ -30,6 +30,7 @@
 /* Initialize empty render pass state. */
 VulkanRenderPass::VulkanRenderPass()
     : RenderPass(VK_NULL_HANDLE)
+    , WeightedOIT(false)
 {
 }
 
@@ -41,7 +42,9 @@ VulkanRenderPass::~VulkanRenderPass()
 /* Create render pass for swapchain rendering. */
 bool VulkanRenderPass::Create(
     VkDevice Device,
-    VkFormat SwapchainFormat)
+    VkFormat SwapchainFormat,
+    VkImageLayout FinalLayout,
+    bool WeightedOIT)
 {
     /* Color attachment with multisampling. */
     VkAttachmentDescription colorAttachment{};
@@ -67,7 +70,7 @@ bool VulkanRenderPass::Create(
     depthAttachment.finalLayout =
         VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
-    /* Resolve attachment for presentation. */
+    /* Resolve attachment for presentation or offscreen readback. */
     VkAttachmentDescription resolveAttachment{};
     resolveAttachment.format = SwapchainFormat;
     resolveAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -76,8 +79,23 @@ bool VulkanRenderPass::Create(
     resolveAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     resolveAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     resolveAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    resolveAttachment.finalLayout =
-        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    resolveAttachment.finalLayout = FinalLayout;
+
+    /* Weighted blended OIT accumulation, cleared to zero. */
+    VkAttachmentDescription accumAttachment{};
+    accumAttachment.format = kAccumFormat;
+    accumAttachment.samples = VK_SAMPLE_COUNT_4_BIT;
+    accumAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    accumAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    accumAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    accumAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    accumAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    accumAttachment.finalLayout =
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    /* Weighted blended OIT revealage, cleared to one. */
+    VkAttachmentDescription revealageAttachment = accumAttachment;
+    revealageAttachment.format = kRevealageFormat;
 
     /* Attachment references. */
     VkAttachmentReference colorAttachmentRef{};
@@ -90,36 +108,149 @@ bool VulkanRenderPass::Create(
     depthAttachmentRef.layout =
         VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
+    VkAttachmentReference depthReadOnlyRef{};
+    depthReadOnlyRef.attachment = 1;
+    depthReadOnlyRef.layout =
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
     VkAttachmentReference resolveAttachmentRef{};
     resolveAttachmentRef.attachment = 2;
     resolveAttachmentRef.layout =
         VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-    /* Graphics subpass description. */
-    VkSubpassDescription subpass{};
-    subpass.pipelineBindPoint =
+    VkAttachmentReference oitTargetRefs[2]{};
+    oitTargetRefs[0].attachment = 3;
+    oitTargetRefs[0].layout =
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    oitTargetRefs[1].attachment = 4;
+    oitTargetRefs[1].layout =
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference oitInputRefs[2]{};
+    oitInputRefs[0].attachment = 3;
+    oitInputRefs[0].layout =
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    oitInputRefs[1].attachment = 4;
+    oitInputRefs[1].layout =
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    const std::uint32_t preservedColor = 0;
+
+    /* Scene subpass: sky, opaque and depth-sorted blending. */
+    VkSubpassDescription subpasses[3]{};
+    subpasses[kSceneSubpass].pipelineBindPoint =
+        VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[kSceneSubpass].colorAttachmentCount = 1;
+    subpasses[kSceneSubpass].pColorAttachments = &colorAttachmentRef;
+    subpasses[kSceneSubpass].pDepthStencilAttachment = &depthAttachmentRef;
+
+    /* Accumulation subpass: depth tested but read-only, scene color kept. */
+    subpasses[kAccumulateSubpass].pipelineBindPoint =
+        VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[kAccumulateSubpass].colorAttachmentCount = 2;
+    subpasses[kAccumulateSubpass].pColorAttachments = oitTargetRefs;
+    subpasses[kAccumulateSubpass].pDepthStencilAttachment = &depthReadOnlyRef;
+    subpasses[kAccumulateSubpass].preserveAttachmentCount = 1;
+    subpasses[kAccumulateSubpass].pPreserveAttachments = &preservedColor;
+
+    /* Composite subpass: blends the OIT result over the scene, then resolves. */
+    subpasses[kCompositeSubpass].pipelineBindPoint =
         VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-    subpass.pResolveAttachments = &resolveAttachmentRef;
-    subpass.pDepthStencilAttachment = &depthAttachmentRef;
+    subpasses[kCompositeSubpass].inputAttachmentCount = 2;
+    subpasses[kCompositeSubpass].pInputAttachments = oitInputRefs;
+    subpasses[kCompositeSubpass].colorAttachmentCount = 1;
+    subpasses[kCompositeSubpass].pColorAttachments = &colorAttachmentRef;
+    subpasses[kCompositeSubpass].pResolveAttachments = &resolveAttachmentRef;
+
+    /* Per-pixel hand-offs between the subpasses. */
+    VkSubpassDependency dependencies[5]{};
+    dependencies[0].srcSubpass = kSceneSubpass;
+    dependencies[0].dstSubpass = kAccumulateSubpass;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstStageMask =
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    dependencies[1].srcSubpass = kAccumulateSubpass;
+    dependencies[1].dstSubpass = kCompositeSubpass;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    dependencies[2].srcSubpass = kSceneSubpass;
+    dependencies[2].dstSubpass = kCompositeSubpass;
+    dependencies[2].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dstAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    /* Frames in flight share depth and OIT targets: order this frame's */
+    /* clears after the previous frame's writes and composite reads. */
+    dependencies[3].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[3].dstSubpass = kSceneSubpass;
+    dependencies[3].srcStageMask =
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[3].dstStageMask = dependencies[3].srcStageMask;
+    dependencies[3].srcAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[3].dstAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    dependencies[4].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[4].dstSubpass = kAccumulateSubpass;
+    dependencies[4].srcStageMask =
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[4].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[4].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[4].dstAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
     /* Render pass attachments. */
-    VkAttachmentDescription attachments[3] =
+    VkAttachmentDescription attachments[5] =
     {
         colorAttachment,
         depthAttachment,
-        resolveAttachment
+        resolveAttachment,
+        accumAttachment,
+        revealageAttachment
     };
 
     /* Render pass creation info. */
     VkRenderPassCreateInfo renderPassInfo{};
     renderPassInfo.sType =
         VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = 3;
+    renderPassInfo.attachmentCount = 5;
     renderPassInfo.pAttachments = attachments;
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.subpassCount = 3;
+    renderPassInfo.pSubpasses = subpasses;
+    renderPassInfo.dependencyCount = 5;
+    renderPassInfo.pDependencies = dependencies;
+
+    if (!WeightedOIT)
+    {
+        /* Scene subpass resolves itself; only the external hand-off remains. */
+        subpasses[kSceneSubpass].pResolveAttachments = &resolveAttachmentRef;
+        renderPassInfo.attachmentCount = 3;
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.dependencyCount = 1;
+        renderPassInfo.pDependencies = &dependencies[3];
+    }
 
     /* Create render pass. */
     if (vkCreateRenderPass(
@@ -134,6 +265,7 @@ bool VulkanRenderPass::Create(
         return false;
     }
 
+    this->WeightedOIT = WeightedOIT;
     return true;
 }
 
@@ -152,3 +284,9 @@ VkRenderPass VulkanRenderPass::GetHandle() const
 {
     return RenderPass;
 }
+
+/* Query whether the OIT subpasses exist. */
+bool VulkanRenderPass::HasWeightedOIT() const
+{
+    return WeightedOIT;
+}
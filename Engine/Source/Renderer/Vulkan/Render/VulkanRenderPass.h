@@ -27,10 +27,21 @@
 
 #include <vulkan/vulkan.h>
 
+#include <cstdint>
+
  /* Vulkan render pass wrapper. */
 class VulkanRenderPass
 {
 public:
+    /* Subpasses: scene (sky, opaque, sorted blending), weighted OIT accumulation, composite. */
+    static constexpr std::uint32_t kSceneSubpass = 0;
+    static constexpr std::uint32_t kAccumulateSubpass = 1;
+    static constexpr std::uint32_t kCompositeSubpass = 2;
+
+    /* Weighted blended OIT targets, both multisampled like the scene color. */
+    static constexpr VkFormat kAccumFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+    static constexpr VkFormat kRevealageFormat = VK_FORMAT_R16_SFLOAT;
+
     /* Initialize empty render pass state. */
     VulkanRenderPass();
 
@@ -38,7 +49,11 @@ public:
     ~VulkanRenderPass();
 
     /* Create render pass for given swapchain format. */
-    bool Create(VkDevice Device, VkFormat SwapchainFormat);
+    /* FinalLayout is what the resolved image is left in: present for the */
+    /* swapchain, transfer source for offscreen targets read back on the CPU. */
+    /* Without WeightedOIT the pass has only the scene subpass, which */
+    /* resolves, and attachments 0-2; the OIT targets are left out. */
+    bool Create(VkDevice Device, VkFormat SwapchainFormat, VkImageLayout FinalLayout, bool WeightedOIT);
 
     /* Destroy render pass handle. */
     void Destroy(VkDevice Device);
@@ -46,7 +61,13 @@ public:
     /* Get render pass handle. */
     VkRenderPass GetHandle() const;
 
+    /* True when the pass has the OIT accumulation and composite subpasses. */
+    bool HasWeightedOIT() const;
+
 private:
     /* Vulkan render pass handle. */
     VkRenderPass RenderPass = VK_NULL_HANDLE;
+
+    /* Shape the pass was created with. */
+    bool WeightedOIT = false;
 };
@@ -25,17 +25,24 @@
 
 #include "VulkanRenderer.h"
 
+#include "Engine/ParallelFor.h"
+#include "Renderer/PngReader.h"
+#include "Renderer/Vulkan/Core/VulkanPipelineCache.h"
 #include "Renderer/Vulkan/Pipeline/VulkanPipeline.h"
+#include "Renderer/Vulkan/Render/VulkanRenderPass.h"
 #include "Renderer/Vulkan/Skybox/SkyboxRenderer.h"
 #include "Scene/EngineCamera.h"
-#include "Renderer/Vulkan/Render/WicTextureLoader.h"
+#include "Scene/Collision/Frustum.h"
 
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.h>
 
 #include <cstdio>
 #include <cstring>
+#include <cmath>
 #include <algorithm>
+#include <limits>
+#include <thread>
 
 namespace
 {
@@ -46,7 +53,7 @@ namespace
         float AlphaModePadding[4];
     };
 
-    float ComputeDepthSq(const RenderItem& item, const Camera* camera)
+    float ComputeDepthSq(const Mat4& model, const Camera* camera)
     {
         if (!camera)
         {
@@ -54,9 +61,9 @@ namespace
         }
 
         const Vec3 itemPosition(
-            item.Model.m[12],
-            item.Model.m[13],
-            item.Model.m[14]);
+            model.m[12],
+            model.m[13],
+            model.m[14]);
         const Vec3 offset = itemPosition - camera->GetPosition();
         return Vec3::Dot(offset, offset);
     }
@@ -70,73 +77,92 @@ namespace
 
     const VkSampleCountFlagBits kMsaaSamples = VK_SAMPLE_COUNT_4_BIT;
 
-    uint32_t FindMemoryType(
-        VkPhysicalDevice physicalDevice,
-        uint32_t typeFilter,
-        VkMemoryPropertyFlags properties)
+    /* Starting frame ring size, it doubles when a frame outgrows it. */
+    const VkDeviceSize kFrameRingCapacity = 1024 * 1024;
+
+    /* Instance transforms start on a 16-byte boundary. */
+    const VkDeviceSize kInstanceAlignment = 16;
+
+    /* Draws per secondary command buffer; fixed so static ranges cut the same. */
+    const std::size_t kDrawsPerRecordTask = 256;
+
+    /* Fewest secondaries worth a recording thread of their own. */
+    const std::uint32_t kMinTasksPerRecordWorker = 2;
+
+    /* Starting retained buffer size per frame slot, doubled as needed. */
+    const VkDeviceSize kRetainedCapacity = 256 * 1024;
+
+    /* Retained instances follow the frame uniforms. */
+    const VkDeviceSize kRetainedInstanceOffset = 256;
+
+    /* Culling push constants: frustum planes and the instance count. */
+    struct CullPushConstants
     {
-        VkPhysicalDeviceMemoryProperties memProperties{};
-        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+        float Planes[6][4];
+        std::uint32_t InstanceCount;
+        std::uint32_t Padding[3];
+    };
 
-        for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i)
-        {
-            if ((typeFilter & (1 << i)) &&
-                (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-            {
-                return i;
-            }
-        }
+    /* Per-mesh culling input, std430 layout of CullDraw in Cull.comp. */
+    struct CullDraw
+    {
+        float Sphere[4];
+        std::uint32_t OutputBase;
+        std::uint32_t Padding[3];
+    };
 
-        return UINT32_MAX;
-    }
+    /* Invocations per culling workgroup, local_size_x of Cull.comp. */
+    const std::uint32_t kCullGroupSize = 64;
 
-    bool CreateBuffer(
-        VkPhysicalDevice physicalDevice,
-        VkDevice device,
-        VkDeviceSize size,
-        VkBufferUsageFlags usage,
-        VkMemoryPropertyFlags properties,
-        VkBuffer& outBuffer,
-        VkDeviceMemory& outMemory)
+    /* Indexed and non-indexed indirect commands share one stride; both */
+    /* keep the instance count in the word the culling pass increments. */
+    const std::uint32_t kIndirectCommandStride = sizeof(VkDrawIndexedIndirectCommand);
+
+    void SetFullViewport(VkCommandBuffer commandBuffer, VkExtent2D extent)
     {
-        VkBufferCreateInfo bufferInfo{};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = size;
-        bufferInfo.usage = usage;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(extent.width);
+        viewport.height = static_cast<float>(extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
 
-        if (vkCreateBuffer(device, &bufferInfo, nullptr, &outBuffer) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "VulkanRenderer: vkCreateBuffer failed\n");
-            return false;
-        }
+        VkRect2D scissor{};
+        scissor.offset = { 0, 0 };
+        scissor.extent = extent;
+
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    }
 
-        VkMemoryRequirements memRequirements{};
-        vkGetBufferMemoryRequirements(device, outBuffer, &memRequirements);
+    bool BeginSecondaryCommandBuffer(
+        VkCommandBuffer commandBuffer,
+        VkRenderPass renderPass,
+        uint32_t subpass,
+        VkFramebuffer framebuffer)
+    {
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.renderPass = renderPass;
+        inheritanceInfo.subpass = subpass;
+        inheritanceInfo.framebuffer = framebuffer;
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = FindMemoryType(
-            physicalDevice,
-            memRequirements.memoryTypeBits,
-            properties);
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
 
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &outMemory) != VK_SUCCESS)
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
         {
-            std::fprintf(stderr, "VulkanRenderer: vkAllocateMemory (buffer) failed\n");
-            vkDestroyBuffer(device, outBuffer, nullptr);
-            outBuffer = VK_NULL_HANDLE;
+            std::fprintf(stderr, "VulkanRenderer: vkBeginCommandBuffer (secondary) failed\n");
             return false;
         }
 
-        vkBindBufferMemory(device, outBuffer, outMemory, 0);
         return true;
     }
 
     bool CreateImage(
-        VkPhysicalDevice physicalDevice,
-        VkDevice device,
         uint32_t width,
         uint32_t height,
         VkFormat format,
@@ -144,7 +170,7 @@ namespace
         VkImageUsageFlags usage,
         VkMemoryPropertyFlags properties,
         VkImage& outImage,
-        VkDeviceMemory& outMemory)
+        VulkanAllocation& outAllocation)
     {
         VkImageCreateInfo imageInfo{};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -161,207 +187,14 @@ namespace
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        if (vkCreateImage(device, &imageInfo, nullptr, &outImage) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "VulkanRenderer: vkCreateImage failed\n");
-            return false;
-        }
-
-        VkMemoryRequirements memRequirements{};
-        vkGetImageMemoryRequirements(device, outImage, &memRequirements);
-
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = FindMemoryType(
-            physicalDevice,
-            memRequirements.memoryTypeBits,
-            properties);
-
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &outMemory) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "VulkanRenderer: vkAllocateMemory (image) failed\n");
-            vkDestroyImage(device, outImage, nullptr);
-            outImage = VK_NULL_HANDLE;
-            return false;
-        }
-
-        vkBindImageMemory(device, outImage, outMemory, 0);
-        return true;
-    }
-
-    /* One-shot command helpers intentionally unchanged semantically. */
-    bool BeginSingleTimeCommands(
-        VkDevice device,
-        uint32_t queueFamily,
-        VkCommandPool& outPool,
-        VkCommandBuffer& outCommandBuffer)
-    {
-        VkCommandPoolCreateInfo poolInfo{};
-        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-        poolInfo.queueFamilyIndex = queueFamily;
-
-        if (vkCreateCommandPool(device, &poolInfo, nullptr, &outPool) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "VulkanRenderer: vkCreateCommandPool failed\n");
-            return false;
-        }
-
-        VkCommandBufferAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = outPool;
-        allocInfo.commandBufferCount = 1;
-
-        if (vkAllocateCommandBuffers(device, &allocInfo, &outCommandBuffer) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "VulkanRenderer: vkAllocateCommandBuffers failed\n");
-            vkDestroyCommandPool(device, outPool, nullptr);
-            outPool = VK_NULL_HANDLE;
-            return false;
-        }
-
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-        if (vkBeginCommandBuffer(outCommandBuffer, &beginInfo) != VK_SUCCESS)
+        if (!g_VulkanAllocator.CreateImage(imageInfo, properties, outImage, outAllocation))
         {
-            std::fprintf(stderr, "VulkanRenderer: vkBeginCommandBuffer failed\n");
-            vkFreeCommandBuffers(device, outPool, 1, &outCommandBuffer);
-            vkDestroyCommandPool(device, outPool, nullptr);
-            outPool = VK_NULL_HANDLE;
-            outCommandBuffer = VK_NULL_HANDLE;
+            std::fprintf(stderr, "VulkanRenderer: CreateImage failed\n");
             return false;
         }
 
         return true;
     }
-
-    void EndSingleTimeCommands(
-        VkDevice device,
-        VkQueue queue,
-        VkCommandPool pool,
-        VkCommandBuffer commandBuffer)
-    {
-        vkEndCommandBuffer(commandBuffer);
-
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
-
-        vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(queue);
-
-        vkFreeCommandBuffers(device, pool, 1, &commandBuffer);
-        vkDestroyCommandPool(device, pool, nullptr);
-    }
-
-    void TransitionImageLayout(
-        VkDevice device,
-        VkQueue queue,
-        uint32_t queueFamily,
-        VkImage image,
-        VkFormat format,
-        VkImageLayout oldLayout,
-        VkImageLayout newLayout)
-    {
-        (void)format;
-
-        VkCommandPool pool = VK_NULL_HANDLE;
-        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
-        if (!BeginSingleTimeCommands(device, queueFamily, pool, commandBuffer))
-        {
-            return;
-        }
-
-        VkImageMemoryBarrier barrier{};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = oldLayout;
-        barrier.newLayout = newLayout;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = image;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-
-        VkPipelineStageFlags sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        VkPipelineStageFlags destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-
-        if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED &&
-            newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-        {
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        }
-        else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
-            newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-        {
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        }
-
-        vkCmdPipelineBarrier(
-            commandBuffer,
-            sourceStage,
-            destinationStage,
-            0,
-            0,
-            nullptr,
-            0,
-            nullptr,
-            1,
-            &barrier);
-
-        EndSingleTimeCommands(device, queue, pool, commandBuffer);
-    }
-
-    void CopyBufferToImage(
-        VkDevice device,
-        VkQueue queue,
-        uint32_t queueFamily,
-        VkBuffer buffer,
-        VkImage image,
-        uint32_t width,
-        uint32_t height)
-    {
-        VkCommandPool pool = VK_NULL_HANDLE;
-        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
-        if (!BeginSingleTimeCommands(device, queueFamily, pool, commandBuffer))
-        {
-            return;
-        }
-
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-        region.imageOffset = { 0, 0, 0 };
-        region.imageExtent = { width, height, 1 };
-
-        vkCmdCopyBufferToImage(
-            commandBuffer,
-            buffer,
-            image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1,
-            &region);
-
-        EndSingleTimeCommands(device, queue, pool, commandBuffer);
-    }
 }
 
 VulkanRenderer::VulkanRenderer()
@@ -372,28 +205,30 @@ VulkanRenderer::VulkanRenderer()
     , DeviceHandle(VK_NULL_HANDLE)
     , PhysicalDeviceHandle(VK_NULL_HANDLE)
     , CommandPool(VK_NULL_HANDLE)
-    , ImageAvailable(VK_NULL_HANDLE)
-    , RenderFinished(VK_NULL_HANDLE)
-    , InFlightFence(VK_NULL_HANDLE)
     , Pipeline(nullptr)
-    , UniformBuffer(VK_NULL_HANDLE)
-    , UniformMemory(VK_NULL_HANDLE)
     , DepthImage(VK_NULL_HANDLE)
-    , DepthImageMemory(VK_NULL_HANDLE)
+    , DepthImageAllocation()
     , DepthImageView(VK_NULL_HANDLE)
+    , AccumImage(VK_NULL_HANDLE)
+    , AccumImageAllocation()
+    , AccumImageView(VK_NULL_HANDLE)
+    , RevealageImage(VK_NULL_HANDLE)
+    , RevealageImageAllocation()
+    , RevealageImageView(VK_NULL_HANDLE)
     , ShadowRenderPass(VK_NULL_HANDLE)
     , ShadowFramebuffer(VK_NULL_HANDLE)
     , ShadowImage(VK_NULL_HANDLE)
-    , ShadowImageMemory(VK_NULL_HANDLE)
+    , ShadowImageAllocation()
     , ShadowImageView(VK_NULL_HANDLE)
     , ShadowSampler(VK_NULL_HANDLE)
     , DiffuseImage(VK_NULL_HANDLE)
-    , DiffuseImageMemory(VK_NULL_HANDLE)
+    , DiffuseImageAllocation()
     , DiffuseImageView(VK_NULL_HANDLE)
     , DiffuseSampler(VK_NULL_HANDLE)
     , DescriptorSetLayout(VK_NULL_HANDLE)
     , DescriptorPool(VK_NULL_HANDLE)
-    , DescriptorSet(VK_NULL_HANDLE)
+    , CompositeSetLayout(VK_NULL_HANDLE)
+    , CompositeSet(VK_NULL_HANDLE)
     , Camera(nullptr)
     , Time(0.0f)
 {
@@ -427,6 +262,12 @@ bool VulkanRenderer::Create(
     GraphicsQueueHandle = GraphicsQueue;
     this->SwapchainImageViews = SwapchainImageViews;
 
+    /* Per-frame slots are filled by the uniform, descriptor, command and sync steps. */
+    Frames.assign(FramesInFlight, FrameResources{});
+    CurrentFrame = 0;
+    ImagesInFlight.assign(SwapchainImageViews.size(), VK_NULL_HANDLE);
+    LastImageIndex = UINT32_MAX;
+
     if (!Camera)
     {
         Camera = new ::Camera();
@@ -437,9 +278,9 @@ bool VulkanRenderer::Create(
         std::fprintf(stderr, "VulkanRenderer::Create: CreateDescriptorSetLayout failed\n");
         return false;
     }
-    if (!CreateUniformBuffer(PhysicalDevice, Device))
+    if (!CreateFrameRing(PhysicalDevice, Device))
     {
-        std::fprintf(stderr, "VulkanRenderer::Create: CreateUniformBuffer failed\n");
+        std::fprintf(stderr, "VulkanRenderer::Create: CreateFrameRing failed\n");
         return false;
     }
     if (!CreateDescriptorPool(Device))
@@ -452,7 +293,7 @@ bool VulkanRenderer::Create(
         std::fprintf(stderr, "VulkanRenderer::Create: CreateShadowResources failed\n");
         return false;
     }
-    if (!CreateTextureResources(PhysicalDevice, Device, GraphicsQueue, GraphicsQueueFamily))
+    if (!CreateTextureResources(PhysicalDevice, Device))
     {
         std::fprintf(stderr, "VulkanRenderer::Create: CreateTextureResources failed\n");
         return false;
@@ -466,13 +307,19 @@ bool VulkanRenderer::Create(
     {
         Pipeline = new VulkanPipeline();
     }
-    if (!Pipeline->Create(Device, RenderPass, ShadowRenderPass, DescriptorSetLayout))
+    if (!Pipeline->Create(
+        Device,
+        RenderPass,
+        ShadowRenderPass,
+        DescriptorSetLayout,
+        WeightedOITEnabled ? CompositeSetLayout : VK_NULL_HANDLE,
+        GpuCullingEnabled ? CullSetLayout : VK_NULL_HANDLE))
     {
         std::fprintf(stderr, "VulkanRenderer::Create: Pipeline::Create failed\n");
         return false;
     }
     /* Create skybox resources. */
-    if (!Skybox.Create(Device, PhysicalDevice, RenderPass, GraphicsQueue, GraphicsQueueFamily))
+    if (!Skybox.Create(Device, PhysicalDevice, RenderPass))
     {
         std::fprintf(stderr, "VulkanRenderer::Create: Skybox::Create failed\n");
         return false;
@@ -521,14 +368,8 @@ bool VulkanRenderer::Create(
         { { -0.5f, -0.5f, -0.5f }, { 0.0f, 0.0f } }
     };
 
-    CubeMesh.Destroy(Device);
-    if (!CubeMesh.VertexBuffer.CreateVertexBuffer(
-        PhysicalDevice,
-        Device,
-        GraphicsQueue,
-        GraphicsQueueFamily,
-        kCubeVertices,
-        sizeof(kCubeVertices)))
+    CubeMesh.Destroy();
+    if (!CubeMesh.VertexBuffer.CreateVertexBuffer(kCubeVertices, sizeof(kCubeVertices)))
     {
         std::fprintf(stderr, "VulkanRenderer::Create: Failed to upload cube mesh\n");
         return false;
@@ -537,6 +378,18 @@ bool VulkanRenderer::Create(
         sizeof(kCubeVertices) / sizeof(kCubeVertices[0]));
     CubeMesh.IndexCount = 0;
     CubeMesh.HasIndex = false;
+
+    /* Keep cube triangles on the CPU for scene queries. */
+    CubeMesh.Positions.reserve(CubeMesh.VertexCount);
+    for (const Vertex& vertex : kCubeVertices)
+    {
+        CubeMesh.Positions.emplace_back(
+            vertex.Position[0],
+            vertex.Position[1],
+            vertex.Position[2]);
+    }
+    CubeMesh.UpdateLocalBounds();
+
     CubeMaterial.BaseColor = Vec3(1.0f, 1.0f, 1.0f);
     CubeMaterial.Ambient = 0.0f;
     CubeMaterial.Alpha = 1.0f;
@@ -550,6 +403,11 @@ bool VulkanRenderer::Create(
         std::fprintf(stderr, "VulkanRenderer::Create: CreateColorResources failed\n");
         return false;
     }
+    if (!CreateTransparencyResources(PhysicalDeviceHandle, Device, Extent))
+    {
+        std::fprintf(stderr, "VulkanRenderer::Create: CreateTransparencyResources failed\n");
+        return false;
+    }
     if (!CreateFramebuffers(Device, RenderPass, SwapchainFormat, SwapchainImageViews, Extent))
     {
         std::fprintf(stderr, "VulkanRenderer::Create: CreateFramebuffers failed\n");
@@ -570,6 +428,11 @@ bool VulkanRenderer::Create(
         std::fprintf(stderr, "VulkanRenderer::Create: CreateSyncObjects failed\n");
         return false;
     }
+    if (!CreateRecordPools(Device, GraphicsQueueFamily))
+    {
+        std::fprintf(stderr, "VulkanRenderer::Create: CreateRecordPools failed\n");
+        return false;
+    }
 
     (void)GraphicsQueue;
     return true;
@@ -626,14 +489,77 @@ void VulkanRenderer::InitializeOverlay(GLFWwindow* WindowHandle)
         GraphicsQueueHandle,
         SwapchainFormat,
         SwapchainImageViews,
-        SwapchainExtent);
+        SwapchainExtent,
+        static_cast<std::uint32_t>(Frames.size()));
+}
+
+void VulkanRenderer::SetFramesInFlight(std::uint32_t Count)
+{
+    FramesInFlight = std::clamp(Count, 1u, kMaxFramesInFlight);
+}
+
+void VulkanRenderer::SetRecordWorkers(std::uint32_t Count)
+{
+    RecordWorkers = std::min(Count, kMaxRecordWorkers);
 }
 
-void VulkanRenderer::SetRenderItems(const std::vector<RenderItem>& Items)       
+void VulkanRenderer::SetGpuCullingEnabled(bool Enabled, bool DrawIndirectCount)
+{
+    GpuCullingEnabled = Enabled;
+    DrawIndirectCountEnabled = Enabled && DrawIndirectCount;
+}
+
+void VulkanRenderer::SetRenderItems(const RenderList* Items)
 {
     RenderItems = Items;
 }
 
+void VulkanRenderer::SetShadowCasters(const RenderList* Items)
+{
+    ShadowCasterItems = Items;
+}
+
+void VulkanRenderer::SetRenderResources(const RenderResourceTable* Resources)
+{
+    RenderResources = Resources;
+}
+
+void VulkanRenderer::SetCullStats(std::uint32_t Submitted, std::uint32_t Culled, std::uint32_t Occluded)
+{
+    SubmittedItemCount = Submitted;
+    CulledItemCount = Culled;
+    OccludedItemCount = Occluded;
+}
+
+void VulkanRenderer::SetSortKeyLayout(RenderStage Stage, const RenderSortKeyLayout& Layout)
+{
+    const std::size_t stageIndex = static_cast<std::size_t>(Stage);
+    if (stageIndex >= static_cast<std::size_t>(RenderStage::Count))
+    {
+        return;
+    }
+
+    if (!Layout.IsValid())
+    {
+        std::fprintf(stderr, "VulkanRenderer::SetSortKeyLayout: invalid layout\n");
+        return;
+    }
+
+    SortKeyEncoders[stageIndex] = RenderSortKeyEncoder(Layout);
+}
+
+void VulkanRenderer::SetDepthPrepassEnabled(bool Enabled)
+{
+    DepthPrepassEnabled = Enabled;
+    UpdatePipelineVariants();
+}
+
+void VulkanRenderer::SetWeightedOITEnabled(bool Enabled)
+{
+    WeightedOITEnabled = Enabled;
+    UpdatePipelineVariants();
+}
+
 void VulkanRenderer::SetEditorEntities(const std::vector<Entity>& Entities)
 {
     EditorEntities = Entities;
@@ -670,27 +596,177 @@ void VulkanRenderer::RecordSkyboxStage(VkCommandBuffer CommandBuffer, VkExtent2D
     Skybox.Record(CommandBuffer, Extent, Camera);
 }
 
+void VulkanRenderer::RecordShadowStage(
+    VkCommandBuffer CommandBuffer,
+    const OpaqueBatch* Batches,
+    std::size_t BatchCount)
+{
+    VkViewport shadowViewport{};
+    shadowViewport.x = 0.0f;
+    shadowViewport.y = 0.0f;
+    shadowViewport.width = static_cast<float>(ShadowExtent.width);
+    shadowViewport.height = static_cast<float>(ShadowExtent.height);
+    shadowViewport.minDepth = 0.0f;
+    shadowViewport.maxDepth = 1.0f;
+
+    VkRect2D shadowScissor{};
+    shadowScissor.offset = { 0, 0 };
+    shadowScissor.extent = ShadowExtent;
+
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->GetShadowHandle());
+    vkCmdSetViewport(CommandBuffer, 0, 1, &shadowViewport);
+    vkCmdSetScissor(CommandBuffer, 0, 1, &shadowScissor);
+
+    /* The light matrix comes from the frame uniform buffer. */
+    vkCmdBindDescriptorSets(
+        CommandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        Pipeline->GetShadowLayout(),
+        0,
+        1,
+        &Frames[CurrentFrame].DescriptorSet,
+        1,
+        &FrameUniformOffset);
+
+    /* One instanced draw per mesh, models come from the instance buffer. */
+    for (std::size_t index = 0; index < BatchCount; ++index)
+    {
+        const OpaqueBatch& batch = Batches[index];
+        VkBuffer vertexBuffer = batch.MeshPtr->VertexBuffer.GetBuffer();
+        if (vertexBuffer == VK_NULL_HANDLE)
+        {
+            continue;
+        }
+
+        VkBuffer buffers[] = { vertexBuffer, RetainedInstances.Buffer };
+        VkDeviceSize offsets[] = { 0, RetainedInstances.Offset };
+        vkCmdBindVertexBuffers(CommandBuffer, 0, 2, buffers, offsets);
+
+        if (batch.MeshPtr->HasIndex && batch.MeshPtr->IndexCount > 0)
+        {
+            VkBuffer indexBuffer = batch.MeshPtr->IndexBuffer.GetBuffer();
+            if (indexBuffer != VK_NULL_HANDLE)
+            {
+                vkCmdBindIndexBuffer(CommandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                vkCmdDrawIndexed(
+                    CommandBuffer,
+                    batch.MeshPtr->IndexCount,
+                    static_cast<std::uint32_t>(batch.Count),
+                    0,
+                    0,
+                    static_cast<std::uint32_t>(batch.StartIndex));
+            }
+        }
+        else
+        {
+            vkCmdDraw(
+                CommandBuffer,
+                batch.MeshPtr->VertexCount,
+                static_cast<std::uint32_t>(batch.Count),
+                0,
+                static_cast<std::uint32_t>(batch.StartIndex));
+        }
+    }
+}
+
+void VulkanRenderer::RecordDepthPrepassStage(
+    VkCommandBuffer CommandBuffer,
+    const OpaqueBatch* Batches,
+    std::size_t BatchCount)
+{
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->GetDepthPrepassHandle());
+    vkCmdBindDescriptorSets(
+        CommandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        Pipeline->GetLayout(),
+        0,
+        1,
+        &Frames[CurrentFrame].DescriptorSet,
+        1,
+        &FrameUniformOffset);
+
+    /* Same batches and instances as the colour pass, no material state. */
+    Mesh* boundMesh = nullptr;
+    for (std::size_t index = 0; index < BatchCount; ++index)
+    {
+        const OpaqueBatch& batch = Batches[index];
+        if (!batch.MeshPtr)
+        {
+            continue;
+        }
+
+        if (batch.MeshPtr != boundMesh)
+        {
+            VkBuffer vertexBuffer = batch.MeshPtr->VertexBuffer.GetBuffer();
+            if (vertexBuffer != VK_NULL_HANDLE)
+            {
+                VkBuffer buffers[] = { vertexBuffer, RetainedInstances.Buffer };
+                VkDeviceSize offsets[] = { 0, RetainedInstances.Offset };
+                vkCmdBindVertexBuffers(CommandBuffer, 0, 2, buffers, offsets);
+            }
+
+            if (batch.MeshPtr->HasIndex && batch.MeshPtr->IndexCount > 0)
+            {
+                VkBuffer indexBuffer = batch.MeshPtr->IndexBuffer.GetBuffer();
+                if (indexBuffer != VK_NULL_HANDLE)
+                {
+                    vkCmdBindIndexBuffer(CommandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                }
+            }
+
+            boundMesh = batch.MeshPtr;
+        }
+
+        if (batch.MeshPtr->HasIndex && batch.MeshPtr->IndexCount > 0)
+        {
+            vkCmdDrawIndexed(
+                CommandBuffer,
+                batch.MeshPtr->IndexCount,
+                static_cast<std::uint32_t>(batch.Count),
+                0,
+                0,
+                static_cast<std::uint32_t>(batch.StartIndex));
+        }
+        else
+        {
+            vkCmdDraw(
+                CommandBuffer,
+                batch.MeshPtr->VertexCount,
+                static_cast<std::uint32_t>(batch.Count),
+                0,
+                static_cast<std::uint32_t>(batch.StartIndex));
+        }
+    }
+}
+
 void VulkanRenderer::RecordOpaqueStage(
     VkCommandBuffer CommandBuffer,
     VkExtent2D Extent,
-    const std::vector<SortedRenderItem>& Items,
-    const std::vector<OpaqueBatch>& Batches)
+    const std::vector<RenderItem>& Items,
+    const OpaqueBatch* Batches,
+    std::size_t BatchCount)
 {
     (void)Items;
     (void)Extent;
-    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->GetWorldHandle());
+
+    /* After a pre-pass the depth buffer is final, only matching fragments shade. */
+    VkPipeline worldPipeline = DepthPrepassActive
+        ? Pipeline->GetWorldEqualHandle()
+        : Pipeline->GetWorldHandle();
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, worldPipeline);
     vkCmdBindDescriptorSets(
         CommandBuffer,
         VK_PIPELINE_BIND_POINT_GRAPHICS,
         Pipeline->GetLayout(),
         0,
         1,
-        &DescriptorSet,
-        0,
-        nullptr);
+        &Frames[CurrentFrame].DescriptorSet,
+        1,
+        &FrameUniformOffset);
     Mesh* boundMesh = nullptr;
-    for (const OpaqueBatch& batch : Batches)
+    for (std::size_t index = 0; index < BatchCount; ++index)
     {
+        const OpaqueBatch& batch = Batches[index];
         PushConstants worldPush{};
         worldPush.BaseColorAmbient[0] = 1.0f;
         worldPush.BaseColorAmbient[1] = 1.0f;
@@ -721,8 +797,8 @@ void VulkanRenderer::RecordOpaqueStage(
             VkBuffer vertexBuffer = batch.MeshPtr->VertexBuffer.GetBuffer();
             if (vertexBuffer != VK_NULL_HANDLE)
             {
-                VkBuffer buffers[] = { vertexBuffer, InstanceBuffer };
-                VkDeviceSize offsets[] = { 0, 0 };
+                VkBuffer buffers[] = { vertexBuffer, RetainedInstances.Buffer };
+                VkDeviceSize offsets[] = { 0, RetainedInstances.Offset };
                 vkCmdBindVertexBuffers(CommandBuffer, 0, 2, buffers, offsets);
             }
 
@@ -763,7 +839,8 @@ void VulkanRenderer::RecordOpaqueStage(
 void VulkanRenderer::RecordTransparentStage(
     VkCommandBuffer CommandBuffer,
     VkExtent2D Extent,
-    const std::vector<SortedRenderItem>& Items,
+    const RenderItem* Items,
+    std::size_t ItemCount,
     std::uint32_t BaseInstance)
 {
     (void)Extent;
@@ -774,16 +851,17 @@ void VulkanRenderer::RecordTransparentStage(
         Pipeline->GetLayout(),
         0,
         1,
-        &DescriptorSet,
-        0,
-        nullptr);
-    for (std::size_t index = 0; index < Items.size(); ++index)
+        &Frames[CurrentFrame].DescriptorSet,
+        1,
+        &FrameUniformOffset);
+    for (std::size_t index = 0; index < ItemCount; ++index)
     {
-        const RenderItem& item = *Items[index].Item;
+        const Mesh* mesh = RenderResources->GetMesh(Items[index].MeshHandle);
+        const Material* material = RenderResources->GetMaterial(Items[index].MaterialHandle);
 
-        VkBuffer vertexBuffer = item.MeshPtr->VertexBuffer.GetBuffer();
-        VkBuffer buffers[] = { vertexBuffer, InstanceBuffer };
-        VkDeviceSize offsets[] = { 0, 0 };
+        VkBuffer vertexBuffer = mesh->VertexBuffer.GetBuffer();
+        VkBuffer buffers[] = { vertexBuffer, FrameInstances.Buffer };
+        VkDeviceSize offsets[] = { 0, FrameInstances.Offset };
         vkCmdBindVertexBuffers(CommandBuffer, 0, 2, buffers, offsets);
 
         PushConstants worldPush{};
@@ -795,13 +873,13 @@ void VulkanRenderer::RecordTransparentStage(
         worldPush.AlphaModePadding[1] = 1.0f;
         worldPush.AlphaModePadding[2] = 0.0f;
         worldPush.AlphaModePadding[3] = 0.0f;
-        if (item.MaterialPtr)
+        if (material)
         {
-            worldPush.BaseColorAmbient[0] = item.MaterialPtr->BaseColor.x;
-            worldPush.BaseColorAmbient[1] = item.MaterialPtr->BaseColor.y;
-            worldPush.BaseColorAmbient[2] = item.MaterialPtr->BaseColor.z;
-            worldPush.BaseColorAmbient[3] = item.MaterialPtr->Ambient;
-            worldPush.AlphaModePadding[0] = item.MaterialPtr->Alpha;
+            worldPush.BaseColorAmbient[0] = material->BaseColor.x;
+            worldPush.BaseColorAmbient[1] = material->BaseColor.y;
+            worldPush.BaseColorAmbient[2] = material->BaseColor.z;
+            worldPush.BaseColorAmbient[3] = material->Ambient;
+            worldPush.AlphaModePadding[0] = material->Alpha;
         }
         vkCmdPushConstants(
             CommandBuffer,
@@ -810,15 +888,15 @@ void VulkanRenderer::RecordTransparentStage(
             0,
             sizeof(PushConstants),
             &worldPush);
-        if (item.MeshPtr->HasIndex && item.MeshPtr->IndexCount > 0)
+        if (mesh->HasIndex && mesh->IndexCount > 0)
         {
-            VkBuffer indexBuffer = item.MeshPtr->IndexBuffer.GetBuffer();
+            VkBuffer indexBuffer = mesh->IndexBuffer.GetBuffer();
             if (indexBuffer != VK_NULL_HANDLE)
             {
                 vkCmdBindIndexBuffer(CommandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
                 vkCmdDrawIndexed(
                     CommandBuffer,
-                    item.MeshPtr->IndexCount,
+                    mesh->IndexCount,
                     1,
                     0,
                     0,
@@ -829,7 +907,7 @@ void VulkanRenderer::RecordTransparentStage(
         {
             vkCmdDraw(
                 CommandBuffer,
-                item.MeshPtr->VertexCount,
+                mesh->VertexCount,
                 1,
                 0,
                 BaseInstance + static_cast<std::uint32_t>(index));
@@ -837,42 +915,759 @@ void VulkanRenderer::RecordTransparentStage(
     }
 }
 
+void VulkanRenderer::RecordWeightedBlendStage(
+    VkCommandBuffer CommandBuffer,
+    const OpaqueBatch* Batches,
+    std::size_t BatchCount)
+{
+    /* Weighted sums commute, so transparent batches instance like opaque ones. */
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->GetWeightedBlendHandle());
+    vkCmdBindDescriptorSets(
+        CommandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        Pipeline->GetLayout(),
+        0,
+        1,
+        &Frames[CurrentFrame].DescriptorSet,
+        1,
+        &FrameUniformOffset);
+    Mesh* boundMesh = nullptr;
+    for (std::size_t index = 0; index < BatchCount; ++index)
+    {
+        const OpaqueBatch& batch = Batches[index];
+        if (!batch.MeshPtr)
+        {
+            continue;
+        }
+
+        PushConstants worldPush{};
+        worldPush.BaseColorAmbient[0] = 1.0f;
+        worldPush.BaseColorAmbient[1] = 1.0f;
+        worldPush.BaseColorAmbient[2] = 1.0f;
+        worldPush.BaseColorAmbient[3] = 0.0f;
+        worldPush.AlphaModePadding[0] = 1.0f;
+        worldPush.AlphaModePadding[1] = 1.0f;
+        worldPush.AlphaModePadding[2] = 0.0f;
+        worldPush.AlphaModePadding[3] = 0.0f;
+        if (batch.MaterialPtr)
+        {
+            worldPush.BaseColorAmbient[0] = batch.MaterialPtr->BaseColor.x;
+            worldPush.BaseColorAmbient[1] = batch.MaterialPtr->BaseColor.y;
+            worldPush.BaseColorAmbient[2] = batch.MaterialPtr->BaseColor.z;
+            worldPush.BaseColorAmbient[3] = batch.MaterialPtr->Ambient;
+            worldPush.AlphaModePadding[0] = batch.MaterialPtr->Alpha;
+        }
+        vkCmdPushConstants(
+            CommandBuffer,
+            Pipeline->GetLayout(),
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0,
+            sizeof(PushConstants),
+            &worldPush);
+
+        if (batch.MeshPtr != boundMesh)
+        {
+            VkBuffer vertexBuffer = batch.MeshPtr->VertexBuffer.GetBuffer();
+            if (vertexBuffer != VK_NULL_HANDLE)
+            {
+                VkBuffer buffers[] = { vertexBuffer, FrameInstances.Buffer };
+                VkDeviceSize offsets[] = { 0, FrameInstances.Offset };
+                vkCmdBindVertexBuffers(CommandBuffer, 0, 2, buffers, offsets);
+            }
+
+            if (batch.MeshPtr->HasIndex && batch.MeshPtr->IndexCount > 0)
+            {
+                VkBuffer indexBuffer = batch.MeshPtr->IndexBuffer.GetBuffer();
+                if (indexBuffer != VK_NULL_HANDLE)
+                {
+                    vkCmdBindIndexBuffer(CommandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                }
+            }
+
+            boundMesh = batch.MeshPtr;
+        }
+
+        if (batch.MeshPtr->HasIndex && batch.MeshPtr->IndexCount > 0)
+        {
+            vkCmdDrawIndexed(
+                CommandBuffer,
+                batch.MeshPtr->IndexCount,
+                static_cast<std::uint32_t>(batch.Count),
+                0,
+                0,
+                static_cast<std::uint32_t>(batch.StartIndex));
+        }
+        else
+        {
+            vkCmdDraw(
+                CommandBuffer,
+                batch.MeshPtr->VertexCount,
+                static_cast<std::uint32_t>(batch.Count),
+                0,
+                static_cast<std::uint32_t>(batch.StartIndex));
+        }
+    }
+}
+
+void VulkanRenderer::RecordCompositeStage(VkCommandBuffer CommandBuffer)
+{
+    /* Full-screen triangle blending the resolved OIT average over the scene. */
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->GetCompositeHandle());
+    vkCmdBindDescriptorSets(
+        CommandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        Pipeline->GetCompositeLayout(),
+        0,
+        1,
+        &CompositeSet,
+        0,
+        nullptr);
+    vkCmdDraw(CommandBuffer, 3, 1, 0, 0);
+}
+
+void VulkanRenderer::RecordIndirectStage(
+    VkCommandBuffer CommandBuffer,
+    bool DepthOnly,
+    std::size_t FirstDraw,
+    std::size_t DrawCount)
+{
+    VkPipeline pipeline = Pipeline->GetDepthPrepassHandle();
+    if (!DepthOnly)
+    {
+        pipeline = DepthPrepassActive ? Pipeline->GetWorldEqualHandle() : Pipeline->GetWorldHandle();
+    }
+
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    vkCmdBindDescriptorSets(
+        CommandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        Pipeline->GetLayout(),
+        0,
+        1,
+        &Frames[CurrentFrame].DescriptorSet,
+        1,
+        &FrameUniformOffset);
+
+    /* The world shaders read only the mode and alpha, the same for every */
+    /* opaque material, so one push covers all meshes. */
+    if (!DepthOnly)
+    {
+        PushConstants worldPush{};
+        worldPush.BaseColorAmbient[0] = 1.0f;
+        worldPush.BaseColorAmbient[1] = 1.0f;
+        worldPush.BaseColorAmbient[2] = 1.0f;
+        worldPush.BaseColorAmbient[3] = 0.0f;
+        worldPush.AlphaModePadding[0] = 1.0f;
+        worldPush.AlphaModePadding[1] = 1.0f;
+        vkCmdPushConstants(
+            CommandBuffer,
+            Pipeline->GetLayout(),
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0,
+            sizeof(PushConstants),
+            &worldPush);
+    }
+
+    /* Each mesh reads its visible range from the start, so commands keep */
+    /* firstInstance at 0 and need no drawIndirectFirstInstance support. */
+    for (std::size_t drawIndex = FirstDraw; drawIndex < FirstDraw + DrawCount; ++drawIndex)
+    {
+        const IndirectDraw& draw = IndirectDraws[drawIndex];
+        VkBuffer buffers[] = { draw.MeshPtr->VertexBuffer.GetBuffer(), VisibleInstances.Buffer };
+        VkDeviceSize offsets[] = { 0, VisibleInstances.Offset + sizeof(Mat4) * draw.OutputBase };
+        vkCmdBindVertexBuffers(CommandBuffer, 0, 2, buffers, offsets);
+
+        const VkDeviceSize commandOffset = IndirectCommands.Offset + kIndirectCommandStride * drawIndex;
+        const VkDeviceSize countOffset = IndirectCounts.Offset + sizeof(std::uint32_t) * drawIndex;
+        if (draw.MeshPtr->HasIndex && draw.MeshPtr->IndexCount > 0)
+        {
+            vkCmdBindIndexBuffer(CommandBuffer, draw.MeshPtr->IndexBuffer.GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+            if (DrawIndirectCountEnabled)
+            {
+                vkCmdDrawIndexedIndirectCount(
+                    CommandBuffer,
+                    IndirectCommands.Buffer,
+                    commandOffset,
+                    IndirectCounts.Buffer,
+                    countOffset,
+                    1,
+                    kIndirectCommandStride);
+            }
+            else
+            {
+                vkCmdDrawIndexedIndirect(CommandBuffer, IndirectCommands.Buffer, commandOffset, 1, kIndirectCommandStride);
+            }
+        }
+        else if (DrawIndirectCountEnabled)
+        {
+            vkCmdDrawIndirectCount(
+                CommandBuffer,
+                IndirectCommands.Buffer,
+                commandOffset,
+                IndirectCounts.Buffer,
+                countOffset,
+                1,
+                kIndirectCommandStride);
+        }
+        else
+        {
+            vkCmdDrawIndirect(CommandBuffer, IndirectCommands.Buffer, commandOffset, 1, kIndirectCommandStride);
+        }
+    }
+}
+
 void VulkanRenderer::DrawFrame(VkDevice Device, VkQueue GraphicsQueue)
 {
     /* Record a clear-only pass and present the swapchain image. */
 
-    if (Swapchain == VK_NULL_HANDLE || RenderPass == VK_NULL_HANDLE || CommandBuffers.empty())
+    if (SwapchainImageViews.empty() || RenderPass == VK_NULL_HANDLE ||
+        Frames.empty() || Frames[CurrentFrame].CommandBuffer == VK_NULL_HANDLE)
     {
         return;
     }
 
-    vkWaitForFences(Device, 1, &InFlightFence, VK_TRUE, UINT64_MAX);
+    /* Without a swapchain the frame renders into an offscreen image. */
+    const bool offscreen = Swapchain == VK_NULL_HANDLE;
 
-    uint32_t imageIndex = 0;
-    VkResult acquireResult = vkAcquireNextImageKHR(
-        Device,
-        Swapchain,
-        UINT64_MAX,
-        ImageAvailable,
-        VK_NULL_HANDLE,
-        &imageIndex);
+    /* Only this slot's last use must retire, newer frames keep the GPU busy. */
+    FrameResources& frame = Frames[CurrentFrame];
+    vkWaitForFences(Device, 1, &frame.InFlightFence, VK_TRUE, UINT64_MAX);
+
+    VkCommandBuffer commandBuffer = frame.CommandBuffer;
+    vkResetCommandBuffer(commandBuffer, 0);
+
+    /* This slot's fence was waited, so its ring region and retained */
+    /* storage can be rewritten and its secondaries re-recorded. */
+    FrameRing.BeginFrame(CurrentFrame);
+
+    /* Pick up pipeline variants that finished compiling since the last frame. */
+    UpdatePipelineVariants();
+
+    /* Without a resource table no handle can resolve. */
+    const RenderList* items = RenderResources ? RenderItems : nullptr;
+    const RenderList* casters = RenderResources ? ShadowCasterItems : nullptr;
+    const std::size_t itemCount = items && items->Transforms ? items->Items.size() : 0;
+    const std::size_t casterCount = casters && casters->Transforms ? casters->Items.size() : 0;
+
+    /* Retained proxy order: a leading run of opaque items already in batch */
+    /* order skips key building and the radix sort entirely. */
+    const std::size_t sortedCount =
+        itemCount > 0 ? std::min(static_cast<std::size_t>(items->SortedCount), itemCount) : 0;
+    const std::size_t sortedCasterCount =
+        casterCount > 0 ? std::min(static_cast<std::size_t>(casters->SortedCount), casterCount) : 0;
+
+    std::vector<RenderItem> opaqueItems;
+    std::vector<RenderItem> transparentItems;
+    std::vector<OpaqueBatch> opaqueBatches;
+    std::vector<OpaqueBatch> transparentBatches;
+    std::vector<OpaqueBatch> shadowBatches;
+    opaqueItems.reserve(itemCount);
+    transparentItems.reserve(itemCount);
+    if (sortedCount > 0)
+    {
+        opaqueItems.assign(items->Items.begin(), items->Items.begin() + sortedCount);
+    }
+    SortEntries.clear();
+    SortEntries.reserve(itemCount - sortedCount);
+
+    /* Build one packed key per item, the stage sits in the top bits. */
+    /* Handles are compact already, so they go into the key as-is. */
+    for (std::size_t index = sortedCount; index < itemCount; ++index)
+    {
+        const RenderItem& item = items->Items[index];
+        const Mesh* mesh = RenderResources->GetMesh(item.MeshHandle);
+        if (!mesh || mesh->VertexCount == 0)
+        {
+            continue;
+        }
+
+        const Material* material = RenderResources->GetMaterial(item.MaterialHandle);
+        const float alpha = material ? material->Alpha : 1.0f;
+        const RenderStage stage = alpha < 1.0f ? RenderStage::Transparent : RenderStage::Opaque;
+
+        RenderSortEntry entry{};
+        entry.Key = SortKeyEncoders[static_cast<std::size_t>(stage)].Encode(
+            stage,
+            0,
+            item.MaterialHandle,
+            item.MeshHandle,
+            ComputeDepthSq(items->Transforms[item.TransformIndex], Camera));
+        entry.Index = static_cast<std::uint32_t>(index);
+        SortEntries.push_back(entry);
+    }
+
+    RadixSortRenderEntries(SortEntries, SortScratch);
+
+    /* Sorted keys are grouped by stage, split them in order. */
+    constexpr std::uint32_t kStageShift = 64 - RenderSortKeyEncoder::kStageBits;
+    for (const RenderSortEntry& entry : SortEntries)
+    {
+        const RenderItem& item = items->Items[entry.Index];
+        if (static_cast<RenderStage>(entry.Key >> kStageShift) == RenderStage::Transparent)
+        {
+            transparentItems.push_back(item);
+        }
+        else
+        {
+            opaqueItems.push_back(item);
+        }
+    }
+
+    /* Shadow casters come from their own light-culled list and only */
+    /* need grouping by mesh, so the key is the mesh handle alone. */
+    /* Their presorted run is grouped by material first, which only splits */
+    /* a mesh into one batch per material. */
+    SortEntries.clear();
+    SortEntries.reserve(casterCount - sortedCasterCount);
+    for (std::size_t index = sortedCasterCount; index < casterCount; ++index)
+    {
+        const RenderItem& item = casters->Items[index];
+        const Mesh* mesh = RenderResources->GetMesh(item.MeshHandle);
+        if (!mesh || mesh->VertexCount == 0)
+        {
+            continue;
+        }
 
-    if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR)
+        RenderSortEntry entry{};
+        entry.Key = item.MeshHandle;
+        entry.Index = static_cast<std::uint32_t>(index);
+        SortEntries.push_back(entry);
+    }
+
+    RadixSortRenderEntries(SortEntries, SortScratch);
+
+    /* Matrices go straight from the scene cache into mapped memory in final */
+    /* order. Opaque and shadow instances use the slot's retained buffer, so a */
+    /* static scene keeps the same addresses; transparent ones use the ring. */
+    const std::size_t retainedCount = opaqueItems.size() + sortedCasterCount + SortEntries.size();
+    if (!ReserveRetainedStorage(frame, retainedCount) || !UpdateUniformBuffer(Device))
     {
         return;
     }
 
-    vkResetFences(Device, 1, &InFlightFence);
+    FrameInstances = RingAllocation{};
+    if (!transparentItems.empty() &&
+        !FrameRing.Allocate(sizeof(Mat4) * transparentItems.size(), kInstanceAlignment, FrameInstances))
+    {
+        std::fprintf(stderr, "VulkanRenderer::DrawFrame: instance allocation failed\n");
+        return;
+    }
 
-    VkCommandBuffer commandBuffer = CommandBuffers[imageIndex];
-    vkResetCommandBuffer(commandBuffer, 0);
+    Mat4* instances = static_cast<Mat4*>(RetainedInstances.Mapped);
+    Mat4* transparentInstances = static_cast<Mat4*>(FrameInstances.Mapped);
+    std::size_t instanceIndex = 0;
+
+    /* Items are sorted by state, so a batch ends where either handle changes. */
+    for (std::size_t index = 0; index < opaqueItems.size(); ++index)
+    {
+        const RenderItem& item = opaqueItems[index];
+        if (index == 0 ||
+            item.MeshHandle != opaqueItems[index - 1].MeshHandle ||
+            item.MaterialHandle != opaqueItems[index - 1].MaterialHandle)
+        {
+            OpaqueBatch batch{};
+            batch.StartIndex = instanceIndex;
+            batch.MeshPtr = RenderResources->GetMesh(item.MeshHandle);
+            batch.MaterialPtr = RenderResources->GetMaterial(item.MaterialHandle);
+            opaqueBatches.push_back(batch);
+        }
+
+        ++opaqueBatches.back().Count;
+        instances[instanceIndex++] = items->Transforms[item.TransformIndex];
+    }
+
+    /* With OIT the transparent order is free, so equal state batches up. */
+    for (std::size_t index = 0; index < transparentItems.size(); ++index)
+    {
+        const RenderItem& item = transparentItems[index];
+        if (WeightedOITActive &&
+            (index == 0 ||
+            item.MeshHandle != transparentItems[index - 1].MeshHandle ||
+            item.MaterialHandle != transparentItems[index - 1].MaterialHandle))
+        {
+            OpaqueBatch batch{};
+            batch.StartIndex = index;
+            batch.MeshPtr = RenderResources->GetMesh(item.MeshHandle);
+            batch.MaterialPtr = RenderResources->GetMaterial(item.MaterialHandle);
+            transparentBatches.push_back(batch);
+        }
+
+        if (WeightedOITActive)
+        {
+            ++transparentBatches.back().Count;
+        }
+        transparentInstances[index] = items->Transforms[item.TransformIndex];
+    }
+
+    /* The presorted run is not filtered yet, so casters without */
+    /* geometry are skipped here before they can open a batch. */
+    auto appendShadowCaster = [&](const RenderItem& item)
+    {
+        if (shadowBatches.empty() || shadowBatches.back().MeshHandle != item.MeshHandle)
+        {
+            Mesh* mesh = RenderResources->GetMesh(item.MeshHandle);
+            if (!mesh || mesh->VertexCount == 0)
+            {
+                return;
+            }
+
+            OpaqueBatch batch{};
+            batch.StartIndex = instanceIndex;
+            batch.MeshHandle = item.MeshHandle;
+            batch.MeshPtr = mesh;
+            shadowBatches.push_back(batch);
+        }
+
+        ++shadowBatches.back().Count;
+        instances[instanceIndex++] = casters->Transforms[item.TransformIndex];
+    };
 
-    UpdateUniformBuffer(Device);
+    for (std::size_t index = 0; index < sortedCasterCount; ++index)
+    {
+        appendShadowCaster(casters->Items[index]);
+    }
+
+    for (const RenderSortEntry& entry : SortEntries)
+    {
+        appendShadowCaster(casters->Items[entry.Index]);
+    }
+
+    /* Opaque instances are culled on the GPU and drawn indirectly per mesh; */
+    /* frames the path cannot take fall back to the CPU batches. */
+    const bool gpuCulling =
+        GpuCullingEnabled &&
+        Pipeline->IsVariantReady(PipelineVariant::Cull) &&
+        !opaqueBatches.empty() &&
+        PrepareGpuCulling(Device, opaqueBatches, opaqueItems.size());
+    const std::size_t opaqueDrawCount = gpuCulling ? IndirectDraws.size() : opaqueBatches.size();
+
+    std::uint32_t drawCalls = 0;
+    std::uint64_t triangleCount = 0;
+    std::uint64_t vertexCount = 0;
+    if (Skybox.IsReady() && Camera && SwapchainExtent.width > 0 && SwapchainExtent.height > 0)
+    {
+        drawCalls += 1;
+        vertexCount += 36;
+        triangleCount += 12;
+    }
+    /* Adds one batch's draws and geometry; indexed meshes count indices. */
+    auto recordBatchStats = [&](const Mesh* mesh, std::uint64_t instanceCount, std::uint32_t draws, std::uint32_t passes)
+    {
+        drawCalls += draws;
+        const std::uint64_t perInstance =
+            mesh->HasIndex && mesh->IndexCount > 0 ? mesh->IndexCount : mesh->VertexCount;
+        vertexCount += perInstance * instanceCount * passes;
+        triangleCount += (perInstance / 3) * instanceCount * passes;
+    };
+
+    /* The depth pre-pass replays every opaque batch. With GPU culling the */
+    /* geometry counts are before culling, an upper bound of what is drawn. */
+    const std::uint32_t opaquePasses = DepthPrepassActive ? 2u : 1u;
+    if (gpuCulling)
+    {
+        drawCalls += static_cast<std::uint32_t>(opaqueDrawCount) * opaquePasses;
+    }
+    for (const OpaqueBatch& batch : opaqueBatches)
+    {
+        if (batch.MeshPtr)
+        {
+            recordBatchStats(batch.MeshPtr, batch.Count, gpuCulling ? 0u : opaquePasses, opaquePasses);
+        }
+    }
+    for (const OpaqueBatch& batch : shadowBatches)
+    {
+        recordBatchStats(batch.MeshPtr, batch.Count, 1u, 1u);
+    }
+    for (const OpaqueBatch& batch : transparentBatches)
+    {
+        recordBatchStats(batch.MeshPtr, batch.Count, 1u, 1u);
+    }
+    if (WeightedOITActive && !transparentBatches.empty())
+    {
+        drawCalls += 1;
+        vertexCount += 3;
+        triangleCount += 1;
+    }
+    /* The sorted transparent stage draws one instance per item. */
+    const std::size_t sortedTransparentCount = WeightedOITActive ? 0 : transparentItems.size();
+    for (std::size_t index = 0; index < sortedTransparentCount; ++index)
+    {
+        recordBatchStats(RenderResources->GetMesh(transparentItems[index].MeshHandle), 1u, 1u, 1u);
+    }
+
+    if (Overlay.IsInitialized())
+    {
+        Overlay.SetRenderStats(drawCalls, triangleCount, vertexCount);
+        Overlay.SetCullStats(
+            SubmittedItemCount,
+            CulledItemCount,
+            OccludedItemCount,
+            static_cast<std::uint32_t>(opaqueItems.size() + transparentItems.size()));
+
+        /* Startup pipeline creation time against the last cold start, */
+        /* still growing while variants compile in the background. */
+        const VulkanPipelineCacheStats cacheStats = g_VulkanPipelineCache.GetStats();
+        Overlay.SetPipelineCacheStats(
+            cacheStats.Warm,
+            cacheStats.StartupComplete,
+            cacheStats.PipelineCount,
+            static_cast<float>(cacheStats.StartupMilliseconds),
+            static_cast<float>(cacheStats.SavedMilliseconds));
+    }
+
+    /* Stages are cut into fixed-size draw ranges, each recorded into its own */
+    /* secondary; a stage that did not change cuts the same way next time. */
+    std::vector<RecordTask>& tasks = frame.Tasks;
+    PreviousTasks.swap(tasks);
+    tasks.clear();
+
+    auto addTasks = [&](RecordStage stage, std::size_t count)
+    {
+        for (std::size_t begin = 0; begin < count; begin += kDrawsPerRecordTask)
+        {
+            RecordTask task{};
+            task.Stage = stage;
+            task.Begin = begin;
+            task.End = std::min(count, begin + kDrawsPerRecordTask);
+            tasks.push_back(task);
+        }
+    };
+
+    /* Task order is replay order: shadow pass, then subpass 0, then subpass 1. */
+    addTasks(RecordStage::Shadow, shadowBatches.size());
+    if (DepthPrepassActive)
+    {
+        addTasks(RecordStage::DepthPrepass, opaqueDrawCount);
+    }
+    RecordTask skyboxTask{};
+    skyboxTask.Stage = RecordStage::Skybox;
+    tasks.push_back(skyboxTask);
+    addTasks(RecordStage::Opaque, opaqueDrawCount);
+    addTasks(RecordStage::Transparent, sortedTransparentCount);
+    if (WeightedOITActive)
+    {
+        addTasks(RecordStage::WeightedBlend, transparentBatches.size());
+    }
+
+    /* Shadow, pre-pass and opaque commands depend only on their batches and */
+    /* the slot's retained bindings; sky and transparent ones change per frame, */
+    /* as do indirect draws, which read this frame's ring blocks. */
+    auto cachedBatches = [&](RecordStage stage) -> const OpaqueBatch*
+    {
+        switch (stage)
+        {
+        case RecordStage::Shadow:
+            return shadowBatches.data();
+        case RecordStage::DepthPrepass:
+        case RecordStage::Opaque:
+            return gpuCulling ? nullptr : opaqueBatches.data();
+        default:
+            return nullptr;
+        }
+    };
+
+    /* Both task lists are ordered by stage and range, so one cursor walks */
+    /* the previous list while matching ranges take over its secondaries. */
+    std::size_t cursor = 0;
+    for (RecordTask& task : tasks)
+    {
+        const OpaqueBatch* batches = cachedBatches(task.Stage);
+        if (!batches)
+        {
+            continue;
+        }
+
+        while (cursor < PreviousTasks.size() &&
+            (PreviousTasks[cursor].Stage < task.Stage ||
+            (PreviousTasks[cursor].Stage == task.Stage && PreviousTasks[cursor].Begin < task.Begin)))
+        {
+            ++cursor;
+        }
+
+        if (cursor == PreviousTasks.size())
+        {
+            break;
+        }
+
+        RecordTask& previous = PreviousTasks[cursor];
+        if (previous.Stage != task.Stage ||
+            previous.Begin != task.Begin ||
+            previous.End != task.End ||
+            previous.CommandBuffer == VK_NULL_HANDLE ||
+            previous.CacheEpoch != RecordCacheEpoch ||
+            !MatchesBatchState(previous.Batches, batches + task.Begin))
+        {
+            continue;
+        }
+
+        task.CommandBuffer = previous.CommandBuffer;
+        task.Worker = previous.Worker;
+        task.CacheEpoch = previous.CacheEpoch;
+        task.Batches.swap(previous.Batches);
+        previous.CommandBuffer = VK_NULL_HANDLE;
+    }
+
+    /* Secondaries that did not replay go back to their worker for reuse. */
+    for (const RecordTask& previous : PreviousTasks)
+    {
+        if (previous.CommandBuffer != VK_NULL_HANDLE)
+        {
+            frame.Workers[previous.Worker].Free.push_back(previous.CommandBuffer);
+        }
+    }
+    PreviousTasks.clear();
+
+    PendingTasks.clear();
+    for (std::size_t index = 0; index < tasks.size(); ++index)
+    {
+        if (tasks[index].CommandBuffer == VK_NULL_HANDLE)
+        {
+            PendingTasks.push_back(static_cast<std::uint32_t>(index));
+        }
+    }
+
+    /* Each worker records into its own pool; the inputs are read-only here. */
+    /* Scene secondaries leave the framebuffer open so any swapchain image */
+    /* can replay them. */
+    const std::uint32_t pendingCount = static_cast<std::uint32_t>(PendingTasks.size());
+    const std::uint32_t recordWorkers = std::min(
+        static_cast<std::uint32_t>(frame.Workers.size()),
+        GetParallelWorkerCount(pendingCount, kMinTasksPerRecordWorker));
+    ParallelFor(pendingCount, recordWorkers,
+        [&](std::uint32_t workerIndex, std::uint32_t begin, std::uint32_t end)
+        {
+            RecordWorker& worker = frame.Workers[workerIndex];
+            for (std::uint32_t pendingIndex = begin; pendingIndex < end; ++pendingIndex)
+            {
+                RecordTask& task = tasks[PendingTasks[pendingIndex]];
+                const bool shadowTask = task.Stage == RecordStage::Shadow;
+
+                VkCommandBuffer secondary = AcquireSecondary(Device, worker);
+                if (secondary == VK_NULL_HANDLE)
+                {
+                    continue;
+                }
+
+                if (!BeginSecondaryCommandBuffer(
+                    secondary,
+                    shadowTask ? ShadowRenderPass : RenderPass,
+                    task.Stage == RecordStage::WeightedBlend ? 1u : 0u,
+                    shadowTask ? ShadowFramebuffer : VK_NULL_HANDLE))
+                {
+                    worker.Free.push_back(secondary);
+                    continue;
+                }
+
+                /* Dynamic state is not inherited from the primary. */
+                if (!shadowTask)
+                {
+                    SetFullViewport(secondary, SwapchainExtent);
+                }
+
+                const std::size_t count = task.End - task.Begin;
+                switch (task.Stage)
+                {
+                case RecordStage::Shadow:
+                    RecordShadowStage(secondary, shadowBatches.data() + task.Begin, count);
+                    break;
+                case RecordStage::DepthPrepass:
+                    if (gpuCulling)
+                    {
+                        RecordIndirectStage(secondary, true, task.Begin, count);
+                    }
+                    else
+                    {
+                        RecordDepthPrepassStage(secondary, opaqueBatches.data() + task.Begin, count);
+                    }
+                    break;
+                case RecordStage::Skybox:
+                    RecordSkyboxStage(secondary, SwapchainExtent);
+                    break;
+                case RecordStage::Opaque:
+                    if (gpuCulling)
+                    {
+                        RecordIndirectStage(secondary, false, task.Begin, count);
+                    }
+                    else
+                    {
+                        RecordOpaqueStage(
+                            secondary,
+                            SwapchainExtent,
+                            opaqueItems,
+                            opaqueBatches.data() + task.Begin,
+                            count);
+                    }
+                    break;
+                case RecordStage::Transparent:
+                    RecordTransparentStage(
+                        secondary,
+                        SwapchainExtent,
+                        transparentItems.data() + task.Begin,
+                        count,
+                        static_cast<std::uint32_t>(task.Begin));
+                    break;
+                case RecordStage::WeightedBlend:
+                    RecordWeightedBlendStage(secondary, transparentBatches.data() + task.Begin, count);
+                    break;
+                }
+
+                if (vkEndCommandBuffer(secondary) != VK_SUCCESS)
+                {
+                    worker.Free.push_back(secondary);
+                    continue;
+                }
+
+                task.CommandBuffer = secondary;
+                task.Worker = workerIndex;
+
+                /* Remember what the commands baked in, for replay next time. */
+                const OpaqueBatch* batches = cachedBatches(task.Stage);
+                if (batches)
+                {
+                    task.CacheEpoch = RecordCacheEpoch;
+                    task.Batches.clear();
+                    for (std::size_t index = task.Begin; index < task.End; ++index)
+                    {
+                        task.Batches.push_back(CaptureBatchState(batches[index]));
+                    }
+                }
+            }
+        });
+
+    /* Tasks are grouped by stage, so each subpass replays a contiguous run. */
+    std::vector<VkCommandBuffer> secondaries;
+    secondaries.reserve(tasks.size());
+    auto executeRecorded = [&](RecordStage firstStage, RecordStage lastStage)
+    {
+        secondaries.clear();
+        for (const RecordTask& task : tasks)
+        {
+            if (task.Stage >= firstStage && task.Stage <= lastStage &&
+                task.CommandBuffer != VK_NULL_HANDLE)
+            {
+                secondaries.push_back(task.CommandBuffer);
+            }
+        }
+
+        if (!secondaries.empty())
+        {
+            vkCmdExecuteCommands(
+                commandBuffer,
+                static_cast<std::uint32_t>(secondaries.size()),
+                secondaries.data());
+        }
+    };
 
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     vkBeginCommandBuffer(commandBuffer, &beginInfo);
 
+    /* Culling runs outside the render passes, before anything draws. */
+    if (gpuCulling)
+    {
+        RecordCullDispatch(commandBuffer, static_cast<std::uint32_t>(opaqueItems.size()));
+    }
+
     VkImageMemoryBarrier shadowToDepth{};
     shadowToDepth.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     shadowToDepth.srcAccessMask = ShadowLayoutInitialized ? VK_ACCESS_SHADER_READ_BIT : 0;
@@ -914,71 +1709,8 @@ void VulkanRenderer::DrawFrame(VkDevice Device, VkQueue GraphicsQueue)
     shadowPassInfo.clearValueCount = 1;
     shadowPassInfo.pClearValues = &shadowClear;
 
-    vkCmdBeginRenderPass(commandBuffer, &shadowPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-    VkViewport shadowViewport{};
-    shadowViewport.x = 0.0f;
-    shadowViewport.y = 0.0f;
-    shadowViewport.width = static_cast<float>(ShadowExtent.width);
-    shadowViewport.height = static_cast<float>(ShadowExtent.height);
-    shadowViewport.minDepth = 0.0f;
-    shadowViewport.maxDepth = 1.0f;
-
-    VkRect2D shadowScissor{};
-    shadowScissor.offset = { 0, 0 };
-    shadowScissor.extent = ShadowExtent;
-
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline->GetShadowHandle());
-    vkCmdSetViewport(commandBuffer, 0, 1, &shadowViewport);
-    vkCmdSetScissor(commandBuffer, 0, 1, &shadowScissor);
-
-    struct ShadowPush
-    {
-        Mat4 LightViewProj;
-        Mat4 Model;
-    };
-
-    for (const RenderItem& item : RenderItems)
-    {
-        if (!item.MeshPtr || item.MeshPtr->VertexCount == 0)
-        {
-            continue;
-        }
-
-        VkBuffer vertexBuffer = item.MeshPtr->VertexBuffer.GetBuffer();
-        if (vertexBuffer != VK_NULL_HANDLE)
-        {
-            VkDeviceSize offsets[] = { 0 };
-            vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, offsets);
-        }
-
-        ShadowPush shadowPush{};
-        shadowPush.LightViewProj = LightViewProj;
-        shadowPush.Model = item.Model;
-
-        vkCmdPushConstants(
-            commandBuffer,
-            Pipeline->GetShadowLayout(),
-            VK_SHADER_STAGE_VERTEX_BIT,
-            0,
-            sizeof(ShadowPush),
-            &shadowPush);
-
-        if (item.MeshPtr->HasIndex && item.MeshPtr->IndexCount > 0)
-        {
-            VkBuffer indexBuffer = item.MeshPtr->IndexBuffer.GetBuffer();
-            if (indexBuffer != VK_NULL_HANDLE)
-            {
-                vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-                vkCmdDrawIndexed(commandBuffer, item.MeshPtr->IndexCount, 1, 0, 0, 0);
-            }
-        }
-        else
-        {
-            vkCmdDraw(commandBuffer, item.MeshPtr->VertexCount, 1, 0, 0);
-        }
-    }
-
+    vkCmdBeginRenderPass(commandBuffer, &shadowPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    executeRecorded(RecordStage::Shadow, RecordStage::Shadow);
     vkCmdEndRenderPass(commandBuffer);
 
     VkImageMemoryBarrier shadowToRead{};
@@ -1009,204 +1741,79 @@ void VulkanRenderer::DrawFrame(VkDevice Device, VkQueue GraphicsQueue)
         &shadowToRead);
     ShadowLayoutInitialized = true;
 
-    VkClearValue clearValues[3]{};
-    clearValues[0].color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
-    clearValues[1].depthStencil = { 1.0f, 0 };
-    clearValues[2].color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
-
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = RenderPass;
-    renderPassInfo.framebuffer = Framebuffers[imageIndex];
-    renderPassInfo.renderArea.offset = { 0, 0 };
-    renderPassInfo.renderArea.extent = SwapchainExtent;
-    renderPassInfo.clearValueCount = 3;
-    renderPassInfo.pClearValues = clearValues;
-
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(SwapchainExtent.width);
-    viewport.height = static_cast<float>(SwapchainExtent.height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor{};
-    scissor.offset = { 0, 0 };
-    scissor.extent = SwapchainExtent;
-
-    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-    std::vector<SortedRenderItem> opaqueItems;
-    std::vector<SortedRenderItem> transparentItems;
-    std::vector<OpaqueBatch> opaqueBatches;
-    std::vector<Mat4> instanceModels;
-    opaqueItems.reserve(RenderItems.size());
-    transparentItems.reserve(RenderItems.size());
-
-    for (const RenderItem& item : RenderItems)
+    /* Every early return is behind us, so the acquired image always */
+    /* reaches a submit that waits on ImageAvailable. */
+    uint32_t imageIndex = 0;
+    if (offscreen)
     {
-        if (!item.MeshPtr || item.MeshPtr->VertexCount == 0)
-        {
-            continue;
-        }
-
-        const float depthSq = ComputeDepthSq(item, Camera);
-        const float alpha = item.MaterialPtr ? item.MaterialPtr->Alpha : 1.0f;
-        const SortedRenderItem entry{ &item, depthSq };
-
-        if (alpha < 1.0f)
-        {
-            transparentItems.push_back(entry);
-        }
-        else
-        {
-            opaqueItems.push_back(entry);
-        }
+        /* Offscreen images are owned outright, cycle them with the frame slot. */
+        imageIndex = CurrentFrame % static_cast<uint32_t>(SwapchainImageViews.size());
     }
-
-    std::sort(
-        opaqueItems.begin(),
-        opaqueItems.end(),
-        [](const SortedRenderItem& a, const SortedRenderItem& b)
-        {
-            if (a.DepthSq != b.DepthSq)
-            {
-                return a.DepthSq < b.DepthSq;
-            }
-            if (a.Item->MaterialPtr != b.Item->MaterialPtr)
-            {
-                return a.Item->MaterialPtr < b.Item->MaterialPtr;
-            }
-            return a.Item->MeshPtr < b.Item->MeshPtr;
-        });
-
-    if (!opaqueItems.empty())
+    else
     {
-        OpaqueBatch currentBatch{};
-        currentBatch.StartIndex = 0;
-        currentBatch.Count = 0;
-        currentBatch.MeshPtr = opaqueItems[0].Item->MeshPtr;
-        currentBatch.MaterialPtr = opaqueItems[0].Item->MaterialPtr;
+        VkResult acquireResult = vkAcquireNextImageKHR(
+            Device,
+            Swapchain,
+            UINT64_MAX,
+            frame.ImageAvailable,
+            VK_NULL_HANDLE,
+            &imageIndex);
 
-        for (std::size_t index = 0; index < opaqueItems.size(); ++index)
+        if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR)
         {
-            const RenderItem* item = opaqueItems[index].Item;
-            if (item->MeshPtr != currentBatch.MeshPtr ||
-                item->MaterialPtr != currentBatch.MaterialPtr)
-            {
-                opaqueBatches.push_back(currentBatch);
-                currentBatch.StartIndex = index;
-                currentBatch.Count = 0;
-                currentBatch.MeshPtr = item->MeshPtr;
-                currentBatch.MaterialPtr = item->MaterialPtr;
-            }
-
-            ++currentBatch.Count;
+            return;
         }
-
-        opaqueBatches.push_back(currentBatch);
     }
 
-    std::sort(
-        transparentItems.begin(),
-        transparentItems.end(),
-        [](const SortedRenderItem& a, const SortedRenderItem& b)
-        {
-            return a.DepthSq > b.DepthSq;
-        });
-
-    instanceModels.reserve(opaqueItems.size() + transparentItems.size());
-    for (const SortedRenderItem& entry : opaqueItems)
+    /* The image may still be in use by an older slot (out-of-order acquire). */
+    if (imageIndex < ImagesInFlight.size())
     {
-        instanceModels.push_back(entry.Item->Model);
-    }
-    const std::uint32_t transparentBase =
-        static_cast<std::uint32_t>(instanceModels.size());
-    for (const SortedRenderItem& entry : transparentItems)
-    {
-        instanceModels.push_back(entry.Item->Model);
-    }
-
-    std::uint32_t drawCalls = 0;
-    std::uint64_t triangleCount = 0;
-    std::uint64_t vertexCount = 0;
-    if (Skybox.IsReady() && Camera && SwapchainExtent.width > 0 && SwapchainExtent.height > 0)
-    {
-        drawCalls += 1;
-        vertexCount += 36;
-        triangleCount += 12;
-    }
-    for (const OpaqueBatch& batch : opaqueBatches)
-    {
-        if (!batch.MeshPtr)
+        if (ImagesInFlight[imageIndex] != VK_NULL_HANDLE &&
+            ImagesInFlight[imageIndex] != frame.InFlightFence)
         {
-            continue;
-        }
-
-        drawCalls += 1;
-        if (batch.MeshPtr->HasIndex && batch.MeshPtr->IndexCount > 0)
-        {
-            const std::uint64_t indicesPerInstance = batch.MeshPtr->IndexCount;
-            vertexCount += indicesPerInstance * batch.Count;
-            triangleCount += (indicesPerInstance / 3) * batch.Count;
-        }
-        else
-        {
-            const std::uint64_t verticesPerInstance = batch.MeshPtr->VertexCount;
-            vertexCount += verticesPerInstance * batch.Count;
-            triangleCount += (verticesPerInstance / 3) * batch.Count;
+            vkWaitForFences(Device, 1, &ImagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
         }
+        ImagesInFlight[imageIndex] = frame.InFlightFence;
     }
-    for (const SortedRenderItem& entry : transparentItems)
-    {
-        const RenderItem& item = *entry.Item;
-        if (!item.MeshPtr)
-        {
-            continue;
-        }
 
-        drawCalls += 1;
-        if (item.MeshPtr->HasIndex && item.MeshPtr->IndexCount > 0)
-        {
-            const std::uint64_t indicesPerInstance = item.MeshPtr->IndexCount;
-            vertexCount += indicesPerInstance;
-            triangleCount += indicesPerInstance / 3;
-        }
-        else
-        {
-            const std::uint64_t verticesPerInstance = item.MeshPtr->VertexCount;
-            vertexCount += verticesPerInstance;
-            triangleCount += verticesPerInstance / 3;
-        }
-    }
+    /* Accumulation starts empty, revealage starts fully revealed. */
+    /* A pass without the OIT subpasses only takes the first three. */
+    VkClearValue clearValues[5]{};
+    clearValues[0].color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+    clearValues[1].depthStencil = { 1.0f, 0 };
+    clearValues[2].color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+    clearValues[3].color = { { 0.0f, 0.0f, 0.0f, 0.0f } };
+    clearValues[4].color = { { 1.0f, 0.0f, 0.0f, 0.0f } };
 
-    if (Overlay.IsInitialized())
-    {
-        Overlay.SetRenderStats(drawCalls, triangleCount, vertexCount);
-    }
+    VkRenderPassBeginInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = RenderPass;
+    renderPassInfo.framebuffer = Framebuffers[imageIndex];
+    renderPassInfo.renderArea.offset = { 0, 0 };
+    renderPassInfo.renderArea.extent = SwapchainExtent;
+    renderPassInfo.clearValueCount = WeightedOITEnabled ? 5 : 3;
+    renderPassInfo.pClearValues = clearValues;
 
-    if (!EnsureInstanceBuffer(Device, PhysicalDeviceHandle, instanceModels.size()))
-    {
-        return;
-    }
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    /* Main render pass stages: [depth pre-pass] -> skybox -> opaque -> transparent. */
+    /* The pre-pass runs first so the sky is also rejected behind geometry. */
+    executeRecorded(RecordStage::DepthPrepass, RecordStage::Transparent);
 
-    if (!instanceModels.empty())
+    /* OIT subpasses exist only when enabled at create; until the OIT */
+    /* pipelines are ready they stay empty and resolve only. */
+    if (WeightedOITEnabled)
     {
-        void* instanceData = nullptr;
-        if (vkMapMemory(Device, InstanceMemory, 0,
-            sizeof(Mat4) * instanceModels.size(), 0, &instanceData) == VK_SUCCESS)
+        vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        executeRecorded(RecordStage::WeightedBlend, RecordStage::WeightedBlend);
+
+        /* The composite is a single draw, it always records inline. */
+        vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+        if (WeightedOITActive && !transparentBatches.empty())
         {
-            std::memcpy(instanceData, instanceModels.data(),
-                sizeof(Mat4) * instanceModels.size());
-            vkUnmapMemory(Device, InstanceMemory);
+            SetFullViewport(commandBuffer, SwapchainExtent);
+            RecordCompositeStage(commandBuffer);
         }
     }
-    /* Main render pass stages: skybox -> opaque -> transparent. */
-    RecordSkyboxStage(commandBuffer, SwapchainExtent);
-    RecordOpaqueStage(commandBuffer, SwapchainExtent, opaqueItems, opaqueBatches);
-    RecordTransparentStage(commandBuffer, SwapchainExtent, transparentItems, transparentBase);
     vkCmdEndRenderPass(commandBuffer);
 
     vkEndCommandBuffer(commandBuffer);
@@ -1215,29 +1822,60 @@ void VulkanRenderer::DrawFrame(VkDevice Device, VkQueue GraphicsQueue)
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = &ImageAvailable;
-    submitInfo.pWaitDstStageMask = waitStages;
+    submitInfo.waitSemaphoreCount = offscreen ? 0 : 1;
+    submitInfo.pWaitSemaphores = offscreen ? nullptr : &frame.ImageAvailable;
+    submitInfo.pWaitDstStageMask = offscreen ? nullptr : waitStages;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &RenderFinished;
+    submitInfo.signalSemaphoreCount = offscreen ? 0 : 1;
+    submitInfo.pSignalSemaphores = offscreen ? nullptr : &frame.RenderFinished;
+
+    /* Pending uploads reach the graphics queue first; their barriers */
+    /* order them before this frame without a CPU wait. */
+    g_VulkanUploader.Flush();
+
+    /* With the overlay the fence rides on a trailing empty submit instead, */
+    /* so it also covers the overlay's command buffer. */
+    const bool overlayActive = !offscreen && Overlay.IsInitialized();
+    vkResetFences(Device, 1, &frame.InFlightFence);
+    if (vkQueueSubmit(
+        GraphicsQueue,
+        1,
+        &submitInfo,
+        overlayActive ? VK_NULL_HANDLE : frame.InFlightFence) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanRenderer::DrawFrame: vkQueueSubmit failed\n");
+        RetireFrameSlot(Device, GraphicsQueue, frame, !offscreen);
+        return;
+    }
+
+    LastImageIndex = imageIndex;
 
-    if (vkQueueSubmit(GraphicsQueue, 1, &submitInfo, InFlightFence) != VK_SUCCESS)
+    if (offscreen)
     {
+        /* Nothing to present, the image stays a transfer source for readback. */
+        CurrentFrame = (CurrentFrame + 1) % static_cast<std::uint32_t>(Frames.size());
         return;
     }
 
-    VkSemaphore presentSemaphore = RenderFinished;
+    VkSemaphore presentSemaphore = frame.RenderFinished;
 
-    if (Overlay.IsInitialized())
+    if (overlayActive)
     {
+        /* The overlay streams into this slot's own buffers, which the */
+        /* fence wait at the top of the frame already retired. */
         Overlay.SetSceneEntities(EditorEntities);
         Overlay.SetSelectedEntity(EditorSelectedEntity);
         Overlay.SetInspectorData(InspectorState);
         Overlay.BeginFrame(OverlayDeltaTime);
         EditorSelectedEntity = Overlay.GetSelectedEntity();
-        presentSemaphore = Overlay.Render(GraphicsQueue, imageIndex, RenderFinished);
+        presentSemaphore = Overlay.Render(GraphicsQueue, imageIndex, CurrentFrame, frame.RenderFinished);
+        if (vkQueueSubmit(GraphicsQueue, 0, nullptr, frame.InFlightFence) != VK_SUCCESS)
+        {
+            /* The image is already rendered, so it is still presented below. */
+            std::fprintf(stderr, "VulkanRenderer::DrawFrame: vkQueueSubmit (overlay fence) failed\n");
+            RetireFrameSlot(Device, GraphicsQueue, frame, false);
+        }
     }
 
     VkPresentInfoKHR presentInfo{};
@@ -1249,6 +1887,13 @@ void VulkanRenderer::DrawFrame(VkDevice Device, VkQueue GraphicsQueue)
     presentInfo.pImageIndices = &imageIndex;
 
     vkQueuePresentKHR(GraphicsQueue, &presentInfo);
+
+    CurrentFrame = (CurrentFrame + 1) % static_cast<std::uint32_t>(Frames.size());
+}
+
+std::uint32_t VulkanRenderer::GetLastImageIndex() const
+{
+    return LastImageIndex;
 }
 
 void VulkanRenderer::Destroy(VkDevice Device)
@@ -1261,12 +1906,7 @@ void VulkanRenderer::Destroy(VkDevice Device)
 
     if (activeDevice != VK_NULL_HANDLE)
     {
-        if (!CommandBuffers.empty() && CommandPool != VK_NULL_HANDLE)
-        {
-            vkFreeCommandBuffers(activeDevice, CommandPool,
-                static_cast<uint32_t>(CommandBuffers.size()), CommandBuffers.data());
-        }
-        CommandBuffers.clear();
+        DestroyFrameResources(activeDevice);
 
         for (VkFramebuffer framebuffer : Framebuffers)
         {
@@ -1279,6 +1919,7 @@ void VulkanRenderer::Destroy(VkDevice Device)
 
         DestroyDepthResources(activeDevice);
         DestroyColorResources(activeDevice);
+        DestroyTransparencyResources(activeDevice);
         DestroyTextureResources(activeDevice);
         /* Release skybox resources. */
         Skybox.Destroy(activeDevice);
@@ -1289,24 +1930,6 @@ void VulkanRenderer::Destroy(VkDevice Device)
             CommandPool = VK_NULL_HANDLE;
         }
 
-        if (ImageAvailable != VK_NULL_HANDLE)
-        {
-            vkDestroySemaphore(activeDevice, ImageAvailable, nullptr);
-            ImageAvailable = VK_NULL_HANDLE;
-        }
-
-        if (RenderFinished != VK_NULL_HANDLE)
-        {
-            vkDestroySemaphore(activeDevice, RenderFinished, nullptr);
-            RenderFinished = VK_NULL_HANDLE;
-        }
-
-        if (InFlightFence != VK_NULL_HANDLE)
-        {
-            vkDestroyFence(activeDevice, InFlightFence, nullptr);
-            InFlightFence = VK_NULL_HANDLE;
-        }
-
         if (DescriptorPool != VK_NULL_HANDLE)
         {
             vkDestroyDescriptorPool(activeDevice, DescriptorPool, nullptr);
@@ -1319,36 +1942,37 @@ void VulkanRenderer::Destroy(VkDevice Device)
             DescriptorSetLayout = VK_NULL_HANDLE;
         }
 
-        if (UniformBuffer != VK_NULL_HANDLE)
+        if (CompositeSetLayout != VK_NULL_HANDLE)
         {
-            vkDestroyBuffer(activeDevice, UniformBuffer, nullptr);
-            UniformBuffer = VK_NULL_HANDLE;
+            vkDestroyDescriptorSetLayout(activeDevice, CompositeSetLayout, nullptr);
+            CompositeSetLayout = VK_NULL_HANDLE;
         }
+        CompositeSet = VK_NULL_HANDLE;
 
-        if (UniformMemory != VK_NULL_HANDLE)
+        if (CullSetLayout != VK_NULL_HANDLE)
         {
-            vkFreeMemory(activeDevice, UniformMemory, nullptr);
-            UniformMemory = VK_NULL_HANDLE;
+            vkDestroyDescriptorSetLayout(activeDevice, CullSetLayout, nullptr);
+            CullSetLayout = VK_NULL_HANDLE;
         }
 
-        if (InstanceBuffer != VK_NULL_HANDLE)
-        {
-            vkDestroyBuffer(activeDevice, InstanceBuffer, nullptr);
-            InstanceBuffer = VK_NULL_HANDLE;
-        }
-
-        if (InstanceMemory != VK_NULL_HANDLE)
-        {
-            vkFreeMemory(activeDevice, InstanceMemory, nullptr);
-            InstanceMemory = VK_NULL_HANDLE;
-        }
-        InstanceCapacity = 0;
+        FrameRing.Destroy(activeDevice);
+        FrameInstances = RingAllocation{};
+        RetainedInstances = RingAllocation{};
+        IndirectCommands = RingAllocation{};
+        IndirectCounts = RingAllocation{};
+        VisibleInstances = RingAllocation{};
     }
 
     if (activeDevice != VK_NULL_HANDLE)
     {
-        CubeMesh.Destroy(activeDevice);
-        RenderItems.clear();
+        CubeMesh.Destroy();
+        for (const std::unique_ptr<MeshLODChain>& chain : ImportedMeshes)
+        {
+            chain->Destroy();
+        }
+        ImportedMeshes.clear();
+        RenderItems = nullptr;
+        ShadowCasterItems = nullptr;
     }
 
     if (Pipeline)
@@ -1375,6 +1999,8 @@ void VulkanRenderer::Destroy(VkDevice Device)
     DeviceHandle = VK_NULL_HANDLE;
     PhysicalDeviceHandle = VK_NULL_HANDLE;
     SwapchainImageViews.clear();
+    ImagesInFlight.clear();
+    LastImageIndex = UINT32_MAX;
     GraphicsQueueHandle = VK_NULL_HANDLE;
     GraphicsQueueFamily = 0;
 }
@@ -1409,6 +2035,7 @@ bool VulkanRenderer::Recreate(
 
     DestroyDepthResources(Device);
     DestroyColorResources(Device);
+    DestroyTransparencyResources(Device);
 
     if (!CreateDepthResources(PhysicalDeviceHandle, Device, Extent))
     {
@@ -1420,11 +2047,19 @@ bool VulkanRenderer::Recreate(
         std::fprintf(stderr, "VulkanRenderer::Recreate: CreateColorResources failed\n");
         return false;
     }
+    if (!CreateTransparencyResources(PhysicalDeviceHandle, Device, Extent))
+    {
+        std::fprintf(stderr, "VulkanRenderer::Recreate: CreateTransparencyResources failed\n");
+        return false;
+    }
     if (!CreateFramebuffers(Device, RenderPass, SwapchainFormat, SwapchainImageViews, Extent))
     {
         std::fprintf(stderr, "VulkanRenderer::Recreate: CreateFramebuffers failed\n");
         return false;
     }
+    /* Cached secondaries baked the old render pass and extent. */
+    InvalidateRecordCache();
+
     /* Recreate skybox pipeline for the new render pass. */
     if (!Skybox.Recreate(Device, RenderPass))
     {
@@ -1432,13 +2067,19 @@ bool VulkanRenderer::Recreate(
         return false;
     }
 
-    if (CommandPool != VK_NULL_HANDLE && !CommandBuffers.empty())
+    for (FrameResources& frame : Frames)
     {
-        vkFreeCommandBuffers(Device, CommandPool,
-            static_cast<uint32_t>(CommandBuffers.size()), CommandBuffers.data());
-        CommandBuffers.clear();
+        if (frame.CommandBuffer != VK_NULL_HANDLE && CommandPool != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(Device, CommandPool, 1, &frame.CommandBuffer);
+        }
+        frame.CommandBuffer = VK_NULL_HANDLE;
     }
 
+    /* The caller idles the device first, so no image has a frame pending. */
+    ImagesInFlight.assign(SwapchainImageViews.size(), VK_NULL_HANDLE);
+    LastImageIndex = UINT32_MAX;
+
     if (!CreateCommandPool(Device, GraphicsQueueFamily))
     {
         std::fprintf(stderr, "VulkanRenderer::Recreate: CreateCommandPool failed\n");
@@ -1475,6 +2116,26 @@ Material* VulkanRenderer::GetCubeMaterial()
     return &CubeMaterial;
 }
 
+MeshLODChain* VulkanRenderer::ImportMesh(const std::string& Path, const ObjLoadOptions& Options)
+{
+    if (DeviceHandle == VK_NULL_HANDLE)
+    {
+        std::fprintf(stderr, "VulkanRenderer::ImportMesh: Renderer is not initialized\n");
+        return nullptr;
+    }
+
+    std::unique_ptr<MeshLODChain> chain =
+        std::make_unique<MeshLODChain>(ObjLoader::LoadOBJLODChain(Path, Options));
+    if (chain->LevelCount == 0)
+    {
+        std::fprintf(stderr, "VulkanRenderer::ImportMesh: Failed to load %s\n", Path.c_str());
+        return nullptr;
+    }
+
+    ImportedMeshes.push_back(std::move(chain));
+    return ImportedMeshes.back().get();
+}
+
 bool VulkanRenderer::CreateFramebuffers(
     VkDevice Device,
     VkRenderPass RenderPassHandle,
@@ -1495,16 +2156,18 @@ bool VulkanRenderer::CreateFramebuffers(
 
     for (std::size_t i = 0; i < SwapchainImageViews.size(); ++i)
     {
-        VkImageView attachments[3] = {
+        VkImageView attachments[5] = {
             ColorImageViews[i],
             DepthImageView,
-            SwapchainImageViews[i]
+            SwapchainImageViews[i],
+            AccumImageView,
+            RevealageImageView
         };
 
         VkFramebufferCreateInfo framebufferInfo{};
         framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebufferInfo.renderPass = RenderPassHandle;
-        framebufferInfo.attachmentCount = 3;
+        framebufferInfo.attachmentCount = WeightedOITEnabled ? 5 : 3;
         framebufferInfo.pAttachments = attachments;
         framebufferInfo.width = Extent.width;
         framebufferInfo.height = Extent.height;
@@ -1547,121 +2210,360 @@ bool VulkanRenderer::CreateCommandPool(VkDevice Device, std::uint32_t GraphicsQu
 
 bool VulkanRenderer::CreateCommandBuffers(VkDevice Device)
 {
-    CommandBuffers.clear();
-
     if (Framebuffers.empty() || CommandPool == VK_NULL_HANDLE)
     {
         return true;
     }
 
-    CommandBuffers.resize(Framebuffers.size());
-
+    /* One primary per frame in flight, not per swapchain image. */
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.commandPool = CommandPool;
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = static_cast<uint32_t>(CommandBuffers.size());
+    allocInfo.commandBufferCount = 1;
 
-    if (vkAllocateCommandBuffers(Device, &allocInfo, CommandBuffers.data()) != VK_SUCCESS)
+    for (FrameResources& frame : Frames)
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateCommandBuffers: vkAllocateCommandBuffers failed\n");
-        CommandBuffers.clear();
-        return false;
+        if (vkAllocateCommandBuffers(Device, &allocInfo, &frame.CommandBuffer) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VulkanRenderer::CreateCommandBuffers: vkAllocateCommandBuffers failed\n");
+            frame.CommandBuffer = VK_NULL_HANDLE;
+            return false;
+        }
     }
 
     return true;
 }
 
-bool VulkanRenderer::CreateSyncObjects(VkDevice Device)
+bool VulkanRenderer::CreateRecordPools(VkDevice Device, std::uint32_t GraphicsQueueFamily)
+{
+    std::uint32_t workerCount = RecordWorkers;
+    if (workerCount == 0)
+    {
+        workerCount = std::min(std::thread::hardware_concurrency(), kMaxRecordWorkers);
+    }
+
+    /* The render thread records as worker 0. */
+    workerCount = std::max(workerCount, 1u);
+
+    /* Cached secondaries outlive a frame, so buffers are reset one by one. */
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = GraphicsQueueFamily;
+
+    for (FrameResources& frame : Frames)
+    {
+        frame.Workers.assign(workerCount, RecordWorker{});
+        for (RecordWorker& worker : frame.Workers)
+        {
+            if (vkCreateCommandPool(Device, &poolInfo, nullptr, &worker.Pool) != VK_SUCCESS)
+            {
+                std::fprintf(stderr, "VulkanRenderer::CreateRecordPools: vkCreateCommandPool failed\n");
+                worker.Pool = VK_NULL_HANDLE;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+VkCommandBuffer VulkanRenderer::AcquireSecondary(VkDevice Device, RecordWorker& Worker)
 {
-    if (ImageAvailable != VK_NULL_HANDLE)
+    if (!Worker.Free.empty())
+    {
+        VkCommandBuffer commandBuffer = Worker.Free.back();
+        Worker.Free.pop_back();
+        return commandBuffer;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = Worker.Pool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    if (vkAllocateCommandBuffers(Device, &allocInfo, &commandBuffer) != VK_SUCCESS)
     {
-        vkDestroySemaphore(Device, ImageAvailable, nullptr);
-        ImageAvailable = VK_NULL_HANDLE;
+        std::fprintf(stderr, "VulkanRenderer::AcquireSecondary: vkAllocateCommandBuffers failed\n");
+        return VK_NULL_HANDLE;
     }
-    if (RenderFinished != VK_NULL_HANDLE)
+
+    return commandBuffer;
+}
+
+void VulkanRenderer::InvalidateRecordCache()
+{
+    ++RecordCacheEpoch;
+}
+
+void VulkanRenderer::UpdatePipelineVariants()
+{
+    const bool depthPrepass =
+        DepthPrepassEnabled && Pipeline && Pipeline->IsVariantReady(PipelineVariant::DepthPrepass);
+    if (depthPrepass != DepthPrepassActive)
     {
-        vkDestroySemaphore(Device, RenderFinished, nullptr);
-        RenderFinished = VK_NULL_HANDLE;
+        /* Cached opaque secondaries bound the other world pipeline. */
+        DepthPrepassActive = depthPrepass;
+        InvalidateRecordCache();
+        SetSortKeyLayout(
+            RenderStage::Opaque,
+            depthPrepass ? RenderSortKeyLayout::StateOnly() : RenderSortKeyLayout::StateFirst());
     }
-    if (InFlightFence != VK_NULL_HANDLE)
+
+    /* Until OIT is ready transparent items keep the sorted, blended stage. */
+    const bool weightedOIT =
+        WeightedOITEnabled && Pipeline && Pipeline->IsVariantReady(PipelineVariant::WeightedOIT);
+    if (weightedOIT != WeightedOITActive)
     {
-        vkDestroyFence(Device, InFlightFence, nullptr);
-        InFlightFence = VK_NULL_HANDLE;
+        WeightedOITActive = weightedOIT;
+        SetSortKeyLayout(
+            RenderStage::Transparent,
+            weightedOIT ? RenderSortKeyLayout::StateOnly() : RenderSortKeyLayout::DepthFirst());
     }
+}
 
-    VkSemaphoreCreateInfo semaphoreInfo{};
-    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+VulkanRenderer::BatchState VulkanRenderer::CaptureBatchState(const OpaqueBatch& Batch)
+{
+    BatchState state{};
+    state.StartIndex = Batch.StartIndex;
+    state.Count = Batch.Count;
 
-    if (vkCreateSemaphore(Device, &semaphoreInfo, nullptr, &ImageAvailable) != VK_SUCCESS)
+    if (Batch.MeshPtr)
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateSyncObjects: vkCreateSemaphore (ImageAvailable) failed\n");
-        return false;
+        state.VertexBuffer = Batch.MeshPtr->VertexBuffer.GetBuffer();
+        state.Indexed = Batch.MeshPtr->HasIndex && Batch.MeshPtr->IndexCount > 0;
+        state.IndexBuffer = state.Indexed ? Batch.MeshPtr->IndexBuffer.GetBuffer() : VK_NULL_HANDLE;
+        state.ElementCount = state.Indexed ? Batch.MeshPtr->IndexCount : Batch.MeshPtr->VertexCount;
     }
-    if (vkCreateSemaphore(Device, &semaphoreInfo, nullptr, &RenderFinished) != VK_SUCCESS)
+
+    /* Material values are pushed as constants, so edits must miss the cache. */
+    if (Batch.MaterialPtr)
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateSyncObjects: vkCreateSemaphore (RenderFinished) failed\n");
-        return false;
+        state.BaseColorAmbient[0] = Batch.MaterialPtr->BaseColor.x;
+        state.BaseColorAmbient[1] = Batch.MaterialPtr->BaseColor.y;
+        state.BaseColorAmbient[2] = Batch.MaterialPtr->BaseColor.z;
+        state.BaseColorAmbient[3] = Batch.MaterialPtr->Ambient;
+        state.Alpha = Batch.MaterialPtr->Alpha;
+    }
+
+    return state;
+}
+
+bool VulkanRenderer::MatchesBatchState(const std::vector<BatchState>& States, const OpaqueBatch* Batches)
+{
+    for (std::size_t index = 0; index < States.size(); ++index)
+    {
+        const BatchState& cached = States[index];
+        const BatchState current = CaptureBatchState(Batches[index]);
+        if (cached.VertexBuffer != current.VertexBuffer ||
+            cached.IndexBuffer != current.IndexBuffer ||
+            cached.ElementCount != current.ElementCount ||
+            cached.Indexed != current.Indexed ||
+            cached.StartIndex != current.StartIndex ||
+            cached.Count != current.Count ||
+            cached.Alpha != current.Alpha ||
+            std::memcmp(cached.BaseColorAmbient, current.BaseColorAmbient, sizeof(cached.BaseColorAmbient)) != 0)
+        {
+            return false;
+        }
     }
 
+    return true;
+}
+
+bool VulkanRenderer::CreateSyncObjects(VkDevice Device)
+{
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    /* Fences start signaled so the first wait on each slot returns. */
     VkFenceCreateInfo fenceInfo{};
     fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-    if (vkCreateFence(Device, &fenceInfo, nullptr, &InFlightFence) != VK_SUCCESS)
+    for (FrameResources& frame : Frames)
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateSyncObjects: vkCreateFence failed\n");
-        return false;
+        if (vkCreateSemaphore(Device, &semaphoreInfo, nullptr, &frame.ImageAvailable) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VulkanRenderer::CreateSyncObjects: vkCreateSemaphore (ImageAvailable) failed\n");
+            return false;
+        }
+        if (vkCreateSemaphore(Device, &semaphoreInfo, nullptr, &frame.RenderFinished) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VulkanRenderer::CreateSyncObjects: vkCreateSemaphore (RenderFinished) failed\n");
+            return false;
+        }
+        if (vkCreateFence(Device, &fenceInfo, nullptr, &frame.InFlightFence) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VulkanRenderer::CreateSyncObjects: vkCreateFence failed\n");
+            return false;
+        }
     }
 
     return true;
 }
 
-bool VulkanRenderer::CreateUniformBuffer(VkPhysicalDevice PhysicalDevice, VkDevice Device)
+bool VulkanRenderer::RetireFrameSlot(VkDevice Device, VkQueue GraphicsQueue, FrameResources& Frame, bool WaitImage)
 {
-    if (UniformBuffer != VK_NULL_HANDLE)
+    /* An empty batch still consumes the acquire semaphore and signals the fence. */
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = WaitImage ? 1 : 0;
+    submitInfo.pWaitSemaphores = WaitImage ? &Frame.ImageAvailable : nullptr;
+    submitInfo.pWaitDstStageMask = WaitImage ? &waitStage : nullptr;
+
+    if (vkQueueSubmit(GraphicsQueue, 1, &submitInfo, Frame.InFlightFence) == VK_SUCCESS)
+    {
+        return true;
+    }
+
+    /* The queue refuses work, so drain it and swap in a signaled fence */
+    /* so the next wait on this slot cannot hang. */
+    std::fprintf(stderr, "VulkanRenderer::RetireFrameSlot: vkQueueSubmit failed\n");
+    vkQueueWaitIdle(GraphicsQueue);
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    VkFence fence = VK_NULL_HANDLE;
+    if (vkCreateFence(Device, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanRenderer::RetireFrameSlot: vkCreateFence failed\n");
+        return false;
+    }
+
+    for (VkFence& imageFence : ImagesInFlight)
     {
-        vkDestroyBuffer(Device, UniformBuffer, nullptr);
-        UniformBuffer = VK_NULL_HANDLE;
+        if (imageFence == Frame.InFlightFence)
+        {
+            imageFence = VK_NULL_HANDLE;
+        }
     }
-    if (UniformMemory != VK_NULL_HANDLE)
+    vkDestroyFence(Device, Frame.InFlightFence, nullptr);
+    Frame.InFlightFence = fence;
+    return false;
+}
+
+void VulkanRenderer::DestroyFrameResources(VkDevice Device)
+{
+    for (FrameResources& frame : Frames)
     {
-        vkFreeMemory(Device, UniformMemory, nullptr);
-        UniformMemory = VK_NULL_HANDLE;
+        if (frame.CommandBuffer != VK_NULL_HANDLE && CommandPool != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(Device, CommandPool, 1, &frame.CommandBuffer);
+        }
+
+        if (frame.ImageAvailable != VK_NULL_HANDLE)
+        {
+            vkDestroySemaphore(Device, frame.ImageAvailable, nullptr);
+        }
+
+        if (frame.RenderFinished != VK_NULL_HANDLE)
+        {
+            vkDestroySemaphore(Device, frame.RenderFinished, nullptr);
+        }
+
+        if (frame.InFlightFence != VK_NULL_HANDLE)
+        {
+            vkDestroyFence(Device, frame.InFlightFence, nullptr);
+        }
+
+        g_VulkanAllocator.DestroyBuffer(frame.RetainedBuffer, frame.RetainedAllocation);
+
+        /* Secondaries are freed with their pools. */
+        for (RecordWorker& worker : frame.Workers)
+        {
+            if (worker.Pool != VK_NULL_HANDLE)
+            {
+                vkDestroyCommandPool(Device, worker.Pool, nullptr);
+            }
+        }
     }
 
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = sizeof(UniformBufferObject);
-    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    /* Descriptor sets go with the pool. */
+    Frames.clear();
+    CurrentFrame = 0;
+}
+
+bool VulkanRenderer::CreateFrameRing(VkPhysicalDevice PhysicalDevice, VkDevice Device)
+{
+    /* Culling inputs and indirect draws are bound straight from the ring. */
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(PhysicalDevice, &properties);
+    StorageAlignment = std::max<VkDeviceSize>(properties.limits.minStorageBufferOffsetAlignment, kInstanceAlignment);
 
-    if (vkCreateBuffer(Device, &bufferInfo, nullptr, &UniformBuffer) != VK_SUCCESS)
+    if (!FrameRing.Create(
+        Device,
+        kFrameRingCapacity,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        static_cast<std::uint32_t>(Frames.size())))
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateUniformBuffer: vkCreateBuffer failed\n");
+        std::fprintf(stderr, "VulkanRenderer::CreateFrameRing: ring creation failed\n");
         return false;
     }
 
-    VkMemoryRequirements memRequirements{};
-    vkGetBufferMemoryRequirements(Device, UniformBuffer, &memRequirements);
+    /* The frame sets point at the retained buffers from the start. */
+    for (FrameResources& frame : Frames)
+    {
+        if (!ReserveRetainedStorage(frame, 0))
+        {
+            std::fprintf(stderr, "VulkanRenderer::CreateFrameRing: retained storage failed\n");
+            return false;
+        }
+    }
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(
-        PhysicalDevice,
-        memRequirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    return true;
+}
 
-    if (vkAllocateMemory(Device, &allocInfo, nullptr, &UniformMemory) != VK_SUCCESS)
+bool VulkanRenderer::ReserveRetainedStorage(FrameResources& Frame, std::size_t InstanceCount)
+{
+    const VkDeviceSize required = kRetainedInstanceOffset + sizeof(Mat4) * InstanceCount;
+    if (Frame.RetainedBuffer == VK_NULL_HANDLE || Frame.RetainedCapacity < required)
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateUniformBuffer: vkAllocateMemory failed\n");
-        vkDestroyBuffer(Device, UniformBuffer, nullptr);
-        UniformBuffer = VK_NULL_HANDLE;
-        return false;
+        VkDeviceSize capacity = Frame.RetainedCapacity > 0 ? Frame.RetainedCapacity * 2 : kRetainedCapacity;
+        while (capacity < required)
+        {
+            capacity *= 2;
+        }
+
+        /* The slot is idle, so the old block goes at once; commands cached */
+        /* against it must not replay. */
+        g_VulkanAllocator.DestroyBuffer(Frame.RetainedBuffer, Frame.RetainedAllocation);
+        Frame.RetainedCapacity = 0;
+        InvalidateRecordCache();
+
+        /* Same placement as the frame ring: device-local when the CPU can */
+        /* write it directly, system memory otherwise. */
+        /* Opaque instances are also the culling pass's storage input. */
+        const VkBufferUsageFlags usage =
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        const VkMemoryPropertyFlags hostFlags =
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        const VkMemoryPropertyFlags localFlags = hostFlags | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+        const bool deviceLocal =
+            g_VulkanAllocator.FindMemoryType(UINT32_MAX, localFlags) != UINT32_MAX &&
+            g_VulkanAllocator.CreateBuffer(capacity, usage, localFlags, Frame.RetainedBuffer, Frame.RetainedAllocation);
+        if (!deviceLocal &&
+            !g_VulkanAllocator.CreateBuffer(capacity, usage, hostFlags, Frame.RetainedBuffer, Frame.RetainedAllocation))
+        {
+            std::fprintf(stderr, "VulkanRenderer::ReserveRetainedStorage: CreateBuffer failed\n");
+            return false;
+        }
+
+        Frame.RetainedCapacity = capacity;
     }
 
-    vkBindBufferMemory(Device, UniformBuffer, UniformMemory, 0);
+    RetainedInstances.Buffer = Frame.RetainedBuffer;
+    RetainedInstances.Offset = kRetainedInstanceOffset;
+    RetainedInstances.Mapped = static_cast<std::uint8_t*>(Frame.RetainedAllocation.Mapped) + kRetainedInstanceOffset;
     return true;
 }
 
@@ -1673,21 +2575,34 @@ bool VulkanRenderer::CreateDescriptorPool(VkDevice Device)
         DescriptorPool = VK_NULL_HANDLE;
     }
 
+    /* One scene and one culling set per frame in flight plus the composite set. */
+    const std::uint32_t frameCount = static_cast<std::uint32_t>(Frames.size());
+
     VkDescriptorPoolSize poolSize{};
-    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSize.descriptorCount = 1;
+    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSize.descriptorCount = frameCount;
 
     VkDescriptorPoolSize samplerPoolSize{};
     samplerPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    samplerPoolSize.descriptorCount = 1;
+    samplerPoolSize.descriptorCount = frameCount;
+
+    /* OIT accumulation and revealage for the composite set. */
+    VkDescriptorPoolSize inputPoolSize{};
+    inputPoolSize.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    inputPoolSize.descriptorCount = 2;
 
-    VkDescriptorPoolSize poolSizes[] = { poolSize, samplerPoolSize };
+    /* Six culling buffers per frame set. */
+    VkDescriptorPoolSize storagePoolSize{};
+    storagePoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    storagePoolSize.descriptorCount = 6 * frameCount;
+
+    VkDescriptorPoolSize poolSizes[] = { poolSize, samplerPoolSize, inputPoolSize, storagePoolSize };
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = 2;
+    poolInfo.poolSizeCount = 4;
     poolInfo.pPoolSizes = poolSizes;
-    poolInfo.maxSets = 1;
+    poolInfo.maxSets = 2 * frameCount + 1;
 
     if (vkCreateDescriptorPool(Device, &poolInfo, nullptr, &DescriptorPool) != VK_SUCCESS)
     {
@@ -1698,51 +2613,6 @@ bool VulkanRenderer::CreateDescriptorPool(VkDevice Device)
     return true;
 }
 
-bool VulkanRenderer::EnsureInstanceBuffer(
-    VkDevice Device,
-    VkPhysicalDevice PhysicalDevice,
-    std::size_t InstanceCount)
-{
-    if (InstanceCount == 0)
-    {
-        return true;
-    }
-
-    if (InstanceCount <= InstanceCapacity && InstanceBuffer != VK_NULL_HANDLE)
-    {
-        return true;
-    }
-
-    if (InstanceBuffer != VK_NULL_HANDLE)
-    {
-        vkDestroyBuffer(Device, InstanceBuffer, nullptr);
-        InstanceBuffer = VK_NULL_HANDLE;
-    }
-
-    if (InstanceMemory != VK_NULL_HANDLE)
-    {
-        vkFreeMemory(Device, InstanceMemory, nullptr);
-        InstanceMemory = VK_NULL_HANDLE;
-    }
-
-    VkDeviceSize size = sizeof(Mat4) * InstanceCount;
-    if (!CreateBuffer(
-        PhysicalDevice,
-        Device,
-        size,
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        InstanceBuffer,
-        InstanceMemory))
-    {
-        InstanceCapacity = 0;
-        return false;
-    }
-
-    InstanceCapacity = InstanceCount;
-    return true;
-}
-
 bool VulkanRenderer::CreateDescriptorSetLayout(VkDevice Device)
 {
     if (DescriptorSetLayout != VK_NULL_HANDLE)
@@ -1753,7 +2623,7 @@ bool VulkanRenderer::CreateDescriptorSetLayout(VkDevice Device)
 
     VkDescriptorSetLayoutBinding uboLayoutBinding{};
     uboLayoutBinding.binding = 0;
-    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     uboLayoutBinding.descriptorCount = 1;
     uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
     uboLayoutBinding.pImmutableSamplers = nullptr;
@@ -1778,6 +2648,61 @@ bool VulkanRenderer::CreateDescriptorSetLayout(VkDevice Device)
         return false;
     }
 
+    if (CompositeSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(Device, CompositeSetLayout, nullptr);
+        CompositeSetLayout = VK_NULL_HANDLE;
+    }
+
+    VkDescriptorSetLayoutBinding compositeBindings[2]{};
+    for (std::uint32_t binding = 0; binding < 2; ++binding)
+    {
+        compositeBindings[binding].binding = binding;
+        compositeBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        compositeBindings[binding].descriptorCount = 1;
+        compositeBindings[binding].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        compositeBindings[binding].pImmutableSamplers = nullptr;
+    }
+
+    VkDescriptorSetLayoutCreateInfo compositeLayoutInfo{};
+    compositeLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    compositeLayoutInfo.bindingCount = 2;
+    compositeLayoutInfo.pBindings = compositeBindings;
+
+    if (vkCreateDescriptorSetLayout(Device, &compositeLayoutInfo, nullptr, &CompositeSetLayout) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanRenderer::CreateDescriptorSetLayout: composite layout creation failed\n");
+        return false;
+    }
+
+    if (CullSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(Device, CullSetLayout, nullptr);
+        CullSetLayout = VK_NULL_HANDLE;
+    }
+
+    /* Instances, instance draws, draws, commands, counts, visible instances. */
+    VkDescriptorSetLayoutBinding cullBindings[6]{};
+    for (std::uint32_t binding = 0; binding < 6; ++binding)
+    {
+        cullBindings[binding].binding = binding;
+        cullBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        cullBindings[binding].descriptorCount = 1;
+        cullBindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        cullBindings[binding].pImmutableSamplers = nullptr;
+    }
+
+    VkDescriptorSetLayoutCreateInfo cullLayoutInfo{};
+    cullLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    cullLayoutInfo.bindingCount = 6;
+    cullLayoutInfo.pBindings = cullBindings;
+
+    if (vkCreateDescriptorSetLayout(Device, &cullLayoutInfo, nullptr, &CullSetLayout) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanRenderer::CreateDescriptorSetLayout: cull layout creation failed\n");
+        return false;
+    }
+
     return true;
 }
 
@@ -1795,147 +2720,130 @@ bool VulkanRenderer::CreateDescriptorSet(VkDevice Device)
     allocInfo.descriptorSetCount = 1;
     allocInfo.pSetLayouts = &DescriptorSetLayout;
 
-    if (vkAllocateDescriptorSets(Device, &allocInfo, &DescriptorSet) != VK_SUCCESS)
+    /* Uniforms sit at the front of the slot's retained buffer. */
+    for (FrameResources& frame : Frames)
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateDescriptorSet: vkAllocateDescriptorSets failed\n");
-        return false;
-    }
-
-    VkDescriptorBufferInfo bufferInfo{};
-    bufferInfo.buffer = UniformBuffer;
-    bufferInfo.offset = 0;
-    bufferInfo.range = sizeof(UniformBufferObject);
-
-    VkWriteDescriptorSet descriptorWrite{};
-    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrite.dstSet = DescriptorSet;
-    descriptorWrite.dstBinding = 0;
-    descriptorWrite.dstArrayElement = 0;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    descriptorWrite.descriptorCount = 1;
-    descriptorWrite.pBufferInfo = &bufferInfo;
-
-    VkDescriptorImageInfo diffuseInfo{};
-    diffuseInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    diffuseInfo.imageView = DiffuseImageView;
-    diffuseInfo.sampler = DiffuseSampler;
-
-    VkWriteDescriptorSet diffuseWrite{};
-    diffuseWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    diffuseWrite.dstSet = DescriptorSet;
-    diffuseWrite.dstBinding = 1;
-    diffuseWrite.dstArrayElement = 0;
-    diffuseWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    diffuseWrite.descriptorCount = 1;
-    diffuseWrite.pImageInfo = &diffuseInfo;
-
-    VkWriteDescriptorSet writes[] = { descriptorWrite, diffuseWrite };
-
-    vkUpdateDescriptorSets(Device, 2, writes, 0, nullptr);
-    return true;
-}
-
-bool VulkanRenderer::CreateTextureResources(
-    VkPhysicalDevice PhysicalDevice,
-    VkDevice Device,
-    VkQueue GraphicsQueue,
-    std::uint32_t GraphicsQueueFamily)
-{
-    DestroyTextureResources(Device);
+        if (vkAllocateDescriptorSets(Device, &allocInfo, &frame.DescriptorSet) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VulkanRenderer::CreateDescriptorSet: vkAllocateDescriptorSets failed\n");
+            return false;
+        }
 
-    TextureData texture;
+        frame.UniformSetBuffer = frame.RetainedBuffer;
+
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = frame.UniformSetBuffer;
+        bufferInfo.offset = 0;
+        bufferInfo.range = sizeof(UniformBufferObject);
+
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = frame.DescriptorSet;
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+
+        VkDescriptorImageInfo diffuseInfo{};
+        diffuseInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        diffuseInfo.imageView = DiffuseImageView;
+        diffuseInfo.sampler = DiffuseSampler;
+
+        VkWriteDescriptorSet diffuseWrite{};
+        diffuseWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        diffuseWrite.dstSet = frame.DescriptorSet;
+        diffuseWrite.dstBinding = 1;
+        diffuseWrite.dstArrayElement = 0;
+        diffuseWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        diffuseWrite.descriptorCount = 1;
+        diffuseWrite.pImageInfo = &diffuseInfo;
+
+        VkWriteDescriptorSet writes[] = { descriptorWrite, diffuseWrite };
+
+        vkUpdateDescriptorSets(Device, 2, writes, 0, nullptr);
+
+        /* Culling buffers move with the ring, they are written per frame. */
+        VkDescriptorSetAllocateInfo cullAllocInfo = allocInfo;
+        cullAllocInfo.pSetLayouts = &CullSetLayout;
+
+        if (vkAllocateDescriptorSets(Device, &cullAllocInfo, &frame.CullSet) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VulkanRenderer::CreateDescriptorSet: cull set allocation failed\n");
+            return false;
+        }
+    }
 
-    if (!LoadPngWic("../Assets/Textures/Base.png", texture))
+    if (!WeightedOITEnabled)
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateTextureResources: Failed to load Base.png\n");
-        return false;
+        return true;
     }
 
-    VkDeviceSize imageSize = static_cast<VkDeviceSize>(texture.Pixels.size());
+    /* Composite inputs are written once the OIT targets exist. */
+    VkDescriptorSetAllocateInfo compositeAllocInfo = allocInfo;
+    compositeAllocInfo.pSetLayouts = &CompositeSetLayout;
 
-    if (imageSize == 0)
+    if (vkAllocateDescriptorSets(Device, &compositeAllocInfo, &CompositeSet) != VK_SUCCESS)
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateTextureResources: Empty texture\n");
+        std::fprintf(stderr, "VulkanRenderer::CreateDescriptorSet: composite set allocation failed\n");
         return false;
     }
 
-    VkBuffer stagingBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+    return true;
+}
+
+bool VulkanRenderer::CreateTextureResources(
+    VkPhysicalDevice PhysicalDevice,
+    VkDevice Device)
+{
+    DestroyTextureResources(Device);
+
+    std::uint32_t textureWidth = 0;
+    std::uint32_t textureHeight = 0;
+    std::vector<std::uint8_t> texturePixels;
 
-    if (!CreateBuffer(
-        PhysicalDevice,
-        Device,
-        imageSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer,
-        stagingMemory))
+    if (!ReadPng("../Assets/Textures/Base.png", textureWidth, textureHeight, texturePixels))
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateTextureResources: Staging buffer failed\n");
+        std::fprintf(stderr, "VulkanRenderer::CreateTextureResources: Failed to load Base.png\n");
         return false;
     }
 
-    void* mappedData = nullptr;
+    VkDeviceSize imageSize = static_cast<VkDeviceSize>(texturePixels.size());
 
-    if (vkMapMemory(Device, stagingMemory, 0, imageSize, 0, &mappedData) != VK_SUCCESS)
+    if (imageSize == 0)
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateTextureResources: vkMapMemory failed\n");
-        vkDestroyBuffer(Device, stagingBuffer, nullptr);
-        vkFreeMemory(Device, stagingMemory, nullptr);
+        std::fprintf(stderr, "VulkanRenderer::CreateTextureResources: Empty texture\n");
         return false;
     }
 
-    std::memcpy(mappedData, texture.Pixels.data(), static_cast<size_t>(imageSize));
-    vkUnmapMemory(Device, stagingMemory);
-
     VkFormat textureFormat = VK_FORMAT_R8G8B8A8_SRGB;
     if (!CreateImage(
-        PhysicalDevice,
-        Device,
-        texture.Width,
-        texture.Height,
+        textureWidth,
+        textureHeight,
         textureFormat,
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         DiffuseImage,
-        DiffuseImageMemory))
+        DiffuseImageAllocation))
     {
         std::fprintf(stderr, "VulkanRenderer::CreateTextureResources: CreateImage failed\n");
-        vkDestroyBuffer(Device, stagingBuffer, nullptr);
-        vkFreeMemory(Device, stagingMemory, nullptr);
         return false;
     }
 
-    TransitionImageLayout(
-        Device,
-        GraphicsQueue,
-        GraphicsQueueFamily,
-        DiffuseImage,
-        textureFormat,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-    CopyBufferToImage(
-        Device,
-        GraphicsQueue,
-        GraphicsQueueFamily,
-        stagingBuffer,
-        DiffuseImage,
-        texture.Width,
-        texture.Height);
-
-    TransitionImageLayout(
-        Device,
-        GraphicsQueue,
-        GraphicsQueueFamily,
+    /* Copy and layout transitions ride the next upload batch. */
+    DiffuseUpload = g_VulkanUploader.UploadImage(
         DiffuseImage,
-        textureFormat,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-    vkDestroyBuffer(Device, stagingBuffer, nullptr);
-    vkFreeMemory(Device, stagingMemory, nullptr);
+        texturePixels.data(),
+        imageSize,
+        textureWidth,
+        textureHeight,
+        1);
+    if (DiffuseUpload == 0)
+    {
+        std::fprintf(stderr, "VulkanRenderer::CreateTextureResources: UploadImage failed\n");
+        return false;
+    }
 
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -1990,17 +2898,9 @@ void VulkanRenderer::DestroyTextureResources(VkDevice Device)
         DiffuseImageView = VK_NULL_HANDLE;
     }
 
-    if (DiffuseImage != VK_NULL_HANDLE)
-    {
-        vkDestroyImage(Device, DiffuseImage, nullptr);
-        DiffuseImage = VK_NULL_HANDLE;
-    }
-
-    if (DiffuseImageMemory != VK_NULL_HANDLE)
-    {
-        vkFreeMemory(Device, DiffuseImageMemory, nullptr);
-        DiffuseImageMemory = VK_NULL_HANDLE;
-    }
+    g_VulkanUploader.Wait(DiffuseUpload);
+    DiffuseUpload = 0;
+    g_VulkanAllocator.DestroyImage(DiffuseImage, DiffuseImageAllocation);
 }
 
 
@@ -2019,7 +2919,7 @@ bool VulkanRenderer::CreateColorResources(
     }
 
     ColorImages.assign(ImageCount, VK_NULL_HANDLE);
-    ColorImageMemories.assign(ImageCount, VK_NULL_HANDLE);
+    ColorImageAllocations.assign(ImageCount, VulkanAllocation{});
     ColorImageViews.assign(ImageCount, VK_NULL_HANDLE);
 
     for (std::size_t i = 0; i < ImageCount; ++i)
@@ -2039,33 +2939,13 @@ bool VulkanRenderer::CreateColorResources(
         imageInfo.samples = kMsaaSamples;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        if (vkCreateImage(Device, &imageInfo, nullptr, &ColorImages[i]) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "VulkanRenderer::CreateColorResources: vkCreateImage failed\n");
-            DestroyColorResources(Device);
-            return false;
-        }
-
-        VkMemoryRequirements memRequirements{};
-        vkGetImageMemoryRequirements(Device, ColorImages[i], &memRequirements);
-
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = FindMemoryType(
-            PhysicalDevice,
-            memRequirements.memoryTypeBits,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-        if (vkAllocateMemory(Device, &allocInfo, nullptr, &ColorImageMemories[i]) != VK_SUCCESS)
+        if (!g_VulkanAllocator.CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ColorImages[i], ColorImageAllocations[i]))
         {
-            std::fprintf(stderr, "VulkanRenderer::CreateColorResources: vkAllocateMemory failed\n");
+            std::fprintf(stderr, "VulkanRenderer::CreateColorResources: CreateImage failed\n");
             DestroyColorResources(Device);
             return false;
         }
 
-        vkBindImageMemory(Device, ColorImages[i], ColorImageMemories[i], 0);
-
         VkImageViewCreateInfo viewInfo{};
         viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         viewInfo.image = ColorImages[i];
@@ -2100,25 +2980,13 @@ void VulkanRenderer::DestroyColorResources(VkDevice Device)
 
     ColorImageViews.clear();
 
-    for (VkImage image : ColorImages)
+    for (std::size_t i = 0; i < ColorImages.size(); ++i)
     {
-        if (image != VK_NULL_HANDLE)
-        {
-            vkDestroyImage(Device, image, nullptr);
-        }
+        g_VulkanAllocator.DestroyImage(ColorImages[i], ColorImageAllocations[i]);
     }
 
     ColorImages.clear();
-
-    for (VkDeviceMemory memory : ColorImageMemories)
-    {
-        if (memory != VK_NULL_HANDLE)
-        {
-            vkFreeMemory(Device, memory, nullptr);
-        }
-    }
-
-    ColorImageMemories.clear();
+    ColorImageAllocations.clear();
 }
 bool VulkanRenderer::CreateDepthResources(
     VkPhysicalDevice PhysicalDevice,
@@ -2143,33 +3011,12 @@ bool VulkanRenderer::CreateDepthResources(
     imageInfo.samples = kMsaaSamples;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    if (vkCreateImage(Device, &imageInfo, nullptr, &DepthImage) != VK_SUCCESS)
-    {
-        std::fprintf(stderr, "VulkanRenderer::CreateDepthResources: vkCreateImage failed\n");
-        return false;
-    }
-
-    VkMemoryRequirements memRequirements{};
-    vkGetImageMemoryRequirements(Device, DepthImage, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(
-        PhysicalDevice,
-        memRequirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(Device, &allocInfo, nullptr, &DepthImageMemory) != VK_SUCCESS)
+    if (!g_VulkanAllocator.CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, DepthImage, DepthImageAllocation))
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateDepthResources: vkAllocateMemory failed\n");
-        vkDestroyImage(Device, DepthImage, nullptr);
-        DepthImage = VK_NULL_HANDLE;
+        std::fprintf(stderr, "VulkanRenderer::CreateDepthResources: CreateImage failed\n");
         return false;
     }
 
-    vkBindImageMemory(Device, DepthImage, DepthImageMemory, 0);
-
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image = DepthImage;
@@ -2184,10 +3031,7 @@ bool VulkanRenderer::CreateDepthResources(
     if (vkCreateImageView(Device, &viewInfo, nullptr, &DepthImageView) != VK_SUCCESS)
     {
         std::fprintf(stderr, "VulkanRenderer::CreateDepthResources: vkCreateImageView failed\n");
-        vkDestroyImage(Device, DepthImage, nullptr);
-        vkFreeMemory(Device, DepthImageMemory, nullptr);
-        DepthImage = VK_NULL_HANDLE;
-        DepthImageMemory = VK_NULL_HANDLE;
+        g_VulkanAllocator.DestroyImage(DepthImage, DepthImageAllocation);
         return false;
     }
 
@@ -2202,16 +3046,118 @@ void VulkanRenderer::DestroyDepthResources(VkDevice Device)
         DepthImageView = VK_NULL_HANDLE;
     }
 
-    if (DepthImage != VK_NULL_HANDLE)
+    g_VulkanAllocator.DestroyImage(DepthImage, DepthImageAllocation);
+}
+
+bool VulkanRenderer::CreateTransparencyResources(
+    VkPhysicalDevice PhysicalDevice,
+    VkDevice Device,
+    VkExtent2D Extent)
+{
+    DestroyTransparencyResources(Device);
+
+    /* The render pass has no OIT attachments to back. */
+    if (!WeightedOITEnabled)
+    {
+        return true;
+    }
+
+    /* Both targets live only inside the render pass, so they can stay transient. */
+    auto createTarget = [&](VkFormat Format, VkImage& OutImage, VulkanAllocation& OutAllocation, VkImageView& OutView)
+    {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = Extent.width;
+        imageInfo.extent.height = Extent.height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = Format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+            VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+            VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        imageInfo.samples = kMsaaSamples;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (!g_VulkanAllocator.CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, OutImage, OutAllocation))
+        {
+            OutImage = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = OutImage;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = Format;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(Device, &viewInfo, nullptr, &OutView) != VK_SUCCESS)
+        {
+            OutView = VK_NULL_HANDLE;
+            return false;
+        }
+
+        return true;
+    };
+
+    if (!createTarget(VulkanRenderPass::kAccumFormat, AccumImage, AccumImageAllocation, AccumImageView) ||
+        !createTarget(VulkanRenderPass::kRevealageFormat, RevealageImage, RevealageImageAllocation, RevealageImageView))
+    {
+        std::fprintf(stderr, "VulkanRenderer::CreateTransparencyResources: target creation failed\n");
+        DestroyTransparencyResources(Device);
+        return false;
+    }
+
+    if (CompositeSet == VK_NULL_HANDLE)
+    {
+        return true;
+    }
+
+    VkDescriptorImageInfo inputInfos[2]{};
+    inputInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    inputInfos[0].imageView = AccumImageView;
+    inputInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    inputInfos[1].imageView = RevealageImageView;
+
+    VkWriteDescriptorSet inputWrites[2]{};
+    for (std::uint32_t binding = 0; binding < 2; ++binding)
     {
-        vkDestroyImage(Device, DepthImage, nullptr);
-        DepthImage = VK_NULL_HANDLE;
+        inputWrites[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        inputWrites[binding].dstSet = CompositeSet;
+        inputWrites[binding].dstBinding = binding;
+        inputWrites[binding].dstArrayElement = 0;
+        inputWrites[binding].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        inputWrites[binding].descriptorCount = 1;
+        inputWrites[binding].pImageInfo = &inputInfos[binding];
     }
 
-    if (DepthImageMemory != VK_NULL_HANDLE)
+    vkUpdateDescriptorSets(Device, 2, inputWrites, 0, nullptr);
+    return true;
+}
+
+void VulkanRenderer::DestroyTransparencyResources(VkDevice Device)
+{
+    VkImageView* views[] = { &AccumImageView, &RevealageImageView };
+    VkImage* images[] = { &AccumImage, &RevealageImage };
+    VulkanAllocation* allocations[] = { &AccumImageAllocation, &RevealageImageAllocation };
+
+    for (std::size_t i = 0; i < 2; ++i)
     {
-        vkFreeMemory(Device, DepthImageMemory, nullptr);
-        DepthImageMemory = VK_NULL_HANDLE;
+        if (*views[i] != VK_NULL_HANDLE)
+        {
+            vkDestroyImageView(Device, *views[i], nullptr);
+            *views[i] = VK_NULL_HANDLE;
+        }
+
+        g_VulkanAllocator.DestroyImage(*images[i], *allocations[i]);
     }
 }
 
@@ -2234,33 +3180,12 @@ bool VulkanRenderer::CreateShadowResources(VkPhysicalDevice PhysicalDevice, VkDe
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    if (vkCreateImage(Device, &imageInfo, nullptr, &ShadowImage) != VK_SUCCESS)
+    if (!g_VulkanAllocator.CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ShadowImage, ShadowImageAllocation))
     {
-        std::fprintf(stderr, "VulkanRenderer::CreateShadowResources: vkCreateImage failed\n");
+        std::fprintf(stderr, "VulkanRenderer::CreateShadowResources: CreateImage failed\n");
         return false;
     }
 
-    VkMemoryRequirements memRequirements{};
-    vkGetImageMemoryRequirements(Device, ShadowImage, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(
-        PhysicalDevice,
-        memRequirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(Device, &allocInfo, nullptr, &ShadowImageMemory) != VK_SUCCESS)
-    {
-        std::fprintf(stderr, "VulkanRenderer::CreateShadowResources: vkAllocateMemory failed\n");
-        vkDestroyImage(Device, ShadowImage, nullptr);
-        ShadowImage = VK_NULL_HANDLE;
-        return false;
-    }
-
-    vkBindImageMemory(Device, ShadowImage, ShadowImageMemory, 0);
-
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image = ShadowImage;
@@ -2275,10 +3200,7 @@ bool VulkanRenderer::CreateShadowResources(VkPhysicalDevice PhysicalDevice, VkDe
     if (vkCreateImageView(Device, &viewInfo, nullptr, &ShadowImageView) != VK_SUCCESS)
     {
         std::fprintf(stderr, "VulkanRenderer::CreateShadowResources: vkCreateImageView failed\n");
-        vkDestroyImage(Device, ShadowImage, nullptr);
-        vkFreeMemory(Device, ShadowImageMemory, nullptr);
-        ShadowImage = VK_NULL_HANDLE;
-        ShadowImageMemory = VK_NULL_HANDLE;
+        g_VulkanAllocator.DestroyImage(ShadowImage, ShadowImageAllocation);
         return false;
     }
 
@@ -2298,11 +3220,8 @@ bool VulkanRenderer::CreateShadowResources(VkPhysicalDevice PhysicalDevice, VkDe
     {
         std::fprintf(stderr, "VulkanRenderer::CreateShadowResources: vkCreateSampler failed\n");
         vkDestroyImageView(Device, ShadowImageView, nullptr);
-        vkDestroyImage(Device, ShadowImage, nullptr);
-        vkFreeMemory(Device, ShadowImageMemory, nullptr);
         ShadowImageView = VK_NULL_HANDLE;
-        ShadowImage = VK_NULL_HANDLE;
-        ShadowImageMemory = VK_NULL_HANDLE;
+        g_VulkanAllocator.DestroyImage(ShadowImage, ShadowImageAllocation);
         return false;
     }
 
@@ -2383,38 +3302,19 @@ void VulkanRenderer::DestroyShadowResources(VkDevice Device)
         ShadowImageView = VK_NULL_HANDLE;
     }
 
-    if (ShadowImage != VK_NULL_HANDLE)
-    {
-        vkDestroyImage(Device, ShadowImage, nullptr);
-        ShadowImage = VK_NULL_HANDLE;
-    }
-
-    if (ShadowImageMemory != VK_NULL_HANDLE)
-    {
-        vkFreeMemory(Device, ShadowImageMemory, nullptr);
-        ShadowImageMemory = VK_NULL_HANDLE;
-    }
+    g_VulkanAllocator.DestroyImage(ShadowImage, ShadowImageAllocation);
 
     ShadowLayoutInitialized = false;
 }
 
-void VulkanRenderer::UpdateUniformBuffer(VkDevice Device)
+Mat4 VulkanRenderer::GetCameraViewProj() const
 {
-    if (UniformMemory == VK_NULL_HANDLE || !Camera)
+    if (!Camera)
     {
-        return;
+        return Mat4::Identity();
     }
 
     const float kPi = 3.1415926535f;
-    Vec3 lightDir(0.0f, 0.0f, -1.0f);
-    Vec3 target(0.0f, 0.0f, -5.0f);
-    Vec3 lightPos = target - lightDir * 10.0f;
-
-    Mat4 lightView = Mat4::LookAt(lightPos, target, Vec3(0.0f, 1.0f, 0.0f));
-    Mat4 lightProj = Mat4::Orthographic(-10.0f, 10.0f, -10.0f, 10.0f, 0.1f, 30.0f);
-
-    UniformBufferObject ubo{};
-    ubo.LightViewProj = lightProj * lightView;
     float aspect = 1.0f;
     if (SwapchainExtent.height > 0)
     {
@@ -2425,14 +3325,289 @@ void VulkanRenderer::UpdateUniformBuffer(VkDevice Device)
     Mat4 projection = Mat4::Perspective(fovRadians, aspect, 0.1f, 100.0f);
     Vec3 eye = Camera->GetPosition();
     Mat4 view = Mat4::LookAt(eye, eye + Camera->GetFront(), Camera->GetUp());
-    ubo.ViewProj = projection * view;
-    LightViewProj = ubo.LightViewProj;
+    return projection * view;
+}
+
+Mat4 VulkanRenderer::GetLightViewProj() const
+{
+    Vec3 lightDir(0.0f, 0.0f, -1.0f);
+    Vec3 target(0.0f, 0.0f, -5.0f);
+    Vec3 lightPos = target - lightDir * 10.0f;
+
+    Mat4 lightView = Mat4::LookAt(lightPos, target, Vec3(0.0f, 1.0f, 0.0f));
+    Mat4 lightProj = Mat4::Orthographic(-10.0f, 10.0f, -10.0f, 10.0f, 0.1f, 30.0f);
+    return lightProj * lightView;
+}
+
+float VulkanRenderer::GetCameraProjectionScale() const
+{
+    if (!Camera)
+    {
+        return 1.0f;
+    }
+
+    const float kPi = 3.1415926535f;
+    const float fovRadians = Camera->GetZoom() * kPi / 180.0f;
+    return 1.0f / std::tan(fovRadians * 0.5f);
+}
+
+bool VulkanRenderer::UpdateUniformBuffer(VkDevice Device)
+{
+    UniformBufferObject ubo{};
+    if (Camera)
+    {
+        ubo.LightViewProj = GetLightViewProj();
+        ubo.ViewProj = GetCameraViewProj();
+    }
+
+    /* A fixed slot offset keeps cached secondaries' dynamic offset valid. */
+    FrameResources& frame = Frames[CurrentFrame];
+    if (frame.RetainedBuffer == VK_NULL_HANDLE || !frame.RetainedAllocation.Mapped)
+    {
+        std::fprintf(stderr, "VulkanRenderer::UpdateUniformBuffer: retained storage missing\n");
+        return false;
+    }
+
+    std::memcpy(frame.RetainedAllocation.Mapped, &ubo, sizeof(UniformBufferObject));
+    FrameUniformOffset = 0;
+
+    /* After the retained buffer grows, repoint this frame's set; it is idle here. */
+    if (frame.UniformSetBuffer != frame.RetainedBuffer)
+    {
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = frame.RetainedBuffer;
+        bufferInfo.offset = 0;
+        bufferInfo.range = sizeof(UniformBufferObject);
+
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = frame.DescriptorSet;
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+
+        vkUpdateDescriptorSets(Device, 1, &descriptorWrite, 0, nullptr);
+        frame.UniformSetBuffer = frame.RetainedBuffer;
+    }
+
+    return true;
+}
+
+bool VulkanRenderer::PrepareGpuCulling(
+    VkDevice Device,
+    const std::vector<OpaqueBatch>& Batches,
+    std::size_t InstanceCount)
+{
+    if (!Camera || InstanceCount == 0)
+    {
+        return false;
+    }
+
+    /* Batches split a mesh per material; the indirect draw merges them. */
+    /* Handles are compact, so a flat table maps each mesh to its draw. */
+    IndirectDraws.clear();
+    for (const OpaqueBatch& batch : Batches)
+    {
+        if (!batch.MeshPtr || batch.MeshPtr->VertexBuffer.GetBuffer() == VK_NULL_HANDLE ||
+            (batch.MeshPtr->HasIndex && batch.MeshPtr->IndexBuffer.GetBuffer() == VK_NULL_HANDLE))
+        {
+            for (const IndirectDraw& draw : IndirectDraws)
+            {
+                IndirectDrawLookup[draw.MeshPtr->Handle] = UINT32_MAX;
+            }
+            return false;
+        }
+
+        const std::uint32_t handle = batch.MeshPtr->Handle;
+        if (handle >= IndirectDrawLookup.size())
+        {
+            IndirectDrawLookup.resize(static_cast<std::size_t>(handle) + 1, UINT32_MAX);
+        }
+
+        if (IndirectDrawLookup[handle] == UINT32_MAX)
+        {
+            IndirectDrawLookup[handle] = static_cast<std::uint32_t>(IndirectDraws.size());
+            IndirectDraw draw{};
+            draw.MeshPtr = batch.MeshPtr;
+            IndirectDraws.push_back(draw);
+        }
+
+        IndirectDraws[IndirectDrawLookup[handle]].InstanceCount += static_cast<std::uint32_t>(batch.Count);
+    }
+
+    /* Each mesh owns a visible range as large as its unculled count. */
+    std::uint32_t outputBase = 0;
+    for (IndirectDraw& draw : IndirectDraws)
+    {
+        draw.OutputBase = outputBase;
+        outputBase += draw.InstanceCount;
+    }
+
+    const std::size_t drawCount = IndirectDraws.size();
+    RingAllocation instanceDraws;
+    RingAllocation draws;
+    const bool allocated =
+        FrameRing.Allocate(sizeof(std::uint32_t) * InstanceCount, StorageAlignment, instanceDraws) &&
+        FrameRing.Allocate(sizeof(CullDraw) * drawCount, StorageAlignment, draws) &&
+        FrameRing.Allocate(kIndirectCommandStride * drawCount, StorageAlignment, IndirectCommands) &&
+        FrameRing.Allocate(sizeof(std::uint32_t) * drawCount, StorageAlignment, IndirectCounts) &&
+        FrameRing.Allocate(sizeof(Mat4) * InstanceCount, StorageAlignment, VisibleInstances);
+
+    /* Instances keep their batch order, each tagged with its mesh's draw. */
+    if (allocated)
+    {
+        std::uint32_t* drawIndices = static_cast<std::uint32_t*>(instanceDraws.Mapped);
+        for (const OpaqueBatch& batch : Batches)
+        {
+            const std::uint32_t drawIndex = IndirectDrawLookup[batch.MeshPtr->Handle];
+            for (std::size_t index = 0; index < batch.Count; ++index)
+            {
+                drawIndices[batch.StartIndex + index] = drawIndex;
+            }
+        }
+    }
+
+    for (const IndirectDraw& draw : IndirectDraws)
+    {
+        IndirectDrawLookup[draw.MeshPtr->Handle] = UINT32_MAX;
+    }
 
-    void* data = nullptr;
+    if (!allocated)
+    {
+        std::fprintf(stderr, "VulkanRenderer::PrepareGpuCulling: ring allocation failed\n");
+        return false;
+    }
 
-    if (vkMapMemory(Device, UniformMemory, 0, sizeof(UniformBufferObject), 0, &data) == VK_SUCCESS)
+    /* Commands start with no instances and every draw count at zero; */
+    /* the culling pass fills both in. */
+    CullDraw* drawData = static_cast<CullDraw*>(draws.Mapped);
+    std::uint8_t* commands = static_cast<std::uint8_t*>(IndirectCommands.Mapped);
+    std::memset(commands, 0, kIndirectCommandStride * drawCount);
+    std::memset(IndirectCounts.Mapped, 0, sizeof(std::uint32_t) * drawCount);
+    for (std::size_t drawIndex = 0; drawIndex < drawCount; ++drawIndex)
     {
-        std::memcpy(data, &ubo, sizeof(UniformBufferObject));
-        vkUnmapMemory(Device, UniformMemory);
+        const IndirectDraw& draw = IndirectDraws[drawIndex];
+        const Mesh& mesh = *draw.MeshPtr;
+
+        /* Meshes without CPU geometry have no bounds and are never culled. */
+        CullDraw cullDraw{};
+        cullDraw.OutputBase = draw.OutputBase;
+        if (mesh.HasGeometry())
+        {
+            const Vec3& minimum = mesh.LocalBounds.Min;
+            const Vec3& maximum = mesh.LocalBounds.Max;
+            const float extentX = maximum.x - minimum.x;
+            const float extentY = maximum.y - minimum.y;
+            const float extentZ = maximum.z - minimum.z;
+            cullDraw.Sphere[0] = 0.5f * (minimum.x + maximum.x);
+            cullDraw.Sphere[1] = 0.5f * (minimum.y + maximum.y);
+            cullDraw.Sphere[2] = 0.5f * (minimum.z + maximum.z);
+            cullDraw.Sphere[3] = 0.5f * std::sqrt(extentX * extentX + extentY * extentY + extentZ * extentZ);
+        }
+        else
+        {
+            cullDraw.Sphere[3] = std::numeric_limits<float>::max();
+        }
+        drawData[drawIndex] = cullDraw;
+
+        std::uint8_t* command = commands + kIndirectCommandStride * drawIndex;
+        if (mesh.HasIndex && mesh.IndexCount > 0)
+        {
+            VkDrawIndexedIndirectCommand indexed{};
+            indexed.indexCount = mesh.IndexCount;
+            std::memcpy(command, &indexed, sizeof(indexed));
+        }
+        else
+        {
+            VkDrawIndirectCommand nonIndexed{};
+            nonIndexed.vertexCount = mesh.VertexCount;
+            std::memcpy(command, &nonIndexed, sizeof(nonIndexed));
+        }
     }
+
+    /* The slot is idle, so its culling set can point at this frame's blocks. */
+    VkDescriptorBufferInfo bufferInfos[6]{};
+    bufferInfos[0].buffer = RetainedInstances.Buffer;
+    bufferInfos[0].offset = RetainedInstances.Offset;
+    bufferInfos[0].range = sizeof(Mat4) * InstanceCount;
+    bufferInfos[1].buffer = instanceDraws.Buffer;
+    bufferInfos[1].offset = instanceDraws.Offset;
+    bufferInfos[1].range = sizeof(std::uint32_t) * InstanceCount;
+    bufferInfos[2].buffer = draws.Buffer;
+    bufferInfos[2].offset = draws.Offset;
+    bufferInfos[2].range = sizeof(CullDraw) * drawCount;
+    bufferInfos[3].buffer = IndirectCommands.Buffer;
+    bufferInfos[3].offset = IndirectCommands.Offset;
+    bufferInfos[3].range = kIndirectCommandStride * drawCount;
+    bufferInfos[4].buffer = IndirectCounts.Buffer;
+    bufferInfos[4].offset = IndirectCounts.Offset;
+    bufferInfos[4].range = sizeof(std::uint32_t) * drawCount;
+    bufferInfos[5].buffer = VisibleInstances.Buffer;
+    bufferInfos[5].offset = VisibleInstances.Offset;
+    bufferInfos[5].range = sizeof(Mat4) * InstanceCount;
+
+    VkWriteDescriptorSet writes[6]{};
+    for (std::uint32_t binding = 0; binding < 6; ++binding)
+    {
+        writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[binding].dstSet = Frames[CurrentFrame].CullSet;
+        writes[binding].dstBinding = binding;
+        writes[binding].dstArrayElement = 0;
+        writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[binding].descriptorCount = 1;
+        writes[binding].pBufferInfo = &bufferInfos[binding];
+    }
+
+    vkUpdateDescriptorSets(Device, 6, writes, 0, nullptr);
+    return true;
+}
+
+void VulkanRenderer::RecordCullDispatch(VkCommandBuffer CommandBuffer, std::uint32_t InstanceCount)
+{
+    /* Same planes the CPU extraction culls with, from the uniform's matrix. */
+    const Frustum frustum = Frustum::FromViewProjection(GetCameraViewProj());
+
+    CullPushConstants cullPush{};
+    std::memcpy(cullPush.Planes, frustum.Planes, sizeof(cullPush.Planes));
+    cullPush.InstanceCount = InstanceCount;
+
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, Pipeline->GetCullHandle());
+    vkCmdBindDescriptorSets(
+        CommandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        Pipeline->GetCullLayout(),
+        0,
+        1,
+        &Frames[CurrentFrame].CullSet,
+        0,
+        nullptr);
+    vkCmdPushConstants(
+        CommandBuffer,
+        Pipeline->GetCullLayout(),
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(CullPushConstants),
+        &cullPush);
+    vkCmdDispatch(CommandBuffer, (InstanceCount + kCullGroupSize - 1) / kCullGroupSize, 1, 1);
+
+    /* Commands and counts feed the indirect draws, visible transforms */
+    /* the instance vertex stream. */
+    VkMemoryBarrier cullToDraw{};
+    cullToDraw.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    cullToDraw.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    cullToDraw.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        CommandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        0,
+        1,
+        &cullToDraw,
+        0,
+        nullptr,
+        0,
+        nullptr);
 }
@@ -27,7 +27,13 @@
 
 #include "../../../Math/MathTypes.h"
 #include "Mesh.h"
+#include "ObjLoader.h"
+#include "../Core/VulkanMemoryAllocator.h"
+#include "../Core/VulkanRingBuffer.h"
+#include "../Core/VulkanUploadManager.h"
 #include "../../RenderItem.h"
+#include "../../RenderResourceTable.h"
+#include "../../RenderSortKey.h"
 #include "../Skybox/SkyboxRenderer.h"
 #include "Scene/Entity.h"
 
@@ -35,6 +41,8 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <memory>
+#include <string>
 #include <vector>
 
 class VulkanPipeline;
@@ -52,7 +60,24 @@ public:
     /* Destroy renderer resources. */
     ~VulkanRenderer();
 
+    /* Frames the CPU may record ahead of the GPU, clamped to 1..kMaxFramesInFlight. */
+    /* Applied by the next Create. */
+    void SetFramesInFlight(std::uint32_t Count);
+
+    /* Threads recording secondary command buffers, clamped to kMaxRecordWorkers. */
+    /* 0 picks the hardware thread count, 1 records on the render thread. */
+    /* Applied by the next Create. */
+    void SetRecordWorkers(std::uint32_t Count);
+
+    /* Cull opaque instances in a compute pass and draw them indirectly, one */
+    /* draw per mesh. DrawIndirectCount tells whether the device enabled */
+    /* vkCmdDraw*IndirectCount; without it empty draws keep zero instances. */
+    /* Applied by the next Create. */
+    void SetGpuCullingEnabled(bool Enabled, bool DrawIndirectCount);
+
     /* Create renderer resources. */
+    /* A null SwapchainHandle renders offscreen into the given image views: */
+    /* images cycle with the frame slot, nothing is acquired or presented. */
     bool Create(
         VkDevice Device,
         VkPhysicalDevice PhysicalDevice,
@@ -67,8 +92,30 @@ public:
     /* Update camera state. */
     void UpdateCamera(float DeltaTime);
 
-    /* Set render submission list. */
-    void SetRenderItems(const std::vector<RenderItem>& Items);
+    /* Set render submission list, borrowed until the next call. */
+    void SetRenderItems(const RenderList* Items);
+
+    /* Set shadow caster list, culled against the light frustum. */
+    void SetShadowCasters(const RenderList* Items);
+
+    /* Table resolving the mesh and material handles of submitted items. */
+    /* Must outlive the frames drawn with it. */
+    void SetRenderResources(const RenderResourceTable* Resources);
+
+    /* Select the sort key layout used for one stage. */
+    void SetSortKeyLayout(RenderStage Stage, const RenderSortKeyLayout& Layout);
+
+    /* Lay down opaque depth first, then shade opaque batches with an EQUAL test. */
+    /* Takes effect once the pre-pass pipelines finish compiling, and then */
+    /* also switches the opaque sort key layout to state-only. */
+    void SetDepthPrepassEnabled(bool Enabled);
+
+    /* Resolve transparency with weighted blended OIT instead of a sorted stage. */
+    /* The render pass given to Create must match: it has the OIT subpasses */
+    /* only when enabled. Applied by the next Create; takes effect once the */
+    /* OIT pipelines finish compiling, and then also switches the transparent */
+    /* sort key layout to state-only. */
+    void SetWeightedOITEnabled(bool Enabled);
 
     /* Update editor scene entity list. */
     void SetEditorEntities(const std::vector<Entity>& Entities);
@@ -88,6 +135,10 @@ public:
     /* Render a single frame. */
     void DrawFrame(VkDevice Device, VkQueue GraphicsQueue);
 
+    /* Image index the last submitted frame rendered to, UINT32_MAX before */
+    /* the first. Offscreen targets read it back from this image. */
+    std::uint32_t GetLastImageIndex() const;
+
     /* Destroy renderer resources. */
     void Destroy(VkDevice Device);
 
@@ -106,10 +157,26 @@ public:
     Mesh* GetCubeMesh();
     Material* GetCubeMaterial();
 
+    /* Import an OBJ as a LOD chain owned by the renderer. */
+    /* Returns null on failure; the chain lives until Destroy. */
+    MeshLODChain* ImportMesh(const std::string& Path, const ObjLoadOptions& Options = ObjLoadOptions{});
+
     /* Camera position helpers. */
     Vec3 GetCameraPosition() const;
     void SetCameraPosition(const Vec3& Position);
 
+    /* Camera view-projection for the current swapchain aspect. */
+    Mat4 GetCameraViewProj() const;
+
+    /* Directional light view-projection used by the shadow pass. */
+    Mat4 GetLightViewProj() const;
+
+    /* cot(fovY / 2) of the camera projection, for screen-size estimates. */
+    float GetCameraProjectionScale() const;
+
+    /* Visibility counters from scene extraction, shown in the overlay. */
+    void SetCullStats(std::uint32_t Submitted, std::uint32_t Culled, std::uint32_t Occluded);
+
     /* Overlay timing input. */
     void SetOverlayTiming(float DeltaTime);
 
@@ -123,21 +190,107 @@ public:
         Mat4 ViewProj;
     };
 
+    /* Upper bound for SetFramesInFlight. */
+    static constexpr std::uint32_t kMaxFramesInFlight = 4;
+
+    /* Upper bound for SetRecordWorkers. */
+    static constexpr std::uint32_t kMaxRecordWorkers = 16;
+
 private:
-    struct SortedRenderItem
+    /* Secondary command buffers of one recording thread, never shared. */
+    struct RecordWorker
     {
-        const RenderItem* Item = nullptr;
-        float DepthSq = 0.0f;
+        VkCommandPool Pool = VK_NULL_HANDLE;
+
+        /* Idle secondaries, reset implicitly when recording begins. */
+        std::vector<VkCommandBuffer> Free;
+    };
+
+    /* Stage a secondary command buffer records, which fixes its subpass. */
+    enum class RecordStage : std::uint8_t
+    {
+        Shadow,
+        DepthPrepass,
+        Skybox,
+        Opaque,
+        Transparent,
+        WeightedBlend
+    };
+
+    /* Everything a recorded batch draw bakes in besides the slot's bindings. */
+    struct BatchState
+    {
+        VkBuffer VertexBuffer = VK_NULL_HANDLE;
+        VkBuffer IndexBuffer = VK_NULL_HANDLE;
+        std::uint32_t ElementCount = 0;
+        bool Indexed = false;
+        std::size_t StartIndex = 0;
+        std::size_t Count = 0;
+        float BaseColorAmbient[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+        float Alpha = 1.0f;
+    };
+
+    /* Contiguous draw range of one stage, recorded into one secondary. */
+    struct RecordTask
+    {
+        RecordStage Stage = RecordStage::Opaque;
+        std::size_t Begin = 0;
+        std::size_t End = 0;
+        VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+
+        /* Worker whose pool owns the command buffer. */
+        std::uint32_t Worker = 0;
+
+        /* Replay key of cached stages: cache epoch and batch state at record time. */
+        std::uint64_t CacheEpoch = 0;
+        std::vector<BatchState> Batches;
+    };
+
+    /* State owned by one frame in flight, reused once its fence signals. */
+    struct FrameResources
+    {
+        VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+        VkSemaphore ImageAvailable = VK_NULL_HANDLE;
+        VkSemaphore RenderFinished = VK_NULL_HANDLE;
+        VkFence InFlightFence = VK_NULL_HANDLE;
+
+        /* Scene set, its uniform is dynamic so only the ring block is bound. */
+        VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
+        VkBuffer UniformSetBuffer = VK_NULL_HANDLE;
+
+        /* Culling inputs and outputs, rewritten each frame it runs. */
+        VkDescriptorSet CullSet = VK_NULL_HANDLE;
+
+        /* Uniforms, then opaque and shadow instances, at a fixed address */
+        /* so commands recorded against them can be replayed. */
+        VkBuffer RetainedBuffer = VK_NULL_HANDLE;
+        VulkanAllocation RetainedAllocation;
+        VkDeviceSize RetainedCapacity = 0;
+
+        /* Per-thread pools, and the tasks this slot recorded or replayed last. */
+        std::vector<RecordWorker> Workers;
+        std::vector<RecordTask> Tasks;
     };
 
     struct OpaqueBatch
     {
         std::size_t StartIndex = 0;
         std::size_t Count = 0;
+        std::uint32_t MeshHandle = 0;
         Mesh* MeshPtr = nullptr;
         Material* MaterialPtr = nullptr;
     };
 
+    /* One mesh on the GPU culling path: all its opaque instances, any material. */
+    struct IndirectDraw
+    {
+        Mesh* MeshPtr = nullptr;
+
+        /* Instances before culling, and the first slot of its visible range. */
+        std::uint32_t InstanceCount = 0;
+        std::uint32_t OutputBase = 0;
+    };
+
     /* Framebuffer creation. */
     bool CreateFramebuffers(
         VkDevice Device,
@@ -152,14 +305,41 @@ private:
         std::uint32_t GraphicsQueueFamily);
     bool CreateCommandBuffers(VkDevice Device);
 
+    /* Per-frame, per-worker pools for secondary command buffers. */
+    bool CreateRecordPools(
+        VkDevice Device,
+        std::uint32_t GraphicsQueueFamily);
+
+    /* Next free secondary of a worker, allocated on first use. */
+    VkCommandBuffer AcquireSecondary(VkDevice Device, RecordWorker& Worker);
+
+    /* Drop every cached secondary, for changes batch state does not capture. */
+    void InvalidateRecordCache();
+
+    /* Switch requested features on as their background pipelines become */
+    /* ready; until then frames draw with the generic world pipeline. */
+    void UpdatePipelineVariants();
+
+    /* Batch state snapshots deciding whether a cached range can replay. */
+    static BatchState CaptureBatchState(const OpaqueBatch& Batch);
+    static bool MatchesBatchState(const std::vector<BatchState>& States, const OpaqueBatch* Batches);
+
     /* Synchronization objects. */
     bool CreateSyncObjects(VkDevice Device);
+    void DestroyFrameResources(VkDevice Device);
 
-    /* Uniform buffer resources. */
-    bool CreateUniformBuffer(
+    /* Signal a slot's fence after its frame failed to submit; with WaitImage */
+    /* the batch also consumes the acquire semaphore. */
+    bool RetireFrameSlot(VkDevice Device, VkQueue GraphicsQueue, FrameResources& Frame, bool WaitImage);
+
+    /* Per-frame ring for transparent instances and other dynamic data. */
+    bool CreateFrameRing(
         VkPhysicalDevice PhysicalDevice,
         VkDevice Device);
 
+    /* Grow a slot's retained buffer to hold the instance count; the slot is idle. */
+    bool ReserveRetainedStorage(FrameResources& Frame, std::size_t InstanceCount);
+
     /* Descriptor resources. */
     bool CreateDescriptorPool(VkDevice Device);
     bool CreateDescriptorSetLayout(VkDevice Device);
@@ -168,9 +348,7 @@ private:
     /* Texture resources. */
     bool CreateTextureResources(
         VkPhysicalDevice PhysicalDevice,
-        VkDevice Device,
-        VkQueue GraphicsQueue,
-        std::uint32_t GraphicsQueueFamily);
+        VkDevice Device);
     void DestroyTextureResources(VkDevice Device);
 
     /* MSAA color resources. */
@@ -189,28 +367,66 @@ private:
         VkExtent2D Extent);
     void DestroyDepthResources(VkDevice Device);
 
+    /* Weighted blended OIT targets, written to the composite set. */
+    /* Nothing is allocated while OIT is disabled. */
+    bool CreateTransparencyResources(
+        VkPhysicalDevice PhysicalDevice,
+        VkDevice Device,
+        VkExtent2D Extent);
+    void DestroyTransparencyResources(VkDevice Device);
+
     /* Shadow map resources. */
     bool CreateShadowResources(
         VkPhysicalDevice PhysicalDevice,
         VkDevice Device);
     void DestroyShadowResources(VkDevice Device);
 
-    /* Uniform updates. */
-    void UpdateUniformBuffer(VkDevice Device);
-    bool EnsureInstanceBuffer(VkDevice Device, VkPhysicalDevice PhysicalDevice, std::size_t InstanceCount);
+    /* Write this frame's uniforms into the ring and point the frame set at them. */
+    bool UpdateUniformBuffer(VkDevice Device);
+
+    /* Group opaque batches per mesh and write the culling inputs into the ring. */
+    bool PrepareGpuCulling(VkDevice Device, const std::vector<OpaqueBatch>& Batches, std::size_t InstanceCount);
+
+    /* Cull the opaque instances and make the indirect draws visible to drawing. */
+    void RecordCullDispatch(VkCommandBuffer CommandBuffer, std::uint32_t InstanceCount);
+
+    /* Shadow pass recording, one instanced draw per mesh batch. */
+    void RecordShadowStage(
+        VkCommandBuffer CommandBuffer,
+        const OpaqueBatch* Batches,
+        std::size_t BatchCount);
 
     /* Main render pass stage recording. */
+    /* Batch and item ranges let one stage split across several recorders. */
+    void RecordDepthPrepassStage(
+        VkCommandBuffer CommandBuffer,
+        const OpaqueBatch* Batches,
+        std::size_t BatchCount);
     void RecordSkyboxStage(VkCommandBuffer CommandBuffer, VkExtent2D Extent);
     void RecordOpaqueStage(
         VkCommandBuffer CommandBuffer,
         VkExtent2D Extent,
-        const std::vector<SortedRenderItem>& Items,
-        const std::vector<OpaqueBatch>& Batches);
+        const std::vector<RenderItem>& Items,
+        const OpaqueBatch* Batches,
+        std::size_t BatchCount);
     void RecordTransparentStage(
         VkCommandBuffer CommandBuffer,
         VkExtent2D Extent,
-        const std::vector<SortedRenderItem>& Items,
+        const RenderItem* Items,
+        std::size_t ItemCount,
         std::uint32_t BaseInstance);
+    void RecordWeightedBlendStage(
+        VkCommandBuffer CommandBuffer,
+        const OpaqueBatch* Batches,
+        std::size_t BatchCount);
+    void RecordCompositeStage(VkCommandBuffer CommandBuffer);
+
+    /* Pre-pass or opaque colour over the culled instances, one draw per mesh. */
+    void RecordIndirectStage(
+        VkCommandBuffer CommandBuffer,
+        bool DepthOnly,
+        std::size_t FirstDraw,
+        std::size_t DrawCount);
 
 private:
     /* Swapchain state. */
@@ -224,46 +440,81 @@ private:
     VkQueue GraphicsQueueHandle = VK_NULL_HANDLE;
     std::vector<VkImageView> SwapchainImageViews;
 
-    /* Command buffers. */
+    /* Command pool for the per-frame command buffers. */
     VkCommandPool CommandPool = VK_NULL_HANDLE;
-    std::vector<VkCommandBuffer> CommandBuffers;
+
+    /* Frames in flight, cycled by CurrentFrame. */
+    std::vector<FrameResources> Frames;
+    std::uint32_t FramesInFlight = 2;
+    std::uint32_t CurrentFrame = 0;
+
+    /* Requested recording threads, 0 for the hardware thread count. */
+    std::uint32_t RecordWorkers = 0;
+
+    /* Cached secondaries from an older epoch never replay. */
+    std::uint64_t RecordCacheEpoch = 1;
+    std::vector<RecordTask> PreviousTasks;
+    std::vector<std::uint32_t> PendingTasks;
+
+    /* Fence of the frame last rendered to each swapchain image. */
+    std::vector<VkFence> ImagesInFlight;
+
+    /* Image the last submitted frame rendered to. */
+    std::uint32_t LastImageIndex = UINT32_MAX;
 
     /* Framebuffers. */
     std::vector<VkFramebuffer> Framebuffers;
 
     /* MSAA color buffers. */
     std::vector<VkImage> ColorImages;
-    std::vector<VkDeviceMemory> ColorImageMemories;
+    std::vector<VulkanAllocation> ColorImageAllocations;
     std::vector<VkImageView> ColorImageViews;
 
-    /* Synchronization primitives. */
-    VkSemaphore ImageAvailable = VK_NULL_HANDLE;
-    VkSemaphore RenderFinished = VK_NULL_HANDLE;
-    VkFence InFlightFence = VK_NULL_HANDLE;
-
     /* Graphics pipeline. */
     VulkanPipeline* Pipeline = nullptr;
 
     /* Skybox renderer. */
     SkyboxRenderer Skybox;
 
-    /* Uniform buffer. */
-    VkBuffer UniformBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory UniformMemory = VK_NULL_HANDLE;
-    VkBuffer InstanceBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory InstanceMemory = VK_NULL_HANDLE;
-    std::size_t InstanceCapacity = 0;
+    /* Dynamic per-frame data: transparent instance transforms. */
+    VulkanRingBuffer FrameRing;
+    RingAllocation FrameInstances;
+
+    /* Current slot's uniform offset and opaque and shadow instance region. */
+    std::uint32_t FrameUniformOffset = 0;
+    RingAllocation RetainedInstances;
+
+    /* Ring offsets of storage buffer bindings must be multiples of this. */
+    VkDeviceSize StorageAlignment = 256;
+
+    /* GPU culling: per-mesh draws, a handle-to-draw scratch table, and this */
+    /* frame's indirect commands, draw counts and visible instance transforms. */
+    bool GpuCullingEnabled = false;
+    bool DrawIndirectCountEnabled = false;
+    std::vector<IndirectDraw> IndirectDraws;
+    std::vector<std::uint32_t> IndirectDrawLookup;
+    RingAllocation IndirectCommands;
+    RingAllocation IndirectCounts;
+    RingAllocation VisibleInstances;
 
     /* Depth buffer. */
     VkImage DepthImage = VK_NULL_HANDLE;
-    VkDeviceMemory DepthImageMemory = VK_NULL_HANDLE;
+    VulkanAllocation DepthImageAllocation;
     VkImageView DepthImageView = VK_NULL_HANDLE;
 
+    /* Weighted blended OIT accumulation and revealage targets. */
+    VkImage AccumImage = VK_NULL_HANDLE;
+    VulkanAllocation AccumImageAllocation;
+    VkImageView AccumImageView = VK_NULL_HANDLE;
+    VkImage RevealageImage = VK_NULL_HANDLE;
+    VulkanAllocation RevealageImageAllocation;
+    VkImageView RevealageImageView = VK_NULL_HANDLE;
+
     /* Shadow map. */
     VkRenderPass ShadowRenderPass = VK_NULL_HANDLE;
     VkFramebuffer ShadowFramebuffer = VK_NULL_HANDLE;
     VkImage ShadowImage = VK_NULL_HANDLE;
-    VkDeviceMemory ShadowImageMemory = VK_NULL_HANDLE;
+    VulkanAllocation ShadowImageAllocation;
     VkImageView ShadowImageView = VK_NULL_HANDLE;
     VkSampler ShadowSampler = VK_NULL_HANDLE;
     VkExtent2D ShadowExtent{ 2048, 2048 };
@@ -271,19 +522,42 @@ private:
 
     /* Diffuse texture. */
     VkImage DiffuseImage = VK_NULL_HANDLE;
-    VkDeviceMemory DiffuseImageMemory = VK_NULL_HANDLE;
+    VulkanAllocation DiffuseImageAllocation;
+    UploadToken DiffuseUpload = 0;
     VkImageView DiffuseImageView = VK_NULL_HANDLE;
     VkSampler DiffuseSampler = VK_NULL_HANDLE;
 
     /* Descriptor sets. */
     VkDescriptorSetLayout DescriptorSetLayout = VK_NULL_HANDLE;
     VkDescriptorPool DescriptorPool = VK_NULL_HANDLE;
-    VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
+    VkDescriptorSetLayout CompositeSetLayout = VK_NULL_HANDLE;
+    VkDescriptorSet CompositeSet = VK_NULL_HANDLE;
+    VkDescriptorSetLayout CullSetLayout = VK_NULL_HANDLE;
 
     /* Meshes and render list. */
     Mesh CubeMesh;
+    std::vector<std::unique_ptr<MeshLODChain>> ImportedMeshes;
     Material CubeMaterial;
-    std::vector<RenderItem> RenderItems;
+    const RenderList* RenderItems = nullptr;
+    const RenderList* ShadowCasterItems = nullptr;
+    const RenderResourceTable* RenderResources = nullptr;
+
+    /* Per-stage sort key encoders and radix sort buffers. */
+    RenderSortKeyEncoder SortKeyEncoders[static_cast<std::size_t>(RenderStage::Count)] = {
+        RenderSortKeyEncoder(RenderSortKeyLayout::StateFirst()),
+        RenderSortKeyEncoder(RenderSortKeyLayout::DepthFirst()) };
+    std::vector<RenderSortEntry> SortEntries;
+    std::vector<RenderSortEntry> SortScratch;
+
+    /* Opaque depth is rendered by a position-only pass before colour. */
+    /* Active once the pre-pass pipelines are ready as well as requested. */
+    bool DepthPrepassEnabled = false;
+    bool DepthPrepassActive = false;
+
+    /* Transparent batches accumulate order-independently, then composite. */
+    /* Active once the OIT pipelines are ready as well as requested. */
+    bool WeightedOITEnabled = false;
+    bool WeightedOITActive = false;
 
     /* Camera reference. */
     Camera* Camera = nullptr;
@@ -291,12 +565,12 @@ private:
     /* Time state. */
     float Time = 0.0f;
 
-    /* Cached light matrix. */
-    Mat4 LightViewProj = Mat4::Identity();
-
     /* Debug overlay. */
     NuklearOverlay Overlay;
     float OverlayDeltaTime = 0.0f;
+    std::uint32_t SubmittedItemCount = 0;
+    std::uint32_t CulledItemCount = 0;
+    std::uint32_t OccludedItemCount = 0;
 
     /* Editor selection data. */
     std::vector<Entity> EditorEntities;
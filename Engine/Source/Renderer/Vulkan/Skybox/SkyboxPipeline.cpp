@@ -25,6 +25,8 @@
 
 #include "SkyboxPipeline.h"
 
+#include "Renderer/Vulkan/Core/VulkanPipelineCache.h"
+
 #include <cstdio>
 #include <fstream>
 #include <vector>
@@ -237,7 +239,7 @@ bool SkyboxPipeline::Create(
     pipelineInfo.renderPass = RenderPass;
     pipelineInfo.subpass = 0;
 
-    if (vkCreateGraphicsPipelines(Device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &PipelineHandle) != VK_SUCCESS)
+    if (g_VulkanPipelineCache.CreateGraphicsPipelines(Device, 1, &pipelineInfo, &PipelineHandle) != VK_SUCCESS)
     {
         std::fprintf(stderr, "SkyboxPipeline::Create: vkCreateGraphicsPipelines failed\n");
         vkDestroyPipelineLayout(Device, PipelineLayout, nullptr);
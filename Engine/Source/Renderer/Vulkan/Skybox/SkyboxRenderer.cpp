@@ -28,7 +28,6 @@
 #include "Scene/EngineCamera.h"
 
 #include <algorithm>
-#include <array>
 #include <cctype>
 #include <cmath>
 #include <cstdlib>
@@ -224,9 +223,9 @@ namespace
         std::getline(file, line);
         int width = 0;
         int height = 0;
-        if (::sscanf_s(line.c_str(), "-Y %d +X %d", &height, &width) != 2)
+        if (std::sscanf(line.c_str(), "-Y %d +X %d", &height, &width) != 2)
         {
-            if (::sscanf_s(line.c_str(), "+X %d -Y %d", &width, &height) != 2)
+            if (std::sscanf(line.c_str(), "+X %d -Y %d", &width, &height) != 2)
             {
                 std::fprintf(stderr, "SkyboxRenderer: Invalid HDR resolution %s\n", Path.c_str());
                 return false;
@@ -407,230 +406,6 @@ namespace
 
         return true;
     }
-
-    /* Find Vulkan memory type. */
-    uint32_t FindMemoryType(
-        VkPhysicalDevice PhysicalDevice,
-        uint32_t TypeFilter,
-        VkMemoryPropertyFlags Properties)
-    {
-        VkPhysicalDeviceMemoryProperties memProperties{};
-        vkGetPhysicalDeviceMemoryProperties(PhysicalDevice, &memProperties);
-
-        for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i)
-        {
-            if ((TypeFilter & (1 << i)) &&
-                (memProperties.memoryTypes[i].propertyFlags & Properties) == Properties)
-            {
-                return i;
-            }
-        }
-
-        return UINT32_MAX;
-    }
-
-    /* Create a Vulkan buffer with memory. */
-    bool CreateBuffer(
-        VkPhysicalDevice PhysicalDevice,
-        VkDevice Device,
-        VkDeviceSize Size,
-        VkBufferUsageFlags Usage,
-        VkMemoryPropertyFlags Properties,
-        VkBuffer& OutBuffer,
-        VkDeviceMemory& OutMemory)
-    {
-        VkBufferCreateInfo bufferInfo{};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = Size;
-        bufferInfo.usage = Usage;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-        if (vkCreateBuffer(Device, &bufferInfo, nullptr, &OutBuffer) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "SkyboxRenderer: vkCreateBuffer failed\n");
-            return false;
-        }
-
-        VkMemoryRequirements memRequirements{};
-        vkGetBufferMemoryRequirements(Device, OutBuffer, &memRequirements);
-
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = FindMemoryType(
-            PhysicalDevice,
-            memRequirements.memoryTypeBits,
-            Properties);
-
-        if (vkAllocateMemory(Device, &allocInfo, nullptr, &OutMemory) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "SkyboxRenderer: vkAllocateMemory failed\n");
-            vkDestroyBuffer(Device, OutBuffer, nullptr);
-            OutBuffer = VK_NULL_HANDLE;
-            return false;
-        }
-
-        vkBindBufferMemory(Device, OutBuffer, OutMemory, 0);
-        return true;
-    }
-
-    /* Begin one-shot command buffer. */
-    bool BeginSingleTimeCommands(
-        VkDevice Device,
-        uint32_t QueueFamily,
-        VkCommandPool& OutPool,
-        VkCommandBuffer& OutCommandBuffer)
-    {
-        VkCommandPoolCreateInfo poolInfo{};
-        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-        poolInfo.queueFamilyIndex = QueueFamily;
-
-        if (vkCreateCommandPool(Device, &poolInfo, nullptr, &OutPool) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "SkyboxRenderer: vkCreateCommandPool failed\n");
-            return false;
-        }
-
-        VkCommandBufferAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = OutPool;
-        allocInfo.commandBufferCount = 1;
-
-        if (vkAllocateCommandBuffers(Device, &allocInfo, &OutCommandBuffer) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "SkyboxRenderer: vkAllocateCommandBuffers failed\n");
-            vkDestroyCommandPool(Device, OutPool, nullptr);
-            OutPool = VK_NULL_HANDLE;
-            return false;
-        }
-
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-        if (vkBeginCommandBuffer(OutCommandBuffer, &beginInfo) != VK_SUCCESS)
-        {
-            std::fprintf(stderr, "SkyboxRenderer: vkBeginCommandBuffer failed\n");
-            vkFreeCommandBuffers(Device, OutPool, 1, &OutCommandBuffer);
-            vkDestroyCommandPool(Device, OutPool, nullptr);
-            OutPool = VK_NULL_HANDLE;
-            return false;
-        }
-
-        return true;
-    }
-
-    /* End and submit one-shot command buffer. */
-    void EndSingleTimeCommands(
-        VkDevice Device,
-        VkQueue Queue,
-        VkCommandPool CommandPool,
-        VkCommandBuffer CommandBuffer)
-    {
-        vkEndCommandBuffer(CommandBuffer);
-
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &CommandBuffer;
-
-        vkQueueSubmit(Queue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(Queue);
-
-        vkFreeCommandBuffers(Device, CommandPool, 1, &CommandBuffer);
-        vkDestroyCommandPool(Device, CommandPool, nullptr);
-    }
-
-    /* Transition cubemap image layout. */
-    void TransitionImageLayout(
-        VkCommandBuffer CommandBuffer,
-        VkImage Image,
-        VkImageLayout OldLayout,
-        VkImageLayout NewLayout,
-        uint32_t LayerCount)
-    {
-        VkImageMemoryBarrier barrier{};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = OldLayout;
-        barrier.newLayout = NewLayout;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = Image;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = LayerCount;
-
-        VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-
-        if (OldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
-            NewLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-        {
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        }
-        else if (OldLayout == VK_IMAGE_LAYOUT_UNDEFINED &&
-            NewLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-        {
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        }
-
-        vkCmdPipelineBarrier(
-            CommandBuffer,
-            srcStage,
-            dstStage,
-            0,
-            0,
-            nullptr,
-            0,
-            nullptr,
-            1,
-            &barrier);
-    }
-
-    /* Copy a buffer into a cubemap image. */
-    void CopyBufferToImage(
-        VkCommandBuffer CommandBuffer,
-        VkBuffer Buffer,
-        VkImage Image,
-        uint32_t FaceSize)
-    {
-        std::array<VkBufferImageCopy, 6> regions{};
-        VkDeviceSize faceSizeBytes = static_cast<VkDeviceSize>(FaceSize) *
-            static_cast<VkDeviceSize>(FaceSize) *
-            sizeof(std::uint16_t) * 4;
-
-        for (uint32_t face = 0; face < 6; ++face)
-        {
-            VkBufferImageCopy& region = regions[face];
-            region.bufferOffset = faceSizeBytes * face;
-            region.bufferRowLength = 0;
-            region.bufferImageHeight = 0;
-            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            region.imageSubresource.mipLevel = 0;
-            region.imageSubresource.baseArrayLayer = face;
-            region.imageSubresource.layerCount = 1;
-            region.imageOffset = { 0, 0, 0 };
-            region.imageExtent = { FaceSize, FaceSize, 1 };
-        }
-
-        vkCmdCopyBufferToImage(
-            CommandBuffer,
-            Buffer,
-            Image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            static_cast<uint32_t>(regions.size()),
-            regions.data());
-    }
 }
 
 SkyboxRenderer::SkyboxRenderer() = default;
@@ -640,9 +415,7 @@ SkyboxRenderer::~SkyboxRenderer() = default;
 bool SkyboxRenderer::Create(
     VkDevice Device,
     VkPhysicalDevice PhysicalDevice,
-    VkRenderPass RenderPass,
-    VkQueue GraphicsQueue,
-    std::uint32_t GraphicsQueueFamily)
+    VkRenderPass RenderPass)
 {
     Destroy(Device);
 
@@ -664,7 +437,7 @@ bool SkyboxRenderer::Create(
         return false;
     }
 
-    if (!CreateVertexBuffer(PhysicalDevice, Device, GraphicsQueue, GraphicsQueueFamily))
+    if (!CreateVertexBuffer())
     {
         std::fprintf(stderr, "SkyboxRenderer::Create: Vertex buffer failed\n");
         return false;
@@ -687,7 +460,7 @@ bool SkyboxRenderer::Create(
         return false;
     }
 
-    if (!LoadSkyboxResources(it->second, Device, PhysicalDevice, GraphicsQueue, GraphicsQueueFamily))
+    if (!LoadSkyboxResources(it->second, Device, PhysicalDevice))
     {
         std::fprintf(stderr, "SkyboxRenderer::Create: Failed to load skybox resources\n");
         return false;
@@ -712,7 +485,7 @@ void SkyboxRenderer::Destroy(VkDevice Device)
     Pipeline.Destroy(Device);
     DestroySkyboxResources(Device);
     DestroyDescriptorResources(Device);
-    VertexBuffer.Destroy(Device);
+    VertexBuffer.Destroy();
 
     AssetsReadyRoot.clear();
     VertexShaderPath.clear();
@@ -833,9 +606,7 @@ void SkyboxRenderer::Record(
 bool SkyboxRenderer::SetActiveSkybox(
     const std::string& Name,
     VkDevice Device,
-    VkPhysicalDevice PhysicalDevice,
-    VkQueue GraphicsQueue,
-    std::uint32_t GraphicsQueueFamily)
+    VkPhysicalDevice PhysicalDevice)
 {
     auto it = Skyboxes.find(Name);
     if (it == Skyboxes.end())
@@ -843,7 +614,7 @@ bool SkyboxRenderer::SetActiveSkybox(
         return false;
     }
 
-    if (!LoadSkyboxResources(it->second, Device, PhysicalDevice, GraphicsQueue, GraphicsQueueFamily))
+    if (!LoadSkyboxResources(it->second, Device, PhysicalDevice))
     {
         return false;
     }
@@ -1010,9 +781,7 @@ bool SkyboxRenderer::LoadCatalog()
 bool SkyboxRenderer::LoadSkyboxResources(
     const SkyboxDefinition& Definition,
     VkDevice Device,
-    VkPhysicalDevice PhysicalDevice,
-    VkQueue GraphicsQueue,
-    std::uint32_t GraphicsQueueFamily)
+    VkPhysicalDevice PhysicalDevice)
 {
     DestroySkyboxResources(Device);
 
@@ -1030,34 +799,8 @@ bool SkyboxRenderer::LoadSkyboxResources(
         return false;
     }
 
-    VkBuffer stagingBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
     VkDeviceSize dataSize = static_cast<VkDeviceSize>(cubemapData.size()) * sizeof(std::uint16_t);
 
-    if (!CreateBuffer(
-        PhysicalDevice,
-        Device,
-        dataSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer,
-        stagingMemory))
-    {
-        return false;
-    }
-
-    void* mapped = nullptr;
-    if (vkMapMemory(Device, stagingMemory, 0, dataSize, 0, &mapped) != VK_SUCCESS)
-    {
-        std::fprintf(stderr, "SkyboxRenderer: vkMapMemory failed\n");
-        vkDestroyBuffer(Device, stagingBuffer, nullptr);
-        vkFreeMemory(Device, stagingMemory, nullptr);
-        return false;
-    }
-
-    std::memcpy(mapped, cubemapData.data(), static_cast<std::size_t>(dataSize));
-    vkUnmapMemory(Device, stagingMemory);
-
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -1074,71 +817,27 @@ bool SkyboxRenderer::LoadSkyboxResources(
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     imageInfo.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
 
-    if (vkCreateImage(Device, &imageInfo, nullptr, &CubemapImage) != VK_SUCCESS)
-    {
-        std::fprintf(stderr, "SkyboxRenderer: vkCreateImage failed\n");
-        vkDestroyBuffer(Device, stagingBuffer, nullptr);
-        vkFreeMemory(Device, stagingMemory, nullptr);
-        return false;
-    }
-
-    VkMemoryRequirements memRequirements{};
-    vkGetImageMemoryRequirements(Device, CubemapImage, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = FindMemoryType(
-        PhysicalDevice,
-        memRequirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(Device, &allocInfo, nullptr, &CubemapMemory) != VK_SUCCESS)
+    if (!g_VulkanAllocator.CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, CubemapImage, CubemapAllocation))
     {
-        std::fprintf(stderr, "SkyboxRenderer: vkAllocateMemory failed\n");
-        vkDestroyImage(Device, CubemapImage, nullptr);
-        vkDestroyBuffer(Device, stagingBuffer, nullptr);
-        vkFreeMemory(Device, stagingMemory, nullptr);
-        CubemapImage = VK_NULL_HANDLE;
+        std::fprintf(stderr, "SkyboxRenderer: CreateImage failed\n");
         return false;
     }
 
-    vkBindImageMemory(Device, CubemapImage, CubemapMemory, 0);
-
-    VkCommandPool commandPool = VK_NULL_HANDLE;
-    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
-    if (!BeginSingleTimeCommands(Device, GraphicsQueueFamily, commandPool, commandBuffer))
+    /* Faces are packed back to back, one upload fills all six layers. */
+    CubemapUpload = g_VulkanUploader.UploadImage(
+        CubemapImage,
+        cubemapData.data(),
+        dataSize,
+        Definition.Size,
+        Definition.Size,
+        6);
+    if (CubemapUpload == 0)
     {
-        vkDestroyImage(Device, CubemapImage, nullptr);
-        vkFreeMemory(Device, CubemapMemory, nullptr);
-        vkDestroyBuffer(Device, stagingBuffer, nullptr);
-        vkFreeMemory(Device, stagingMemory, nullptr);
-        CubemapImage = VK_NULL_HANDLE;
-        CubemapMemory = VK_NULL_HANDLE;
+        std::fprintf(stderr, "SkyboxRenderer: UploadImage failed\n");
+        g_VulkanAllocator.DestroyImage(CubemapImage, CubemapAllocation);
         return false;
     }
 
-    TransitionImageLayout(
-        commandBuffer,
-        CubemapImage,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        6);
-
-    CopyBufferToImage(commandBuffer, stagingBuffer, CubemapImage, Definition.Size);
-
-    TransitionImageLayout(
-        commandBuffer,
-        CubemapImage,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        6);
-
-    EndSingleTimeCommands(Device, GraphicsQueue, commandPool, commandBuffer);
-
-    vkDestroyBuffer(Device, stagingBuffer, nullptr);
-    vkFreeMemory(Device, stagingMemory, nullptr);
-
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image = CubemapImage;
@@ -1210,17 +909,10 @@ void SkyboxRenderer::DestroySkyboxResources(VkDevice Device)
         CubemapView = VK_NULL_HANDLE;
     }
 
-    if (CubemapImage != VK_NULL_HANDLE)
-    {
-        vkDestroyImage(Device, CubemapImage, nullptr);
-        CubemapImage = VK_NULL_HANDLE;
-    }
-
-    if (CubemapMemory != VK_NULL_HANDLE)
-    {
-        vkFreeMemory(Device, CubemapMemory, nullptr);
-        CubemapMemory = VK_NULL_HANDLE;
-    }
+    /* A skybox swap can land before its upload was flushed. */
+    g_VulkanUploader.Wait(CubemapUpload);
+    CubemapUpload = 0;
+    g_VulkanAllocator.DestroyImage(CubemapImage, CubemapAllocation);
 }
 
 bool SkyboxRenderer::CreateDescriptorResources(VkDevice Device)
@@ -1296,11 +988,7 @@ void SkyboxRenderer::DestroyDescriptorResources(VkDevice Device)
     }
 }
 
-bool SkyboxRenderer::CreateVertexBuffer(
-    VkPhysicalDevice PhysicalDevice,
-    VkDevice Device,
-    VkQueue GraphicsQueue,
-    std::uint32_t GraphicsQueueFamily)
+bool SkyboxRenderer::CreateVertexBuffer()
 {
     const float vertices[] = {
         -1.0f,  1.0f, -1.0f,
@@ -1347,13 +1035,7 @@ bool SkyboxRenderer::CreateVertexBuffer(
     };
 
     VkDeviceSize size = sizeof(vertices);
-    if (!VertexBuffer.CreateVertexBuffer(
-        PhysicalDevice,
-        Device,
-        GraphicsQueue,
-        GraphicsQueueFamily,
-        vertices,
-        size))
+    if (!VertexBuffer.CreateVertexBuffer(vertices, size))
     {
         std::fprintf(stderr, "SkyboxRenderer: Vertex buffer upload failed\n");
         return false;
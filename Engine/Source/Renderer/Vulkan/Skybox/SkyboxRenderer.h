@@ -27,6 +27,8 @@
 
 #include "SkyboxPipeline.h"
 #include "../Core/VulkanBuffer.h"
+#include "../Core/VulkanMemoryAllocator.h"
+#include "../Core/VulkanUploadManager.h"
 #include "../../../Math/MathTypes.h"
 
 #include <vulkan/vulkan.h>
@@ -49,9 +51,7 @@ public:
     bool Create(
         VkDevice Device,
         VkPhysicalDevice PhysicalDevice,
-        VkRenderPass RenderPass,
-        VkQueue GraphicsQueue,
-        std::uint32_t GraphicsQueueFamily);
+        VkRenderPass RenderPass);
 
     /* Destroy skybox resources. */
     void Destroy(VkDevice Device);
@@ -69,9 +69,7 @@ public:
     bool SetActiveSkybox(
         const std::string& Name,
         VkDevice Device,
-        VkPhysicalDevice PhysicalDevice,
-        VkQueue GraphicsQueue,
-        std::uint32_t GraphicsQueueFamily);
+        VkPhysicalDevice PhysicalDevice);
 
     /* Get active skybox name. */
     const std::string& GetActiveSkyboxName() const;
@@ -97,9 +95,7 @@ private:
     bool LoadSkyboxResources(
         const SkyboxDefinition& Definition,
         VkDevice Device,
-        VkPhysicalDevice PhysicalDevice,
-        VkQueue GraphicsQueue,
-        std::uint32_t GraphicsQueueFamily);
+        VkPhysicalDevice PhysicalDevice);
 
     /* Destroy cubemap resources. */
     void DestroySkyboxResources(VkDevice Device);
@@ -111,11 +107,7 @@ private:
     void DestroyDescriptorResources(VkDevice Device);
 
     /* Create skybox vertex buffer. */
-    bool CreateVertexBuffer(
-        VkPhysicalDevice PhysicalDevice,
-        VkDevice Device,
-        VkQueue GraphicsQueue,
-        std::uint32_t GraphicsQueueFamily);
+    bool CreateVertexBuffer();
 
 private:
     std::string AssetsReadyRoot;
@@ -134,7 +126,8 @@ private:
     VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
 
     VkImage CubemapImage = VK_NULL_HANDLE;
-    VkDeviceMemory CubemapMemory = VK_NULL_HANDLE;
+    VulkanAllocation CubemapAllocation;
+    UploadToken CubemapUpload = 0;
     VkImageView CubemapView = VK_NULL_HANDLE;
     VkSampler CubemapSampler = VK_NULL_HANDLE;
 };
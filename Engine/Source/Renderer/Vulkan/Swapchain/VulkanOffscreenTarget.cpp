@@ -0,0 +1,344 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "VulkanOffscreenTarget.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    /* RGBA8 so readback rows are already in PNG channel order. */
+    constexpr VkFormat kOffscreenFormat = VK_FORMAT_R8G8B8A8_UNORM;
+    constexpr uint32_t kBytesPerPixel = 4;
+}
+
+/* Initialize empty target state. */
+VulkanOffscreenTarget::VulkanOffscreenTarget()
+    : ImageFormat(VK_FORMAT_UNDEFINED)
+    , Extent{}
+    , ReadbackBuffer(VK_NULL_HANDLE)
+    , ReadbackAllocation()
+    , CommandPool(VK_NULL_HANDLE)
+    , CommandBuffer(VK_NULL_HANDLE)
+    , ReadbackFence(VK_NULL_HANDLE)
+{
+}
+
+/* Destroy target object. */
+VulkanOffscreenTarget::~VulkanOffscreenTarget()
+{
+}
+
+/* Create colour images, views and the readback buffer. */
+bool VulkanOffscreenTarget::Create(
+    VkDevice Device,
+    uint32_t GraphicsQueueFamily,
+    uint32_t Width,
+    uint32_t Height,
+    uint32_t ImageCount)
+{
+    if (Width == 0 || Height == 0 || ImageCount == 0)
+    {
+        std::fprintf(stderr, "VulkanOffscreenTarget::Create: invalid extent or image count\n");
+        return false;
+    }
+
+    ImageFormat = kOffscreenFormat;
+    Extent = { Width, Height };
+
+    /* Create images the render pass resolves into and the readback copies from. */
+    Images.assign(ImageCount, VK_NULL_HANDLE);
+    ImageAllocations.assign(ImageCount, VulkanAllocation{});
+    ImageViews.assign(ImageCount, VK_NULL_HANDLE);
+
+    for (uint32_t i = 0; i < ImageCount; ++i)
+    {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = ImageFormat;
+        imageInfo.extent = { Width, Height, 1 };
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage =
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+            VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (!g_VulkanAllocator.CreateImage(
+            imageInfo,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            Images[i],
+            ImageAllocations[i]))
+        {
+            std::fprintf(stderr, "VulkanOffscreenTarget::Create: failed to create image\n");
+            Destroy(Device);
+            return false;
+        }
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = Images[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = ImageFormat;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(Device, &viewInfo, nullptr, &ImageViews[i]) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VulkanOffscreenTarget::Create: failed to create image view\n");
+            Destroy(Device);
+            return false;
+        }
+    }
+
+    /* Readback lands in one persistently mapped buffer sized for a full image. */
+    const VkDeviceSize readbackSize =
+        static_cast<VkDeviceSize>(Width) * Height * kBytesPerPixel;
+    if (!g_VulkanAllocator.CreateBuffer(
+        readbackSize,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        ReadbackBuffer,
+        ReadbackAllocation) ||
+        !ReadbackAllocation.Mapped)
+    {
+        std::fprintf(stderr, "VulkanOffscreenTarget::Create: failed to create readback buffer\n");
+        Destroy(Device);
+        return false;
+    }
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = GraphicsQueueFamily;
+
+    if (vkCreateCommandPool(Device, &poolInfo, nullptr, &CommandPool) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanOffscreenTarget::Create: failed to create command pool\n");
+        Destroy(Device);
+        return false;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = CommandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(Device, &allocInfo, &CommandBuffer) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanOffscreenTarget::Create: failed to allocate command buffer\n");
+        Destroy(Device);
+        return false;
+    }
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    if (vkCreateFence(Device, &fenceInfo, nullptr, &ReadbackFence) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanOffscreenTarget::Create: failed to create fence\n");
+        Destroy(Device);
+        return false;
+    }
+
+    return true;
+}
+
+/* Release images, views and readback resources. */
+void VulkanOffscreenTarget::Destroy(VkDevice Device)
+{
+    if (ReadbackFence != VK_NULL_HANDLE)
+    {
+        vkDestroyFence(Device, ReadbackFence, nullptr);
+        ReadbackFence = VK_NULL_HANDLE;
+    }
+
+    if (CommandPool != VK_NULL_HANDLE)
+    {
+        vkDestroyCommandPool(Device, CommandPool, nullptr);
+        CommandPool = VK_NULL_HANDLE;
+        CommandBuffer = VK_NULL_HANDLE;
+    }
+
+    g_VulkanAllocator.DestroyBuffer(ReadbackBuffer, ReadbackAllocation);
+
+    for (VkImageView view : ImageViews)
+    {
+        if (view != VK_NULL_HANDLE)
+        {
+            vkDestroyImageView(Device, view, nullptr);
+        }
+    }
+
+    for (std::size_t i = 0; i < Images.size(); ++i)
+    {
+        g_VulkanAllocator.DestroyImage(Images[i], ImageAllocations[i]);
+    }
+
+    ImageViews.clear();
+    Images.clear();
+    ImageAllocations.clear();
+    ImageFormat = VK_FORMAT_UNDEFINED;
+    Extent = {};
+}
+
+/* Copy one image to the CPU as tightly packed RGBA8 rows. */
+bool VulkanOffscreenTarget::Readback(
+    VkDevice Device,
+    VkQueue GraphicsQueue,
+    uint32_t ImageIndex,
+    std::vector<std::uint8_t>& OutPixels)
+{
+    if (ImageIndex >= Images.size() || CommandBuffer == VK_NULL_HANDLE)
+    {
+        std::fprintf(stderr, "VulkanOffscreenTarget::Readback: invalid image index\n");
+        return false;
+    }
+
+    /* Frames in flight may still be resolving into this image. */
+    vkQueueWaitIdle(GraphicsQueue);
+
+    vkResetCommandBuffer(CommandBuffer, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(CommandBuffer, &beginInfo);
+
+    /* The render pass already left the image a transfer source; only the */
+    /* resolve writes need to be made visible to the copy. */
+    VkImageMemoryBarrier toTransfer{};
+    toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toTransfer.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    toTransfer.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.image = Images[ImageIndex];
+    toTransfer.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    toTransfer.subresourceRange.baseMipLevel = 0;
+    toTransfer.subresourceRange.levelCount = 1;
+    toTransfer.subresourceRange.baseArrayLayer = 0;
+    toTransfer.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(
+        CommandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0, nullptr,
+        0, nullptr,
+        1, &toTransfer);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = { Extent.width, Extent.height, 1 };
+
+    vkCmdCopyImageToBuffer(
+        CommandBuffer,
+        Images[ImageIndex],
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        ReadbackBuffer,
+        1,
+        &region);
+
+    /* Make the copy visible to the mapped pointer. */
+    VkBufferMemoryBarrier toHost{};
+    toHost.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    toHost.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    toHost.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toHost.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toHost.buffer = ReadbackBuffer;
+    toHost.offset = 0;
+    toHost.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(
+        CommandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        0, nullptr,
+        1, &toHost,
+        0, nullptr);
+
+    vkEndCommandBuffer(CommandBuffer);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &CommandBuffer;
+
+    vkResetFences(Device, 1, &ReadbackFence);
+    if (vkQueueSubmit(GraphicsQueue, 1, &submitInfo, ReadbackFence) != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VulkanOffscreenTarget::Readback: vkQueueSubmit failed\n");
+        return false;
+    }
+
+    vkWaitForFences(Device, 1, &ReadbackFence, VK_TRUE, UINT64_MAX);
+
+    const std::size_t byteCount =
+        static_cast<std::size_t>(Extent.width) * Extent.height * kBytesPerPixel;
+    OutPixels.resize(byteCount);
+    std::memcpy(OutPixels.data(), ReadbackAllocation.Mapped, byteCount);
+
+    return true;
+}
+
+/* Get target image format. */
+VkFormat VulkanOffscreenTarget::GetImageFormat() const
+{
+    return ImageFormat;
+}
+
+/* Get target extent. */
+VkExtent2D VulkanOffscreenTarget::GetExtent() const
+{
+    return Extent;
+}
+
+/* Get image view handles. */
+std::vector<VkImageView> VulkanOffscreenTarget::GetImageViews() const
+{
+    return ImageViews;
+}
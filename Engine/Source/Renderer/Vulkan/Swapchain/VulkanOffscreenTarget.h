@@ -0,0 +1,93 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "../Core/VulkanMemoryAllocator.h"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+ /* Device images standing in for a swapchain when rendering headless. */
+class VulkanOffscreenTarget
+{
+public:
+    /* Initialize empty target state. */
+    VulkanOffscreenTarget();
+
+    /* Destroy target resources. */
+    ~VulkanOffscreenTarget();
+
+    /* Create colour images, views and the readback buffer. */
+    /* One image per frame in flight, so frames never wait on each other's target. */
+    bool Create(
+        VkDevice Device,
+        uint32_t GraphicsQueueFamily,
+        uint32_t Width,
+        uint32_t Height,
+        uint32_t ImageCount);
+
+    /* Release images, views and readback resources. */
+    void Destroy(VkDevice Device);
+
+    /* Copy one image to the CPU as tightly packed RGBA8 rows. */
+    /* Waits for the queue to go idle, so only call it between frames. */
+    bool Readback(
+        VkDevice Device,
+        VkQueue GraphicsQueue,
+        uint32_t ImageIndex,
+        std::vector<std::uint8_t>& OutPixels);
+
+    /* Get target image format. */
+    VkFormat GetImageFormat() const;
+
+    /* Get target extent. */
+    VkExtent2D GetExtent() const;
+
+    /* Get image view handles. */
+    std::vector<VkImageView> GetImageViews() const;
+
+private:
+    /* Colour images the renderer resolves into. */
+    std::vector<VkImage> Images;
+    std::vector<VulkanAllocation> ImageAllocations;
+    std::vector<VkImageView> ImageViews;
+
+    /* Target image format. */
+    VkFormat ImageFormat = VK_FORMAT_UNDEFINED;
+
+    /* Target resolution. */
+    VkExtent2D Extent{};
+
+    /* Host-visible copy destination, persistently mapped. */
+    VkBuffer ReadbackBuffer = VK_NULL_HANDLE;
+    VulkanAllocation ReadbackAllocation;
+
+    /* One-shot command buffer and fence for readback copies. */
+    VkCommandPool CommandPool = VK_NULL_HANDLE;
+    VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+    VkFence ReadbackFence = VK_NULL_HANDLE;
+};
@@ -27,9 +27,46 @@
 
 #include "../../Math/MathTypes.h"
 
+#include <cstdint>
+
+/* Read one component of a vector by axis index, 0 to 2. */
+inline float GetAxisComponent(const Vec3& Value, std::uint32_t Axis)
+{
+    if (Axis == 0)
+    {
+        return Value.x;
+    }
+
+    return Axis == 1 ? Value.y : Value.z;
+}
+
 /* Stores min and max corners in world space. */
 struct AABB
 {
     Vec3 Min = Vec3(0.0f, 0.0f, 0.0f);
     Vec3 Max = Vec3(0.0f, 0.0f, 0.0f);
+
+    /* Test whether two boxes overlap, touching counts as overlap. */
+    bool Overlaps(const AABB& Other) const
+    {
+        return Min.x <= Other.Max.x && Max.x >= Other.Min.x &&
+            Min.y <= Other.Max.y && Max.y >= Other.Min.y &&
+            Min.z <= Other.Max.z && Max.z >= Other.Min.z;
+    }
+
+    /* Bounds of this box after an affine transform. */
+    AABB Transformed(const Mat4& Model) const
+    {
+        const Vec3 Center = (Min + Max) * 0.5f;
+        const Vec3 Extents = (Max - Min) * 0.5f;
+
+        /* Project extents onto the absolute basis vectors. */
+        const Vec3 WorldCenter = Model.TransformPoint(Center);
+        const Vec3 WorldExtents(
+            std::fabs(Model.m[0]) * Extents.x + std::fabs(Model.m[4]) * Extents.y + std::fabs(Model.m[8]) * Extents.z,
+            std::fabs(Model.m[1]) * Extents.x + std::fabs(Model.m[5]) * Extents.y + std::fabs(Model.m[9]) * Extents.z,
+            std::fabs(Model.m[2]) * Extents.x + std::fabs(Model.m[6]) * Extents.y + std::fabs(Model.m[10]) * Extents.z);
+
+        return AABB{ WorldCenter - WorldExtents, WorldCenter + WorldExtents };
+    }
 };
@@ -23,23 +23,19 @@
  * THE SOFTWARE.
  */
 
-#pragma once
+#include "Broadphase.h"
 
-#include <cstdint>
-#include <vector>
+#include "SweepAndPrune.h"
 
- /* Raw texture pixel data container. */
-struct TextureData
+/* Create a broadphase of the requested type. */
+std::unique_ptr<IBroadphase> CreateBroadphase(BroadphaseType type)
 {
-    /* Texture width in pixels. */
-    std::uint32_t Width = 0;
+    switch (type)
+    {
+    case BroadphaseType::SweepAndPrune:
+        return std::make_unique<SweepAndPrune>();
+    }
 
-    /* Texture height in pixels. */
-    std::uint32_t Height = 0;
-
-    /* RGBA pixel buffer. */
-    std::vector<std::uint8_t> Pixels;
-};
-
-/* Load PNG texture using WIC backend. */
-bool LoadPngWic(const char* Path, TextureData& OutData);
+    /* Unknown types fall back to sweep-and-prune. */
+    return std::make_unique<SweepAndPrune>();
+}
@@ -0,0 +1,78 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "AABB.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/* Potentially overlapping pair of proxy ids, with A < B. */
+struct BroadphasePair
+{
+    std::uint32_t A = 0;
+    std::uint32_t B = 0;
+};
+
+/* Available broadphase implementations, chosen per level. */
+enum class BroadphaseType
+{
+    SweepAndPrune
+};
+
+/* Common overlap-pair interface for all broadphase implementations. */
+class IBroadphase
+{
+public:
+    virtual ~IBroadphase() = default;
+
+    /* Insert a proxy or update the bounds of an existing one. */
+    virtual void SetBounds(std::uint32_t id, const AABB& bounds) = 0;
+
+    /* Remove a proxy, ignoring unknown ids. */
+    virtual void Remove(std::uint32_t id) = 0;
+
+    /* Remove every proxy. */
+    virtual void Clear() = 0;
+
+    /* Bring internal acceleration data up to date with the latest bounds. */
+    virtual void Update() = 0;
+
+    /* Collect all overlapping pairs, call Update first. */
+    virtual void FindPairs(std::vector<BroadphasePair>& outPairs) = 0;
+
+    /* Collect ids whose bounds overlap the query box, call Update first. */
+    virtual void QueryAABB(
+        const AABB& bounds,
+        std::vector<std::uint32_t>& outIds) const = 0;
+
+    /* Number of live proxies. */
+    virtual std::uint32_t GetProxyCount() const = 0;
+};
+
+/* Create a broadphase of the requested type. */
+std::unique_ptr<IBroadphase> CreateBroadphase(BroadphaseType type);
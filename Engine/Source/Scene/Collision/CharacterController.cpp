@@ -0,0 +1,453 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "CharacterController.h"
+
+#include "Ray.h"
+#include "Scene/Scene.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+/* Local helpers. */
+namespace
+{
+    /* Moves shorter than this are treated as finished. */
+    constexpr float kMinMoveDistance = 1e-5f;
+
+    /* Unit vector along an axis with a sign. */
+    Vec3 AxisNormal(std::uint32_t axis, float sign)
+    {
+        if (axis == 0)
+        {
+            return Vec3(sign, 0.0f, 0.0f);
+        }
+
+        return axis == 1 ? Vec3(0.0f, sign, 0.0f) : Vec3(0.0f, 0.0f, sign);
+    }
+
+    /* Ray against a box, reporting the face normal of the entry point. */
+    /* Starting inside reports the nearest face as the push-out normal. */
+    bool IntersectSegmentBox(
+        const Vec3& origin,
+        const Vec3& direction,
+        float maxDistance,
+        const AABB& bounds,
+        float& outDistance,
+        Vec3& outNormal)
+    {
+        const bool startInside =
+            origin.x >= bounds.Min.x && origin.x <= bounds.Max.x &&
+            origin.y >= bounds.Min.y && origin.y <= bounds.Max.y &&
+            origin.z >= bounds.Min.z && origin.z <= bounds.Max.z;
+
+        if (!startInside)
+        {
+            const Vec3 inverseDirection(
+                SafeReciprocal(direction.x),
+                SafeReciprocal(direction.y),
+                SafeReciprocal(direction.z));
+
+            float enter = 0.0f;
+            if (!IntersectSlabs(bounds, origin, inverseDirection, maxDistance, enter))
+            {
+                return false;
+            }
+
+            /* The entry face belongs to the slab entered last. */
+            float latest = -FLT_MAX;
+            for (std::uint32_t axis = 0; axis < 3; ++axis)
+            {
+                const float inverse = GetAxisComponent(inverseDirection, axis);
+                const bool increasing = inverse >= 0.0f;
+                const float face = GetAxisComponent(increasing ? bounds.Min : bounds.Max, axis);
+                const float distance = (face - GetAxisComponent(origin, axis)) * inverse;
+                if (distance > latest)
+                {
+                    latest = distance;
+                    outNormal = AxisNormal(axis, increasing ? -1.0f : 1.0f);
+                }
+            }
+
+            outDistance = enter;
+            return true;
+        }
+
+        /* Already overlapping, push out through the closest face. */
+        float bestDepth = FLT_MAX;
+        for (std::uint32_t axis = 0; axis < 3; ++axis)
+        {
+            const float start = GetAxisComponent(origin, axis);
+            const float toMin = start - GetAxisComponent(bounds.Min, axis);
+            const float toMax = GetAxisComponent(bounds.Max, axis) - start;
+
+            if (toMin < bestDepth)
+            {
+                bestDepth = toMin;
+                outNormal = AxisNormal(axis, -1.0f);
+            }
+            if (toMax < bestDepth)
+            {
+                bestDepth = toMax;
+                outNormal = AxisNormal(axis, 1.0f);
+            }
+        }
+
+        /* Moving out of the box is always allowed. */
+        if (Vec3::Dot(direction, outNormal) >= 0.0f)
+        {
+            return false;
+        }
+
+        outDistance = 0.0f;
+        return true;
+    }
+
+    /* Earliest entry of a ray into a sphere, ignoring starts inside it. */
+    bool IntersectSegmentSphere(
+        const Vec3& origin,
+        const Vec3& direction,
+        float maxDistance,
+        const Vec3& center,
+        float radius,
+        float& outDistance,
+        Vec3& outNormal)
+    {
+        const Vec3 offset = origin - center;
+        const float b = Vec3::Dot(offset, direction);
+        const float c = Vec3::Dot(offset, offset) - radius * radius;
+        if (c > 0.0f && b > 0.0f)
+        {
+            return false;
+        }
+
+        const float discriminant = b * b - c;
+        if (discriminant < 0.0f)
+        {
+            return false;
+        }
+
+        const float distance = -b - std::sqrt(discriminant);
+        if (distance < 0.0f || distance > maxDistance)
+        {
+            return false;
+        }
+
+        outDistance = distance;
+        outNormal = (origin + direction * distance - center) * (1.0f / radius);
+        return true;
+    }
+
+    /* Earliest entry of a ray into the capsule around segment a-b. */
+    bool IntersectSegmentCapsule(
+        const Vec3& origin,
+        const Vec3& direction,
+        float maxDistance,
+        const Vec3& a,
+        const Vec3& b,
+        float radius,
+        float& outDistance,
+        Vec3& outNormal)
+    {
+        bool hit = false;
+        outDistance = maxDistance;
+
+        /* Side of the cylinder, solved in the plane across the segment. */
+        const Vec3 axis = b - a;
+        const Vec3 offset = origin - a;
+        const float dd = Vec3::Dot(axis, axis);
+        const float md = Vec3::Dot(offset, axis);
+        const float nd = Vec3::Dot(direction, axis);
+        const float quadA = dd - nd * nd;
+        const float quadB = dd * Vec3::Dot(offset, direction) - nd * md;
+        const float quadC = dd * (Vec3::Dot(offset, offset) - radius * radius) - md * md;
+
+        if (quadA > 1e-8f * dd)
+        {
+            const float discriminant = quadB * quadB - quadA * quadC;
+            if (discriminant >= 0.0f)
+            {
+                const float distance = (-quadB - std::sqrt(discriminant)) / quadA;
+                const float along = md + distance * nd;
+                if (distance >= 0.0f && distance <= outDistance && along >= 0.0f && along <= dd)
+                {
+                    const Vec3 point = origin + direction * distance;
+                    const Vec3 closest = a + axis * (along / dd);
+                    outDistance = distance;
+                    outNormal = (point - closest) * (1.0f / radius);
+                    hit = true;
+                }
+            }
+        }
+
+        /* End caps. */
+        float capDistance = 0.0f;
+        Vec3 capNormal;
+        if (IntersectSegmentSphere(origin, direction, outDistance, a, radius, capDistance, capNormal))
+        {
+            outDistance = capDistance;
+            outNormal = capNormal;
+            hit = true;
+        }
+        if (IntersectSegmentSphere(origin, direction, outDistance, b, radius, capDistance, capNormal))
+        {
+            outDistance = capDistance;
+            outNormal = capNormal;
+            hit = true;
+        }
+
+        return hit;
+    }
+
+    /* Sphere moving along a ray against a box, exact at edges and corners. */
+    /* The box grown by the radius is tested first; entries in an edge or */
+    /* corner region of that box are refined against the rounded capsules. */
+    bool IntersectSweptSphereBox(
+        const Vec3& origin,
+        const Vec3& direction,
+        float maxDistance,
+        const AABB& bounds,
+        float radius,
+        float& outDistance,
+        Vec3& outNormal)
+    {
+        if (radius <= 0.0f)
+        {
+            return IntersectSegmentBox(origin, direction, maxDistance, bounds, outDistance, outNormal);
+        }
+
+        AABB grownBounds;
+        grownBounds.Min = bounds.Min - Vec3(radius, radius, radius);
+        grownBounds.Max = bounds.Max + Vec3(radius, radius, radius);
+
+        /* Starting inside the grown box, the region comes from the origin itself. */
+        const bool startInside =
+            origin.x >= grownBounds.Min.x && origin.x <= grownBounds.Max.x &&
+            origin.y >= grownBounds.Min.y && origin.y <= grownBounds.Max.y &&
+            origin.z >= grownBounds.Min.z && origin.z <= grownBounds.Max.z;
+
+        outDistance = 0.0f;
+        if (!startInside &&
+            !IntersectSegmentBox(origin, direction, maxDistance, grownBounds, outDistance, outNormal))
+        {
+            return false;
+        }
+
+        /* Which side of the original box the entry point lies on, per axis. */
+        const Vec3 point = origin + direction * outDistance;
+        float low[3];
+        float high[3];
+        int side[3];
+        std::uint32_t outsideCount = 0;
+        for (std::uint32_t axis = 0; axis < 3; ++axis)
+        {
+            const float value = GetAxisComponent(point, axis);
+            low[axis] = GetAxisComponent(bounds.Min, axis);
+            high[axis] = GetAxisComponent(bounds.Max, axis);
+            side[axis] = value < low[axis] ? -1 : (value > high[axis] ? 1 : 0);
+            outsideCount += side[axis] != 0 ? 1u : 0u;
+        }
+
+        /* Face regions match the grown box exactly, including its push-out. */
+        if (outsideCount <= 1)
+        {
+            return !startInside ||
+                IntersectSegmentBox(origin, direction, maxDistance, grownBounds, outDistance, outNormal);
+        }
+
+        /* Overlapping a rounded edge or corner: moving in is blocked, out is allowed. */
+        if (startInside)
+        {
+            const Vec3 closest(
+                std::clamp(origin.x, bounds.Min.x, bounds.Max.x),
+                std::clamp(origin.y, bounds.Min.y, bounds.Max.y),
+                std::clamp(origin.z, bounds.Min.z, bounds.Max.z));
+            const Vec3 away = origin - closest;
+            const float gap = away.Length();
+            if (gap <= radius)
+            {
+                outNormal = away * (1.0f / gap);
+                return Vec3::Dot(direction, outNormal) < 0.0f;
+            }
+        }
+
+        /* Test the edges meeting in the region: one for an edge, three for a corner. */
+        bool hit = false;
+        float bestDistance = maxDistance;
+        for (std::uint32_t edgeAxis = 0; edgeAxis < 3; ++edgeAxis)
+        {
+            if (outsideCount == 2 && side[edgeAxis] != 0)
+            {
+                continue;
+            }
+
+            float start[3];
+            float end[3];
+            for (std::uint32_t axis = 0; axis < 3; ++axis)
+            {
+                const float corner = side[axis] < 0 ? low[axis] : high[axis];
+                start[axis] = axis == edgeAxis ? low[axis] : corner;
+                end[axis] = axis == edgeAxis ? high[axis] : corner;
+            }
+
+            float edgeDistance = 0.0f;
+            Vec3 edgeNormal;
+            if (IntersectSegmentCapsule(
+                    origin,
+                    direction,
+                    bestDistance,
+                    Vec3(start[0], start[1], start[2]),
+                    Vec3(end[0], end[1], end[2]),
+                    radius,
+                    edgeDistance,
+                    edgeNormal))
+            {
+                bestDistance = edgeDistance;
+                outNormal = edgeNormal;
+                hit = true;
+            }
+        }
+
+        outDistance = bestDistance;
+        return hit;
+    }
+}
+
+/* Initialize controller defaults. */
+CharacterController::CharacterController()
+{
+    /* Members default-initialize, nothing required here. */
+}
+
+/* Controller cleanup handled by containers. */
+CharacterController::~CharacterController()
+{
+}
+
+/* Collision sphere radius. */
+void CharacterController::SetRadius(float newRadius)
+{
+    radius = std::max(0.0f, newRadius);
+}
+
+/* Collision sphere radius. */
+float CharacterController::GetRadius() const
+{
+    return radius;
+}
+
+/* Gap kept between the sphere and surfaces after a hit. */
+void CharacterController::SetSkinWidth(float newSkinWidth)
+{
+    skinWidth = std::max(0.0f, newSkinWidth);
+}
+
+/* Maximum slide planes resolved per move. */
+void CharacterController::SetMaxIterations(std::uint32_t newMaxIterations)
+{
+    maxIterations = std::max(1u, newMaxIterations);
+}
+
+/* Sweep from start towards target and return the resolved position. */
+Vec3 CharacterController::Move(const Scene& scene, const Vec3& start, const Vec3& target)
+{
+    Vec3 position = start;
+    Vec3 remaining = target - start;
+
+    for (std::uint32_t iteration = 0; iteration < maxIterations; ++iteration)
+    {
+        const float distance = remaining.Length();
+        if (distance < kMinMoveDistance)
+        {
+            break;
+        }
+
+        const Vec3 direction = remaining * (1.0f / distance);
+
+        float hitDistance = 0.0f;
+        Vec3 hitNormal;
+        if (!SweepSphere(scene, position, direction, distance, hitDistance, hitNormal))
+        {
+            position = position + remaining;
+            break;
+        }
+
+        /* Advance up to the contact, keeping a small skin gap. */
+        const float travel = std::max(0.0f, hitDistance - skinWidth);
+        position = position + direction * travel;
+
+        /* Slide the leftover motion along the contact plane. */
+        const Vec3 leftover = direction * (distance - travel);
+        remaining = leftover - hitNormal * Vec3::Dot(leftover, hitNormal);
+    }
+
+    return position;
+}
+
+/* Earliest hit of the sphere moving along a segment. */
+bool CharacterController::SweepSphere(
+    const Scene& scene,
+    const Vec3& origin,
+    const Vec3& direction,
+    float distance,
+    float& outDistance,
+    Vec3& outNormal)
+{
+    /* Broadphase region covering the whole swept path. */
+    const Vec3 end = origin + direction * distance;
+    const Vec3 padding(radius + skinWidth, radius + skinWidth, radius + skinWidth);
+
+    AABB sweptBounds;
+    sweptBounds.Min = Vec3(std::min(origin.x, end.x), std::min(origin.y, end.y), std::min(origin.z, end.z)) - padding;
+    sweptBounds.Max = Vec3(std::max(origin.x, end.x), std::max(origin.y, end.y), std::max(origin.z, end.z)) + padding;
+
+    scene.QueryWorldBounds(sweptBounds, nearbyIds);
+
+    bool hit = false;
+    outDistance = distance;
+
+    /* Exact sphere sweep, so the sphere rounds edges and corners. */
+    for (const std::uint32_t id : nearbyIds)
+    {
+        AABB bounds;
+        if (!scene.GetWorldBounds(Entity(id), bounds))
+        {
+            continue;
+        }
+
+        float entryDistance = 0.0f;
+        Vec3 normal;
+        if (IntersectSweptSphereBox(origin, direction, outDistance, bounds, radius, entryDistance, normal) &&
+            entryDistance <= outDistance)
+        {
+            outDistance = entryDistance;
+            outNormal = normal;
+            hit = true;
+        }
+    }
+
+    return hit;
+}
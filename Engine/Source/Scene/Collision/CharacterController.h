@@ -0,0 +1,73 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "AABB.h"
+
+#include <cstdint>
+#include <vector>
+
+class Scene;
+
+/* Swept-sphere mover that slides along scene bounds. */
+/* Only bounds near the swept path are visited, found through the scene broadphase. */
+class CharacterController
+{
+public:
+    CharacterController();
+    ~CharacterController();
+
+    /* Collision sphere radius. */
+    void SetRadius(float newRadius);
+    float GetRadius() const;
+
+    /* Gap kept between the sphere and surfaces after a hit. */
+    void SetSkinWidth(float newSkinWidth);
+
+    /* Maximum slide planes resolved per move. */
+    void SetMaxIterations(std::uint32_t newMaxIterations);
+
+    /* Sweep from start towards target and return the resolved position. */
+    Vec3 Move(const Scene& scene, const Vec3& start, const Vec3& target);
+
+private:
+    /* Earliest hit of the sphere moving along a segment. */
+    bool SweepSphere(
+        const Scene& scene,
+        const Vec3& origin,
+        const Vec3& direction,
+        float distance,
+        float& outDistance,
+        Vec3& outNormal);
+
+private:
+    float radius = 0.25f;
+    float skinWidth = 0.01f;
+    std::uint32_t maxIterations = 4;
+
+    /* Broadphase results, reused across moves. */
+    std::vector<std::uint32_t> nearbyIds;
+};
@@ -0,0 +1,184 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Frustum.h"
+
+#include "Engine/ParallelFor.h"
+
+#include <cmath>
+
+/* Local helpers. */
+namespace
+{
+    /* Row of a column-major matrix. */
+    void GetRow(const Mat4& matrix, std::uint32_t row, float outRow[4])
+    {
+        outRow[0] = matrix.m[row];
+        outRow[1] = matrix.m[4 + row];
+        outRow[2] = matrix.m[8 + row];
+        outRow[3] = matrix.m[12 + row];
+    }
+
+    /* Combine two rows into a normalized plane. */
+    void SetPlane(float outPlane[4], const float a[4], const float b[4], float sign)
+    {
+        for (std::uint32_t index = 0; index < 4; ++index)
+        {
+            outPlane[index] = a[index] + sign * b[index];
+        }
+
+        const float length = std::sqrt(
+            outPlane[0] * outPlane[0] + outPlane[1] * outPlane[1] + outPlane[2] * outPlane[2]);
+        if (length > 0.0f)
+        {
+            for (std::uint32_t index = 0; index < 4; ++index)
+            {
+                outPlane[index] /= length;
+            }
+        }
+    }
+}
+
+/* Extract planes from a view-projection matrix with 0..1 clip depth. */
+Frustum Frustum::FromViewProjection(const Mat4& viewProjection)
+{
+    float rows[4][4];
+    for (std::uint32_t row = 0; row < 4; ++row)
+    {
+        GetRow(viewProjection, row, rows[row]);
+    }
+
+    const float zero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    Frustum frustum{};
+    SetPlane(frustum.Planes[0], rows[3], rows[0], 1.0f);
+    SetPlane(frustum.Planes[1], rows[3], rows[0], -1.0f);
+    SetPlane(frustum.Planes[2], rows[3], rows[1], 1.0f);
+    SetPlane(frustum.Planes[3], rows[3], rows[1], -1.0f);
+    SetPlane(frustum.Planes[4], zero, rows[2], 1.0f);
+    SetPlane(frustum.Planes[5], rows[3], rows[2], -1.0f);
+    return frustum;
+}
+
+/* Conservative box test, true when the box may be visible. */
+bool Frustum::Intersects(const AABB& bounds) const
+{
+    for (const float* plane : Planes)
+    {
+        /* Corner furthest along the plane normal. */
+        const float x = plane[0] >= 0.0f ? bounds.Max.x : bounds.Min.x;
+        const float y = plane[1] >= 0.0f ? bounds.Max.y : bounds.Min.y;
+        const float z = plane[2] >= 0.0f ? bounds.Max.z : bounds.Min.z;
+
+        if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Write 1 per packed entry that intersects the frustum, 0 otherwise. */
+std::uint32_t CullPackedBounds(
+    const Frustum& frustum,
+    const PackedBounds& bounds,
+    std::vector<std::uint8_t>& outVisible,
+    std::uint32_t minPerWorker)
+{
+    const std::uint32_t count = bounds.GetCount();
+    outVisible.resize(count);
+
+    const std::uint32_t workerCount = GetParallelWorkerCount(count, minPerWorker);
+    std::vector<std::uint32_t> visibleCounts(workerCount, 0);
+
+    ParallelFor(count, workerCount,
+        [&](std::uint32_t worker, std::uint32_t begin, std::uint32_t end)
+        {
+            /* Plane terms as locals: the byte output may alias anything, */
+            /* so reading them through the frustum reloads them per box. */
+            float normalX[6];
+            float normalY[6];
+            float normalZ[6];
+            float offset[6];
+            float absX[6];
+            float absY[6];
+            float absZ[6];
+            for (std::uint32_t plane = 0; plane < 6; ++plane)
+            {
+                normalX[plane] = frustum.Planes[plane][0];
+                normalY[plane] = frustum.Planes[plane][1];
+                normalZ[plane] = frustum.Planes[plane][2];
+                offset[plane] = frustum.Planes[plane][3];
+                absX[plane] = std::fabs(normalX[plane]);
+                absY[plane] = std::fabs(normalY[plane]);
+                absZ[plane] = std::fabs(normalZ[plane]);
+            }
+
+            const float* minX = bounds.MinX.data();
+            const float* minY = bounds.MinY.data();
+            const float* minZ = bounds.MinZ.data();
+            const float* maxX = bounds.MaxX.data();
+            const float* maxY = bounds.MaxY.data();
+            const float* maxZ = bounds.MaxZ.data();
+            std::uint8_t* visible = outVisible.data();
+
+            /* Branch-free center/extent test so the loop vectorizes. */
+            std::uint32_t visibleCount = 0;
+            for (std::uint32_t index = begin; index < end; ++index)
+            {
+                const float centerX = (minX[index] + maxX[index]) * 0.5f;
+                const float centerY = (minY[index] + maxY[index]) * 0.5f;
+                const float centerZ = (minZ[index] + maxZ[index]) * 0.5f;
+                const float extentX = (maxX[index] - minX[index]) * 0.5f;
+                const float extentY = (maxY[index] - minY[index]) * 0.5f;
+                const float extentZ = (maxZ[index] - minZ[index]) * 0.5f;
+
+                std::uint32_t inside = 1;
+                for (std::uint32_t plane = 0; plane < 6; ++plane)
+                {
+                    const float distance =
+                        normalX[plane] * centerX + normalY[plane] * centerY +
+                        normalZ[plane] * centerZ + offset[plane];
+                    const float radius =
+                        absX[plane] * extentX + absY[plane] * extentY + absZ[plane] * extentZ;
+                    inside &= distance + radius >= 0.0f ? 1u : 0u;
+                }
+
+                visible[index] = static_cast<std::uint8_t>(inside);
+                visibleCount += inside;
+            }
+
+            visibleCounts[worker] = visibleCount;
+        });
+
+    std::uint32_t total = 0;
+    for (const std::uint32_t visibleCount : visibleCounts)
+    {
+        total += visibleCount;
+    }
+
+    return total;
+}
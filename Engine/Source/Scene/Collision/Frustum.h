@@ -0,0 +1,56 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "AABB.h"
+#include "PackedBounds.h"
+
+#include <cstdint>
+#include <vector>
+
+/* Six inward-facing planes (nx, ny, nz, d), inside when n.p + d >= 0. */
+struct Frustum
+{
+    /* Left, right, bottom, top, near, far. */
+    float Planes[6][4] = {};
+
+    /* Extract planes from a view-projection matrix with 0..1 clip depth. */
+    static Frustum FromViewProjection(const Mat4& viewProjection);
+
+    /* Conservative box test, true when the box may be visible. */
+    bool Intersects(const AABB& bounds) const;
+};
+
+/* Minimum packed entries per worker before culling goes parallel. */
+constexpr std::uint32_t kFrustumCullMinPerWorker = 4096;
+
+/* Write 1 per packed entry that intersects the frustum, 0 otherwise. */
+/* Runs over contiguous ranges on worker threads, returns the visible count. */
+std::uint32_t CullPackedBounds(
+    const Frustum& frustum,
+    const PackedBounds& bounds,
+    std::vector<std::uint8_t>& outVisible,
+    std::uint32_t minPerWorker = kFrustumCullMinPerWorker);
@@ -0,0 +1,571 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "OcclusionBuffer.h"
+
+#include "Engine/ParallelFor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define OCCLUSION_USE_SSE 1
+#endif
+
+/* Local helpers. */
+namespace
+{
+    /* Default resolution, wide enough for 16:9 views. */
+    constexpr std::uint32_t kDefaultWidth = 256;
+    constexpr std::uint32_t kDefaultHeight = 128;
+
+    /* Depth of an empty pixel. */
+    constexpr float kClearDepth = 1.0f;
+
+    /* Degenerate triangles below this screen area are skipped. */
+    constexpr float kMinTriangleArea = 1e-8f;
+
+    /* Work sizes below which a stage stays on the calling thread. */
+    constexpr std::uint32_t kMinOccludersPerWorker = 4;
+    constexpr std::uint32_t kMinTrianglesForBands = 64;
+    constexpr std::uint32_t kMinTestsPerWorker = 1024;
+
+    /* Transform an object-space point to clip space. */
+    void TransformToClip(const Mat4& matrix, const Vec3& point, float outClip[4])
+    {
+        for (std::uint32_t row = 0; row < 4; ++row)
+        {
+            outClip[row] =
+                matrix.m[row] * point.x +
+                matrix.m[4 + row] * point.y +
+                matrix.m[8 + row] * point.z +
+                matrix.m[12 + row];
+        }
+    }
+
+    /* Round up to a multiple of the block size, at least one block. */
+    std::uint32_t RoundUpToBlock(std::uint32_t value)
+    {
+        const std::uint32_t blocks =
+            std::max(1u, (value + OcclusionBuffer::kBlockSize - 1) / OcclusionBuffer::kBlockSize);
+        return blocks * OcclusionBuffer::kBlockSize;
+    }
+}
+
+/* Initialize a buffer at the default resolution. */
+OcclusionBuffer::OcclusionBuffer()
+{
+    Resize(kDefaultWidth, kDefaultHeight);
+}
+
+/* Buffer cleanup handled by containers. */
+OcclusionBuffer::~OcclusionBuffer()
+{
+}
+
+/* Buffer resolution, rounded up to whole blocks. */
+void OcclusionBuffer::Resize(std::uint32_t newWidth, std::uint32_t newHeight)
+{
+    width = RoundUpToBlock(newWidth);
+    height = RoundUpToBlock(newHeight);
+    blocksX = width / kBlockSize;
+    blocksY = height / kBlockSize;
+
+    depth.assign(static_cast<std::size_t>(width) * height, kClearDepth);
+    blockMaxDepth.assign(static_cast<std::size_t>(blocksX) * blocksY, kClearDepth);
+    triangles.clear();
+}
+
+/* Buffer resolution, rounded up to whole blocks. */
+std::uint32_t OcclusionBuffer::GetWidth() const
+{
+    return width;
+}
+
+/* Buffer resolution, rounded up to whole blocks. */
+std::uint32_t OcclusionBuffer::GetHeight() const
+{
+    return height;
+}
+
+/* Start a frame, clearing depth and queued occluders. */
+void OcclusionBuffer::Begin(const Mat4& newViewProjection)
+{
+    viewProjection = newViewProjection;
+    std::fill(depth.begin(), depth.end(), kClearDepth);
+    std::fill(blockMaxDepth.begin(), blockMaxDepth.end(), kClearDepth);
+    occluders.clear();
+    triangles.clear();
+}
+
+/* Queue an object-space triangle list, empty indices mean unindexed. */
+void OcclusionBuffer::AddOccluder(
+    const std::vector<Vec3>& positions,
+    const std::vector<std::uint32_t>& indices,
+    const Mat4& model)
+{
+    const std::size_t count = indices.empty() ? positions.size() : indices.size();
+    if (count < 3)
+    {
+        return;
+    }
+
+    Occluder occluder{};
+    occluder.Positions = positions.data();
+    occluder.Indices = indices.empty() ? nullptr : indices.data();
+    occluder.TriangleCount = static_cast<std::uint32_t>(count / 3);
+    occluder.Model = model;
+    occluders.push_back(occluder);
+}
+
+/* Transform, clip and rasterize every queued occluder. */
+void OcclusionBuffer::Rasterize()
+{
+    triangles.clear();
+
+    /* Begin already cleared the depth. ParallelFor runs nothing for an */
+    /* empty range, so the worker lists would still hold old triangles. */
+    const std::uint32_t occluderCount = static_cast<std::uint32_t>(occluders.size());
+    if (occluderCount == 0)
+    {
+        return;
+    }
+
+    /* Project occluders on workers, then concatenate in occluder order. */
+    const std::uint32_t transformWorkers = GetParallelWorkerCount(occluderCount, kMinOccludersPerWorker);
+    workerTriangles.resize(transformWorkers);
+
+    ParallelFor(occluderCount, transformWorkers,
+        [this](std::uint32_t worker, std::uint32_t begin, std::uint32_t end)
+        {
+            std::vector<ScreenTriangle>& output = workerTriangles[worker];
+            output.clear();
+
+            for (std::uint32_t index = begin; index < end; ++index)
+            {
+                const Occluder& occluder = occluders[index];
+                const Mat4 modelViewProjection = viewProjection * occluder.Model;
+
+                for (std::uint32_t triangle = 0; triangle < occluder.TriangleCount; ++triangle)
+                {
+                    float clip[3][4];
+                    for (std::uint32_t corner = 0; corner < 3; ++corner)
+                    {
+                        const std::uint32_t vertex = triangle * 3 + corner;
+                        const std::uint32_t position =
+                            occluder.Indices ? occluder.Indices[vertex] : vertex;
+                        TransformToClip(modelViewProjection, occluder.Positions[position], clip[corner]);
+                    }
+
+                    AppendClipTriangle(clip, output);
+                }
+            }
+        });
+
+    for (std::uint32_t worker = 0; worker < transformWorkers; ++worker)
+    {
+        triangles.insert(triangles.end(), workerTriangles[worker].begin(), workerTriangles[worker].end());
+    }
+
+    /* Each worker owns whole block rows, so no two workers touch a pixel. */
+    const std::uint32_t bandWorkers =
+        triangles.size() < kMinTrianglesForBands ? 1 : GetParallelWorkerCount(blocksY, 1);
+
+    ParallelFor(blocksY, bandWorkers,
+        [this](std::uint32_t, std::uint32_t begin, std::uint32_t end)
+        {
+            const std::int32_t beginRow = static_cast<std::int32_t>(begin * kBlockSize);
+            const std::int32_t endRow = static_cast<std::int32_t>(end * kBlockSize);
+
+            for (const ScreenTriangle& triangle : triangles)
+            {
+                if (triangle.MaxY >= beginRow && triangle.MinY < endRow)
+                {
+                    RasterizeTriangle(triangle, beginRow, endRow);
+                }
+            }
+
+            UpdateBlockDepth(begin, end);
+        });
+}
+
+/* True once Rasterize has written at least one triangle. */
+bool OcclusionBuffer::HasOccluders() const
+{
+    return !triangles.empty();
+}
+
+/* Conservative test, false only when the box is fully hidden. */
+bool OcclusionBuffer::IsVisible(const AABB& bounds) const
+{
+    if (triangles.empty())
+    {
+        return true;
+    }
+
+    float minX = 1e30f;
+    float minY = 1e30f;
+    float maxX = -1e30f;
+    float maxY = -1e30f;
+    float nearestDepth = 1e30f;
+
+    for (std::uint32_t corner = 0; corner < 8; ++corner)
+    {
+        const Vec3 point(
+            (corner & 1) ? bounds.Max.x : bounds.Min.x,
+            (corner & 2) ? bounds.Max.y : bounds.Min.y,
+            (corner & 4) ? bounds.Max.z : bounds.Min.z);
+
+        float clip[4];
+        TransformToClip(viewProjection, point, clip);
+
+        /* Boxes reaching the near plane are always treated as visible. */
+        if (clip[2] <= 0.0f || clip[3] <= 0.0f)
+        {
+            return true;
+        }
+
+        const float inverseW = 1.0f / clip[3];
+        const float screenX = (clip[0] * inverseW * 0.5f + 0.5f) * static_cast<float>(width);
+        const float screenY = (clip[1] * inverseW * 0.5f + 0.5f) * static_cast<float>(height);
+
+        minX = std::min(minX, screenX);
+        minY = std::min(minY, screenY);
+        maxX = std::max(maxX, screenX);
+        maxY = std::max(maxY, screenY);
+        nearestDepth = std::min(nearestDepth, clip[2] * inverseW);
+    }
+
+    /* Off-screen boxes are left to the frustum test. */
+    if (maxX < 0.0f || maxY < 0.0f ||
+        minX >= static_cast<float>(width) || minY >= static_cast<float>(height))
+    {
+        return true;
+    }
+
+    /* Every pixel the screen rectangle touches. */
+    const std::uint32_t beginX = static_cast<std::uint32_t>(std::max(0.0f, std::floor(minX)));
+    const std::uint32_t beginY = static_cast<std::uint32_t>(std::max(0.0f, std::floor(minY)));
+    const std::uint32_t endX = static_cast<std::uint32_t>(std::min(static_cast<float>(width - 1), std::floor(maxX)));
+    const std::uint32_t endY = static_cast<std::uint32_t>(std::min(static_cast<float>(height - 1), std::floor(maxY)));
+
+    for (std::uint32_t blockY = beginY / kBlockSize; blockY <= endY / kBlockSize; ++blockY)
+    {
+        for (std::uint32_t blockX = beginX / kBlockSize; blockX <= endX / kBlockSize; ++blockX)
+        {
+            /* The whole block sits in front of the box. */
+            if (blockMaxDepth[blockY * blocksX + blockX] < nearestDepth)
+            {
+                continue;
+            }
+
+            const std::uint32_t rowBegin = std::max(beginY, blockY * kBlockSize);
+            const std::uint32_t rowEnd = std::min(endY, blockY * kBlockSize + kBlockSize - 1);
+            const std::uint32_t columnBegin = std::max(beginX, blockX * kBlockSize);
+            const std::uint32_t columnEnd = std::min(endX, blockX * kBlockSize + kBlockSize - 1);
+
+            for (std::uint32_t row = rowBegin; row <= rowEnd; ++row)
+            {
+                const float* line = depth.data() + static_cast<std::size_t>(row) * width;
+                for (std::uint32_t column = columnBegin; column <= columnEnd; ++column)
+                {
+                    if (line[column] >= nearestDepth)
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+/* Clear flags of packed entries hidden behind occluders. */
+std::uint32_t OcclusionBuffer::CullPackedBounds(
+    const PackedBounds& bounds,
+    std::vector<std::uint8_t>& inOutVisible) const
+{
+    const std::uint32_t count = bounds.GetCount();
+    if (triangles.empty() || inOutVisible.size() < count)
+    {
+        return 0;
+    }
+
+    const std::uint32_t workerCount = GetParallelWorkerCount(count, kMinTestsPerWorker);
+    std::vector<std::uint32_t> hiddenCounts(workerCount, 0);
+
+    ParallelFor(count, workerCount,
+        [&](std::uint32_t worker, std::uint32_t begin, std::uint32_t end)
+        {
+            std::uint32_t hidden = 0;
+            for (std::uint32_t index = begin; index < end; ++index)
+            {
+                if (inOutVisible[index] && !IsVisible(bounds.GetBounds(index)))
+                {
+                    inOutVisible[index] = 0;
+                    ++hidden;
+                }
+            }
+
+            hiddenCounts[worker] = hidden;
+        });
+
+    std::uint32_t total = 0;
+    for (const std::uint32_t hidden : hiddenCounts)
+    {
+        total += hidden;
+    }
+
+    return total;
+}
+
+/* Row-major depth (0 near, 1 empty) for inspection and tests. */
+const std::vector<float>& OcclusionBuffer::GetDepth() const
+{
+    return depth;
+}
+
+/* Clip a clip-space triangle to the near plane and project it. */
+void OcclusionBuffer::AppendClipTriangle(
+    const float clip[3][4],
+    std::vector<ScreenTriangle>& outTriangles) const
+{
+    /* Common case, every vertex in front of the near plane. */
+    if (clip[0][2] >= 0.0f && clip[1][2] >= 0.0f && clip[2][2] >= 0.0f)
+    {
+        AppendScreenTriangle(clip[0], clip[1], clip[2], outTriangles);
+        return;
+    }
+
+    /* Sutherland-Hodgman against z >= 0 yields up to four vertices. */
+    float polygon[4][4];
+    std::uint32_t vertexCount = 0;
+    for (std::uint32_t index = 0; index < 3; ++index)
+    {
+        const float* current = clip[index];
+        const float* next = clip[(index + 1) % 3];
+        const bool currentInside = current[2] >= 0.0f;
+        const bool nextInside = next[2] >= 0.0f;
+
+        if (currentInside)
+        {
+            std::copy(current, current + 4, polygon[vertexCount++]);
+        }
+
+        if (currentInside != nextInside)
+        {
+            const float t = current[2] / (current[2] - next[2]);
+            for (std::uint32_t component = 0; component < 4; ++component)
+            {
+                polygon[vertexCount][component] =
+                    current[component] + (next[component] - current[component]) * t;
+            }
+            ++vertexCount;
+        }
+    }
+
+    for (std::uint32_t index = 2; index < vertexCount; ++index)
+    {
+        AppendScreenTriangle(polygon[0], polygon[index - 1], polygon[index], outTriangles);
+    }
+}
+
+/* Project clip-space vertices and append a screen triangle. */
+void OcclusionBuffer::AppendScreenTriangle(
+    const float a[4],
+    const float b[4],
+    const float c[4],
+    std::vector<ScreenTriangle>& outTriangles) const
+{
+    const float* vertices[3] = { a, b, c };
+
+    ScreenTriangle triangle{};
+    for (std::uint32_t corner = 0; corner < 3; ++corner)
+    {
+        const float* vertex = vertices[corner];
+        if (vertex[3] <= 0.0f)
+        {
+            return;
+        }
+
+        const float inverseW = 1.0f / vertex[3];
+        triangle.X[corner] = (vertex[0] * inverseW * 0.5f + 0.5f) * static_cast<float>(width);
+        triangle.Y[corner] = (vertex[1] * inverseW * 0.5f + 0.5f) * static_cast<float>(height);
+        triangle.Z[corner] = vertex[2] * inverseW;
+    }
+
+    const float minX = std::min({ triangle.X[0], triangle.X[1], triangle.X[2] });
+    const float maxX = std::max({ triangle.X[0], triangle.X[1], triangle.X[2] });
+    const float minY = std::min({ triangle.Y[0], triangle.Y[1], triangle.Y[2] });
+    const float maxY = std::max({ triangle.Y[0], triangle.Y[1], triangle.Y[2] });
+
+    /* Drop triangles entirely off-screen. */
+    if (maxX < 0.0f || maxY < 0.0f ||
+        minX >= static_cast<float>(width) || minY >= static_cast<float>(height))
+    {
+        return;
+    }
+
+    triangle.MinY = static_cast<std::int32_t>(std::max(0.0f, std::floor(minY)));
+    triangle.MaxY = static_cast<std::int32_t>(std::min(static_cast<float>(height - 1), std::floor(maxY)));
+    outTriangles.push_back(triangle);
+}
+
+/* Rasterize one triangle into the rows [beginRow, endRow). */
+void OcclusionBuffer::RasterizeTriangle(
+    const ScreenTriangle& triangle,
+    std::int32_t beginRow,
+    std::int32_t endRow)
+{
+    float x[3] = { triangle.X[0], triangle.X[1], triangle.X[2] };
+    float y[3] = { triangle.Y[0], triangle.Y[1], triangle.Y[2] };
+    float z[3] = { triangle.Z[0], triangle.Z[1], triangle.Z[2] };
+
+    /* Orient counter-clockwise so inside means all edges non-negative. */
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (std::fabs(area) < kMinTriangleArea)
+    {
+        return;
+    }
+    if (area < 0.0f)
+    {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(z[1], z[2]);
+        area = -area;
+    }
+
+    /* Edge functions E(p) = A * px + B * py + C. */
+    float edgeA[3];
+    float edgeB[3];
+    float edgeC[3];
+    for (std::uint32_t edge = 0; edge < 3; ++edge)
+    {
+        const std::uint32_t next = (edge + 1) % 3;
+        edgeA[edge] = y[edge] - y[next];
+        edgeB[edge] = x[next] - x[edge];
+        edgeC[edge] = -(edgeA[edge] * x[edge] + edgeB[edge] * y[edge]);
+    }
+
+    /* Screen-space depth plane, z/w interpolates linearly in screen space. */
+    const float inverseArea = 1.0f / area;
+    const float depthDx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) * inverseArea;
+    const float depthDy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) * inverseArea;
+    const float depthC = z[0] - depthDx * x[0] - depthDy * y[0];
+
+    const float minX = std::min({ x[0], x[1], x[2] });
+    const float maxX = std::max({ x[0], x[1], x[2] });
+    const std::int32_t columnBegin = static_cast<std::int32_t>(std::max(0.0f, std::floor(minX)));
+    const std::int32_t columnEnd = static_cast<std::int32_t>(std::min(static_cast<float>(width - 1), std::floor(maxX)));
+    const std::int32_t rowBegin = std::max(beginRow, triangle.MinY);
+    const std::int32_t rowEnd = std::min(endRow - 1, triangle.MaxY);
+
+    for (std::int32_t row = rowBegin; row <= rowEnd; ++row)
+    {
+        const float centerY = static_cast<float>(row) + 0.5f;
+        float* line = depth.data() + static_cast<std::size_t>(row) * width;
+
+        /* Width is a whole number of blocks, so aligned groups of four stay in range. */
+        std::int32_t column = columnBegin & ~3;
+
+#if defined(OCCLUSION_USE_SSE)
+        const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        __m128 rowEdge[3];
+        __m128 stepEdge[3];
+        for (std::uint32_t edge = 0; edge < 3; ++edge)
+        {
+            rowEdge[edge] = _mm_set1_ps(edgeB[edge] * centerY + edgeC[edge]);
+            stepEdge[edge] = _mm_set1_ps(edgeA[edge]);
+        }
+        const __m128 rowDepth = _mm_set1_ps(depthDy * centerY + depthC);
+        const __m128 stepDepth = _mm_set1_ps(depthDx);
+
+        for (; column <= columnEnd; column += 4)
+        {
+            const __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(column)), laneOffsets);
+
+            __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepEdge[0], centerX), rowEdge[0]), zero);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepEdge[1], centerX), rowEdge[1]), zero));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepEdge[2], centerX), rowEdge[2]), zero));
+            if (_mm_movemask_ps(inside) == 0)
+            {
+                continue;
+            }
+
+            const __m128 pixelDepth = _mm_add_ps(_mm_mul_ps(stepDepth, centerX), rowDepth);
+            const __m128 stored = _mm_loadu_ps(line + column);
+            const __m128 nearest = _mm_min_ps(stored, pixelDepth);
+            _mm_storeu_ps(line + column, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, stored)));
+        }
+#else
+        /* Same row-constant terms as the SIMD path, so both round alike. */
+        const float rowEdge[3] = {
+            edgeB[0] * centerY + edgeC[0],
+            edgeB[1] * centerY + edgeC[1],
+            edgeB[2] * centerY + edgeC[2] };
+        const float rowDepth = depthDy * centerY + depthC;
+
+        for (; column <= columnEnd; ++column)
+        {
+            const float centerX = static_cast<float>(column) + 0.5f;
+            if (edgeA[0] * centerX + rowEdge[0] < 0.0f ||
+                edgeA[1] * centerX + rowEdge[1] < 0.0f ||
+                edgeA[2] * centerX + rowEdge[2] < 0.0f)
+            {
+                continue;
+            }
+
+            line[column] = std::min(line[column], depthDx * centerX + rowDepth);
+        }
+#endif
+    }
+}
+
+/* Refresh farthest depth per block for the block rows [begin, end). */
+void OcclusionBuffer::UpdateBlockDepth(std::uint32_t beginBlockRow, std::uint32_t endBlockRow)
+{
+    for (std::uint32_t blockY = beginBlockRow; blockY < endBlockRow; ++blockY)
+    {
+        for (std::uint32_t blockX = 0; blockX < blocksX; ++blockX)
+        {
+            float farthest = 0.0f;
+            for (std::uint32_t row = 0; row < kBlockSize; ++row)
+            {
+                const float* line =
+                    depth.data() + static_cast<std::size_t>(blockY * kBlockSize + row) * width + blockX * kBlockSize;
+                for (std::uint32_t column = 0; column < kBlockSize; ++column)
+                {
+                    farthest = std::max(farthest, line[column]);
+                }
+            }
+
+            blockMaxDepth[blockY * blocksX + blockX] = farthest;
+        }
+    }
+}
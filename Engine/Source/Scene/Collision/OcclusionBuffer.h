@@ -0,0 +1,136 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "AABB.h"
+#include "PackedBounds.h"
+
+#include <cstdint>
+#include <vector>
+
+/* Low-resolution CPU depth buffer for occlusion culling. */
+/* Occluders are rasterized in horizontal bands, one worker per band, so */
+/* results never depend on thread count or scheduling. */
+class OcclusionBuffer
+{
+public:
+    /* Pixel size of a coarse depth block, bands are whole block rows. */
+    static constexpr std::uint32_t kBlockSize = 8;
+
+    OcclusionBuffer();
+    ~OcclusionBuffer();
+
+    /* Buffer resolution, rounded up to whole blocks. */
+    void Resize(std::uint32_t newWidth, std::uint32_t newHeight);
+    std::uint32_t GetWidth() const;
+    std::uint32_t GetHeight() const;
+
+    /* Start a frame, clearing depth and queued occluders. */
+    void Begin(const Mat4& newViewProjection);
+
+    /* Queue an object-space triangle list, empty indices mean unindexed. */
+    /* The geometry must stay alive until Rasterize returns. */
+    void AddOccluder(
+        const std::vector<Vec3>& positions,
+        const std::vector<std::uint32_t>& indices,
+        const Mat4& model);
+
+    /* Transform, clip and rasterize every queued occluder. */
+    void Rasterize();
+
+    /* True once Rasterize has written at least one triangle. */
+    bool HasOccluders() const;
+
+    /* Conservative test, false only when the box is fully hidden. */
+    bool IsVisible(const AABB& bounds) const;
+
+    /* Clear flags of packed entries hidden behind occluders. */
+    /* Entries already at 0 are skipped, returns the number newly hidden. */
+    std::uint32_t CullPackedBounds(
+        const PackedBounds& bounds,
+        std::vector<std::uint8_t>& inOutVisible) const;
+
+    /* Row-major depth (0 near, 1 empty) for inspection and tests. */
+    const std::vector<float>& GetDepth() const;
+
+private:
+    /* Queued occluder, geometry is borrowed from the caller. */
+    struct Occluder
+    {
+        const Vec3* Positions = nullptr;
+        const std::uint32_t* Indices = nullptr;
+        std::uint32_t TriangleCount = 0;
+        Mat4 Model = Mat4::Identity();
+    };
+
+    /* Screen-space triangle with a depth plane. */
+    struct ScreenTriangle
+    {
+        float X[3] = {};
+        float Y[3] = {};
+        float Z[3] = {};
+        std::int32_t MinY = 0;
+        std::int32_t MaxY = 0;
+    };
+
+    /* Clip a clip-space triangle to the near plane and project it. */
+    void AppendClipTriangle(const float clip[3][4], std::vector<ScreenTriangle>& outTriangles) const;
+
+    /* Project clip-space vertices and append a screen triangle. */
+    void AppendScreenTriangle(
+        const float a[4],
+        const float b[4],
+        const float c[4],
+        std::vector<ScreenTriangle>& outTriangles) const;
+
+    /* Rasterize one triangle into the rows [beginRow, endRow). */
+    void RasterizeTriangle(
+        const ScreenTriangle& triangle,
+        std::int32_t beginRow,
+        std::int32_t endRow);
+
+    /* Refresh farthest depth per block for the block rows [begin, end). */
+    void UpdateBlockDepth(std::uint32_t beginBlockRow, std::uint32_t endBlockRow);
+
+private:
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint32_t blocksX = 0;
+    std::uint32_t blocksY = 0;
+
+    Mat4 viewProjection = Mat4::Identity();
+
+    /* Per-pixel nearest occluder depth. */
+    std::vector<float> depth;
+
+    /* Farthest depth per block, lets tests skip fully covered blocks. */
+    std::vector<float> blockMaxDepth;
+
+    /* Queued occluders and their projected triangles. */
+    std::vector<Occluder> occluders;
+    std::vector<ScreenTriangle> triangles;
+    std::vector<std::vector<ScreenTriangle>> workerTriangles;
+};
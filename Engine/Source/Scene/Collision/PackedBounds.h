@@ -0,0 +1,96 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "AABB.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* World-space bounds stored as structure-of-arrays for wide queries. */
+struct PackedBounds
+{
+    /* Owning entity id per entry. */
+    std::vector<std::uint32_t> Ids;
+
+    /* Box corners, one array per component. */
+    std::vector<float> MinX;
+    std::vector<float> MinY;
+    std::vector<float> MinZ;
+    std::vector<float> MaxX;
+    std::vector<float> MaxY;
+    std::vector<float> MaxZ;
+
+    /* Number of packed entries. */
+    std::uint32_t GetCount() const
+    {
+        return static_cast<std::uint32_t>(Ids.size());
+    }
+
+    /* Remove every entry. */
+    void Clear()
+    {
+        Ids.clear();
+        MinX.clear();
+        MinY.clear();
+        MinZ.clear();
+        MaxX.clear();
+        MaxY.clear();
+        MaxZ.clear();
+    }
+
+    /* Append an entry. */
+    void Push(std::uint32_t Id, const AABB& Bounds)
+    {
+        Ids.push_back(Id);
+        MinX.push_back(Bounds.Min.x);
+        MinY.push_back(Bounds.Min.y);
+        MinZ.push_back(Bounds.Min.z);
+        MaxX.push_back(Bounds.Max.x);
+        MaxY.push_back(Bounds.Max.y);
+        MaxZ.push_back(Bounds.Max.z);
+    }
+
+    /* Overwrite the bounds of an existing entry. */
+    void SetBounds(std::uint32_t Index, const AABB& Bounds)
+    {
+        MinX[Index] = Bounds.Min.x;
+        MinY[Index] = Bounds.Min.y;
+        MinZ[Index] = Bounds.Min.z;
+        MaxX[Index] = Bounds.Max.x;
+        MaxY[Index] = Bounds.Max.y;
+        MaxZ[Index] = Bounds.Max.z;
+    }
+
+    /* Read back an entry as an AABB. */
+    AABB GetBounds(std::uint32_t Index) const
+    {
+        return AABB{
+            Vec3(MinX[Index], MinY[Index], MinZ[Index]),
+            Vec3(MaxX[Index], MaxY[Index], MaxZ[Index]) };
+    }
+};
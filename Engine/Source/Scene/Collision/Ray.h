@@ -0,0 +1,94 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "AABB.h"
+#include "../Entity.h"
+#include "../../Math/MathTypes.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+/* World-space ray, distances are measured in Direction units. */
+struct Ray
+{
+    Vec3 Origin = Vec3(0.0f, 0.0f, 0.0f);
+    Vec3 Direction = Vec3(0.0f, 0.0f, -1.0f);
+    float MaxDistance = FLT_MAX;
+};
+
+/* Reciprocal that keeps the sign of zero components, so axis-aligned */
+/* rays get huge finite slab distances instead of infinities. */
+inline float SafeReciprocal(float Value)
+{
+    if (Value == 0.0f)
+    {
+        return std::signbit(Value) ? -FLT_MAX : FLT_MAX;
+    }
+
+    return 1.0f / Value;
+}
+
+/* Slab test with a precomputed inverse direction. The entry distance is */
+/* clamped to the origin, so a ray starting inside reports 0. */
+inline bool IntersectSlabs(
+    const AABB& Bounds,
+    const Vec3& Origin,
+    const Vec3& InverseDirection,
+    float MaxDistance,
+    float& OutEnter)
+{
+    const float t1x = (Bounds.Min.x - Origin.x) * InverseDirection.x;
+    const float t2x = (Bounds.Max.x - Origin.x) * InverseDirection.x;
+    const float t1y = (Bounds.Min.y - Origin.y) * InverseDirection.y;
+    const float t2y = (Bounds.Max.y - Origin.y) * InverseDirection.y;
+    const float t1z = (Bounds.Min.z - Origin.z) * InverseDirection.z;
+    const float t2z = (Bounds.Max.z - Origin.z) * InverseDirection.z;
+
+    const float enter = std::max(
+        std::max(std::min(t1x, t2x), std::min(t1y, t2y)),
+        std::max(std::min(t1z, t2z), 0.0f));
+    const float exit = std::min(
+        std::min(std::max(t1x, t2x), std::max(t1y, t2y)),
+        std::min(std::max(t1z, t2z), MaxDistance));
+
+    OutEnter = enter;
+    return enter <= exit;
+}
+
+/* Result of a scene ray query. */
+struct RayHit
+{
+    /* Nearest entity hit, invalid when nothing was hit. */
+    Entity HitEntity;
+
+    /* Distance along the ray to the hit. */
+    float Distance = 0.0f;
+
+    /* True when the ray hit something. */
+    bool Hit = false;
+};
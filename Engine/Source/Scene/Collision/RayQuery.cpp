@@ -0,0 +1,304 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "RayQuery.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define RAY_QUERY_USE_SSE 1
+#endif
+
+/* Local helpers. */
+namespace
+{
+    /* Order candidates nearest first. */
+    void SortCandidates(std::vector<RayCandidate>& candidates)
+    {
+        std::sort(candidates.begin(), candidates.end(),
+            [](const RayCandidate& left, const RayCandidate& right)
+            {
+                return left.Distance < right.Distance;
+            });
+    }
+
+    /* Scalar slab test against one packed entry. */
+    bool IntersectPacked(
+        const PackedBounds& bounds,
+        std::uint32_t index,
+        const Vec3& origin,
+        const Vec3& inverseDirection,
+        float maxDistance,
+        float& outDistance)
+    {
+        AABB entry;
+        entry.Min = Vec3(bounds.MinX[index], bounds.MinY[index], bounds.MinZ[index]);
+        entry.Max = Vec3(bounds.MaxX[index], bounds.MaxY[index], bounds.MaxZ[index]);
+        return IntersectSlabs(entry, origin, inverseDirection, maxDistance, outDistance);
+    }
+}
+
+/* Slab test, returns the entry distance clamped to the ray origin. */
+/* Tests the box directly; no packed layout or allocation per call. */
+bool IntersectRayAABB(const Ray& ray, const AABB& bounds, float& outDistance)
+{
+    const Vec3 inverseDirection(
+        SafeReciprocal(ray.Direction.x),
+        SafeReciprocal(ray.Direction.y),
+        SafeReciprocal(ray.Direction.z));
+
+    return IntersectSlabs(bounds, ray.Origin, inverseDirection, ray.MaxDistance, outDistance);
+}
+
+/* Moller-Trumbore test against a double-sided triangle. */
+bool IntersectRayTriangle(
+    const Ray& ray,
+    const Vec3& a,
+    const Vec3& b,
+    const Vec3& c,
+    float& outDistance)
+{
+    constexpr float kEpsilon = 1e-8f;
+
+    const Vec3 edgeAB = b - a;
+    const Vec3 edgeAC = c - a;
+    const Vec3 p = Vec3::Cross(ray.Direction, edgeAC);
+    const float determinant = Vec3::Dot(edgeAB, p);
+
+    /* Ray parallel to the triangle plane. */
+    if (std::fabs(determinant) < kEpsilon)
+    {
+        return false;
+    }
+
+    const float inverseDeterminant = 1.0f / determinant;
+    const Vec3 toOrigin = ray.Origin - a;
+
+    const float u = Vec3::Dot(toOrigin, p) * inverseDeterminant;
+    if (u < 0.0f || u > 1.0f)
+    {
+        return false;
+    }
+
+    const Vec3 q = Vec3::Cross(toOrigin, edgeAB);
+    const float v = Vec3::Dot(ray.Direction, q) * inverseDeterminant;
+    if (v < 0.0f || u + v > 1.0f)
+    {
+        return false;
+    }
+
+    const float t = Vec3::Dot(edgeAC, q) * inverseDeterminant;
+    if (t < 0.0f || t > ray.MaxDistance)
+    {
+        return false;
+    }
+
+    outDistance = t;
+    return true;
+}
+
+/* Collect every packed box hit by one ray, nearest first. */
+void CollectRayCandidates(
+    const PackedBounds& bounds,
+    const Ray& ray,
+    std::vector<RayCandidate>& outCandidates)
+{
+    outCandidates.clear();
+
+    const std::uint32_t count = bounds.GetCount();
+    const Vec3 inverseDirection(
+        SafeReciprocal(ray.Direction.x),
+        SafeReciprocal(ray.Direction.y),
+        SafeReciprocal(ray.Direction.z));
+
+    std::uint32_t index = 0;
+
+#if defined(RAY_QUERY_USE_SSE)
+    /* Broadcast the ray once, then test four boxes per iteration. */
+    const __m128 originX = _mm_set1_ps(ray.Origin.x);
+    const __m128 originY = _mm_set1_ps(ray.Origin.y);
+    const __m128 originZ = _mm_set1_ps(ray.Origin.z);
+    const __m128 inverseX = _mm_set1_ps(inverseDirection.x);
+    const __m128 inverseY = _mm_set1_ps(inverseDirection.y);
+    const __m128 inverseZ = _mm_set1_ps(inverseDirection.z);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxDistance = _mm_set1_ps(ray.MaxDistance);
+
+    alignas(16) float enterLanes[4];
+
+    for (; index + 4 <= count; index += 4)
+    {
+        const __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&bounds.MinX[index]), originX), inverseX);
+        const __m128 t2x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&bounds.MaxX[index]), originX), inverseX);
+        const __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&bounds.MinY[index]), originY), inverseY);
+        const __m128 t2y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&bounds.MaxY[index]), originY), inverseY);
+        const __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&bounds.MinZ[index]), originZ), inverseZ);
+        const __m128 t2z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&bounds.MaxZ[index]), originZ), inverseZ);
+
+        const __m128 enter = _mm_max_ps(
+            _mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)),
+            _mm_max_ps(_mm_min_ps(t1z, t2z), zero));
+        const __m128 exit = _mm_min_ps(
+            _mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)),
+            _mm_min_ps(_mm_max_ps(t1z, t2z), maxDistance));
+
+        const int mask = _mm_movemask_ps(_mm_cmple_ps(enter, exit));
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        _mm_store_ps(enterLanes, enter);
+        for (std::uint32_t lane = 0; lane < 4; ++lane)
+        {
+            if (mask & (1 << lane))
+            {
+                outCandidates.push_back(RayCandidate{ index + lane, enterLanes[lane] });
+            }
+        }
+    }
+#endif
+
+    /* Remaining boxes are tested one by one. */
+    for (; index < count; ++index)
+    {
+        float distance = 0.0f;
+        if (IntersectPacked(bounds, index, ray.Origin, inverseDirection, ray.MaxDistance, distance))
+        {
+            outCandidates.push_back(RayCandidate{ index, distance });
+        }
+    }
+
+    SortCandidates(outCandidates);
+}
+
+/* Collect box hits for up to kRayPacketWidth rays, nearest first per ray. */
+void CollectRayPacketCandidates(
+    const PackedBounds& bounds,
+    const Ray* rays,
+    std::uint32_t rayCount,
+    std::vector<RayCandidate>* outCandidates)
+{
+    rayCount = std::min(rayCount, kRayPacketWidth);
+    for (std::uint32_t lane = 0; lane < rayCount; ++lane)
+    {
+        outCandidates[lane].clear();
+    }
+
+    /* Transpose the packet into lanes, unused lanes can never hit. */
+    alignas(16) float originX[kRayPacketWidth]{};
+    alignas(16) float originY[kRayPacketWidth]{};
+    alignas(16) float originZ[kRayPacketWidth]{};
+    alignas(16) float inverseX[kRayPacketWidth]{};
+    alignas(16) float inverseY[kRayPacketWidth]{};
+    alignas(16) float inverseZ[kRayPacketWidth]{};
+    alignas(16) float maxDistance[kRayPacketWidth];
+
+    for (std::uint32_t lane = 0; lane < kRayPacketWidth; ++lane)
+    {
+        maxDistance[lane] = -1.0f;
+        if (lane >= rayCount)
+        {
+            continue;
+        }
+
+        originX[lane] = rays[lane].Origin.x;
+        originY[lane] = rays[lane].Origin.y;
+        originZ[lane] = rays[lane].Origin.z;
+        inverseX[lane] = SafeReciprocal(rays[lane].Direction.x);
+        inverseY[lane] = SafeReciprocal(rays[lane].Direction.y);
+        inverseZ[lane] = SafeReciprocal(rays[lane].Direction.z);
+        maxDistance[lane] = rays[lane].MaxDistance;
+    }
+
+    const std::uint32_t count = bounds.GetCount();
+
+#if defined(RAY_QUERY_USE_SSE)
+    const __m128 packetOriginX = _mm_load_ps(originX);
+    const __m128 packetOriginY = _mm_load_ps(originY);
+    const __m128 packetOriginZ = _mm_load_ps(originZ);
+    const __m128 packetInverseX = _mm_load_ps(inverseX);
+    const __m128 packetInverseY = _mm_load_ps(inverseY);
+    const __m128 packetInverseZ = _mm_load_ps(inverseZ);
+    const __m128 packetMaxDistance = _mm_load_ps(maxDistance);
+    const __m128 zero = _mm_setzero_ps();
+
+    alignas(16) float enterLanes[kRayPacketWidth];
+
+    /* One box against the whole packet per iteration. */
+    for (std::uint32_t index = 0; index < count; ++index)
+    {
+        const __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bounds.MinX[index]), packetOriginX), packetInverseX);
+        const __m128 t2x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bounds.MaxX[index]), packetOriginX), packetInverseX);
+        const __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bounds.MinY[index]), packetOriginY), packetInverseY);
+        const __m128 t2y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bounds.MaxY[index]), packetOriginY), packetInverseY);
+        const __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bounds.MinZ[index]), packetOriginZ), packetInverseZ);
+        const __m128 t2z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bounds.MaxZ[index]), packetOriginZ), packetInverseZ);
+
+        const __m128 enter = _mm_max_ps(
+            _mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)),
+            _mm_max_ps(_mm_min_ps(t1z, t2z), zero));
+        const __m128 exit = _mm_min_ps(
+            _mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)),
+            _mm_min_ps(_mm_max_ps(t1z, t2z), packetMaxDistance));
+
+        const int mask = _mm_movemask_ps(_mm_cmple_ps(enter, exit));
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        _mm_store_ps(enterLanes, enter);
+        for (std::uint32_t lane = 0; lane < rayCount; ++lane)
+        {
+            if (mask & (1 << lane))
+            {
+                outCandidates[lane].push_back(RayCandidate{ index, enterLanes[lane] });
+            }
+        }
+    }
+#else
+    for (std::uint32_t index = 0; index < count; ++index)
+    {
+        for (std::uint32_t lane = 0; lane < rayCount; ++lane)
+        {
+            float distance = 0.0f;
+            const Vec3 origin(originX[lane], originY[lane], originZ[lane]);
+            const Vec3 inverseDirection(inverseX[lane], inverseY[lane], inverseZ[lane]);
+            if (IntersectPacked(bounds, index, origin, inverseDirection, maxDistance[lane], distance))
+            {
+                outCandidates[lane].push_back(RayCandidate{ index, distance });
+            }
+        }
+    }
+#endif
+
+    for (std::uint32_t lane = 0; lane < rayCount; ++lane)
+    {
+        SortCandidates(outCandidates[lane]);
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "AABB.h"
+#include "PackedBounds.h"
+#include "Ray.h"
+
+#include <cstdint>
+#include <vector>
+
+/* Rays tested together per SIMD iteration in packet queries. */
+constexpr std::uint32_t kRayPacketWidth = 4;
+
+/* Packed bounds entry hit by a ray, with its entry distance. */
+struct RayCandidate
+{
+    std::uint32_t Index = 0;
+    float Distance = 0.0f;
+};
+
+/* Slab test, returns the entry distance clamped to the ray origin. */
+bool IntersectRayAABB(const Ray& ray, const AABB& bounds, float& outDistance);
+
+/* Moller-Trumbore test against a double-sided triangle. */
+bool IntersectRayTriangle(
+    const Ray& ray,
+    const Vec3& a,
+    const Vec3& b,
+    const Vec3& c,
+    float& outDistance);
+
+/* Collect every packed box hit by one ray, nearest first. */
+/* Boxes are tested four at a time. */
+void CollectRayCandidates(
+    const PackedBounds& bounds,
+    const Ray& ray,
+    std::vector<RayCandidate>& outCandidates);
+
+/* Collect box hits for up to kRayPacketWidth rays, nearest first per ray. */
+/* All rays of the packet are tested against a box in one SIMD iteration. */
+void CollectRayPacketCandidates(
+    const PackedBounds& bounds,
+    const Ray* rays,
+    std::uint32_t rayCount,
+    std::vector<RayCandidate>* outCandidates);
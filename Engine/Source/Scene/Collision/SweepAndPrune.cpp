@@ -0,0 +1,486 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SweepAndPrune.h"
+
+#include "Engine/ParallelFor.h"
+
+#include <algorithm>
+#include <utility>
+
+/* Local helpers. */
+namespace
+{
+    /* Above this share of new proxies a full sort beats insertion sort. */
+    constexpr std::uint32_t kFullSortDivisor = 4;
+
+    /* Proxies longer than this multiple of the mean extent are oversized. */
+    constexpr float kOversizedExtentScale = 8.0f;
+}
+
+/* Initialize an empty broadphase sweeping along x. */
+SweepAndPrune::SweepAndPrune()
+{
+    /* Containers default-initialize, nothing required here. */
+}
+
+/* Broadphase cleanup handled by containers. */
+SweepAndPrune::~SweepAndPrune()
+{
+}
+
+/* Insert a proxy or update the bounds of an existing one. */
+void SweepAndPrune::SetBounds(std::uint32_t id, const AABB& bounds)
+{
+    if (id >= proxyById.size())
+    {
+        proxyById.resize(static_cast<std::size_t>(id) + 1, kInvalidIndex);
+    }
+
+    /* Existing proxies only need their bounds refreshed. */
+    const std::uint32_t existing = proxyById[id];
+    if (existing != kInvalidIndex)
+    {
+        Proxy& proxy = proxies[existing];
+        proxy.Bounds = bounds;
+
+        /* Queue the proxy for an incremental re-sort. */
+        if (proxy.InSweep && !proxy.Moved)
+        {
+            proxy.Moved = true;
+            movedProxies.push_back(existing);
+        }
+        return;
+    }
+
+    /* Reuse a free slot when one is available. */
+    std::uint32_t slot = 0;
+    if (!freeProxies.empty())
+    {
+        slot = freeProxies.back();
+        freeProxies.pop_back();
+    }
+    else
+    {
+        slot = static_cast<std::uint32_t>(proxies.size());
+        proxies.emplace_back();
+    }
+
+    /* A reused slot may still sit in the sweep list, InSweep tracks that. */
+    Proxy& proxy = proxies[slot];
+    proxy.Id = id;
+    proxy.Bounds = bounds;
+    proxy.Active = true;
+    proxy.Oversized = false;
+
+    proxyById[id] = slot;
+    ++liveCount;
+    structureChanged = true;
+}
+
+/* Remove a proxy, ignoring unknown ids. */
+void SweepAndPrune::Remove(std::uint32_t id)
+{
+    if (id >= proxyById.size() || proxyById[id] == kInvalidIndex)
+    {
+        return;
+    }
+
+    /* Leave the sweep entry in place until the next update compacts it. */
+    const std::uint32_t slot = proxyById[id];
+    proxies[slot].Active = false;
+    proxies[slot].Oversized = false;
+    freeProxies.push_back(slot);
+
+    proxyById[id] = kInvalidIndex;
+    --liveCount;
+    structureChanged = true;
+}
+
+/* Remove every proxy. */
+void SweepAndPrune::Clear()
+{
+    proxies.clear();
+    freeProxies.clear();
+    proxyById.clear();
+    sweep.clear();
+    sortedMin.clear();
+    sortedMax.clear();
+    sortedBounds.clear();
+    sortedIds.clear();
+    sortedOversized.clear();
+    oversizedProxies.clear();
+    movedProxies.clear();
+    maxExtent = 0.0f;
+    oversizedExtent = 0.0f;
+    liveCount = 0;
+    needsFullSort = false;
+    structureChanged = false;
+}
+
+/* Refresh endpoints and re-sort the sweep list. */
+void SweepAndPrune::Update()
+{
+    /* Pure movement of a small share of proxies stays incremental. */
+    const bool fewMoved =
+        movedProxies.size() * kFullSortDivisor <= sweep.size();
+    if (!structureChanged && !needsFullSort && fewMoved)
+    {
+        UpdateMovedProxies();
+        return;
+    }
+
+    RebuildSweep();
+}
+
+/* Full refresh after inserts, removals, or large batches of moves. */
+void SweepAndPrune::RebuildSweep()
+{
+    /* Drop entries for removed proxies, preserving order. */
+    std::size_t write = 0;
+    for (std::size_t read = 0; read < sweep.size(); ++read)
+    {
+        Proxy& proxy = proxies[sweep[read].Proxy];
+        if (!proxy.Active)
+        {
+            proxy.InSweep = false;
+            continue;
+        }
+
+        sweep[write++] = sweep[read];
+    }
+    sweep.resize(write);
+
+    /* Append newly inserted proxies at the end. */
+    std::uint32_t appendedCount = 0;
+    for (std::uint32_t slot = 0; slot < proxies.size(); ++slot)
+    {
+        Proxy& proxy = proxies[slot];
+        if (proxy.Active && !proxy.InSweep)
+        {
+            proxy.InSweep = true;
+            sweep.push_back(SweepEntry{ 0.0f, slot });
+            ++appendedCount;
+        }
+    }
+
+    /* Pull the latest min endpoints into the sweep list. */
+    for (SweepEntry& entry : sweep)
+    {
+        entry.Min = GetAxisComponent(proxies[entry.Proxy].Bounds.Min, axis);
+    }
+
+    SortSweep(appendedCount);
+
+    /* Pack endpoints and bounds in sweep order for the sweep itself. */
+    const std::size_t count = sweep.size();
+    sortedMin.resize(count);
+    sortedMax.resize(count);
+    sortedBounds.resize(count);
+    sortedIds.resize(count);
+    sortedOversized.resize(count);
+    oversizedProxies.clear();
+    maxExtent = 0.0f;
+
+    float extentSum = 0.0f;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        Proxy& proxy = proxies[sweep[index].Proxy];
+        const float maxValue = GetAxisComponent(proxy.Bounds.Max, axis);
+
+        sortedMin[index] = sweep[index].Min;
+        sortedMax[index] = maxValue;
+        sortedBounds[index] = proxy.Bounds;
+        sortedIds[index] = proxy.Id;
+
+        proxy.SweepIndex = static_cast<std::uint32_t>(index);
+        proxy.Moved = false;
+
+        extentSum += maxValue - sweep[index].Min;
+    }
+
+    /* Split off proxies far longer than the mean, the rest set the look-back. */
+    oversizedExtent = count > 0 ? kOversizedExtentScale * extentSum / static_cast<float>(count) : 0.0f;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const std::uint32_t slot = sweep[index].Proxy;
+        const float extent = sortedMax[index] - sortedMin[index];
+        const bool oversized = extent > oversizedExtent;
+
+        proxies[slot].Oversized = oversized;
+        sortedOversized[index] = oversized ? 1 : 0;
+        if (oversized)
+        {
+            oversizedProxies.push_back(slot);
+        }
+        else
+        {
+            maxExtent = std::max(maxExtent, extent);
+        }
+    }
+
+    movedProxies.clear();
+    structureChanged = false;
+}
+
+/* Re-sort only the proxies that moved, cost scales with moved count. */
+void SweepAndPrune::UpdateMovedProxies()
+{
+    for (const std::uint32_t slot : movedProxies)
+    {
+        Proxy& proxy = proxies[slot];
+        proxy.Moved = false;
+
+        std::size_t index = proxy.SweepIndex;
+        const float minValue = GetAxisComponent(proxy.Bounds.Min, axis);
+        const float maxValue = GetAxisComponent(proxy.Bounds.Max, axis);
+
+        sweep[index].Min = minValue;
+        sortedMin[index] = minValue;
+        sortedMax[index] = maxValue;
+        sortedBounds[index] = proxy.Bounds;
+
+        /* Extent only grows here, a stale larger value stays conservative. */
+        /* Proxies that outgrow the threshold leave the look-back for good. */
+        const float extent = maxValue - minValue;
+        if (!proxy.Oversized && extent > oversizedExtent)
+        {
+            proxy.Oversized = true;
+            sortedOversized[index] = 1;
+            oversizedProxies.push_back(slot);
+        }
+        else if (!proxy.Oversized)
+        {
+            maxExtent = std::max(maxExtent, extent);
+        }
+
+        /* Bubble the entry to its new place in the sweep. */
+        while (index > 0 && sortedMin[index - 1] > sortedMin[index])
+        {
+            SwapSweepEntries(index - 1, index);
+            --index;
+        }
+
+        while (index + 1 < sortedMin.size() && sortedMin[index + 1] < sortedMin[index])
+        {
+            SwapSweepEntries(index, index + 1);
+            ++index;
+        }
+    }
+
+    movedProxies.clear();
+}
+
+/* Swap two sweep slots across every packed array. */
+void SweepAndPrune::SwapSweepEntries(std::size_t left, std::size_t right)
+{
+    std::swap(sweep[left], sweep[right]);
+    std::swap(sortedMin[left], sortedMin[right]);
+    std::swap(sortedMax[left], sortedMax[right]);
+    std::swap(sortedBounds[left], sortedBounds[right]);
+    std::swap(sortedIds[left], sortedIds[right]);
+    std::swap(sortedOversized[left], sortedOversized[right]);
+
+    proxies[sweep[left].Proxy].SweepIndex = static_cast<std::uint32_t>(left);
+    proxies[sweep[right].Proxy].SweepIndex = static_cast<std::uint32_t>(right);
+}
+
+/* Collect all overlapping pairs, splitting the sweep across workers. */
+void SweepAndPrune::FindPairs(std::vector<BroadphasePair>& outPairs)
+{
+    outPairs.clear();
+
+    /* ParallelFor runs nothing for an empty range, so the worker lists */
+    /* would still hold the previous call's pairs. */
+    const std::uint32_t count = static_cast<std::uint32_t>(sortedMin.size());
+    if (count == 0)
+    {
+        return;
+    }
+
+    const std::uint32_t workerCount =
+        GetParallelWorkerCount(count, minProxiesPerWorker);
+
+    if (workerPairs.size() < workerCount)
+    {
+        workerPairs.resize(workerCount);
+    }
+
+    /* Each worker sweeps a contiguous segment of the axis. */
+    ParallelFor(count, workerCount,
+        [this](std::uint32_t worker, std::uint32_t begin, std::uint32_t end)
+        {
+            workerPairs[worker].clear();
+            FindPairsInRange(begin, end, workerPairs[worker]);
+        });
+
+    /* Merge in segment order so the result is deterministic. */
+    std::size_t total = 0;
+    for (std::uint32_t worker = 0; worker < workerCount; ++worker)
+    {
+        total += workerPairs[worker].size();
+    }
+
+    outPairs.reserve(total);
+    for (std::uint32_t worker = 0; worker < workerCount; ++worker)
+    {
+        outPairs.insert(
+            outPairs.end(),
+            workerPairs[worker].begin(),
+            workerPairs[worker].end());
+    }
+}
+
+/* Collect ids whose bounds overlap the query box. */
+void SweepAndPrune::QueryAABB(
+    const AABB& bounds,
+    std::vector<std::uint32_t>& outIds) const
+{
+    outIds.clear();
+
+    const float queryMin = GetAxisComponent(bounds.Min, axis);
+    const float queryMax = GetAxisComponent(bounds.Max, axis);
+
+    /* No regular proxy starting further back than their largest extent can reach us. */
+    const auto first = std::lower_bound(
+        sortedMin.begin(),
+        sortedMin.end(),
+        queryMin - maxExtent);
+
+    for (std::size_t index = static_cast<std::size_t>(first - sortedMin.begin());
+        index < sortedMin.size() && sortedMin[index] <= queryMax;
+        ++index)
+    {
+        if (!sortedOversized[index] &&
+            sortedMax[index] >= queryMin &&
+            sortedBounds[index].Overlaps(bounds))
+        {
+            outIds.push_back(sortedIds[index]);
+        }
+    }
+
+    /* Oversized proxies are few, test them directly. */
+    for (const std::uint32_t slot : oversizedProxies)
+    {
+        const Proxy& proxy = proxies[slot];
+        if (proxy.Oversized && proxy.Bounds.Overlaps(bounds))
+        {
+            outIds.push_back(proxy.Id);
+        }
+    }
+}
+
+/* Number of live proxies. */
+std::uint32_t SweepAndPrune::GetProxyCount() const
+{
+    return liveCount;
+}
+
+/* Select the sweep axis, forcing a full sort on the next update. */
+void SweepAndPrune::SetAxis(std::uint32_t newAxis)
+{
+    const std::uint32_t clamped = std::min(newAxis, 2u);
+    if (clamped != axis)
+    {
+        axis = clamped;
+        needsFullSort = true;
+    }
+}
+
+/* Current sweep axis. */
+std::uint32_t SweepAndPrune::GetAxis() const
+{
+    return axis;
+}
+
+/* Minimum proxies per worker before pair finding goes parallel. */
+void SweepAndPrune::SetMinProxiesPerWorker(std::uint32_t count)
+{
+    minProxiesPerWorker = std::max(1u, count);
+}
+
+/* Re-sort the sweep list, exploiting frame-to-frame coherence. */
+void SweepAndPrune::SortSweep(std::uint32_t appendedCount)
+{
+    const std::size_t count = sweep.size();
+
+    /* Large batches of new proxies or an axis change need a full sort. */
+    if (needsFullSort || appendedCount * kFullSortDivisor > count)
+    {
+        std::sort(sweep.begin(), sweep.end(),
+            [](const SweepEntry& left, const SweepEntry& right)
+            {
+                return left.Min < right.Min;
+            });
+        needsFullSort = false;
+        return;
+    }
+
+    /* Nearly sorted input makes insertion sort close to linear. */
+    for (std::size_t index = 1; index < count; ++index)
+    {
+        const SweepEntry entry = sweep[index];
+        std::size_t hole = index;
+        while (hole > 0 && sweep[hole - 1].Min > entry.Min)
+        {
+            sweep[hole] = sweep[hole - 1];
+            --hole;
+        }
+        sweep[hole] = entry;
+    }
+}
+
+/* Sweep one contiguous segment of the sorted list. */
+void SweepAndPrune::FindPairsInRange(
+    std::uint32_t begin,
+    std::uint32_t end,
+    std::vector<BroadphasePair>& outPairs) const
+{
+    const std::uint32_t count = static_cast<std::uint32_t>(sortedMin.size());
+
+    for (std::uint32_t first = begin; first < end; ++first)
+    {
+        const float firstMax = sortedMax[first];
+        const AABB& firstBounds = sortedBounds[first];
+
+        /* Only proxies starting before this one ends can overlap it. */
+        for (std::uint32_t second = first + 1;
+            second < count && sortedMin[second] <= firstMax;
+            ++second)
+        {
+            if (!firstBounds.Overlaps(sortedBounds[second]))
+            {
+                continue;
+            }
+
+            /* Store pairs with the smaller id first. */
+            const std::uint32_t idA = sortedIds[first];
+            const std::uint32_t idB = sortedIds[second];
+            outPairs.push_back(idA < idB
+                ? BroadphasePair{ idA, idB }
+                : BroadphasePair{ idB, idA });
+        }
+    }
+}
@@ -0,0 +1,145 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Broadphase.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Sort-and-sweep broadphase along a single axis. */
+/* Suited to dense sets of similar-sized, constantly moving proxies. */
+class SweepAndPrune final : public IBroadphase
+{
+public:
+    SweepAndPrune();
+    ~SweepAndPrune() override;
+    SweepAndPrune(const SweepAndPrune& other) = delete;
+    SweepAndPrune& operator=(const SweepAndPrune& other) = delete;
+
+    /* IBroadphase interface. */
+    void SetBounds(std::uint32_t id, const AABB& bounds) override;
+    void Remove(std::uint32_t id) override;
+    void Clear() override;
+    void Update() override;
+    void FindPairs(std::vector<BroadphasePair>& outPairs) override;
+    void QueryAABB(
+        const AABB& bounds,
+        std::vector<std::uint32_t>& outIds) const override;
+    std::uint32_t GetProxyCount() const override;
+
+    /* Select the sweep axis (0 = x, 1 = y, 2 = z). */
+    void SetAxis(std::uint32_t newAxis);
+    std::uint32_t GetAxis() const;
+
+    /* Minimum proxies per worker before pair finding goes parallel. */
+    void SetMinProxiesPerWorker(std::uint32_t count);
+
+private:
+    /* Proxy slot, stable until removed. */
+    struct Proxy
+    {
+        std::uint32_t Id = 0;
+        AABB Bounds;
+        std::uint32_t SweepIndex = 0;
+        bool Active = false;
+        bool InSweep = false;
+        bool Moved = false;
+        bool Oversized = false;
+    };
+
+    /* Min endpoint on the sweep axis plus the owning proxy slot. */
+    struct SweepEntry
+    {
+        float Min = 0.0f;
+        std::uint32_t Proxy = 0;
+    };
+
+    /* Re-sort the sweep list, exploiting frame-to-frame coherence. */
+    void SortSweep(std::uint32_t appendedCount);
+
+    /* Full refresh after inserts, removals, or large batches of moves. */
+    void RebuildSweep();
+
+    /* Re-sort only the proxies that moved, cost scales with moved count. */
+    void UpdateMovedProxies();
+
+    /* Swap two sweep slots across every packed array. */
+    void SwapSweepEntries(std::size_t left, std::size_t right);
+
+    /* Sweep one contiguous segment of the sorted list. */
+    void FindPairsInRange(
+        std::uint32_t begin,
+        std::uint32_t end,
+        std::vector<BroadphasePair>& outPairs) const;
+
+private:
+    /* Invalid index sentinel for sparse mapping. */
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    /* Proxy slots and free list. */
+    std::vector<Proxy> proxies;
+    std::vector<std::uint32_t> freeProxies;
+
+    /* Sparse lookup from id to proxy slot. */
+    std::vector<std::uint32_t> proxyById;
+
+    /* Proxies sorted by min endpoint on the sweep axis. */
+    std::vector<SweepEntry> sweep;
+
+    /* Packed endpoint arrays in sweep order. */
+    std::vector<float> sortedMin;
+    std::vector<float> sortedMax;
+    std::vector<AABB> sortedBounds;
+    std::vector<std::uint32_t> sortedIds;
+
+    /* Set for oversized proxies, which bounds queries skip in the sweep. */
+    std::vector<std::uint8_t> sortedOversized;
+
+    /* Slots of proxies far longer than average on the sweep axis. */
+    /* Queries test these directly, so one huge proxy cannot widen */
+    /* the look-back of every query to the whole sweep. */
+    std::vector<std::uint32_t> oversizedProxies;
+
+    /* Proxies whose bounds changed since the last update. */
+    std::vector<std::uint32_t> movedProxies;
+
+    /* Per-worker pair output, reused across frames. */
+    std::vector<std::vector<BroadphasePair>> workerPairs;
+
+    /* Largest extent among regular proxies, bounds query look-back. */
+    float maxExtent = 0.0f;
+
+    /* Extent on the sweep axis above which a proxy counts as oversized. */
+    float oversizedExtent = 0.0f;
+
+    std::uint32_t axis = 0;
+    std::uint32_t liveCount = 0;
+    std::uint32_t minProxiesPerWorker = 1024;
+    bool needsFullSort = false;
+    bool structureChanged = false;
+};
@@ -0,0 +1,836 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "TriangleBVH.h"
+
+#include "RayQuery.h"
+#include "Engine/ParallelFor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+/* Local helpers. */
+namespace
+{
+    /* SAH tuning. */
+    constexpr std::uint32_t kBinCount = 16;
+    constexpr std::uint32_t kMaxLeafTriangles = 8;
+    constexpr float kTraversalCost = 1.0f;
+    constexpr float kIntersectionCost = 1.0f;
+
+    /* Depth limit keeps traversal stacks fixed-size. */
+    constexpr std::uint32_t kMaxDepth = 60;
+    constexpr std::uint32_t kStackSize = kMaxDepth + 4;
+
+    /* Subtrees smaller than this are not worth a worker. */
+    constexpr std::uint32_t kMinTrianglesPerJob = 4096;
+
+    /* Binary cache format. */
+    constexpr std::uint32_t kFileMagic = 0x48564243u;
+    constexpr std::uint32_t kFileVersion = 1;
+
+    static_assert(std::is_trivially_copyable_v<TriangleBVHNode>, "BVH nodes are written raw");
+    static_assert(std::is_trivially_copyable_v<Vec3>, "Vertices are written raw");
+
+    /* Per-triangle data used only while building. */
+    struct BuildTriangle
+    {
+        AABB Bounds;
+        Vec3 Centroid;
+    };
+
+    /* Pending subtree: node slot, triangle range, and depth. */
+    struct BuildJob
+    {
+        std::uint32_t Node = 0;
+        std::uint32_t Begin = 0;
+        std::uint32_t End = 0;
+        std::uint32_t Depth = 0;
+    };
+
+    /* Shared, read-mostly build inputs. */
+    struct BuildContext
+    {
+        const std::vector<BuildTriangle>* Triangles = nullptr;
+        std::vector<std::uint32_t>* Order = nullptr;
+    };
+
+    /* Box that any grow operation will replace. */
+    AABB EmptyBounds()
+    {
+        return AABB{ Vec3(FLT_MAX, FLT_MAX, FLT_MAX), Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX) };
+    }
+
+    /* Extend a box to contain a point. */
+    void Grow(AABB& bounds, const Vec3& point)
+    {
+        bounds.Min = Vec3(std::min(bounds.Min.x, point.x), std::min(bounds.Min.y, point.y), std::min(bounds.Min.z, point.z));
+        bounds.Max = Vec3(std::max(bounds.Max.x, point.x), std::max(bounds.Max.y, point.y), std::max(bounds.Max.z, point.z));
+    }
+
+    /* Extend a box to contain another box. */
+    void Grow(AABB& bounds, const AABB& other)
+    {
+        Grow(bounds, other.Min);
+        Grow(bounds, other.Max);
+    }
+
+    /* Half surface area, enough for SAH ratios. */
+    float HalfArea(const AABB& bounds)
+    {
+        const Vec3 extent = bounds.Max - bounds.Min;
+        if (extent.x < 0.0f)
+        {
+            return 0.0f;
+        }
+
+        return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+
+    /* Bounds of a triangle range. */
+    AABB ComputeRangeBounds(const BuildContext& context, std::uint32_t begin, std::uint32_t end)
+    {
+        AABB bounds = EmptyBounds();
+        for (std::uint32_t index = begin; index < end; ++index)
+        {
+            Grow(bounds, (*context.Triangles)[(*context.Order)[index]].Bounds);
+        }
+
+        return bounds;
+    }
+
+    /* Find the best binned SAH split, false when a leaf is the better choice. */
+    bool FindSplit(
+        const BuildContext& context,
+        std::uint32_t begin,
+        std::uint32_t end,
+        const AABB& nodeBounds,
+        std::uint32_t& outAxis,
+        float& outPosition)
+    {
+        const std::uint32_t count = end - begin;
+        const std::vector<BuildTriangle>& triangles = *context.Triangles;
+        const std::vector<std::uint32_t>& order = *context.Order;
+
+        AABB centroidBounds = EmptyBounds();
+        for (std::uint32_t index = begin; index < end; ++index)
+        {
+            Grow(centroidBounds, triangles[order[index]].Centroid);
+        }
+
+        const float parentArea = HalfArea(nodeBounds);
+        float bestCost = static_cast<float>(count) * kIntersectionCost;
+        bool found = false;
+
+        for (std::uint32_t axis = 0; axis < 3; ++axis)
+        {
+            const float axisMin = GetAxisComponent(centroidBounds.Min, axis);
+            const float extent = GetAxisComponent(centroidBounds.Max, axis) - axisMin;
+            if (extent <= 1e-12f || parentArea <= 0.0f)
+            {
+                continue;
+            }
+
+            /* Bin triangles by centroid. */
+            AABB binBounds[kBinCount];
+            std::uint32_t binCounts[kBinCount]{};
+            for (AABB& bin : binBounds)
+            {
+                bin = EmptyBounds();
+            }
+
+            const float scale = static_cast<float>(kBinCount) / extent;
+            for (std::uint32_t index = begin; index < end; ++index)
+            {
+                const BuildTriangle& triangle = triangles[order[index]];
+                const std::uint32_t bin = std::min(
+                    kBinCount - 1,
+                    static_cast<std::uint32_t>((GetAxisComponent(triangle.Centroid, axis) - axisMin) * scale));
+                ++binCounts[bin];
+                Grow(binBounds[bin], triangle.Bounds);
+            }
+
+            /* Sweep from the right to get suffix areas and counts. */
+            float rightArea[kBinCount]{};
+            std::uint32_t rightCount[kBinCount]{};
+            AABB accumulated = EmptyBounds();
+            std::uint32_t accumulatedCount = 0;
+            for (std::uint32_t bin = kBinCount - 1; bin > 0; --bin)
+            {
+                Grow(accumulated, binBounds[bin]);
+                accumulatedCount += binCounts[bin];
+                rightArea[bin] = HalfArea(accumulated);
+                rightCount[bin] = accumulatedCount;
+            }
+
+            /* Sweep from the left and evaluate each plane. */
+            accumulated = EmptyBounds();
+            accumulatedCount = 0;
+            for (std::uint32_t bin = 0; bin + 1 < kBinCount; ++bin)
+            {
+                Grow(accumulated, binBounds[bin]);
+                accumulatedCount += binCounts[bin];
+
+                if (accumulatedCount == 0 || rightCount[bin + 1] == 0)
+                {
+                    continue;
+                }
+
+                const float cost = kTraversalCost + kIntersectionCost *
+                    (HalfArea(accumulated) * static_cast<float>(accumulatedCount) +
+                        rightArea[bin + 1] * static_cast<float>(rightCount[bin + 1])) / parentArea;
+
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    outAxis = axis;
+                    outPosition = axisMin + extent * static_cast<float>(bin + 1) / static_cast<float>(kBinCount);
+                    found = true;
+                }
+            }
+        }
+
+        if (found || count <= kMaxLeafTriangles)
+        {
+            return found;
+        }
+
+        /* Oversized leaf, fall back to a midpoint split on the widest axis. */
+        const Vec3 extent = centroidBounds.Max - centroidBounds.Min;
+        outAxis = extent.x >= extent.y && extent.x >= extent.z ? 0u : (extent.y >= extent.z ? 1u : 2u);
+        if (GetAxisComponent(extent, outAxis) <= 1e-12f)
+        {
+            /* Every centroid coincides, no plane can separate them. */
+            return false;
+        }
+
+        outPosition = GetAxisComponent(centroidBounds.Min, outAxis) + GetAxisComponent(extent, outAxis) * 0.5f;
+        return true;
+    }
+
+    /* Partition a range by centroid, returns the first right-hand slot. */
+    std::uint32_t Partition(
+        const BuildContext& context,
+        std::uint32_t begin,
+        std::uint32_t end,
+        std::uint32_t axis,
+        float position)
+    {
+        const std::vector<BuildTriangle>& triangles = *context.Triangles;
+        std::vector<std::uint32_t>& order = *context.Order;
+
+        const auto middle = std::partition(
+            order.begin() + begin,
+            order.begin() + end,
+            [&triangles, axis, position](std::uint32_t triangle)
+            {
+                return GetAxisComponent(triangles[triangle].Centroid, axis) < position;
+            });
+
+        std::uint32_t split = static_cast<std::uint32_t>(middle - order.begin());
+        if (split == begin || split == end)
+        {
+            /* Float edge cases, split the range in half instead. */
+            split = begin + (end - begin) / 2;
+        }
+
+        return split;
+    }
+
+    /* Turn a node into an inner node or a leaf, returns true when split. */
+    bool SplitNode(
+        const BuildContext& context,
+        std::vector<TriangleBVHNode>& nodes,
+        const BuildJob& job,
+        BuildJob& outLeft,
+        BuildJob& outRight)
+    {
+        const AABB bounds = ComputeRangeBounds(context, job.Begin, job.End);
+        nodes[job.Node].Bounds = bounds;
+
+        std::uint32_t axis = 0;
+        float position = 0.0f;
+        if (job.Depth >= kMaxDepth ||
+            !FindSplit(context, job.Begin, job.End, bounds, axis, position))
+        {
+            nodes[job.Node].LeftOrFirst = job.Begin;
+            nodes[job.Node].TriangleCount = job.End - job.Begin;
+            return false;
+        }
+
+        const std::uint32_t split = Partition(context, job.Begin, job.End, axis, position);
+
+        /* Children are allocated as an adjacent pair. */
+        const std::uint32_t left = static_cast<std::uint32_t>(nodes.size());
+        nodes.resize(nodes.size() + 2);
+        nodes[job.Node].LeftOrFirst = left;
+        nodes[job.Node].TriangleCount = 0;
+
+        outLeft = BuildJob{ left, job.Begin, split, job.Depth + 1 };
+        outRight = BuildJob{ left + 1, split, job.End, job.Depth + 1 };
+        return true;
+    }
+
+    /* Build a whole subtree into a local node array rooted at slot 0. */
+    void BuildSubtree(
+        const BuildContext& context,
+        std::vector<TriangleBVHNode>& nodes,
+        const BuildJob& rootJob)
+    {
+        nodes.clear();
+        nodes.emplace_back();
+
+        std::vector<BuildJob> pending;
+        pending.push_back(BuildJob{ 0, rootJob.Begin, rootJob.End, rootJob.Depth });
+
+        while (!pending.empty())
+        {
+            const BuildJob job = pending.back();
+            pending.pop_back();
+
+            BuildJob left;
+            BuildJob right;
+            if (SplitNode(context, nodes, job, left, right))
+            {
+                pending.push_back(right);
+                pending.push_back(left);
+            }
+        }
+    }
+
+    /* Separating axis test between a box and a triangle. */
+    bool IntersectAABBTriangle(const AABB& bounds, const Vec3& a, const Vec3& b, const Vec3& c)
+    {
+        const Vec3 center = (bounds.Min + bounds.Max) * 0.5f;
+        const Vec3 half = (bounds.Max - bounds.Min) * 0.5f;
+
+        /* Work relative to the box center. */
+        const Vec3 vertices[3] = { a - center, b - center, c - center };
+        const Vec3 edges[3] = {
+            vertices[1] - vertices[0],
+            vertices[2] - vertices[1],
+            vertices[0] - vertices[2] };
+        const Vec3 boxAxes[3] = { Vec3(1.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f), Vec3(0.0f, 0.0f, 1.0f) };
+
+        /* Projects the triangle and box onto an axis and checks for a gap. */
+        const auto separated = [&vertices, &half](const Vec3& axis)
+        {
+            const float p0 = Vec3::Dot(vertices[0], axis);
+            const float p1 = Vec3::Dot(vertices[1], axis);
+            const float p2 = Vec3::Dot(vertices[2], axis);
+            const float radius =
+                half.x * std::fabs(axis.x) + half.y * std::fabs(axis.y) + half.z * std::fabs(axis.z);
+
+            return std::min(p0, std::min(p1, p2)) > radius ||
+                std::max(p0, std::max(p1, p2)) < -radius;
+        };
+
+        /* Box face normals. */
+        for (const Vec3& axis : boxAxes)
+        {
+            if (separated(axis))
+            {
+                return false;
+            }
+        }
+
+        /* Triangle normal. */
+        if (separated(Vec3::Cross(edges[0], edges[1])))
+        {
+            return false;
+        }
+
+        /* Edge cross products. */
+        for (const Vec3& edge : edges)
+        {
+            for (const Vec3& axis : boxAxes)
+            {
+                if (separated(Vec3::Cross(axis, edge)))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+/* Build from object-space triangles using a parallel binned SAH build. */
+bool TriangleBVH::Build(
+    const std::vector<Vec3>& positions,
+    const std::vector<std::uint32_t>& indices)
+{
+    Clear();
+
+    const std::size_t cornerCount = indices.empty() ? positions.size() : indices.size();
+    const std::uint32_t triangleCount = static_cast<std::uint32_t>(cornerCount / 3);
+    if (triangleCount == 0)
+    {
+        std::fprintf(stderr, "TriangleBVH::Build: No triangles\n");
+        return false;
+    }
+
+    /* Resolves a triangle corner through the optional index list. */
+    const auto corner = [&positions, &indices](std::size_t slot) -> const Vec3&
+    {
+        return indices.empty() ? positions[slot] : positions[indices[slot]];
+    };
+
+    /* Per-triangle bounds and centroids. */
+    std::vector<BuildTriangle> triangles(triangleCount);
+    const std::uint32_t prepareWorkers = GetParallelWorkerCount(triangleCount, kMinTrianglesPerJob);
+    ParallelFor(triangleCount, prepareWorkers,
+        [&triangles, &corner](std::uint32_t, std::uint32_t begin, std::uint32_t end)
+        {
+            for (std::uint32_t triangle = begin; triangle < end; ++triangle)
+            {
+                const std::size_t base = static_cast<std::size_t>(triangle) * 3;
+                AABB bounds = EmptyBounds();
+                Grow(bounds, corner(base + 0));
+                Grow(bounds, corner(base + 1));
+                Grow(bounds, corner(base + 2));
+
+                triangles[triangle].Bounds = bounds;
+                triangles[triangle].Centroid = (bounds.Min + bounds.Max) * 0.5f;
+            }
+        });
+
+    std::vector<std::uint32_t> order(triangleCount);
+    for (std::uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        order[triangle] = triangle;
+    }
+
+    BuildContext context;
+    context.Triangles = &triangles;
+    context.Order = &order;
+
+    /* Split the top of the tree serially until there is work for every worker. */
+    nodes.emplace_back();
+    std::vector<BuildJob> jobs;
+    jobs.push_back(BuildJob{ 0, 0, triangleCount, 0 });
+
+    const std::uint32_t workerCount = GetParallelWorkerCount(triangleCount, kMinTrianglesPerJob);
+    while (jobs.size() < static_cast<std::size_t>(workerCount) * 2)
+    {
+        /* Always split the largest pending job. */
+        const auto largest = std::max_element(jobs.begin(), jobs.end(),
+            [](const BuildJob& left, const BuildJob& right)
+            {
+                return left.End - left.Begin < right.End - right.Begin;
+            });
+
+        if (largest->End - largest->Begin < kMinTrianglesPerJob)
+        {
+            break;
+        }
+
+        const BuildJob job = *largest;
+        jobs.erase(largest);
+
+        BuildJob left;
+        BuildJob right;
+        if (SplitNode(context, nodes, job, left, right))
+        {
+            jobs.push_back(left);
+            jobs.push_back(right);
+        }
+    }
+
+    /* Subtrees cover disjoint ranges of the order array, so they build independently. */
+    const std::uint32_t jobCount = static_cast<std::uint32_t>(jobs.size());
+    std::vector<std::vector<TriangleBVHNode>> subtrees(jobCount);
+    ParallelFor(jobCount, std::min(workerCount, jobCount),
+        [&context, &jobs, &subtrees](std::uint32_t, std::uint32_t begin, std::uint32_t end)
+        {
+            for (std::uint32_t job = begin; job < end; ++job)
+            {
+                BuildSubtree(context, subtrees[job], jobs[job]);
+            }
+        });
+
+    /* Splice each subtree into the flat array, remapping child indices. */
+    for (std::uint32_t job = 0; job < jobCount; ++job)
+    {
+        const std::vector<TriangleBVHNode>& subtree = subtrees[job];
+        const std::uint32_t offset = static_cast<std::uint32_t>(nodes.size());
+
+        const auto remap = [offset](TriangleBVHNode node)
+        {
+            if (node.TriangleCount == 0)
+            {
+                node.LeftOrFirst = offset + node.LeftOrFirst - 1;
+            }
+            return node;
+        };
+
+        nodes[jobs[job].Node] = remap(subtree[0]);
+        for (std::size_t index = 1; index < subtree.size(); ++index)
+        {
+            nodes.push_back(remap(subtree[index]));
+        }
+    }
+
+    /* Store triangle corners in leaf order for cache-friendly leaves. */
+    triangleVertices.resize(static_cast<std::size_t>(triangleCount) * 3);
+    triangleIds = std::move(order);
+    for (std::uint32_t slot = 0; slot < triangleCount; ++slot)
+    {
+        const std::size_t source = static_cast<std::size_t>(triangleIds[slot]) * 3;
+        triangleVertices[slot * 3 + 0] = corner(source + 0);
+        triangleVertices[slot * 3 + 1] = corner(source + 1);
+        triangleVertices[slot * 3 + 2] = corner(source + 2);
+    }
+
+    sourceHash = ComputeSourceHash(positions, indices);
+    return true;
+}
+
+/* Release all nodes and triangle data. */
+void TriangleBVH::Clear()
+{
+    nodes.clear();
+    triangleVertices.clear();
+    triangleIds.clear();
+    sourceHash = 0;
+}
+
+/* True after a successful build or load. */
+bool TriangleBVH::IsBuilt() const
+{
+    return !nodes.empty();
+}
+
+/* Nearest triangle hit using near-first traversal. */
+bool TriangleBVH::Raycast(
+    const Ray& ray,
+    float& outDistance,
+    std::uint32_t* outTriangle) const
+{
+    if (nodes.empty())
+    {
+        return false;
+    }
+
+    const Vec3 inverseDirection(
+        SafeReciprocal(ray.Direction.x),
+        SafeReciprocal(ray.Direction.y),
+        SafeReciprocal(ray.Direction.z));
+
+    Ray probe = ray;
+    bool hit = false;
+
+    std::uint32_t stack[kStackSize];
+    std::uint32_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const TriangleBVHNode& node = nodes[stack[--stackSize]];
+
+        float enter = 0.0f;
+        if (!IntersectSlabs(node.Bounds, probe.Origin, inverseDirection, probe.MaxDistance, enter))
+        {
+            continue;
+        }
+
+        if (node.TriangleCount > 0)
+        {
+            for (std::uint32_t slot = node.LeftOrFirst; slot < node.LeftOrFirst + node.TriangleCount; ++slot)
+            {
+                float distance = 0.0f;
+                if (IntersectRayTriangle(
+                    probe,
+                    triangleVertices[slot * 3 + 0],
+                    triangleVertices[slot * 3 + 1],
+                    triangleVertices[slot * 3 + 2],
+                    distance))
+                {
+                    /* Later hits must be closer than this one. */
+                    probe.MaxDistance = distance;
+                    outDistance = distance;
+                    if (outTriangle)
+                    {
+                        *outTriangle = triangleIds[slot];
+                    }
+                    hit = true;
+                }
+            }
+            continue;
+        }
+
+        /* Visit the nearer child first by pushing it last. */
+        const std::uint32_t left = node.LeftOrFirst;
+        const std::uint32_t right = left + 1;
+
+        float leftEnter = 0.0f;
+        float rightEnter = 0.0f;
+        const bool leftHit = IntersectSlabs(nodes[left].Bounds, probe.Origin, inverseDirection, probe.MaxDistance, leftEnter);
+        const bool rightHit = IntersectSlabs(nodes[right].Bounds, probe.Origin, inverseDirection, probe.MaxDistance, rightEnter);
+
+        if (leftHit && rightHit)
+        {
+            const bool leftFirst = leftEnter <= rightEnter;
+            stack[stackSize++] = leftFirst ? right : left;
+            stack[stackSize++] = leftFirst ? left : right;
+        }
+        else if (leftHit)
+        {
+            stack[stackSize++] = left;
+        }
+        else if (rightHit)
+        {
+            stack[stackSize++] = right;
+        }
+    }
+
+    return hit;
+}
+
+/* Collect source triangle ids that intersect a box. */
+void TriangleBVH::QueryAABB(
+    const AABB& bounds,
+    std::vector<std::uint32_t>& outTriangles) const
+{
+    outTriangles.clear();
+    if (nodes.empty())
+    {
+        return;
+    }
+
+    std::uint32_t stack[kStackSize];
+    std::uint32_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const TriangleBVHNode& node = nodes[stack[--stackSize]];
+        if (!node.Bounds.Overlaps(bounds))
+        {
+            continue;
+        }
+
+        if (node.TriangleCount == 0)
+        {
+            stack[stackSize++] = node.LeftOrFirst;
+            stack[stackSize++] = node.LeftOrFirst + 1;
+            continue;
+        }
+
+        for (std::uint32_t slot = node.LeftOrFirst; slot < node.LeftOrFirst + node.TriangleCount; ++slot)
+        {
+            if (IntersectAABBTriangle(
+                bounds,
+                triangleVertices[slot * 3 + 0],
+                triangleVertices[slot * 3 + 1],
+                triangleVertices[slot * 3 + 2]))
+            {
+                outTriangles.push_back(triangleIds[slot]);
+            }
+        }
+    }
+}
+
+/* Bounds of the whole hierarchy. */
+AABB TriangleBVH::GetBounds() const
+{
+    return nodes.empty() ? AABB{} : nodes[0].Bounds;
+}
+
+/* Number of flattened nodes. */
+std::uint32_t TriangleBVH::GetNodeCount() const
+{
+    return static_cast<std::uint32_t>(nodes.size());
+}
+
+/* Number of triangles stored in leaves. */
+std::uint32_t TriangleBVH::GetTriangleCount() const
+{
+    return static_cast<std::uint32_t>(triangleIds.size());
+}
+
+/* FNV-1a over the raw source geometry. */
+std::uint64_t TriangleBVH::ComputeSourceHash(
+    const std::vector<Vec3>& positions,
+    const std::vector<std::uint32_t>& indices)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+
+    const auto mix = [&hash](const void* data, std::size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            hash ^= bytes[index];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    const std::uint64_t positionCount = positions.size();
+    const std::uint64_t indexCount = indices.size();
+    mix(&positionCount, sizeof(positionCount));
+    mix(&indexCount, sizeof(indexCount));
+    mix(positions.data(), positions.size() * sizeof(Vec3));
+    mix(indices.data(), indices.size() * sizeof(std::uint32_t));
+
+    return hash;
+}
+
+/* Write the hierarchy to a binary file. */
+bool TriangleBVH::SaveToFile(const std::string& path) const
+{
+    if (nodes.empty())
+    {
+        return false;
+    }
+
+    std::error_code error;
+    const std::filesystem::path filePath(path);
+    if (filePath.has_parent_path())
+    {
+        std::filesystem::create_directories(filePath.parent_path(), error);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::fprintf(stderr, "TriangleBVH::SaveToFile: Failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    const std::uint32_t nodeCount = static_cast<std::uint32_t>(nodes.size());
+    const std::uint32_t triangleCount = static_cast<std::uint32_t>(triangleIds.size());
+
+    file.write(reinterpret_cast<const char*>(&kFileMagic), sizeof(kFileMagic));
+    file.write(reinterpret_cast<const char*>(&kFileVersion), sizeof(kFileVersion));
+    file.write(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash));
+    file.write(reinterpret_cast<const char*>(&nodeCount), sizeof(nodeCount));
+    file.write(reinterpret_cast<const char*>(&triangleCount), sizeof(triangleCount));
+    file.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(TriangleBVHNode));
+    file.write(reinterpret_cast<const char*>(triangleVertices.data()), triangleVertices.size() * sizeof(Vec3));
+    file.write(reinterpret_cast<const char*>(triangleIds.data()), triangleIds.size() * sizeof(std::uint32_t));
+
+    if (!file.good())
+    {
+        std::fprintf(stderr, "TriangleBVH::SaveToFile: Failed to write %s\n", path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/* Read a hierarchy, rejecting files built from different geometry. */
+bool TriangleBVH::LoadFromFile(const std::string& path, std::uint64_t expectedSourceHash)
+{
+    Clear();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    std::uint64_t fileHash = 0;
+    std::uint32_t nodeCount = 0;
+    std::uint32_t triangleCount = 0;
+
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&fileHash), sizeof(fileHash));
+    file.read(reinterpret_cast<char*>(&nodeCount), sizeof(nodeCount));
+    file.read(reinterpret_cast<char*>(&triangleCount), sizeof(triangleCount));
+
+    /* Stale or foreign caches are silently rebuilt by the caller. */
+    if (!file.good() || magic != kFileMagic || version != kFileVersion ||
+        fileHash != expectedSourceHash || nodeCount == 0 || triangleCount == 0)
+    {
+        return false;
+    }
+
+    /* Check the counts against the file size before allocating for them. */
+    std::error_code error;
+    const std::uint64_t fileSize = std::filesystem::file_size(path, error);
+    const std::uint64_t expectedSize =
+        sizeof(magic) + sizeof(version) + sizeof(fileHash) + sizeof(nodeCount) + sizeof(triangleCount) +
+        static_cast<std::uint64_t>(nodeCount) * sizeof(TriangleBVHNode) +
+        static_cast<std::uint64_t>(triangleCount) * (3 * sizeof(Vec3) + sizeof(std::uint32_t));
+    if (error || fileSize < expectedSize)
+    {
+        std::fprintf(stderr, "TriangleBVH::LoadFromFile: Truncated file %s\n", path.c_str());
+        return false;
+    }
+
+    nodes.resize(nodeCount);
+    triangleVertices.resize(static_cast<std::size_t>(triangleCount) * 3);
+    triangleIds.resize(triangleCount);
+
+    file.read(reinterpret_cast<char*>(nodes.data()), nodes.size() * sizeof(TriangleBVHNode));
+    file.read(reinterpret_cast<char*>(triangleVertices.data()), triangleVertices.size() * sizeof(Vec3));
+    file.read(reinterpret_cast<char*>(triangleIds.data()), triangleIds.size() * sizeof(std::uint32_t));
+
+    if (!file.good())
+    {
+        std::fprintf(stderr, "TriangleBVH::LoadFromFile: Truncated file %s\n", path.c_str());
+        Clear();
+        return false;
+    }
+
+    /* Reject bad references and over-deep trees before they reach a traversal. */
+    /* Children always follow their parent, so one forward pass covers depth. */
+    /* Ranges are compared without adding, so huge values cannot wrap. */
+    std::vector<std::uint32_t> depth(nodeCount, 0);
+    for (std::uint32_t index = 0; index < nodeCount; ++index)
+    {
+        const TriangleBVHNode& node = nodes[index];
+        const bool isInner = node.TriangleCount == 0;
+        const bool valid = isInner
+            ? node.LeftOrFirst > index && node.LeftOrFirst < nodeCount - 1 && depth[index] < kMaxDepth
+            : node.TriangleCount <= triangleCount && node.LeftOrFirst <= triangleCount - node.TriangleCount;
+
+        if (valid && isInner)
+        {
+            depth[node.LeftOrFirst] = depth[index] + 1;
+            depth[node.LeftOrFirst + 1] = depth[index] + 1;
+        }
+
+        if (!valid)
+        {
+            std::fprintf(stderr, "TriangleBVH::LoadFromFile: Corrupt file %s\n", path.c_str());
+            Clear();
+            return false;
+        }
+    }
+
+    sourceHash = fileHash;
+    return true;
+}
@@ -0,0 +1,107 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "AABB.h"
+#include "Ray.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Flattened BVH node, children of an inner node are stored adjacently. */
+struct TriangleBVHNode
+{
+    /* Bounds of everything below this node. */
+    AABB Bounds;
+
+    /* Inner: index of the left child. Leaf: first triangle slot. */
+    std::uint32_t LeftOrFirst = 0;
+
+    /* Triangle count for leaves, zero for inner nodes. */
+    std::uint32_t TriangleCount = 0;
+};
+
+/* SAH-built bounding volume hierarchy over a triangle mesh. */
+class TriangleBVH
+{
+public:
+    TriangleBVH() = default;
+    ~TriangleBVH() = default;
+
+    /* Build from object-space triangles, empty indices mean unindexed positions. */
+    bool Build(
+        const std::vector<Vec3>& positions,
+        const std::vector<std::uint32_t>& indices);
+
+    /* Release all nodes and triangle data. */
+    void Clear();
+
+    /* True after a successful build or load. */
+    bool IsBuilt() const;
+
+    /* Nearest triangle hit, distances are in ray direction units. */
+    bool Raycast(
+        const Ray& ray,
+        float& outDistance,
+        std::uint32_t* outTriangle = nullptr) const;
+
+    /* Collect source triangle ids that intersect a box. */
+    void QueryAABB(
+        const AABB& bounds,
+        std::vector<std::uint32_t>& outTriangles) const;
+
+    /* Bounds of the whole hierarchy. */
+    AABB GetBounds() const;
+
+    /* Node and triangle counts for diagnostics. */
+    std::uint32_t GetNodeCount() const;
+    std::uint32_t GetTriangleCount() const;
+
+    /* Hash of the source geometry, used to validate cached files. */
+    static std::uint64_t ComputeSourceHash(
+        const std::vector<Vec3>& positions,
+        const std::vector<std::uint32_t>& indices);
+
+    /* Write the hierarchy to a binary file. */
+    bool SaveToFile(const std::string& path) const;
+
+    /* Read a hierarchy, rejecting files built from different geometry. */
+    bool LoadFromFile(const std::string& path, std::uint64_t expectedSourceHash);
+
+private:
+    /* Flattened node array, node 0 is the root. */
+    std::vector<TriangleBVHNode> nodes;
+
+    /* Triangle corners in leaf order, three per triangle. */
+    std::vector<Vec3> triangleVertices;
+
+    /* Source triangle id per leaf slot. */
+    std::vector<std::uint32_t> triangleIds;
+
+    /* Hash of the geometry this hierarchy was built from. */
+    std::uint64_t sourceHash = 0;
+};
@@ -129,6 +129,12 @@ public:
         indexByEntity[id] = kInvalidIndex;
     }
 
+    /* Entity ids in packed component order. */
+    const std::vector<std::uint32_t>& GetEntityIds() const
+    {
+        return entityIds;
+    }
+
     /* Check whether an entity has this component. */
     bool Has(std::uint32_t id) const
     {
@@ -26,10 +26,18 @@
 #pragma once
 
 struct Mesh;
+struct MeshLODChain;
 
 /* Mesh reference component for renderable entities. */
 struct MeshComponent
 {
     /* Pointer to mesh resource. */
     Mesh* MeshPtr = nullptr;
+
+    /* Optional level-of-detail chain, replaces MeshPtr when set. */
+    /* Rendering picks a level per instance, queries use level 0. */
+    MeshLODChain* LODChain = nullptr;
+
+    /* Rasterized into the occlusion buffer, for large solid meshes. */
+    bool IsOccluder = false;
 };
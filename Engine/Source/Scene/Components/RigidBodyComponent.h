@@ -0,0 +1,49 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "../../Math/MathTypes.h"
+
+/* Rigid body parameters for a box following the entity transform. */
+/* The physics world registers a body on its next step; edits made */
+/* afterwards apply once the body is removed and registered again. */
+struct RigidBodyComponent
+{
+    /* Zero mass makes the body static. */
+    float Mass = 1.0f;
+
+    /* Bounce factor, 0 keeps contacts inelastic. */
+    float Restitution = 0.0f;
+
+    /* Coulomb friction coefficient. */
+    float Friction = 0.5f;
+
+    /* Linear velocity, read when the body registers and overwritten with */
+    /* the simulated value after every step. Set a live body's velocity */
+    /* through PhysicsWorld::SetLinearVelocity. */
+    Vec3 LinearVelocity = Vec3(0.0f, 0.0f, 0.0f);
+};
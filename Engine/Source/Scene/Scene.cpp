@@ -25,6 +25,8 @@
 
 #include "Scene.h"
 
+#include "Renderer/Vulkan/Render/Mesh.h"
+
 #include <cstdint>
 #include <utility>
 
@@ -36,10 +38,67 @@ namespace
     {
         return static_cast<std::size_t>(id) < count;
     }
+
+    /* Invalid index sentinel for the bounds lookup. */
+    constexpr std::uint32_t kInvalidBoundsIndex = 0xFFFFFFFFu;
+
+    /* Screen size reported when the camera is inside an entity's bounds. */
+    constexpr float kInsideScreenSize = 1e30f;
+
+    /* Camera travel before the retained depth buckets are recomputed. */
+    constexpr float kProxyViewRefreshDistance = 1.0f;
+
+    /* Object-space bounds used for entities without mesh geometry. */
+    const AABB kUnitCubeBounds{ Vec3(-0.5f, -0.5f, -0.5f), Vec3(0.5f, 0.5f, 0.5f) };
+
+    /* Full-detail mesh of a component, level 0 of its chain when set. */
+    const Mesh* GetBaseMesh(const MeshComponent& mesh)
+    {
+        if (mesh.LODChain && mesh.LODChain->LevelCount > 0)
+        {
+            return &mesh.LODChain->Levels[0];
+        }
+
+        return mesh.MeshPtr;
+    }
+
+    /* Nearest triangle hit for an object-space ray. */
+    bool RaycastMeshTriangles(const Ray& localRay, const Mesh& mesh, float& outDistance)
+    {
+        /* Prefer the hierarchy when the mesh was imported with one. */
+        if (mesh.BVH.IsBuilt())
+        {
+            return mesh.BVH.Raycast(localRay, outDistance);
+        }
+
+        bool hit = false;
+        Ray ray = localRay;
+
+        const std::uint32_t triangleCount = mesh.GetTriangleCount();
+        for (std::uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            Vec3 a;
+            Vec3 b;
+            Vec3 c;
+            mesh.GetTriangle(triangle, a, b, c);
+
+            float distance = 0.0f;
+            if (IntersectRayTriangle(ray, a, b, c, distance))
+            {
+                /* Shrink the ray so later triangles must be closer. */
+                ray.MaxDistance = distance;
+                outDistance = distance;
+                hit = true;
+            }
+        }
+
+        return hit;
+    }
 }
 
 /* Initialize empty scene state. */
 Scene::Scene()
+    : broadphase(CreateBroadphase(BroadphaseType::SweepAndPrune))
 {
     /* Vectors default-initialize, nothing required here. */
 }
@@ -55,6 +114,19 @@ Scene::Scene(Scene&& other) noexcept
     : alive(std::move(other.alive))
     , componentStores(std::move(other.componentStores))
     , transformSystem(std::move(other.transformSystem))
+    , worldBounds(std::move(other.worldBounds))
+    , boundsIndexByEntity(std::move(other.boundsIndexByEntity))
+    , boundsDirty(std::move(other.boundsDirty))
+    , dirtyBoundsIds(std::move(other.dirtyBoundsIds))
+    , renderResources(std::move(other.renderResources))
+    , renderProxies(std::move(other.renderProxies))
+    , proxyDirty(std::move(other.proxyDirty))
+    , dirtyProxyIds(std::move(other.dirtyProxyIds))
+    , proxyViewOrigin(other.proxyViewOrigin)
+    , proxyViewValid(other.proxyViewValid)
+    , lodLevels(std::move(other.lodLevels))
+    , boundsRebuild(other.boundsRebuild)
+    , broadphase(std::move(other.broadphase))
 {
     /* Transfer ownership of scene data. */
 }
@@ -68,6 +140,19 @@ Scene& Scene::operator=(Scene&& other) noexcept
         alive = std::move(other.alive);
         componentStores = std::move(other.componentStores);
         transformSystem = std::move(other.transformSystem);
+        worldBounds = std::move(other.worldBounds);
+        boundsIndexByEntity = std::move(other.boundsIndexByEntity);
+        boundsDirty = std::move(other.boundsDirty);
+        dirtyBoundsIds = std::move(other.dirtyBoundsIds);
+        renderResources = std::move(other.renderResources);
+        renderProxies = std::move(other.renderProxies);
+        proxyDirty = std::move(other.proxyDirty);
+        dirtyProxyIds = std::move(other.dirtyProxyIds);
+        proxyViewOrigin = other.proxyViewOrigin;
+        proxyViewValid = other.proxyViewValid;
+        lodLevels = std::move(other.lodLevels);
+        boundsRebuild = other.boundsRebuild;
+        broadphase = std::move(other.broadphase);
     }
 
     return *this;
@@ -110,6 +195,10 @@ void Scene::DestroyEntity(Entity entity)
 
     /* Remove transform cache if present. */
     transformSystem.RemoveTransform(id);
+
+    /* Packed bounds must drop the entity, and so must its proxy. */
+    boundsRebuild = true;
+    MarkProxyDirty(id);
 }
 
 /* Retrieve transform component if present. */
@@ -137,6 +226,38 @@ void Scene::MarkTransformDirty(Entity entity)
 
     /* Mark transform cache dirty for this entity. */
     transformSystem.MarkDirty(id);
+
+    /* Queue a bounds refresh unless a full rebuild is already pending. */
+    if (!boundsRebuild && id < boundsDirty.size() && !boundsDirty[id])
+    {
+        boundsDirty[id] = 1;
+        dirtyBoundsIds.push_back(id);
+    }
+}
+
+/* Re-register the render proxy after its draw state changed. */
+void Scene::MarkRenderableDirty(Entity entity)
+{
+    const std::uint32_t id = entity.GetId();
+    if (IsValidId(id, alive.size()))
+    {
+        MarkProxyDirty(id);
+    }
+}
+
+/* Queue an entity for render proxy re-registration, once. */
+void Scene::MarkProxyDirty(std::uint32_t id)
+{
+    if (id >= proxyDirty.size())
+    {
+        proxyDirty.resize(id + 1, 0);
+    }
+
+    if (!proxyDirty[id])
+    {
+        proxyDirty[id] = 1;
+        dirtyProxyIds.push_back(id);
+    }
 }
 
 /* Attach transform component to entity. */
@@ -158,60 +279,301 @@ MaterialComponent& Scene::AddMaterial(Entity entity)
 }
 
 /* Build renderable items from active scene entities. */
-void Scene::BuildRenderList(std::vector<RenderItem>& outItems) const
+void Scene::BuildRenderList(RenderList& outList) const
+{
+    CollectRenderItems(outList, nullptr, nullptr, nullptr, nullptr);
+}
+
+/* Build render submission list, skipping entities outside the frustum. */
+void Scene::BuildRenderList(
+    RenderList& outList,
+    const Frustum& frustum,
+    RenderCullStats& outStats,
+    OcclusionBuffer* occlusion,
+    const LODView* lodView) const
+{
+    UpdateWorldBounds();
+    CullPackedBounds(frustum, worldBounds, boundsVisible);
+
+    /* Occlusion only tests what survived the frustum. */
+    const std::uint8_t* unoccluded = nullptr;
+    if (occlusion)
+    {
+        RasterizeOccluders(*occlusion);
+        if (occlusion->HasOccluders())
+        {
+            boundsUnoccluded = boundsVisible;
+            occlusion->CullPackedBounds(worldBounds, boundsUnoccluded);
+            unoccluded = boundsUnoccluded.data();
+        }
+    }
+
+    CollectRenderItems(outList, boundsVisible.data(), unoccluded, lodView, &outStats);
+}
+
+/* Handles used by this scene's render lists. */
+const RenderResourceTable& Scene::GetRenderResources() const
+{
+    return renderResources;
+}
+
+/* Queue frustum-visible occluder meshes and rasterize them. */
+void Scene::RasterizeOccluders(OcclusionBuffer& occlusion) const
+{
+    const ComponentStorage<TransformComponent>* transformStorage =
+        FindStorage<TransformComponent>();
+    const ComponentStorage<MeshComponent>* meshStorage =
+        FindStorage<MeshComponent>();
+
+    if (transformStorage && meshStorage)
+    {
+        for (std::uint32_t index = 0; index < worldBounds.GetCount(); ++index)
+        {
+            if (!boundsVisible[index])
+            {
+                continue;
+            }
+
+            const std::uint32_t id = worldBounds.Ids[index];
+            const MeshComponent* mesh = meshStorage->Get(id);
+            const Mesh* baseMesh = mesh && mesh->IsOccluder ? GetBaseMesh(*mesh) : nullptr;
+            if (!baseMesh || !baseMesh->HasGeometry())
+            {
+                continue;
+            }
+
+            const TransformComponent* transform = transformStorage->Get(id);
+            occlusion.AddOccluder(
+                baseMesh->Positions,
+                baseMesh->Indices,
+                transformSystem.GetModelMatrix(id, *transform));
+        }
+    }
+
+    occlusion.Rasterize();
+}
+
+/* Gather render items, optionally filtered by per-bounds visibility. */
+void Scene::CollectRenderItems(
+    RenderList& outList,
+    const std::uint8_t* visibleBounds,
+    const std::uint8_t* unoccludedBounds,
+    const LODView* lodView,
+    RenderCullStats* outStats) const
 {
     /* Caller gets a clean list every time. */
-    outItems.clear();
+    outList.Clear();
+    if (outStats)
+    {
+        *outStats = RenderCullStats{};
+    }
+
+    /* Only entities changed since the last list are re-registered. */
+    UpdateRenderProxies(lodView);
 
     /* Resolve component storage once per frame. */
     const ComponentStorage<TransformComponent>* transformStorage =
         FindStorage<TransformComponent>();
     const ComponentStorage<MeshComponent>* meshStorage =
         FindStorage<MeshComponent>();
-    const ComponentStorage<MaterialComponent>* materialStorage =
-        FindStorage<MaterialComponent>();
 
-    if (!transformStorage || !meshStorage || !materialStorage)
+    if (!transformStorage || !meshStorage || renderProxies.GetCount() == 0)
     {
         return;
     }
 
-    /* Avoid repeated reallocations when many entities are alive. */
-    outItems.reserve(alive.size());
+    /* Avoid repeated reallocations when many entities are renderable. */
+    outList.Items.reserve(renderProxies.GetCount());
 
-    for (std::uint32_t id = 0; id < alive.size(); ++id)
+    /* Selected levels persist per entity for hysteresis. */
+    if (lodLevels.size() < alive.size())
+    {
+        lodLevels.resize(alive.size(), 0);
+    }
+
+    auto appendProxy = [&](const RenderProxy& proxy)
     {
-        /* Entity must be alive and fully renderable. */
-        if (!alive[id])
+        const std::uint32_t id = proxy.EntityId;
+        if (outStats)
         {
-            continue;
+            ++outStats->Submitted;
         }
 
-        const TransformComponent* transform = transformStorage->Get(id);
-        if (!transform)
+        /* Every transform has packed bounds, so the lookup is always valid. */
+        if (visibleBounds && !visibleBounds[boundsIndexByEntity[id]])
         {
-            continue;
+            if (outStats)
+            {
+                ++outStats->Culled;
+            }
+            return;
         }
 
-        const MeshComponent* mesh = meshStorage->Get(id);
-        if (!mesh)
+        if (unoccludedBounds && !unoccludedBounds[boundsIndexByEntity[id]])
         {
-            continue;
+            if (outStats)
+            {
+                ++outStats->Culled;
+                ++outStats->Occluded;
+            }
+            return;
         }
 
-        const MaterialComponent* material = materialStorage->Get(id);
-        if (!material)
+        /* Proxies without a fixed mesh pick theirs here. */
+        std::uint32_t meshHandle = proxy.MeshHandle;
+        if (meshHandle == 0)
         {
-            continue;
+            const MeshComponent* mesh = meshStorage->Get(id);
+            Mesh* meshPtr = mesh->MeshPtr;
+
+            /* Each level is its own mesh, so same-level instances still batch. */
+            if (mesh->LODChain && mesh->LODChain->LevelCount > 0)
+            {
+                std::uint32_t level = 0;
+                if (lodView && mesh->LODChain->LevelCount > 1)
+                {
+                    level = mesh->LODChain->SelectLevel(
+                        ComputeScreenSize(id, *lodView),
+                        lodLevels[id],
+                        lodView->Hysteresis);
+                }
+
+                lodLevels[id] = static_cast<std::uint8_t>(level);
+                meshPtr = &mesh->LODChain->Levels[level];
+            }
+
+            meshHandle = renderResources.RegisterMesh(meshPtr);
         }
 
+        /* Refresh the cached matrix, the item only keeps its packed index. */
+        transformSystem.GetModelMatrix(id, *transformStorage->Get(id));
+
         RenderItem item{};
-        item.MeshPtr = mesh->MeshPtr;
-        item.MaterialPtr = material->MaterialPtr;
-        item.Model = transformSystem.GetModelMatrix(id, *transform);
+        item.MeshHandle = meshHandle;
+        item.MaterialHandle = proxy.MaterialHandle;
+        item.TransformIndex = transformSystem.GetModelIndex(id);
+        outList.Items.push_back(item);
+    };
+
+    /* Visibility filtering keeps the retained order, so the opaque run */
+    /* reaches the renderer already grouped by material and mesh, coarsely */
+    /* near to far inside each group. */
+    for (const std::uint32_t slot : renderProxies.GetSortedSlots())
+    {
+        appendProxy(renderProxies.GetProxy(slot));
+    }
+
+    outList.SortedCount = static_cast<std::uint32_t>(outList.Items.size());
+
+    for (const std::uint32_t slot : renderProxies.GetUnsortedSlots())
+    {
+        appendProxy(renderProxies.GetProxy(slot));
+    }
+
+    outList.Transforms = transformSystem.GetModelMatrices();
+}
+
+/* Register, update or drop queued proxies and merge their order. */
+void Scene::UpdateRenderProxies(const LODView* lodView) const
+{
+    /* Bounds are only current on the culled path, which also brings the view. */
+    /* Proxies registered without one get bucket 0 until the next refresh. */
+    if (!lodView && !dirtyProxyIds.empty())
+    {
+        proxyViewValid = false;
+    }
+
+    /* Re-bucket everything once the camera has moved far enough; only */
+    /* proxies whose bucket changed are merged again, idle frames skip this. */
+    if (lodView &&
+        (!proxyViewValid ||
+            (lodView->CameraPosition - proxyViewOrigin).Length() > kProxyViewRefreshDistance))
+    {
+        proxyViewOrigin = lodView->CameraPosition;
+        proxyViewValid = true;
+        for (const std::uint32_t slot : renderProxies.GetSortedSlots())
+        {
+            /* Queued entities may have lost their bounds, they get theirs below. */
+            const std::uint32_t id = renderProxies.GetProxy(slot).EntityId;
+            if (!proxyDirty[id])
+            {
+                renderProxies.SetDepthBucket(id, ComputeProxyDepthBucket(id));
+            }
+        }
+    }
+
+    if (dirtyProxyIds.empty())
+    {
+        renderProxies.Update();
+        return;
+    }
+
+    const ComponentStorage<TransformComponent>* transformStorage =
+        FindStorage<TransformComponent>();
+    const ComponentStorage<MeshComponent>* meshStorage =
+        FindStorage<MeshComponent>();
+    const ComponentStorage<MaterialComponent>* materialStorage =
+        FindStorage<MaterialComponent>();
 
-        outItems.push_back(item);
+    for (const std::uint32_t id : dirtyProxyIds)
+    {
+        proxyDirty[id] = 0;
+
+        /* Entity must be alive and fully renderable to keep a proxy. */
+        const bool renderable =
+            id < alive.size() && alive[id] &&
+            transformStorage && transformStorage->Get(id) &&
+            meshStorage && meshStorage->Get(id) &&
+            materialStorage && materialStorage->Get(id);
+        if (!renderable)
+        {
+            renderProxies.Remove(id);
+            continue;
+        }
+
+        const MeshComponent* mesh = meshStorage->Get(id);
+        const MaterialComponent* material = materialStorage->Get(id);
+
+        /* LOD chains and missing meshes resolve per frame, outside the run. */
+        const bool fixedMesh = mesh->MeshPtr &&
+            !(mesh->LODChain && mesh->LODChain->LevelCount > 0);
+
+        RenderProxy proxy{};
+        proxy.EntityId = id;
+        proxy.MeshHandle = fixedMesh ? renderResources.RegisterMesh(mesh->MeshPtr) : 0;
+        proxy.MaterialHandle = renderResources.RegisterMaterial(material->MaterialPtr);
+        proxy.DepthBucket = lodView ? ComputeProxyDepthBucket(id) : 0;
+        proxy.Transparent = material->MaterialPtr && material->MaterialPtr->Alpha < 1.0f;
+        renderProxies.Set(proxy);
     }
+
+    dirtyProxyIds.clear();
+    renderProxies.Update();
+}
+
+/* Depth bucket of an entity's bounds center from the proxy view origin. */
+std::uint16_t Scene::ComputeProxyDepthBucket(std::uint32_t id) const
+{
+    const AABB bounds = worldBounds.GetBounds(boundsIndexByEntity[id]);
+    const Vec3 offset = (bounds.Min + bounds.Max) * 0.5f - proxyViewOrigin;
+    return RenderProxyTable::ComputeDepthBucket(Vec3::Dot(offset, offset));
+}
+
+/* Projected height of an entity's bounding sphere over the viewport. */
+float Scene::ComputeScreenSize(std::uint32_t id, const LODView& lodView) const
+{
+    const AABB bounds = worldBounds.GetBounds(boundsIndexByEntity[id]);
+    const Vec3 center = (bounds.Min + bounds.Max) * 0.5f;
+    const float radius = (bounds.Max - bounds.Min).Length() * 0.5f;
+    const float distance = (center - lodView.CameraPosition).Length();
+
+    /* Inside the sphere the object fills the view. */
+    if (distance <= radius)
+    {
+        return kInsideScreenSize;
+    }
+
+    return radius * lodView.ProjectionScale / distance;
 }
 
 /* Enumerate living entities in the scene. */
@@ -229,6 +591,88 @@ void Scene::GetEntities(std::vector<Entity>& outEntities) const
     }
 }
 
+/* Packed world bounds of every entity with a transform. */
+const PackedBounds& Scene::GetWorldBounds() const
+{
+    UpdateWorldBounds();
+    return worldBounds;
+}
+
+/* World bounds of one entity, false when it has no transform. */
+bool Scene::GetWorldBounds(Entity entity, AABB& outBounds) const
+{
+    UpdateWorldBounds();
+
+    const std::uint32_t id = entity.GetId();
+    if (!IsValidId(id, boundsIndexByEntity.size()) ||
+        boundsIndexByEntity[id] == kInvalidBoundsIndex)
+    {
+        return false;
+    }
+
+    outBounds = worldBounds.GetBounds(boundsIndexByEntity[id]);
+    return true;
+}
+
+/* Entity ids whose world bounds overlap a box, via the broadphase. */
+void Scene::QueryWorldBounds(const AABB& bounds, std::vector<std::uint32_t>& outIds) const
+{
+    UpdateWorldBounds();
+
+    if (!broadphase)
+    {
+        outIds.clear();
+        return;
+    }
+
+    broadphase->QueryAABB(bounds, outIds);
+}
+
+/* Select the broadphase used for bounds queries, e.g. per level. */
+void Scene::SetBroadphaseType(BroadphaseType type)
+{
+    broadphase = CreateBroadphase(type);
+
+    /* The new broadphase starts empty, repopulate it on next use. */
+    boundsRebuild = true;
+}
+
+/* Nearest entity hit by a ray, refined against mesh triangles. */
+bool Scene::Raycast(const Ray& ray, RayHit& outHit) const
+{
+    outHit = RayHit{};
+
+    const PackedBounds& bounds = GetWorldBounds();
+
+    std::vector<RayCandidate> candidates;
+    CollectRayCandidates(bounds, ray, candidates);
+
+    return RefineRayCandidates(ray, candidates, outHit);
+}
+
+/* Nearest hits for a batch of rays, tested in SIMD packets. */
+void Scene::RaycastPacket(const Ray* rays, std::uint32_t count, RayHit* outHits) const
+{
+    const PackedBounds& bounds = GetWorldBounds();
+
+    std::vector<RayCandidate> candidates[kRayPacketWidth];
+
+    for (std::uint32_t first = 0; first < count; first += kRayPacketWidth)
+    {
+        const std::uint32_t packetSize =
+            count - first < kRayPacketWidth ? count - first : kRayPacketWidth;
+
+        /* Box tests for the whole packet, then exact refinement per ray. */
+        CollectRayPacketCandidates(bounds, rays + first, packetSize, candidates);
+
+        for (std::uint32_t lane = 0; lane < packetSize; ++lane)
+        {
+            outHits[first + lane] = RayHit{};
+            RefineRayCandidates(rays[first + lane], candidates[lane], outHits[first + lane]);
+        }
+    }
+}
+
 /* Ensure internal arrays can hold entity id. */
 void Scene::EnsureSize(std::uint32_t id)
 {
@@ -243,3 +687,170 @@ void Scene::EnsureSize(std::uint32_t id)
 
     alive.resize(newSize, false);
 }
+
+/* Bring cached world bounds up to date. */
+void Scene::UpdateWorldBounds() const
+{
+    const ComponentStorage<TransformComponent>* transformStorage =
+        FindStorage<TransformComponent>();
+
+    if (boundsRebuild)
+    {
+        /* Repack every entity that has a transform. */
+        worldBounds.Clear();
+        boundsIndexByEntity.assign(alive.size(), kInvalidBoundsIndex);
+        boundsDirty.assign(alive.size(), 0);
+        dirtyBoundsIds.clear();
+        boundsRebuild = false;
+
+        if (broadphase)
+        {
+            broadphase->Clear();
+        }
+
+        if (!transformStorage)
+        {
+            return;
+        }
+
+        for (std::uint32_t id = 0; id < alive.size(); ++id)
+        {
+            if (!alive[id])
+            {
+                continue;
+            }
+
+            const TransformComponent* transform = transformStorage->Get(id);
+            if (!transform)
+            {
+                continue;
+            }
+
+            const AABB bounds = ComputeWorldBounds(id, *transform);
+            boundsIndexByEntity[id] = worldBounds.GetCount();
+            worldBounds.Push(id, bounds);
+
+            if (broadphase)
+            {
+                broadphase->SetBounds(id, bounds);
+            }
+        }
+
+        if (broadphase)
+        {
+            broadphase->Update();
+        }
+
+        return;
+    }
+
+    /* Nothing moved, so the broadphase is already current. */
+    if (dirtyBoundsIds.empty())
+    {
+        return;
+    }
+
+    /* Only entities marked dirty since the last refresh are recomputed. */
+    for (const std::uint32_t id : dirtyBoundsIds)
+    {
+        boundsDirty[id] = 0;
+
+        const std::uint32_t index = boundsIndexByEntity[id];
+        const TransformComponent* transform =
+            transformStorage ? transformStorage->Get(id) : nullptr;
+        if (index == kInvalidBoundsIndex || !transform)
+        {
+            continue;
+        }
+
+        const AABB bounds = ComputeWorldBounds(id, *transform);
+        worldBounds.SetBounds(index, bounds);
+
+        if (broadphase)
+        {
+            broadphase->SetBounds(id, bounds);
+        }
+    }
+
+    dirtyBoundsIds.clear();
+
+    /* Moved proxies are re-sorted incrementally. */
+    if (broadphase)
+    {
+        broadphase->Update();
+    }
+}
+
+/* Compute world bounds for one entity from its transform and mesh. */
+AABB Scene::ComputeWorldBounds(std::uint32_t id, const TransformComponent& transform) const
+{
+    const ComponentStorage<MeshComponent>* meshStorage = FindStorage<MeshComponent>();
+    const MeshComponent* mesh = meshStorage ? meshStorage->Get(id) : nullptr;
+    const Mesh* baseMesh = mesh ? GetBaseMesh(*mesh) : nullptr;
+
+    /* Fall back to a unit cube when no CPU geometry is available. */
+    const AABB& localBounds =
+        baseMesh && baseMesh->HasGeometry()
+        ? baseMesh->LocalBounds
+        : kUnitCubeBounds;
+
+    return localBounds.Transformed(transformSystem.GetModelMatrix(id, transform));
+}
+
+/* Walk nearest-first box hits and keep the closest exact hit. */
+bool Scene::RefineRayCandidates(
+    const Ray& ray,
+    const std::vector<RayCandidate>& candidates,
+    RayHit& outHit) const
+{
+    const ComponentStorage<TransformComponent>* transformStorage =
+        FindStorage<TransformComponent>();
+    const ComponentStorage<MeshComponent>* meshStorage =
+        FindStorage<MeshComponent>();
+
+    float bestDistance = ray.MaxDistance;
+
+    for (const RayCandidate& candidate : candidates)
+    {
+        /* Remaining boxes start beyond the best hit so far. */
+        if (candidate.Distance > bestDistance)
+        {
+            break;
+        }
+
+        const std::uint32_t id = worldBounds.Ids[candidate.Index];
+        const MeshComponent* mesh = meshStorage ? meshStorage->Get(id) : nullptr;
+        const Mesh* baseMesh = mesh ? GetBaseMesh(*mesh) : nullptr;
+        const TransformComponent* transform =
+            transformStorage ? transformStorage->Get(id) : nullptr;
+
+        /* Without triangles the box hit is the best answer available. */
+        if (!transform || !baseMesh || !baseMesh->HasGeometry())
+        {
+            bestDistance = candidate.Distance;
+            outHit.HitEntity = Entity(id);
+            outHit.Distance = candidate.Distance;
+            outHit.Hit = true;
+            continue;
+        }
+
+        /* Move the ray into object space, keeping distances in world units. */
+        const Mat4 inverseModel = transformSystem.GetModelMatrix(id, *transform).InverseAffine();
+
+        Ray localRay;
+        localRay.Origin = inverseModel.TransformPoint(ray.Origin);
+        localRay.Direction = inverseModel.TransformDirection(ray.Direction);
+        localRay.MaxDistance = bestDistance;
+
+        float distance = 0.0f;
+        if (RaycastMeshTriangles(localRay, *baseMesh, distance))
+        {
+            bestDistance = distance;
+            outHit.HitEntity = Entity(id);
+            outHit.Distance = distance;
+            outHit.Hit = true;
+        }
+    }
+
+    return outHit.Hit;
+}
@@ -30,9 +30,18 @@
 #include "Components/TransformComponent.h"
 #include "Components/MeshComponent.h"
 #include "Components/MaterialComponent.h"
+#include "Components/RigidBodyComponent.h"
 #include "TransformSystem.h"
+#include "Collision/Broadphase.h"
+#include "Collision/Frustum.h"
+#include "Collision/OcclusionBuffer.h"
+#include "Collision/PackedBounds.h"
+#include "Collision/Ray.h"
+#include "Collision/RayQuery.h"
 
 #include "Renderer/RenderItem.h"
+#include "Renderer/RenderProxyTable.h"
+#include "Renderer/RenderResourceTable.h"
 
 #include <vector>
 #include <cstddef>
@@ -41,6 +50,32 @@
 #include <type_traits>
 #include <unordered_map>
 
+/* Visibility counters from a culled render list. */
+struct RenderCullStats
+{
+    /* Renderable entities considered. */
+    std::uint32_t Submitted = 0;
+
+    /* Renderable entities rejected by the frustum or occlusion. */
+    std::uint32_t Culled = 0;
+
+    /* Part of Culled hidden behind occluders. */
+    std::uint32_t Occluded = 0;
+};
+
+/* Camera inputs for per-instance mesh LOD selection. */
+struct LODView
+{
+    /* World-space eye position. */
+    Vec3 CameraPosition;
+
+    /* cot(fovY / 2), turns radius over distance into viewport height. */
+    float ProjectionScale = 1.0f;
+
+    /* Fraction a switch size must be crossed by before a level changes. */
+    float Hysteresis = 0.15f;
+};
+
  /* Scene owns entity lifetime and component storage. */
 class Scene
 {
@@ -63,8 +98,13 @@ public:
     MaterialComponent* GetMaterial(Entity entity);
 
     /* Mark transform data dirty after modification. */
+    /* Also call this after swapping an entity's mesh pointer. */
     void MarkTransformDirty(Entity entity);
 
+    /* Re-register an entity's render proxy after swapping its mesh, LOD */
+    /* chain or material pointer, or changing that material's alpha. */
+    void MarkRenderableDirty(Entity entity);
+
     /* Component creation. */
     TransformComponent& AddTransform(Entity entity);
     MeshComponent& AddMesh(Entity entity);
@@ -86,16 +126,99 @@ public:
     template <typename T>
     const T* GetComponent(Entity entity) const;
 
+    /* Ids of every entity holding a component type. */
+    template <typename T>
+    void GetComponentEntities(std::vector<std::uint32_t>& outIds) const;
+
     /* Build render submission list. */
-    void BuildRenderList(std::vector<RenderItem>& outItems) const;
+    /* Items come from retained render proxies, opaque ones already in */
+    /* batch order (RenderList::SortedCount); idle frames sort nothing. */
+    /* Within a batch they go near to far by coarse depth buckets, taken */
+    /* from the LOD view's camera and refreshed after it moves a unit; */
+    /* moved entities keep their bucket until then. */
+    /* Meshes and materials are registered in the scene's resource table. */
+    /* Transforms point into the scene's matrix cache, valid until */
+    /* entities gain or lose a transform. */
+    void BuildRenderList(RenderList& outList) const;
+
+    /* Build render submission list, skipping entities outside the frustum. */
+    /* World bounds are culled in parallel before items are gathered. */
+    /* With an occlusion buffer (already begun with the view), visible */
+    /* occluder meshes are rasterized and hidden bounds are culled too. */
+    /* With a LOD view, meshes with a LOD chain pick a level per instance */
+    /* from projected size; without one they always draw level 0. */
+    void BuildRenderList(
+        RenderList& outList,
+        const Frustum& frustum,
+        RenderCullStats& outStats,
+        OcclusionBuffer* occlusion = nullptr,
+        const LODView* lodView = nullptr) const;
+
+    /* Handles used by this scene's render lists. */
+    const RenderResourceTable& GetRenderResources() const;
 
     /* Enumerate living entities. */
     void GetEntities(std::vector<Entity>& outEntities) const;
 
+    /* Packed world bounds of every entity with a transform. */
+    /* Refreshed lazily, only dirty entries are recomputed. */
+    const PackedBounds& GetWorldBounds() const;
+
+    /* World bounds of one entity, false when it has no transform. */
+    bool GetWorldBounds(Entity entity, AABB& outBounds) const;
+
+    /* Entity ids whose world bounds overlap a box, via the broadphase. */
+    void QueryWorldBounds(const AABB& bounds, std::vector<std::uint32_t>& outIds) const;
+
+    /* Select the broadphase used for bounds queries, e.g. per level. */
+    void SetBroadphaseType(BroadphaseType type);
+
+    /* Nearest entity hit by a ray, refined against mesh triangles. */
+    bool Raycast(const Ray& ray, RayHit& outHit) const;
+
+    /* Nearest hits for a batch of rays, tested in SIMD packets. */
+    void RaycastPacket(const Ray* rays, std::uint32_t count, RayHit* outHits) const;
+
 private:
     /* Ensure internal storage can hold entity id. */
     void EnsureSize(std::uint32_t id);
 
+    /* Gather render items, optionally filtered by per-bounds visibility. */
+    void CollectRenderItems(
+        RenderList& outList,
+        const std::uint8_t* visibleBounds,
+        const std::uint8_t* unoccludedBounds,
+        const LODView* lodView,
+        RenderCullStats* outStats) const;
+
+    /* Queue an entity for render proxy re-registration. */
+    void MarkProxyDirty(std::uint32_t id);
+
+    /* Register, update or drop queued proxies and merge their order. */
+    /* With a view, depth buckets follow the camera in coarse steps. */
+    void UpdateRenderProxies(const LODView* lodView) const;
+
+    /* Depth bucket of an entity's bounds center from the proxy view origin. */
+    std::uint16_t ComputeProxyDepthBucket(std::uint32_t id) const;
+
+    /* Projected height of an entity's bounding sphere over the viewport. */
+    float ComputeScreenSize(std::uint32_t id, const LODView& lodView) const;
+
+    /* Queue frustum-visible occluder meshes and rasterize them. */
+    void RasterizeOccluders(OcclusionBuffer& occlusion) const;
+
+    /* Bring cached world bounds up to date. */
+    void UpdateWorldBounds() const;
+
+    /* Compute world bounds for one entity from its transform and mesh. */
+    AABB ComputeWorldBounds(std::uint32_t id, const TransformComponent& transform) const;
+
+    /* Walk nearest-first box hits and keep the closest exact hit. */
+    bool RefineRayCandidates(
+        const Ray& ray,
+        const std::vector<RayCandidate>& candidates,
+        RayHit& outHit) const;
+
 private:
     /* Resolve a stable component type id. */
     template <typename T>
@@ -120,6 +243,39 @@ private:
     std::unordered_map<std::size_t, std::unique_ptr<IComponentStorage>> componentStores;
     TransformSystem transformSystem;
 
+    /* Cached world bounds and their sparse lookup. */
+    mutable PackedBounds worldBounds;
+    mutable std::vector<std::uint32_t> boundsIndexByEntity;
+
+    /* Entities whose bounds changed since the last refresh. */
+    mutable std::vector<std::uint8_t> boundsDirty;
+    mutable std::vector<std::uint32_t> dirtyBoundsIds;
+
+    /* Frustum and occlusion visibility scratch, one flag per packed entry. */
+    mutable std::vector<std::uint8_t> boundsVisible;
+    mutable std::vector<std::uint8_t> boundsUnoccluded;
+
+    /* Mesh and material handles, registered while render lists are built. */
+    mutable RenderResourceTable renderResources;
+
+    /* Retained render proxies and the entities queued for re-registration. */
+    mutable RenderProxyTable renderProxies;
+    mutable std::vector<std::uint8_t> proxyDirty;
+    mutable std::vector<std::uint32_t> dirtyProxyIds;
+
+    /* Camera position the proxy depth buckets were last computed from. */
+    mutable Vec3 proxyViewOrigin;
+    mutable bool proxyViewValid = false;
+
+    /* Last selected LOD level per entity id, for hysteresis. */
+    mutable std::vector<std::uint8_t> lodLevels;
+
+    /* Set when entities or components change, forces a full rebuild. */
+    mutable bool boundsRebuild = true;
+
+    /* Broadphase mirroring the world bounds for region queries. */
+    std::unique_ptr<IBroadphase> broadphase;
+
 };
 
 template <typename T>
@@ -198,6 +354,20 @@ T& Scene::AddComponent(Entity entity)
         transformSystem.MarkDirty(id);
     }
 
+    /* Bounds depend on both transform and mesh. */
+    if constexpr (std::is_same_v<T, TransformComponent> || std::is_same_v<T, MeshComponent>)
+    {
+        boundsRebuild = true;
+    }
+
+    /* Proxies are resolved later, after the caller fills the component. */
+    if constexpr (std::is_same_v<T, TransformComponent> ||
+        std::is_same_v<T, MeshComponent> ||
+        std::is_same_v<T, MaterialComponent>)
+    {
+        MarkProxyDirty(id);
+    }
+
     return component;
 }
 
@@ -219,6 +389,20 @@ void Scene::RemoveComponent(Entity entity)
     {
         transformSystem.RemoveTransform(id);
     }
+
+    /* Bounds depend on both transform and mesh. */
+    if constexpr (std::is_same_v<T, TransformComponent> || std::is_same_v<T, MeshComponent>)
+    {
+        boundsRebuild = true;
+    }
+
+    /* Losing any renderable component drops the proxy. */
+    if constexpr (std::is_same_v<T, TransformComponent> ||
+        std::is_same_v<T, MeshComponent> ||
+        std::is_same_v<T, MaterialComponent>)
+    {
+        MarkProxyDirty(id);
+    }
 }
 
 template <typename T>
@@ -262,3 +446,17 @@ const T* Scene::GetComponent(Entity entity) const
     /* Return the component address. */
     return storage->Get(id);
 }
+
+template <typename T>
+void Scene::GetComponentEntities(std::vector<std::uint32_t>& outIds) const
+{
+    const ComponentStorage<T>* storage = FindStorage<T>();
+    if (!storage)
+    {
+        outIds.clear();
+        return;
+    }
+
+    /* Copy the packed ids, storage may reorder as components change. */
+    outIds = storage->GetEntityIds();
+}
@@ -207,6 +207,18 @@ const Mat4& TransformSystem::GetModelMatrix(
     return modelCache[index];
 }
 
+/* Packed cache index for entity id. */
+std::uint32_t TransformSystem::GetModelIndex(std::uint32_t id) const
+{
+    return GetIndex(id);
+}
+
+/* Packed cached matrices. */
+const Mat4* TransformSystem::GetModelMatrices() const
+{
+    return modelCache.data();
+}
+
 /* Explicitly mark transform dirty. */
 void TransformSystem::MarkDirty(std::uint32_t id)
 {
@@ -56,6 +56,13 @@ public:
         std::uint32_t id,
         const TransformComponent& transform) const;
 
+    /* Packed cache index for entity id, 0xFFFFFFFF when absent. */
+    std::uint32_t GetModelIndex(std::uint32_t id) const;
+
+    /* Packed cached matrices, valid until transforms are added or removed. */
+    /* An entry is current once fetched through GetModelMatrix. */
+    const Mat4* GetModelMatrices() const;
+
     /* Explicitly mark transform dirty. */
     void MarkDirty(std::uint32_t id);
 
@@ -0,0 +1,182 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+/* Sweeps the character controller's sphere into a 2x2x2 box from every */
+/* side. It must stop where it first touches a face, edge or corner, */
+/* rounding edges and corners rather than stopping on the grown box, */
+/* slide along a face, and be free to leave a box it starts inside. */
+
+#include "Scene/Collision/CharacterController.h"
+#include "Scene/Scene.h"
+#include "TestHelpers.h"
+
+#include <cmath>
+#include <cstdint>
+
+/* Local helpers. */
+namespace
+{
+    constexpr float kRadius = 0.5f;
+    constexpr float kHalfSize = 1.0f;
+    constexpr float kTolerance = 1e-4f;
+
+    /* Starting distance from the box centre along the travel axis. */
+    constexpr float kStartDistance = 5.0f;
+
+    /* Vector with along on the travel axis and first, second on the next two. */
+    Vec3 FromAxes(std::uint32_t axis, float along, float first, float second)
+    {
+        float values[3];
+        values[axis] = along;
+        values[(axis + 1) % 3] = first;
+        values[(axis + 2) % 3] = second;
+        return Vec3(values[0], values[1], values[2]);
+    }
+
+    bool IsNear(const Vec3& left, const Vec3& right)
+    {
+        return (left - right).Length() <= kTolerance;
+    }
+
+    /* Single-step controller, so a move ends exactly at its first contact. */
+    CharacterController MakeController(float radius)
+    {
+        CharacterController controller;
+        controller.SetRadius(radius);
+        controller.SetSkinWidth(0.0f);
+        controller.SetMaxIterations(1);
+        return controller;
+    }
+
+    /* Travel along each axis from both sides with the given lateral offset; */
+    /* the sphere must stop once its centre is contactAlong from the box centre. */
+    bool CheckApproaches(const Scene& scene, float first, float second, float contactAlong)
+    {
+        CharacterController controller = MakeController(kRadius);
+
+        bool allMatch = true;
+        for (std::uint32_t axis = 0; axis < 3; ++axis)
+        {
+            for (const float side : { -1.0f, 1.0f })
+            {
+                for (const float firstSign : { -1.0f, 1.0f })
+                {
+                    for (const float secondSign : { -1.0f, 1.0f })
+                    {
+                        const float lateralFirst = first * firstSign;
+                        const float lateralSecond = second * secondSign;
+                        const Vec3 start = FromAxes(axis, side * kStartDistance, lateralFirst, lateralSecond);
+                        const Vec3 target = FromAxes(axis, -side * kStartDistance, lateralFirst, lateralSecond);
+                        const Vec3 expected = contactAlong > 0.0f
+                            ? FromAxes(axis, side * contactAlong, lateralFirst, lateralSecond)
+                            : target;
+
+                        allMatch = allMatch && IsNear(controller.Move(scene, start, target), expected);
+                    }
+                }
+            }
+        }
+
+        return allMatch;
+    }
+}
+
+int main()
+{
+    g_TestName = "CharacterControllerTest";
+
+    /* Unit cube bounds scaled to [-1, 1] on every axis. */
+    Scene scene;
+    const Entity box = scene.CreateEntity();
+    scene.AddTransform(box).Scale = Vec3(2.0f * kHalfSize, 2.0f * kHalfSize, 2.0f * kHalfSize);
+
+    /* Faces: flat contact at the radius, anywhere across the face. */
+    Check(CheckApproaches(scene, 0.0f, 0.0f, kHalfSize + kRadius), "face hit head on stops at the radius");
+    Check(CheckApproaches(scene, 0.7f, 0.9f, kHalfSize + kRadius), "face hit off centre stops at the radius");
+
+    /* Edges: passing 0.3 beyond one face, the sphere meets the edge where */
+    /* the remaining 0.4 along the travel axis completes the radius. */
+    const float edgeOffset = kHalfSize + 0.3f;
+    Check(CheckApproaches(scene, edgeOffset, 0.2f, kHalfSize + 0.4f), "edge hit stops on the rounded edge");
+    Check(CheckApproaches(scene, 0.2f, edgeOffset, kHalfSize + 0.4f), "edge hit on the other lateral axis");
+
+    /* Corners: 0.3 beyond two faces leaves sqrt(0.25 - 0.18) along travel. */
+    const float cornerContact = kHalfSize + std::sqrt(kRadius * kRadius - 2.0f * 0.3f * 0.3f);
+    Check(CheckApproaches(scene, edgeOffset, edgeOffset, cornerContact), "corner hit stops on the rounded corner");
+
+    /* Inside the grown box's corner but clear of the rounded corner: no hit. */
+    const float cornerMiss = kHalfSize + 0.4f;
+    Check(CheckApproaches(scene, cornerMiss, cornerMiss, 0.0f), "corner near miss passes the rounded corner");
+    Check(CheckApproaches(scene, kHalfSize + kRadius + 0.01f, 0.0f, 0.0f), "path beside the face passes");
+
+    /* Diagonal approach onto a corner: contact along the diagonal. */
+    {
+        CharacterController controller = MakeController(kRadius);
+        const float contact = kHalfSize + kRadius / std::sqrt(3.0f);
+        const Vec3 end = controller.Move(scene, Vec3(4.0f, 4.0f, 4.0f), Vec3(0.0f, 0.0f, 0.0f));
+        Check(IsNear(end, Vec3(contact, contact, contact)), "diagonal corner hit stops on the corner");
+    }
+
+    /* Slide: hitting a face at an angle keeps the motion along it. */
+    {
+        CharacterController controller;
+        controller.SetRadius(kRadius);
+        controller.SetSkinWidth(0.01f);
+        const Vec3 end = controller.Move(scene, Vec3(-2.0f, 0.0f, -3.0f), Vec3(-1.2f, 0.0f, 3.0f));
+        Check(end.x <= -kHalfSize - kRadius && end.x > -kHalfSize - kRadius - 0.05f,
+            "slide stays outside the face");
+        Check(std::fabs(end.z - 3.0f) <= kTolerance && std::fabs(end.y) <= kTolerance,
+            "slide keeps the motion along the face");
+    }
+
+    /* Starting overlapped: leaving is free, moving further in is blocked. */
+    {
+        CharacterController controller = MakeController(kRadius);
+        const Vec3 inFace(-kHalfSize - 0.3f, 0.0f, 0.0f);
+        Check(IsNear(controller.Move(scene, inFace, Vec3(-4.0f, 0.0f, 0.0f)), Vec3(-4.0f, 0.0f, 0.0f)),
+            "overlapping a face, moving out is free");
+        Check(IsNear(controller.Move(scene, inFace, Vec3(0.0f, 0.0f, 0.0f)), inFace),
+            "overlapping a face, moving in is blocked");
+
+        const Vec3 inCorner(kHalfSize + 0.2f, kHalfSize + 0.2f, kHalfSize + 0.2f);
+        Check(IsNear(controller.Move(scene, inCorner, Vec3(3.0f, 3.0f, 3.0f)), Vec3(3.0f, 3.0f, 3.0f)),
+            "overlapping a corner, moving out is free");
+        Check(IsNear(controller.Move(scene, inCorner, Vec3(0.0f, 0.0f, 0.0f)), inCorner),
+            "overlapping a corner, moving in is blocked");
+    }
+
+    /* Radius zero is a plain segment test against the box itself. */
+    {
+        CharacterController controller = MakeController(0.0f);
+        Check(IsNear(controller.Move(scene, Vec3(0.5f, -4.0f, 0.5f), Vec3(0.5f, 4.0f, 0.5f)),
+            Vec3(0.5f, -kHalfSize, 0.5f)), "a point stops on the face");
+        Check(IsNear(controller.Move(scene, Vec3(1.1f, -4.0f, 1.1f), Vec3(1.1f, 4.0f, 1.1f)),
+            Vec3(1.1f, 4.0f, 1.1f)), "a point beside the box passes");
+    }
+
+    return FinishChecks();
+}
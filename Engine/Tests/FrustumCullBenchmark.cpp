@@ -0,0 +1,97 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* Culls 100k scattered unit boxes against a camera frustum (about 4% */
+/* visible) with CullPackedBounds, against Frustum::Intersects per box. */
+
+#include "Engine/WorkerPool.h"
+#include "Scene/Collision/Frustum.h"
+#include "TestHelpers.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    constexpr std::uint32_t kBoxCount = 100000;
+    constexpr float kSceneHalfSize = 200.0f;
+}
+
+int main()
+{
+    std::mt19937 random(2);
+    std::uniform_real_distribution<float> coordinate(-kSceneHalfSize, kSceneHalfSize);
+
+    /* Flat field of unit boxes around the camera. */
+    PackedBounds bounds;
+    for (std::uint32_t box = 0; box < kBoxCount; ++box)
+    {
+        const Vec3 center(coordinate(random), coordinate(random) * 0.1f, coordinate(random));
+        bounds.Push(box, AABB{ center - Vec3(0.5f, 0.5f, 0.5f), center + Vec3(0.5f, 0.5f, 0.5f) });
+    }
+
+    const Mat4 viewProjection =
+        Mat4::Perspective(45.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, 100.0f) *
+        Mat4::LookAt(Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 0.0f, -1.0f), Vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum = Frustum::FromViewProjection(viewProjection);
+
+    /* The packed cull must agree with the scalar test on every box. */
+    std::vector<std::uint8_t> visible;
+    const std::uint32_t visibleCount = CullPackedBounds(frustum, bounds, visible);
+
+    std::vector<std::uint8_t> reference(kBoxCount);
+    for (std::uint32_t box = 0; box < kBoxCount; ++box)
+    {
+        reference[box] = frustum.Intersects(bounds.GetBounds(box)) ? 1 : 0;
+        if (reference[box] != visible[box])
+        {
+            std::fprintf(stderr, "FrustumCullBenchmark: packed cull differs at box %u\n", box);
+            return 1;
+        }
+    }
+
+    const double packedMilliseconds = MeasureBest([&]()
+        {
+            CullPackedBounds(frustum, bounds, visible);
+        });
+
+    const double scalarMilliseconds = MeasureBest([&]()
+        {
+            for (std::uint32_t box = 0; box < kBoxCount; ++box)
+            {
+                reference[box] = frustum.Intersects(bounds.GetBounds(box)) ? 1 : 0;
+            }
+        });
+
+    std::printf("FrustumCullBenchmark: %u boxes, %u visible\n", kBoxCount, visibleCount);
+    std::printf("FrustumCullBenchmark: CullPackedBounds %.3f ms (%u threads)\n",
+        packedMilliseconds, g_WorkerPool.GetThreadCount() + 1);
+    std::printf("FrustumCullBenchmark: Frustum::Intersects loop %.3f ms\n", scalarMilliseconds);
+    return 0;
+}
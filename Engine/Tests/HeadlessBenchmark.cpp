@@ -0,0 +1,145 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Runs the full engine headless: no window, surface or swapchain, frames */
+/* rendered into offscreen images through the regular DrawFrame path. */
+/* Renders N frames, reports per-frame times, then saves the last frame. */
+/* Needs a Vulkan driver; software ICDs such as lavapipe or SwiftShader */
+/* work. Run from Engine/ so the ../Assets paths resolve. */
+/* Usage: HeadlessBenchmark [frames] [output.png] */
+
+#include "Engine/EngineRuntime.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    /* Frames rendered before timing starts: pipelines, caches, first uploads. */
+    constexpr std::uint32_t kWarmupFrames = 10;
+    constexpr std::uint32_t kDefaultFrames = 300;
+    constexpr float kFrameTime = 1.0f / 60.0f;
+
+    /* Value at a fraction of the sorted samples. */
+    double Percentile(const std::vector<double>& sorted, double fraction)
+    {
+        const std::size_t index = static_cast<std::size_t>(
+            fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[index];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::uint32_t frameCount = kDefaultFrames;
+    if (argc > 1)
+    {
+        frameCount = static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10));
+    }
+
+    const std::string outputPath = argc > 2 ? argv[2] : "HeadlessFrame.png";
+    if (frameCount == 0)
+    {
+        std::fprintf(stderr, "HeadlessBenchmark: frame count must be positive\n");
+        return 1;
+    }
+
+    EngineConfig config;
+    config.Headless = true;
+
+    EngineRuntime engine;
+    if (!engine.Initialize(nullptr, config))
+    {
+        std::fprintf(stderr, "HeadlessBenchmark: engine initialization failed\n");
+        return 1;
+    }
+
+    for (std::uint32_t frame = 0; frame < kWarmupFrames; ++frame)
+    {
+        engine.Tick(kFrameTime);
+    }
+
+    /* Tick times include waiting on the frame slot's fence, so once the */
+    /* frames in flight are full they track GPU throughput as well. */
+    std::vector<double> frameMilliseconds;
+    frameMilliseconds.reserve(frameCount);
+    for (std::uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        engine.Tick(kFrameTime);
+        const auto end = std::chrono::steady_clock::now();
+        frameMilliseconds.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    double totalMilliseconds = 0.0;
+    for (const double milliseconds : frameMilliseconds)
+    {
+        totalMilliseconds += milliseconds;
+    }
+
+    std::sort(frameMilliseconds.begin(), frameMilliseconds.end());
+    std::printf("HeadlessBenchmark: %u frames at %ux%u, %u in flight\n",
+        frameCount, config.HeadlessWidth, config.HeadlessHeight, config.FramesInFlight);
+    std::printf("HeadlessBenchmark: %.3f ms average, %.3f ms median, %.3f ms p95, %.3f ms max\n",
+        totalMilliseconds / frameCount,
+        Percentile(frameMilliseconds, 0.5),
+        Percentile(frameMilliseconds, 0.95),
+        frameMilliseconds.back());
+
+    /* A frame of one colour means nothing but the clear reached the image. */
+    std::vector<std::uint8_t> pixels;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    if (!engine.ReadbackFrame(pixels, width, height) || !engine.SaveFrame(outputPath))
+    {
+        std::fprintf(stderr, "HeadlessBenchmark: failed to save the last frame\n");
+        return 1;
+    }
+
+    bool uniform = true;
+    for (std::size_t index = 4; index < pixels.size() && uniform; index += 4)
+    {
+        uniform = pixels[index] == pixels[0] &&
+            pixels[index + 1] == pixels[1] &&
+            pixels[index + 2] == pixels[2];
+    }
+
+    engine.Shutdown();
+
+    if (uniform)
+    {
+        std::fprintf(stderr, "HeadlessBenchmark: last frame is a single colour\n");
+        return 1;
+    }
+
+    std::printf("HeadlessBenchmark: saved %ux%u frame to %s\n", width, height, outputPath.c_str());
+    return 0;
+}
@@ -0,0 +1,229 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* Deterministic checks of the occlusion rasterizer and visibility */
+/* queries: a wall in front of the camera must hide boxes fully behind */
+/* it and nothing else, and depth must not depend on the thread count. */
+
+#include "Engine/WorkerPool.h"
+#include "Scene/Collision/OcclusionBuffer.h"
+#include "TestHelpers.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    /* Unit cube triangle list centred on the origin. */
+    void BuildCube(std::vector<Vec3>& outPositions, std::vector<std::uint32_t>& outIndices)
+    {
+        outPositions.clear();
+        for (std::uint32_t corner = 0; corner < 8; ++corner)
+        {
+            outPositions.push_back(Vec3(
+                (corner & 1) ? 0.5f : -0.5f,
+                (corner & 2) ? 0.5f : -0.5f,
+                (corner & 4) ? 0.5f : -0.5f));
+        }
+
+        outIndices = {
+            0, 2, 3, 0, 3, 1,
+            4, 5, 7, 4, 7, 6,
+            0, 1, 5, 0, 5, 4,
+            2, 6, 7, 2, 7, 3,
+            0, 4, 6, 0, 6, 2,
+            1, 3, 7, 1, 7, 5 };
+    }
+
+    /* Model matrix scaling then translating, column-major. */
+    Mat4 MakeModel(const Vec3& position, const Vec3& scale)
+    {
+        Mat4 model = Mat4::Identity();
+        model.m[0] = scale.x;
+        model.m[5] = scale.y;
+        model.m[10] = scale.z;
+        model.m[12] = position.x;
+        model.m[13] = position.y;
+        model.m[14] = position.z;
+        return model;
+    }
+
+    /* Axis-aligned box from a centre and half size. */
+    AABB MakeBox(const Vec3& center, const Vec3& halfSize)
+    {
+        return AABB{ center - halfSize, center + halfSize };
+    }
+
+    /* Camera at the origin looking down -Z, 45 degree 16:9 view. */
+    Mat4 MakeViewProjection()
+    {
+        return Mat4::Perspective(45.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, 100.0f) *
+            Mat4::LookAt(Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 0.0f, -1.0f), Vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    /* 20x10x1 wall whose front face sits at z = -9.5. */
+    Mat4 MakeWallModel()
+    {
+        return MakeModel(Vec3(0.0f, 0.0f, -10.0f), Vec3(20.0f, 10.0f, 1.0f));
+    }
+
+    /* Nothing queued: no occluders, empty depth, everything visible. */
+    void TestEmptyBuffer()
+    {
+        OcclusionBuffer occlusion;
+        occlusion.Begin(MakeViewProjection());
+        occlusion.Rasterize();
+
+        Check(!occlusion.HasOccluders(), "empty buffer reports no occluders");
+
+        bool allClear = true;
+        for (const float value : occlusion.GetDepth())
+        {
+            allClear = allClear && value == 1.0f;
+        }
+        Check(allClear, "empty buffer depth is cleared to 1");
+        Check(occlusion.IsVisible(MakeBox(Vec3(0.0f, 0.0f, -20.0f), Vec3(0.5f, 0.5f, 0.5f))),
+            "empty buffer hides nothing");
+    }
+
+    /* A single wall hides what is fully behind it and nothing else. */
+    void TestWallOccluder()
+    {
+        std::vector<Vec3> positions;
+        std::vector<std::uint32_t> indices;
+        BuildCube(positions, indices);
+
+        OcclusionBuffer occlusion;
+        occlusion.Begin(MakeViewProjection());
+        occlusion.AddOccluder(positions, indices, MakeWallModel());
+        occlusion.Rasterize();
+
+        Check(occlusion.HasOccluders(), "wall is rasterized");
+
+        const Vec3 half(0.5f, 0.5f, 0.5f);
+        Check(!occlusion.IsVisible(MakeBox(Vec3(0.0f, 0.0f, -20.0f), half)),
+            "box centred behind the wall is hidden");
+        Check(!occlusion.IsVisible(MakeBox(Vec3(6.0f, -3.0f, -15.0f), half)),
+            "box behind the wall off centre is hidden");
+        Check(occlusion.IsVisible(MakeBox(Vec3(0.0f, 0.0f, -5.0f), half)),
+            "box in front of the wall is visible");
+        Check(occlusion.IsVisible(MakeBox(Vec3(0.0f, 0.0f, -9.5f), half)),
+            "box touching the wall front is visible");
+        Check(occlusion.IsVisible(MakeBox(Vec3(25.0f, 0.0f, -20.0f), half)),
+            "box behind but outside the wall silhouette is visible");
+        Check(occlusion.IsVisible(MakeBox(Vec3(21.0f, 0.0f, -20.0f), Vec3(1.0f, 0.5f, 0.5f))),
+            "box straddling the wall silhouette is visible");
+        Check(occlusion.IsVisible(MakeBox(Vec3(0.0f, 0.0f, 0.0f), half)),
+            "box around the camera is visible");
+        Check(occlusion.IsVisible(MakeBox(Vec3(0.0f, 0.0f, 5.0f), half)),
+            "box behind the camera is visible");
+
+        /* The packed query must agree with IsVisible and skip hidden entries. */
+        PackedBounds bounds;
+        bounds.Push(0, MakeBox(Vec3(0.0f, 0.0f, -20.0f), half));
+        bounds.Push(1, MakeBox(Vec3(0.0f, 0.0f, -5.0f), half));
+        bounds.Push(2, MakeBox(Vec3(6.0f, -3.0f, -15.0f), half));
+        bounds.Push(3, MakeBox(Vec3(25.0f, 0.0f, -20.0f), half));
+
+        std::vector<std::uint8_t> visible = { 1, 1, 0, 1 };
+        const std::uint32_t hidden = occlusion.CullPackedBounds(bounds, visible);
+        Check(hidden == 1, "packed cull hides exactly one new entry");
+        Check(visible[0] == 0 && visible[1] == 1 && visible[2] == 0 && visible[3] == 1,
+            "packed cull matches IsVisible");
+
+        /* A frame with no occluders must not keep the wall's triangles. */
+        occlusion.Begin(MakeViewProjection());
+        occlusion.Rasterize();
+        Check(!occlusion.HasOccluders(), "a frame with no occluders drops the previous wall");
+        Check(occlusion.IsVisible(MakeBox(Vec3(0.0f, 0.0f, -20.0f), half)),
+            "a frame with no occluders hides nothing");
+    }
+
+    /* Depth from many occluders must be bit-identical for any thread count. */
+    void TestDeterministicAcrossThreads()
+    {
+        std::vector<Vec3> positions;
+        std::vector<std::uint32_t> indices;
+        BuildCube(positions, indices);
+
+        /* Enough occluders and triangles for the parallel paths to engage. */
+        std::vector<Mat4> models;
+        for (std::uint32_t row = 0; row < 8; ++row)
+        {
+            for (std::uint32_t column = 0; column < 12; ++column)
+            {
+                const Vec3 position(
+                    static_cast<float>(column) * 2.5f - 14.0f,
+                    static_cast<float>(row) * 1.7f - 6.0f,
+                    -12.0f - static_cast<float>((row * 7 + column * 3) % 11));
+                models.push_back(MakeModel(position, Vec3(1.5f, 1.2f, 1.0f)));
+            }
+        }
+
+        std::vector<float> reference;
+        const std::uint32_t threadCounts[] = { 0, 1, 3, 7 };
+        for (const std::uint32_t threadCount : threadCounts)
+        {
+            g_WorkerPool.Stop();
+            g_WorkerPool.Start(threadCount);
+
+            OcclusionBuffer occlusion;
+            occlusion.Resize(320, 180);
+            occlusion.Begin(MakeViewProjection());
+            for (const Mat4& model : models)
+            {
+                occlusion.AddOccluder(positions, indices, model);
+            }
+            occlusion.Rasterize();
+
+            const std::vector<float>& depth = occlusion.GetDepth();
+            if (reference.empty())
+            {
+                reference = depth;
+                continue;
+            }
+
+            Check(depth.size() == reference.size() &&
+                std::memcmp(depth.data(), reference.data(), depth.size() * sizeof(float)) == 0,
+                "depth is identical across thread counts");
+        }
+
+        g_WorkerPool.Stop();
+    }
+}
+
+int main()
+{
+    g_TestName = "OcclusionBufferTest";
+
+    TestEmptyBuffer();
+    TestWallOccluder();
+    TestDeterministicAcrossThreads();
+
+    return FinishChecks();
+}
@@ -0,0 +1,120 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* Steps 10k resting boxes (a 50x50 grid of 4-box stacks on a static */
+/* ground) and reports the average cost of one 60 Hz physics step. */
+
+#include "Engine/WorkerPool.h"
+#include "Physics/PhysicsWorld.h"
+#include "Scene/Scene.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    /* Grid of stacks and frames timed. */
+    constexpr std::uint32_t kGridSize = 50;
+    constexpr std::uint32_t kStackHeight = 4;
+    constexpr std::uint32_t kWarmupFrames = 30;
+    constexpr std::uint32_t kTimedFrames = 120;
+    constexpr float kFrameTime = 1.0f / 60.0f;
+}
+
+int main()
+{
+    Scene scene;
+    PhysicsWorld world;
+
+    /* Static ground under the whole grid. */
+    const Entity ground = scene.CreateEntity();
+    TransformComponent& groundTransform = scene.AddTransform(ground);
+    groundTransform.Position = Vec3(37.0f, -0.5f, 37.0f);
+    groundTransform.Scale = Vec3(100.0f, 1.0f, 100.0f);
+    scene.AddComponent<RigidBodyComponent>(ground).Mass = 0.0f;
+
+    /* Unit boxes stacked with a small gap, spaced apart between stacks. */
+    std::vector<Entity> boxes;
+    boxes.reserve(kGridSize * kGridSize * kStackHeight);
+    for (std::uint32_t x = 0; x < kGridSize; ++x)
+    {
+        for (std::uint32_t z = 0; z < kGridSize; ++z)
+        {
+            for (std::uint32_t y = 0; y < kStackHeight; ++y)
+            {
+                const Entity box = scene.CreateEntity();
+                scene.AddTransform(box).Position = Vec3(
+                    static_cast<float>(x) * 1.5f,
+                    0.5f + static_cast<float>(y) * 1.05f,
+                    static_cast<float>(z) * 1.5f);
+                scene.AddComponent<RigidBodyComponent>(box);
+                boxes.push_back(box);
+            }
+        }
+    }
+
+    /* Settle the stacks so timing covers resting contact, the common case. */
+    for (std::uint32_t frame = 0; frame < kWarmupFrames; ++frame)
+    {
+        world.Step(scene, kFrameTime);
+    }
+
+    double totalMilliseconds = 0.0;
+    for (std::uint32_t frame = 0; frame < kTimedFrames; ++frame)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        world.Step(scene, kFrameTime);
+        const auto end = std::chrono::steady_clock::now();
+        totalMilliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    /* Every box should rest on the ground or the box below it. */
+    std::uint32_t fallen = 0;
+    for (const Entity box : boxes)
+    {
+        if (scene.GetTransform(box)->Position.y < 0.45f)
+        {
+            ++fallen;
+        }
+    }
+
+    const PhysicsStats& stats = world.GetStats();
+    std::printf("PhysicsBenchmark: %u bodies, %u contacts, %u islands\n",
+        stats.BodyCount, stats.ContactCount, stats.IslandCount);
+    std::printf("PhysicsBenchmark: %.3f ms per step (%u threads)\n",
+        totalMilliseconds / kTimedFrames, g_WorkerPool.GetThreadCount() + 1);
+
+    if (fallen > 0)
+    {
+        std::fprintf(stderr, "PhysicsBenchmark: %u boxes sank through the ground\n", fallen);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,341 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* Decodes small PNGs built by an independent encoder (Python's zlib at */
+/* level 9, so fixed and dynamic Huffman blocks, every scanline filter, */
+/* IDAT split across chunks) and checks the pixels against the pattern */
+/* they were made from. The writer's stored-block output must round trip, */
+/* and damaged files must be rejected rather than decoded. */
+
+#include "Renderer/PngReader.h"
+#include "Renderer/PngWriter.h"
+#include "TestHelpers.h"
+
+#include <cstdint>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    /* Size of the encoded test images. */
+    constexpr std::uint32_t kWidth = 24;
+    constexpr std::uint32_t kHeight = 20;
+
+    /* Channel pattern the RGB and gray-alpha images were encoded from. */
+    std::uint8_t PatternValue(std::uint32_t x, std::uint32_t y, std::uint32_t channel)
+    {
+        return static_cast<std::uint8_t>(x * x * 3 + y * 5 + channel * 40 + ((x * y) >> 2));
+    }
+
+    /* 24x20 RGB, row filters cycle none/sub/up/average/paeth, fixed Huffman. */
+    const std::uint8_t kRgbPng[] = {
+        0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+        0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x14, 0x08, 0x02, 0x00, 0x00, 0x00, 0x18, 0xD7, 0x6A,
+        0xD4, 0x00, 0x00, 0x01, 0xCE, 0x49, 0x44, 0x41, 0x54, 0x78, 0xDA, 0x63, 0x60, 0xD0, 0x08, 0x60,
+        0xD6, 0x0E, 0xE6, 0x31, 0x89, 0x91, 0x76, 0xCE, 0x36, 0x88, 0x68, 0xF0, 0x2E, 0x9E, 0x9D, 0x33,
+        0x65, 0xCF, 0xE4, 0xDD, 0x8F, 0x0F, 0xBC, 0x10, 0xF8, 0x2C, 0xED, 0xAC, 0x13, 0x52, 0x93, 0x3D,
+        0x79, 0xF7, 0x86, 0x1B, 0x0C, 0xBF, 0x95, 0xBD, 0x7D, 0x4A, 0xE6, 0x2C, 0x3E, 0xFD, 0x19, 0xA8,
+        0x3E, 0xB9, 0x7B, 0xF3, 0x99, 0x2F, 0x32, 0xD6, 0xC9, 0xDD, 0x40, 0x71, 0xED, 0xE0, 0xEA, 0x35,
+        0x57, 0xFE, 0x18, 0x47, 0x37, 0x33, 0xB2, 0xEA, 0x86, 0x32, 0x33, 0x33, 0x73, 0x72, 0x72, 0xF2,
+        0xF3, 0xF3, 0x8B, 0x89, 0x89, 0x49, 0x4B, 0x4B, 0x2B, 0x2A, 0x2A, 0xAA, 0xAB, 0xAB, 0xEB, 0xE9,
+        0xE9, 0x19, 0x1B, 0x1B, 0x5B, 0x5A, 0x5A, 0xDA, 0xDB, 0xDB, 0xBB, 0xB9, 0xB9, 0x79, 0x7B, 0x7B,
+        0x07, 0x06, 0x06, 0x86, 0x87, 0x87, 0xC7, 0xC5, 0xC5, 0x25, 0x27, 0x27, 0x67, 0x66, 0x66, 0xE6,
+        0xE7, 0xE7, 0x97, 0x95, 0x95, 0x55, 0x57, 0x57, 0x37, 0x36, 0x36, 0xB6, 0xB7, 0xB7, 0x33, 0xB1,
+        0x82, 0x01, 0x1B, 0x12, 0x60, 0x47, 0x02, 0x1C, 0x48, 0x80, 0x13, 0x09, 0x70, 0x21, 0x01, 0x6E,
+        0x30, 0x60, 0xE6, 0x92, 0x33, 0x62, 0x61, 0x61, 0x01, 0xAA, 0x03, 0x72, 0xF8, 0xF8, 0xF8, 0x04,
+        0x05, 0x05, 0x45, 0x44, 0x44, 0x24, 0x24, 0x24, 0xA4, 0xA5, 0x67, 0xCF, 0x9D, 0x2B, 0x0B, 0x74,
+        0x9D, 0x8A, 0x8A, 0x8A, 0xBA, 0xFA, 0xF2, 0x55, 0xAB, 0xB4, 0x74, 0x75, 0x75, 0x0D, 0x0D, 0x37,
+        0x6E, 0xD9, 0x62, 0x62, 0x66, 0x66, 0x66, 0xB5, 0x6B, 0xD7, 0x5E, 0x5B, 0x5B, 0x07, 0x87, 0x03,
+        0x87, 0x0F, 0x3B, 0xBB, 0xB9, 0x1D, 0x3B, 0x75, 0xCA, 0x8B, 0x05, 0xE8, 0x1C, 0xA0, 0x41, 0xD8,
+        0x9D, 0x63, 0x42, 0x84, 0x73, 0x6A, 0x20, 0x0E, 0xE2, 0x66, 0x90, 0x74, 0xCC, 0x94, 0x75, 0xCD,
+        0x55, 0xF7, 0x2F, 0x37, 0x8F, 0x6F, 0xF7, 0x2B, 0x9B, 0x97, 0x35, 0x69, 0x57, 0xCF, 0x96, 0x3B,
+        0x5B, 0xEE, 0xB0, 0x3C, 0xE6, 0x36, 0x16, 0xB7, 0x4F, 0x0F, 0xAC, 0x5C, 0x38, 0x71, 0xE7, 0xC3,
+        0x1B, 0x0C, 0x1A, 0x2A, 0x3E, 0x25, 0x65, 0xF3, 0x8E, 0x9D, 0xFB, 0x26, 0xA7, 0x1B, 0x5A, 0x0B,
+        0x14, 0x01, 0x86, 0x3D, 0x30, 0x12, 0x1E, 0x71, 0x19, 0xC5, 0xB5, 0xAD, 0x7B, 0xC0, 0x61, 0x90,
+        0x31, 0x61, 0x07, 0xA3, 0x9C, 0x5B, 0x1E, 0xD0, 0x45, 0x40, 0x23, 0x05, 0x04, 0x04, 0xC4, 0xC5,
+        0xC5, 0x65, 0x64, 0x64, 0x94, 0x95, 0x95, 0x35, 0x34, 0x34, 0xF4, 0xF5, 0xF5, 0x4D, 0x4C, 0x4C,
+        0xAC, 0xAD, 0xAD, 0x1D, 0x1C, 0x1C, 0xDC, 0xDD, 0xDD, 0x7D, 0x7C, 0x7C, 0x82, 0x83, 0x83, 0x23,
+        0x22, 0x22, 0xE2, 0xE3, 0xE3, 0x53, 0x52, 0x52, 0xB2, 0xB3, 0xB3, 0x0B, 0x0A, 0x0A, 0xCA, 0xCB,
+        0xCB, 0x6B, 0x6A, 0x6A, 0x9A, 0x9B, 0x9B, 0x3B, 0x3A, 0x3A, 0xA0, 0x81, 0x4D, 0x79, 0x78, 0x33,
+        0x8B, 0x6B, 0xDB, 0x03, 0x75, 0x02, 0x25, 0x78, 0x78, 0x78, 0x80, 0x29, 0x40, 0x48, 0x48, 0x48,
+        0x54, 0x54, 0x54, 0x42, 0x62, 0x86, 0xF4, 0x6C, 0xE9, 0xF9, 0xF2, 0xF2, 0x4A, 0x4A, 0x4A, 0xAA,
+        0xAA, 0xAA, 0x1A, 0x2B, 0x56, 0xAC, 0xD6, 0xD6, 0x06, 0x26, 0x08, 0xC3, 0x8D, 0x1B, 0xB7, 0x98,
+        0x98, 0x58, 0x58, 0x58, 0xEC, 0xDE, 0xBD, 0x3E, 0x04, 0xA7, 0xBC, 0x00, 0x00, 0x01, 0xCE, 0x49,
+        0x44, 0x41, 0x54, 0xDB, 0xCE, 0xCE, 0xCE, 0xF1, 0xE0, 0x41, 0x17, 0x17, 0x17, 0xF7, 0xE3, 0xC7,
+        0xBD, 0xBC, 0xC0, 0x81, 0x4D, 0x84, 0xA3, 0x3C, 0x30, 0x1C, 0x95, 0x8D, 0xE6, 0x28, 0x06, 0xA3,
+        0xA8, 0x26, 0x60, 0x30, 0x3B, 0x67, 0x4F, 0x0E, 0xA9, 0x59, 0x02, 0x4C, 0xD3, 0x9D, 0x1B, 0x6F,
+        0xAE, 0xBD, 0xFA, 0xF7, 0xDA, 0x3F, 0x35, 0x36, 0xBD, 0x30, 0x60, 0xDA, 0x2D, 0x9F, 0x7F, 0x7C,
+        0xC7, 0x03, 0x0E, 0x60, 0x6A, 0xF6, 0x2D, 0x9D, 0xBB, 0xF0, 0xE4, 0xC7, 0x5F, 0x4A, 0x5E, 0x51,
+        0x4D, 0xAB, 0xF6, 0x3F, 0xE7, 0x07, 0x26, 0xE8, 0x39, 0x47, 0xDE, 0x88, 0xD8, 0xA4, 0x00, 0x03,
+        0x5E, 0xD4, 0x36, 0x75, 0xDE, 0xB1, 0x77, 0x8C, 0x40, 0x53, 0x80, 0x6E, 0x01, 0xFA, 0x0B, 0xE8,
+        0x29, 0x60, 0xF2, 0x91, 0x95, 0x95, 0x05, 0x26, 0x1C, 0x2D, 0x2D, 0x2D, 0x03, 0x03, 0x03, 0x53,
+        0x53, 0x53, 0x1B, 0x1B, 0x1B, 0x27, 0x27, 0x27, 0x0F, 0x0F, 0x0F, 0x5F, 0x5F, 0xDF, 0x90, 0x90,
+        0x90, 0xA8, 0xA8, 0xA8, 0x84, 0x84, 0x84, 0xD4, 0xD4, 0xD4, 0x9C, 0x9C, 0x9C, 0xA2, 0xA2, 0xA2,
+        0x8A, 0x8A, 0x8A, 0xDA, 0xDA, 0xDA, 0x96, 0x96, 0x96, 0xAE, 0xAE, 0x2E, 0x26, 0xAA, 0x24, 0x6B,
+        0x50, 0x60, 0x2B, 0x9B, 0x7B, 0xC3, 0x03, 0x1B, 0x98, 0x02, 0xC0, 0x81, 0x3D, 0x55, 0x62, 0x86,
+        0xC4, 0x1C, 0x19, 0x19, 0x79, 0x68, 0x60, 0x2F, 0x5D, 0xB9, 0x52, 0x53, 0x1B, 0x14, 0xD8, 0xEB,
+        0x36, 0x6E, 0x34, 0x04, 0x3A, 0xD3, 0xC2, 0x62, 0xC7, 0x6E, 0x6B, 0x6B, 0x3B, 0xBB, 0x7D, 0x87,
+        0x0E, 0x39, 0x01, 0x03, 0xFB, 0xF8, 0x71, 0x77, 0x2F, 0xAF, 0x53, 0x2C, 0xD4, 0xCA, 0x6B, 0x0C,
+        0xC0, 0x72, 0x03, 0x98, 0x7C, 0x81, 0x09, 0xB4, 0x70, 0xE6, 0xC1, 0xAE, 0x4D, 0xB7, 0x56, 0x5C,
+        0xF8, 0x71, 0xF6, 0xAB, 0xEC, 0x0F, 0x05, 0x0F, 0xCD, 0xC0, 0xCA, 0xF8, 0xF6, 0xF5, 0xC0, 0x10,
+        0xBD, 0xCF, 0xAE, 0xAF, 0x11, 0x50, 0x01, 0x4C, 0xD6, 0xA7, 0x3F, 0x4B, 0xAB, 0xF9, 0x95, 0xB5,
+        0xAF, 0xBF, 0xFE, 0x56, 0xD4, 0x16, 0x18, 0xE4, 0x40, 0x65, 0x6E, 0x79, 0xD3, 0x80, 0x21, 0xEE,
+        0x59, 0x38, 0xF3, 0xCA, 0x1F, 0x15, 0xC6, 0x80, 0x8A, 0x05, 0x40, 0x9B, 0x79, 0x79, 0x79, 0x85,
+        0x85, 0x85, 0x25, 0x25, 0x25, 0x81, 0xDE, 0x01, 0x26, 0x1C, 0xA0, 0x47, 0x0C, 0x0D, 0x0D, 0xCD,
+        0xCD, 0xCD, 0x6D, 0x6D, 0x6D, 0x9D, 0x9D, 0x9D, 0x3D, 0x3D, 0x3D, 0xFD, 0xFD, 0xFD, 0x43, 0x43,
+        0x43, 0xA3, 0xA3, 0xA3, 0x13, 0x13, 0x13, 0xD3, 0xD3, 0xD3, 0x73, 0x73, 0x73, 0x8B, 0x8B, 0x8B,
+        0x2B, 0x2B, 0x2B, 0xEB, 0xEB, 0xEB, 0x5B, 0x5B, 0x5B, 0xBB, 0xBB, 0xBB, 0x99, 0x88, 0x4B, 0x47,
+        0x84, 0x3D, 0xC8, 0x6C, 0xE0, 0x12, 0x01, 0xD4, 0x06, 0x64, 0x01, 0x1D, 0x05, 0x0C, 0x6C, 0x61,
+        0xE1, 0xC9, 0xE2, 0xD3, 0xC5, 0x67, 0x4A, 0x4A, 0x02, 0xD3, 0x01, 0xD0, 0x75, 0xC0, 0x7C, 0xA7,
+        0xB6, 0x4C, 0x6D, 0xA5, 0xA6, 0xA6, 0x8E, 0x8E, 0x8E, 0xC1, 0x86, 0x0D, 0x9B, 0x8C, 0x8C, 0x80,
+        0x65, 0xC8, 0x8E, 0x1D, 0x3B, 0x80, 0xC9, 0xC2, 0x7E, 0xFF, 0xFE, 0x43, 0x4E, 0x4E, 0xAE, 0x47,
+        0x8F, 0x9E, 0xF4, 0xF4, 0xF4, 0x3E, 0x7D, 0x9A, 0x85, 0x5A, 0x79, 0x0D, 0x00, 0xB0, 0xB7, 0x40,
+        0x66, 0x85, 0x7F, 0x97, 0xD9, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60,
+        0x82,
+    };
+
+    /* Same size gray-alpha, channels 0 and 1 of the pattern, fixed Huffman. */
+    const std::uint8_t kGrayAlphaPng[] = {
+        0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+        0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x14, 0x08, 0x04, 0x00, 0x00, 0x00, 0x3D, 0xBC, 0x35,
+        0x08, 0x00, 0x00, 0x01, 0x48, 0x49, 0x44, 0x41, 0x54, 0x78, 0x01, 0x63, 0x60, 0xD0, 0x60, 0xD6,
+        0xE6, 0x31, 0x91, 0x76, 0x36, 0x88, 0xF0, 0x2E, 0xCE, 0x99, 0x32, 0x79, 0xF7, 0x81, 0x17, 0x9F,
+        0xA5, 0x75, 0x42, 0xB2, 0x27, 0x6F, 0xB8, 0xF1, 0x5B, 0xD9, 0xA7, 0x64, 0xF1, 0x69, 0x06, 0x8D,
+        0xE4, 0xEE, 0x33, 0x5F, 0xAC, 0x93, 0x37, 0xDC, 0xD0, 0x0E, 0x5E, 0x73, 0xC5, 0x38, 0x9A, 0x91,
+        0x55, 0x97, 0x99, 0x99, 0x93, 0x93, 0x9F, 0x5F, 0x4C, 0x4C, 0x5A, 0x5A, 0x51, 0x51, 0x5D, 0x5D,
+        0x4F, 0xCF, 0xD8, 0xD8, 0xD2, 0xD2, 0xDE, 0xDE, 0xCD, 0xCD, 0xDB, 0x3B, 0x30, 0x30, 0x3C, 0x3C,
+        0x2E, 0x2E, 0x39, 0x39, 0x33, 0x33, 0x3F, 0xBF, 0xAC, 0xAC, 0xBA, 0xBA, 0xB1, 0xB1, 0xBD, 0x9D,
+        0x89, 0x15, 0x08, 0xD8, 0xA0, 0x80, 0x1D, 0x0A, 0x38, 0xA0, 0x80, 0x13, 0x0A, 0xB8, 0xA0, 0x80,
+        0x1B, 0x08, 0x98, 0xB9, 0xE4, 0x58, 0x58, 0x38, 0x38, 0xB8, 0xB9, 0xF9, 0xF8, 0x04, 0x05, 0x45,
+        0x44, 0x24, 0x24, 0xA4, 0xA5, 0xE7, 0xCE, 0x55, 0x54, 0x54, 0x51, 0x51, 0x57, 0x5F, 0xB5, 0x4A,
+        0x57, 0xD7, 0xD0, 0x70, 0xCB, 0x16, 0x33, 0x33, 0xAB, 0x5D, 0x7B, 0x6D, 0x1D, 0x1C, 0x0E, 0x1F,
+        0x76, 0x73, 0x3B, 0x75, 0x8A, 0x85, 0x95, 0x95, 0x85, 0x05, 0xCD, 0x7C, 0x13, 0x1C, 0xE6, 0xD7,
+        0x80, 0x6C, 0x60, 0x90, 0x74, 0x94, 0x75, 0x55, 0xF7, 0x37, 0x8F, 0xF7, 0x2B, 0xCB, 0x9A, 0xD4,
+        0xB3, 0x65, 0xCB, 0x9D, 0xC7, 0xDC, 0xE2, 0xF6, 0x81, 0x95, 0x13, 0x77, 0xDE, 0x60, 0x50, 0xF1,
+        0x29, 0x9B, 0x77, 0xEE, 0x9B, 0x6E, 0xE8, 0xC4, 0x9D, 0xBF, 0x95, 0xB3, 0x27, 0x3F, 0xE2, 0x8A,
+        0x6B, 0x7B, 0xC0, 0x91, 0x31, 0x81, 0x51, 0xCE, 0x8D, 0x85, 0x85, 0x9B, 0x5B, 0x40, 0x40, 0x5C,
+        0x5C, 0x46, 0x46, 0x59, 0x59, 0x43, 0x43, 0x5F, 0xDF, 0xC4, 0xC4, 0xDA, 0xDA, 0xC1, 0xC1, 0xDD,
+        0xDD, 0xC7, 0x27, 0x38, 0x38, 0x22, 0x22, 0x3E, 0x3E, 0x25, 0x25, 0x3B, 0xBB, 0xA0, 0xA0, 0xBC,
+        0xBC, 0xA6, 0xA6, 0xB9, 0xB9, 0xA3, 0x03, 0xEC, 0x69, 0x52, 0xBC, 0xCD, 0x2C, 0xAE, 0xCD, 0xC6,
+        0xC6, 0xC9, 0xC9, 0xC3, 0xC3, 0xCF, 0x2F, 0x24, 0x24, 0x2A, 0x0A, 0xF4, 0xF4, 0xEC, 0xF9, 0xF2,
+        0x4A, 0x4A, 0xAA, 0xAA, 0x1A, 0x2B, 0x56, 0x6B, 0xEB, 0xE9, 0x19, 0x6E, 0xDC, 0x62, 0x62, 0x61,
+        0xB1, 0xE9, 0xB1, 0x87, 0xE9, 0x00, 0x00, 0x01, 0x48, 0x49, 0x44, 0x41, 0x54, 0x7B, 0xB7, 0x9D,
+        0x9D, 0xE3, 0x41, 0x17, 0x17, 0xF7, 0xE3, 0x5E, 0x5E, 0x2C, 0xAC, 0xAC, 0xA4, 0xD9, 0xC1, 0x60,
+        0x14, 0x65, 0x1E, 0xEF, 0x9C, 0x1D, 0x52, 0x93, 0x33, 0xA5, 0x73, 0xE3, 0xDA, 0xAB, 0xD7, 0xFE,
+        0xB1, 0xE9, 0x59, 0x27, 0x97, 0xCF, 0xDF, 0xF1, 0x80, 0x41, 0xC3, 0xB7, 0x74, 0xE1, 0xC9, 0x5F,
+        0x4A, 0x51, 0x4D, 0xFB, 0x9F, 0x6B, 0x07, 0xCF, 0x39, 0x22, 0x62, 0x33, 0x71, 0xA7, 0xA8, 0xED,
+        0xBC, 0x63, 0x8C, 0xE6, 0xF1, 0xAC, 0xAC, 0x3C, 0x3C, 0x42, 0x42, 0x12, 0x12, 0xB2, 0xB2, 0x2A,
+        0x2A, 0x5A, 0x5A, 0x06, 0x06, 0xA6, 0xA6, 0x36, 0x36, 0x4E, 0x4E, 0x1E, 0x1E, 0xBE, 0xBE, 0x21,
+        0x21, 0x51, 0x51, 0x09, 0x09, 0xA9, 0xA9, 0x39, 0x39, 0x45, 0x45, 0x15, 0x15, 0xB5, 0xB5, 0x2D,
+        0x2D, 0x5D, 0x5D, 0x4C, 0xA4, 0xC5, 0x33, 0xD0, 0xD3, 0xCA, 0xE6, 0x10, 0x4F, 0x0B, 0x08, 0x80,
+        0x3D, 0x3D, 0x63, 0x8E, 0x8C, 0x3C, 0xD8, 0xD3, 0x2B, 0x57, 0x6A, 0x03, 0x3D, 0xBD, 0x71, 0xA3,
+        0xA9, 0x29, 0xD0, 0xD3, 0xD6, 0x76, 0x76, 0x87, 0x0E, 0xB9, 0xB8, 0x1C, 0x87, 0x79, 0x9A, 0x14,
+        0x3B, 0x18, 0xBC, 0x8B, 0x03, 0x2B, 0xE3, 0xDA, 0x0A, 0x67, 0x76, 0x6D, 0x5A, 0x71, 0xE1, 0xEC,
+        0xD7, 0x1F, 0x0A, 0x9A, 0x81, 0xF1, 0xED, 0x73, 0x8E, 0xDC, 0x67, 0xD7, 0x08, 0x28, 0x9B, 0x77,
+        0xFA, 0xB3, 0x9A, 0x5F, 0xFB, 0xFA, 0xB7, 0xA2, 0x51, 0x4D, 0x67, 0xBF, 0xBA, 0xE5, 0x1D, 0x79,
+        0xE3, 0x59, 0x78, 0xE5, 0x0F, 0x63, 0x40, 0x05, 0x3B, 0x3B, 0x2F, 0xAF, 0xB0, 0xB0, 0xA4, 0xA4,
+        0xBC, 0xBC, 0xAA, 0xAA, 0xB6, 0xB6, 0xA1, 0xA1, 0xB9, 0xB9, 0xAD, 0xAD, 0xB3, 0xB3, 0xA7, 0xA7,
+        0xBF, 0x7F, 0x68, 0x68, 0x74, 0x74, 0x62, 0x62, 0x7A, 0x7A, 0x6E, 0x6E, 0x71, 0x71, 0x65, 0x65,
+        0x7D, 0x7D, 0x6B, 0x6B, 0x77, 0x37, 0x13, 0xA9, 0xF1, 0xC0, 0x6C, 0xE0, 0xC2, 0xC6, 0xC6, 0xC5,
+        0xC5, 0xCB, 0x2B, 0x20, 0x20, 0x2C, 0x2C, 0x3E, 0x7D, 0xA6, 0xA4, 0xAC, 0xAC, 0xBC, 0xBC, 0xB2,
+        0xB2, 0xDA, 0xB2, 0x95, 0x9A, 0x3A, 0x3A, 0x06, 0x1B, 0x36, 0x19, 0x99, 0x99, 0xED, 0xD8, 0x61,
+        0x63, 0x63, 0xBF, 0xFF, 0x90, 0x93, 0xEB, 0xD1, 0x93, 0x9E, 0xDE, 0xA7, 0x59, 0x48, 0x4D, 0x4B,
+        0x00, 0x18, 0x7F, 0xD2, 0x20, 0xB0, 0xD4, 0x8B, 0x23, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E,
+        0x44, 0xAE, 0x42, 0x60, 0x82,
+    };
+
+    /* Same size palette of four entries indexed (x + y) % 4, the first two */
+    /* translucent through tRNS, dynamic Huffman. */
+    const std::uint8_t kPalettePng[] = {
+        0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+        0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x14, 0x08, 0x03, 0x00, 0x00, 0x00, 0xA0, 0x6B, 0x0D,
+        0xB1, 0x00, 0x00, 0x00, 0x0C, 0x50, 0x4C, 0x54, 0x45, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00,
+        0x00, 0xFF, 0x0A, 0x14, 0x1E, 0x22, 0x88, 0x29, 0x04, 0x00, 0x00, 0x00, 0x02, 0x74, 0x52, 0x4E,
+        0x53, 0x80, 0x40, 0x3B, 0xCC, 0x14, 0xE3, 0x00, 0x00, 0x00, 0x23, 0x49, 0x44, 0x41, 0x54, 0x78,
+        0xDA, 0x75, 0x90, 0xB1, 0x0D, 0x00, 0x30, 0x0C, 0xC2, 0x20, 0xF0, 0xFF, 0xC7, 0x55, 0xDB, 0x03,
+        0xE2, 0x48, 0x2C, 0x1E, 0x62, 0x81, 0xE4, 0xC9, 0x16, 0xFF, 0x3B, 0x5B, 0x06, 0xB8, 0x33, 0x3B,
+        0x77, 0x81, 0x59, 0x1A, 0x92, 0xD7, 0x00, 0x00, 0x00, 0x23, 0x49, 0x44, 0x41, 0x54, 0x9B, 0xDC,
+        0x3F, 0xE0, 0x20, 0xEE, 0x5C, 0x70, 0x94, 0x7A, 0x88, 0xDC, 0x0E, 0x38, 0xA8, 0x9F, 0x43, 0x8E,
+        0xD2, 0x56, 0xC2, 0xDE, 0x82, 0x5F, 0x43, 0x8E, 0xD0, 0x26, 0xA5, 0xAD, 0x1E, 0x8A, 0x7C, 0x5F,
+        0xC3, 0x2F, 0xAD, 0xD2, 0x1D, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60,
+        0x82,
+    };
+
+    /* Decode a file and check its size. */
+    bool DecodeSized(
+        const std::uint8_t* data,
+        std::size_t size,
+        std::vector<std::uint8_t>& outPixels)
+    {
+        std::uint32_t width = 0;
+        std::uint32_t height = 0;
+        const std::vector<std::uint8_t> bytes(data, data + size);
+        return DecodePng(bytes, width, height, outPixels) &&
+            width == kWidth && height == kHeight &&
+            outPixels.size() == static_cast<std::size_t>(kWidth) * kHeight * 4;
+    }
+
+    void CheckRgb()
+    {
+        std::vector<std::uint8_t> pixels;
+        if (!DecodeSized(kRgbPng, sizeof(kRgbPng), pixels))
+        {
+            Check(false, "RGB image decodes");
+            return;
+        }
+
+        bool match = true;
+        for (std::uint32_t y = 0; y < kHeight; ++y)
+        {
+            for (std::uint32_t x = 0; x < kWidth; ++x)
+            {
+                const std::uint8_t* pixel = &pixels[(y * kWidth + x) * 4];
+                match = match &&
+                    pixel[0] == PatternValue(x, y, 0) &&
+                    pixel[1] == PatternValue(x, y, 1) &&
+                    pixel[2] == PatternValue(x, y, 2) &&
+                    pixel[3] == 255;
+            }
+        }
+
+        Check(match, "RGB pixels match the pattern with opaque alpha");
+    }
+
+    void CheckGrayAlpha()
+    {
+        std::vector<std::uint8_t> pixels;
+        if (!DecodeSized(kGrayAlphaPng, sizeof(kGrayAlphaPng), pixels))
+        {
+            Check(false, "gray-alpha image decodes");
+            return;
+        }
+
+        bool match = true;
+        for (std::uint32_t y = 0; y < kHeight; ++y)
+        {
+            for (std::uint32_t x = 0; x < kWidth; ++x)
+            {
+                const std::uint8_t* pixel = &pixels[(y * kWidth + x) * 4];
+                const std::uint8_t gray = PatternValue(x, y, 0);
+                match = match &&
+                    pixel[0] == gray && pixel[1] == gray && pixel[2] == gray &&
+                    pixel[3] == PatternValue(x, y, 1);
+            }
+        }
+
+        Check(match, "gray-alpha pixels replicate gray and keep alpha");
+    }
+
+    void CheckPalette()
+    {
+        static const std::uint8_t kEntries[4][4] = {
+            { 255, 0, 0, 128 }, { 0, 255, 0, 64 }, { 0, 0, 255, 255 }, { 10, 20, 30, 255 } };
+
+        std::vector<std::uint8_t> pixels;
+        if (!DecodeSized(kPalettePng, sizeof(kPalettePng), pixels))
+        {
+            Check(false, "palette image decodes");
+            return;
+        }
+
+        bool match = true;
+        for (std::uint32_t y = 0; y < kHeight; ++y)
+        {
+            for (std::uint32_t x = 0; x < kWidth; ++x)
+            {
+                const std::uint8_t* pixel = &pixels[(y * kWidth + x) * 4];
+                const std::uint8_t* entry = kEntries[(x + y) % 4];
+                match = match &&
+                    pixel[0] == entry[0] && pixel[1] == entry[1] &&
+                    pixel[2] == entry[2] && pixel[3] == entry[3];
+            }
+        }
+
+        Check(match, "palette pixels expand through PLTE and tRNS");
+    }
+
+    /* The writer's stored blocks decode back to the same pixels. */
+    void CheckWriterRoundTrip(std::uint32_t width, std::uint32_t height)
+    {
+        std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width) * height * 4);
+        for (std::size_t index = 0; index < pixels.size(); ++index)
+        {
+            pixels[index] = static_cast<std::uint8_t>(index * 7 + index / 13);
+        }
+
+        std::vector<std::uint8_t> png;
+        std::vector<std::uint8_t> decoded;
+        std::uint32_t decodedWidth = 0;
+        std::uint32_t decodedHeight = 0;
+        Check(EncodePng(width, height, pixels, png), "round trip encodes");
+        Check(DecodePng(png, decodedWidth, decodedHeight, decoded), "round trip decodes");
+        Check(decodedWidth == width && decodedHeight == height, "round trip keeps the size");
+        Check(decoded == pixels, "round trip keeps the pixels");
+    }
+
+    /* Damaged files are rejected and leave the outputs empty. */
+    void CheckRejected(const std::vector<std::uint8_t>& bytes, const char* description)
+    {
+        std::uint32_t width = 1;
+        std::uint32_t height = 1;
+        std::vector<std::uint8_t> pixels(4);
+        const bool decoded = DecodePng(bytes, width, height, pixels);
+        Check(!decoded && width == 0 && height == 0 && pixels.empty(), description);
+    }
+}
+
+int main()
+{
+    g_TestName = "PngReaderTest";
+
+    CheckRgb();
+    CheckGrayAlpha();
+    CheckPalette();
+
+    CheckWriterRoundTrip(3, 2);
+    CheckWriterRoundTrip(320, 240);
+
+    const std::vector<std::uint8_t> valid(kRgbPng, kRgbPng + sizeof(kRgbPng));
+
+    std::vector<std::uint8_t> badSignature = valid;
+    badSignature[1] = 'Q';
+    CheckRejected(badSignature, "a bad signature is rejected");
+
+    CheckRejected(
+        std::vector<std::uint8_t>(valid.begin(), valid.begin() + valid.size() / 2),
+        "a truncated file is rejected");
+
+    /* Byte 8 + 25 + 8 + 2 is the first deflate block header: type 3 is reserved. */
+    std::vector<std::uint8_t> badBlock = valid;
+    badBlock[43] |= 0x06;
+    CheckRejected(badBlock, "a reserved deflate block type is rejected");
+
+    /* Bit depth 16 is outside what the decoder handles. */
+    std::vector<std::uint8_t> badDepth = valid;
+    badDepth[24] = 16;
+    CheckRejected(badDepth, "an unsupported bit depth is rejected");
+
+    return FinishChecks();
+}
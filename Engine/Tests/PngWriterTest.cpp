@@ -0,0 +1,213 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* Decodes what the PNG writer produces without an image library: the */
+/* signature, chunk CRCs, header fields, stored deflate blocks and the */
+/* Adler-32 checksum must all hold, and the scanlines must give back */
+/* the input pixels. Images span one block and several. */
+
+#include "Renderer/PngWriter.h"
+#include "TestHelpers.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    /* Read a 32-bit big-endian value. */
+    std::uint32_t ReadBigEndian(const std::uint8_t* data)
+    {
+        return (static_cast<std::uint32_t>(data[0]) << 24) |
+            (static_cast<std::uint32_t>(data[1]) << 16) |
+            (static_cast<std::uint32_t>(data[2]) << 8) |
+            static_cast<std::uint32_t>(data[3]);
+    }
+
+    /* Bit-at-a-time CRC-32, independent of the writer's table. */
+    std::uint32_t ReferenceCrc(const std::uint8_t* data, std::size_t size)
+    {
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            crc ^= data[index];
+            for (std::uint32_t bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+            }
+        }
+
+        return ~crc;
+    }
+
+    /* Byte-at-a-time Adler-32. */
+    std::uint32_t ReferenceAdler(const std::vector<std::uint8_t>& data)
+    {
+        std::uint32_t low = 1;
+        std::uint32_t high = 0;
+        for (const std::uint8_t value : data)
+        {
+            low = (low + value) % 65521u;
+            high = (high + low) % 65521u;
+        }
+
+        return (high << 16) | low;
+    }
+
+    /* Encode a patterned image and decode it back chunk by chunk. */
+    void CheckRoundTrip(std::uint32_t width, std::uint32_t height)
+    {
+        std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width) * height * 4);
+        for (std::size_t index = 0; index < pixels.size(); ++index)
+        {
+            pixels[index] = static_cast<std::uint8_t>(index * 7 + index / 13);
+        }
+
+        std::vector<std::uint8_t> png;
+        Check(EncodePng(width, height, pixels, png), "encode succeeds");
+
+        static const std::uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        if (png.size() < 8 || std::memcmp(png.data(), kSignature, 8) != 0)
+        {
+            Check(false, "signature");
+            return;
+        }
+
+        std::vector<std::uint8_t> zlib;
+        bool sawHeader = false;
+        bool sawEnd = false;
+        std::size_t offset = 8;
+        while (offset + 12 <= png.size() && !sawEnd)
+        {
+            const std::uint32_t length = ReadBigEndian(&png[offset]);
+            if (offset + 12 + length > png.size())
+            {
+                Check(false, "chunk fits in the file");
+                return;
+            }
+
+            const std::uint8_t* type = &png[offset + 4];
+            const std::uint8_t* data = type + 4;
+            Check(ReadBigEndian(data + length) == ReferenceCrc(type, length + 4), "chunk CRC");
+
+            if (std::memcmp(type, "IHDR", 4) == 0)
+            {
+                Check(!sawHeader && offset == 8 && length == 13, "IHDR comes first");
+                Check(ReadBigEndian(data) == width && ReadBigEndian(data + 4) == height, "IHDR size");
+                Check(data[8] == 8 && data[9] == 6, "IHDR is 8-bit RGBA");
+                Check(data[10] == 0 && data[11] == 0 && data[12] == 0, "IHDR methods");
+                sawHeader = true;
+            }
+            else if (std::memcmp(type, "IDAT", 4) == 0)
+            {
+                zlib.insert(zlib.end(), data, data + length);
+            }
+            else if (std::memcmp(type, "IEND", 4) == 0)
+            {
+                Check(length == 0, "IEND is empty");
+                sawEnd = true;
+            }
+
+            offset += 12 + length;
+        }
+
+        Check(sawHeader && sawEnd && offset == png.size(), "IHDR and IEND present, nothing after IEND");
+
+        /* Zlib header, then stored blocks until the final one. */
+        if (zlib.size() < 6 || ((zlib[0] << 8) | zlib[1]) % 31 != 0 || (zlib[0] & 0x0F) != 8)
+        {
+            Check(false, "zlib header");
+            return;
+        }
+
+        std::vector<std::uint8_t> raw;
+        std::size_t position = 2;
+        bool finalBlock = false;
+        std::uint32_t blockCount = 0;
+        while (!finalBlock && position + 5 <= zlib.size())
+        {
+            finalBlock = (zlib[position] & 1) != 0;
+            Check((zlib[position] >> 1) == 0, "stored block type");
+
+            const std::uint32_t size = zlib[position + 1] | (zlib[position + 2] << 8);
+            const std::uint32_t complement = zlib[position + 3] | (zlib[position + 4] << 8);
+            Check((size ^ complement) == 0xFFFFu, "stored length complement");
+
+            position += 5;
+            if (position + size > zlib.size())
+            {
+                Check(false, "stored block fits in the stream");
+                return;
+            }
+
+            raw.insert(raw.end(), zlib.begin() + position, zlib.begin() + position + size);
+            position += size;
+            ++blockCount;
+        }
+
+        Check(finalBlock && position + 4 == zlib.size(), "final block then checksum");
+        Check(ReadBigEndian(&zlib[position]) == ReferenceAdler(raw), "Adler-32");
+
+        const std::size_t rowBytes = static_cast<std::size_t>(width) * 4;
+        const std::size_t expectedBlocks = (raw.size() + 65534) / 65535;
+        Check(blockCount == expectedBlocks, "blocks are filled to 65535 bytes");
+
+        if (raw.size() != (rowBytes + 1) * height)
+        {
+            Check(false, "scanline size");
+            return;
+        }
+
+        bool filtersNone = true;
+        bool pixelsMatch = true;
+        for (std::uint32_t row = 0; row < height; ++row)
+        {
+            const std::uint8_t* line = &raw[row * (rowBytes + 1)];
+            filtersNone = filtersNone && line[0] == 0;
+            pixelsMatch = pixelsMatch && std::memcmp(line + 1, &pixels[row * rowBytes], rowBytes) == 0;
+        }
+
+        Check(filtersNone, "scanlines use filter type none");
+        Check(pixelsMatch, "scanlines hold the input pixels");
+    }
+}
+
+int main()
+{
+    g_TestName = "PngWriterTest";
+
+    CheckRoundTrip(3, 2);
+    CheckRoundTrip(1, 1);
+    CheckRoundTrip(320, 240);
+
+    std::vector<std::uint8_t> png;
+    const std::vector<std::uint8_t> shortPixels(4 * 4 * 4 - 1);
+    Check(!EncodePng(4, 4, shortPixels, png), "short pixel data is rejected");
+    Check(!EncodePng(0, 4, std::vector<std::uint8_t>(), png), "zero width is rejected");
+
+    return FinishChecks();
+}
@@ -0,0 +1,222 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+/* Ray queries against packed boxes must agree whichever path runs them: */
+/* the four-wide packet test, the one-ray-per-call test and a loop of */
+/* IntersectRayAABB over every box. Rays include axis-aligned ones, */
+/* ones starting inside boxes, short ones and part-filled packets. */
+
+#include "Scene/Collision/RayQuery.h"
+#include "TestHelpers.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    /* Not a multiple of the SIMD width, so the tail path runs too. */
+    constexpr std::uint32_t kBoxCount = 203;
+    constexpr std::uint32_t kRayCount = 400;
+    constexpr float kSceneHalfSize = 30.0f;
+
+    /* Random scattered boxes of mixed sizes. */
+    void BuildBoxes(std::mt19937& random, PackedBounds& outBounds, std::vector<AABB>& outBoxes)
+    {
+        std::uniform_real_distribution<float> position(-kSceneHalfSize, kSceneHalfSize);
+        std::uniform_real_distribution<float> size(0.1f, 4.0f);
+
+        for (std::uint32_t index = 0; index < kBoxCount; ++index)
+        {
+            const Vec3 center(position(random), position(random), position(random));
+            const Vec3 half(size(random), size(random), size(random));
+            const AABB box{ center - half, center + half };
+            outBoxes.push_back(box);
+            outBounds.Push(index, box);
+        }
+    }
+
+    /* Random ray; some run along an axis, start inside a box or stop short. */
+    Ray RandomRay(std::mt19937& random, const std::vector<AABB>& boxes)
+    {
+        std::uniform_real_distribution<float> position(-kSceneHalfSize, kSceneHalfSize);
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+        Ray ray;
+        ray.Origin = Vec3(position(random), position(random), position(random));
+        ray.Direction = Vec3(direction(random), direction(random), direction(random));
+
+        switch (random() % 5)
+        {
+        case 0:
+        {
+            /* Along one axis, the other components zero of either sign. */
+            const std::uint32_t axis = random() % 3;
+            ray.Direction = Vec3(
+                axis == 0 ? 1.0f : (random() % 2 ? 0.0f : -0.0f),
+                axis == 1 ? -1.0f : (random() % 2 ? 0.0f : -0.0f),
+                axis == 2 ? 1.0f : (random() % 2 ? 0.0f : -0.0f));
+            break;
+        }
+        case 1:
+        {
+            const AABB& box = boxes[random() % boxes.size()];
+            ray.Origin = (box.Min + box.Max) * 0.5f;
+            break;
+        }
+        case 2:
+            ray.MaxDistance = 5.0f + static_cast<float>(random() % 20);
+            break;
+        default:
+            break;
+        }
+
+        return ray;
+    }
+
+    /* Sort by distance then index, so ties compare equal in any order. */
+    void Normalize(std::vector<RayCandidate>& candidates)
+    {
+        std::sort(candidates.begin(), candidates.end(),
+            [](const RayCandidate& left, const RayCandidate& right)
+            {
+                return left.Distance != right.Distance ? left.Distance < right.Distance : left.Index < right.Index;
+            });
+    }
+
+    /* Same boxes at the same distances. */
+    bool SameCandidates(std::vector<RayCandidate> left, std::vector<RayCandidate> right)
+    {
+        Normalize(left);
+        Normalize(right);
+        if (left.size() != right.size())
+        {
+            return false;
+        }
+
+        for (std::size_t index = 0; index < left.size(); ++index)
+        {
+            if (left[index].Index != right[index].Index || left[index].Distance != right[index].Distance)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /* Candidates must come back nearest first. */
+    bool IsNearestFirst(const std::vector<RayCandidate>& candidates)
+    {
+        for (std::size_t index = 1; index < candidates.size(); ++index)
+        {
+            if (candidates[index].Distance < candidates[index - 1].Distance)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+int main()
+{
+    g_TestName = "RayQueryTest";
+
+    std::mt19937 random(23);
+    PackedBounds bounds;
+    std::vector<AABB> boxes;
+    BuildBoxes(random, bounds, boxes);
+
+    std::vector<Ray> rays;
+    for (std::uint32_t index = 0; index < kRayCount; ++index)
+    {
+        rays.push_back(RandomRay(random, boxes));
+    }
+
+    /* One ray at a time against every box tested alone. */
+    bool singleMatches = true;
+    bool singleOrdered = true;
+    bool anyHit = false;
+    bool anyInside = false;
+    std::vector<RayCandidate> single;
+    for (const Ray& ray : rays)
+    {
+        std::vector<RayCandidate> expected;
+        for (std::uint32_t index = 0; index < kBoxCount; ++index)
+        {
+            float distance = 0.0f;
+            if (IntersectRayAABB(ray, boxes[index], distance))
+            {
+                expected.push_back(RayCandidate{ index, distance });
+                anyInside = anyInside || distance == 0.0f;
+            }
+        }
+
+        CollectRayCandidates(bounds, ray, single);
+        singleMatches = singleMatches && SameCandidates(single, expected);
+        singleOrdered = singleOrdered && IsNearestFirst(single);
+        anyHit = anyHit || !expected.empty();
+    }
+
+    Check(anyHit && anyInside, "rays hit boxes, some from inside");
+    Check(singleMatches, "single-ray query matches IntersectRayAABB on every box");
+    Check(singleOrdered, "single-ray candidates are nearest first");
+
+    /* Packets of every size must give each lane the single-ray result. */
+    bool packetMatches = true;
+    bool packetOrdered = true;
+    std::vector<RayCandidate> packet[kRayPacketWidth];
+    for (std::uint32_t rayCount = 1; rayCount <= kRayPacketWidth; ++rayCount)
+    {
+        for (std::uint32_t first = 0; first + rayCount <= kRayCount; first += rayCount)
+        {
+            CollectRayPacketCandidates(bounds, &rays[first], rayCount, packet);
+            for (std::uint32_t lane = 0; lane < rayCount; ++lane)
+            {
+                CollectRayCandidates(bounds, rays[first + lane], single);
+                packetMatches = packetMatches && SameCandidates(packet[lane], single);
+                packetOrdered = packetOrdered && IsNearestFirst(packet[lane]);
+            }
+        }
+    }
+
+    Check(packetMatches, "packet query matches the single-ray query in every lane");
+    Check(packetOrdered, "packet candidates are nearest first");
+
+    /* An empty set of boxes yields nothing. */
+    PackedBounds empty;
+    CollectRayCandidates(empty, rays[0], single);
+    CollectRayPacketCandidates(empty, rays.data(), kRayPacketWidth, packet);
+    Check(single.empty() && packet[0].empty() && packet[kRayPacketWidth - 1].empty(),
+        "no boxes give no candidates");
+
+    return FinishChecks();
+}
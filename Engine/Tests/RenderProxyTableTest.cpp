@@ -0,0 +1,266 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+/* Drives the retained render proxy table with random frames of Set, */
+/* Remove and SetDepthBucket calls, including several calls on the same */
+/* entity in one frame. After every Update the sorted slots must hold */
+/* exactly the live opaque fixed-mesh proxies in material, mesh, bucket */
+/* then slot order, and the unsorted slots everything else. */
+
+#include "Renderer/RenderProxyTable.h"
+#include "TestHelpers.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    constexpr std::uint32_t kEntityCount = 300;
+    constexpr std::uint32_t kFrameCount = 200;
+    constexpr std::uint32_t kMaterialCount = 6;
+    constexpr std::uint32_t kMeshCount = 5;
+    constexpr std::uint32_t kBucketCount = 8;
+
+    /* Proxies as the test expects them, indexed by entity id. */
+    struct ReferenceProxies
+    {
+        std::vector<RenderProxy> Proxies;
+        std::vector<bool> Live;
+    };
+
+    /* Few materials, meshes and buckets so equal keys are common. */
+    RenderProxy RandomProxy(std::mt19937& random, std::uint32_t entityId)
+    {
+        RenderProxy proxy;
+        proxy.EntityId = entityId;
+        proxy.MeshHandle = random() % (kMeshCount + 1);
+        proxy.MaterialHandle = random() % kMaterialCount;
+        proxy.DepthBucket = static_cast<std::uint16_t>(random() % kBucketCount);
+        proxy.Transparent = random() % 6 == 0;
+        return proxy;
+    }
+
+    bool IsSortedProxy(const RenderProxy& proxy)
+    {
+        return !proxy.Transparent && proxy.MeshHandle != 0;
+    }
+
+    bool SameProxy(const RenderProxy& left, const RenderProxy& right)
+    {
+        return left.EntityId == right.EntityId && left.MeshHandle == right.MeshHandle &&
+            left.MaterialHandle == right.MaterialHandle && left.DepthBucket == right.DepthBucket &&
+            left.Transparent == right.Transparent;
+    }
+
+    /* Full order check of the table against the reference. */
+    void CheckTable(const RenderProxyTable& table, const ReferenceProxies& reference, const char* description)
+    {
+        std::uint32_t liveCount = 0;
+        std::uint32_t sortedCount = 0;
+        for (std::uint32_t entity = 0; entity < kEntityCount; ++entity)
+        {
+            if (reference.Live[entity])
+            {
+                ++liveCount;
+                sortedCount += IsSortedProxy(reference.Proxies[entity]) ? 1u : 0u;
+            }
+        }
+
+        const std::vector<std::uint32_t>& sorted = table.GetSortedSlots();
+        const std::vector<std::uint32_t>& unsorted = table.GetUnsortedSlots();
+        bool valid = table.GetCount() == liveCount &&
+            sorted.size() == sortedCount &&
+            unsorted.size() == liveCount - sortedCount;
+
+        /* Every listed slot holds a live entity's current proxy, once. */
+        std::vector<bool> seen(kEntityCount, false);
+        auto checkSlot = [&](std::uint32_t slot, bool expectSorted)
+        {
+            const RenderProxy& proxy = table.GetProxy(slot);
+            const bool known = proxy.EntityId < kEntityCount && reference.Live[proxy.EntityId] &&
+                !seen[proxy.EntityId];
+            valid = valid && known && SameProxy(proxy, reference.Proxies[proxy.EntityId]) &&
+                IsSortedProxy(proxy) == expectSorted;
+            if (known)
+            {
+                seen[proxy.EntityId] = true;
+            }
+        };
+
+        for (const std::uint32_t slot : sorted)
+        {
+            checkSlot(slot, true);
+        }
+        for (const std::uint32_t slot : unsorted)
+        {
+            checkSlot(slot, false);
+        }
+
+        /* Material, mesh, bucket, then slot, strictly increasing. */
+        for (std::size_t index = 1; valid && index < sorted.size(); ++index)
+        {
+            const RenderProxy& previous = table.GetProxy(sorted[index - 1]);
+            const RenderProxy& current = table.GetProxy(sorted[index]);
+            const auto previousKey = std::make_tuple(
+                previous.MaterialHandle, previous.MeshHandle, previous.DepthBucket, sorted[index - 1]);
+            const auto currentKey = std::make_tuple(
+                current.MaterialHandle, current.MeshHandle, current.DepthBucket, sorted[index]);
+            valid = previousKey < currentKey;
+        }
+
+        Check(valid, description);
+    }
+
+    /* One frame of random changes, then the merge. */
+    void RunFrame(RenderProxyTable& table, ReferenceProxies& reference, std::mt19937& random)
+    {
+        const std::uint32_t changeCount = random() % 40;
+        for (std::uint32_t change = 0; change < changeCount; ++change)
+        {
+            /* Ids past the table exercise the unknown-entity paths. */
+            const std::uint32_t entity = random() % (kEntityCount + 10);
+            const bool known = entity < kEntityCount;
+
+            switch (random() % 4)
+            {
+            case 0:
+            case 1:
+                if (known)
+                {
+                    reference.Proxies[entity] = RandomProxy(random, entity);
+                    reference.Live[entity] = true;
+                    table.Set(reference.Proxies[entity]);
+                }
+                break;
+            case 2:
+                table.Remove(entity);
+                if (known)
+                {
+                    reference.Live[entity] = false;
+                }
+                break;
+            default:
+            {
+                const std::uint16_t bucket = static_cast<std::uint16_t>(random() % kBucketCount);
+                table.SetDepthBucket(entity, bucket);
+                if (known && reference.Live[entity])
+                {
+                    reference.Proxies[entity].DepthBucket = bucket;
+                }
+                break;
+            }
+            }
+        }
+
+        table.Update();
+    }
+}
+
+int main()
+{
+    g_TestName = "RenderProxyTableTest";
+
+    std::mt19937 random(41);
+    RenderProxyTable table;
+    ReferenceProxies reference;
+    reference.Proxies.resize(kEntityCount);
+    reference.Live.resize(kEntityCount, false);
+
+    /* Initial fill. */
+    for (std::uint32_t entity = 0; entity < kEntityCount; entity += 2)
+    {
+        reference.Proxies[entity] = RandomProxy(random, entity);
+        reference.Live[entity] = true;
+        table.Set(reference.Proxies[entity]);
+    }
+    table.Update();
+    CheckTable(table, reference, "initial fill is in order");
+
+    /* An idle update keeps the order as is. */
+    const std::vector<std::uint32_t> before = table.GetSortedSlots();
+    table.Update();
+    Check(table.GetSortedSlots() == before, "idle update keeps the order");
+
+    /* Same-frame sequences on one entity: the last call wins. */
+    const std::uint32_t entity = 1;
+    RenderProxy proxy;
+    proxy.EntityId = entity;
+    proxy.MeshHandle = 1;
+    proxy.MaterialHandle = 2;
+    table.Set(proxy);
+    table.Remove(entity);
+    table.Update();
+    CheckTable(table, reference, "set then remove leaves nothing");
+
+    table.Remove(0);
+    reference.Proxies[0] = proxy;
+    reference.Proxies[0].EntityId = 0;
+    table.Set(reference.Proxies[0]);
+    table.SetDepthBucket(0, 5);
+    table.SetDepthBucket(0, 3);
+    reference.Proxies[0].DepthBucket = 3;
+    table.Update();
+    CheckTable(table, reference, "remove, set and two bucket moves keep the last bucket");
+
+    /* Random frames. */
+    bool allValid = true;
+    for (std::uint32_t frame = 0; frame < kFrameCount && allValid; ++frame)
+    {
+        RunFrame(table, reference, random);
+        const std::uint32_t failuresBefore = g_FailureCount;
+        CheckTable(table, reference, "random frame keeps the merged order");
+        allValid = g_FailureCount == failuresBefore;
+    }
+
+    /* Everything gone, then refilled into the recycled slots. */
+    for (std::uint32_t index = 0; index < kEntityCount; ++index)
+    {
+        table.Remove(index);
+        reference.Live[index] = false;
+    }
+    table.Update();
+    CheckTable(table, reference, "removing every proxy empties both orders");
+
+    for (std::uint32_t index = 0; index < kEntityCount; index += 3)
+    {
+        reference.Proxies[index] = RandomProxy(random, index);
+        reference.Live[index] = true;
+        table.Set(reference.Proxies[index]);
+    }
+    table.Update();
+    CheckTable(table, reference, "refill after removing everything is in order");
+
+    table.Clear();
+    std::fill(reference.Live.begin(), reference.Live.end(), false);
+    CheckTable(table, reference, "clear empties both orders");
+
+    return FinishChecks();
+}
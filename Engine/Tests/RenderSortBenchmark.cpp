@@ -0,0 +1,227 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+/* Sorts 100k render items (64 materials, 32 meshes, 10% transparent) */
+/* with packed keys and the radix sort, against the comparator sort on */
+/* depth, material and mesh pointers that the keys replaced. Then keeps */
+/* the opaque items in a retained proxy table and times an idle update */
+/* and a camera step that re-buckets every proxy by depth. */
+
+#include "Renderer/RenderProxyTable.h"
+#include "Renderer/RenderSortKey.h"
+#include "TestHelpers.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    constexpr std::uint32_t kItemCount = 100000;
+    constexpr std::uint32_t kMaterialCount = 64;
+    constexpr std::uint32_t kMeshCount = 32;
+    constexpr std::uint32_t kTransparentDivisor = 10;
+
+    /* Squared distance change of a camera step, moves a few proxies a bucket. */
+    constexpr float kCameraStepScale = 1.05f;
+
+    /* Item as the comparator sort saw it. */
+    struct PointerItem
+    {
+        const void* Material = nullptr;
+        const void* Mesh = nullptr;
+        float DepthSq = 0.0f;
+    };
+}
+
+int main()
+{
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> depthDistribution(0.1f, 10000.0f);
+
+    const RenderSortKeyEncoder opaqueEncoder(RenderSortKeyLayout::StateFirst());
+    const RenderSortKeyEncoder transparentEncoder(RenderSortKeyLayout::DepthFirst());
+
+    static char materials[kMaterialCount];
+    static char meshes[kMeshCount];
+
+    std::vector<RenderSortEntry> entries(kItemCount);
+    std::vector<PointerItem> pointerItems(kItemCount);
+    std::vector<std::uint32_t> stateIds(kItemCount);
+    for (std::uint32_t item = 0; item < kItemCount; ++item)
+    {
+        const bool transparent = random() % kTransparentDivisor == 0;
+        const std::uint32_t material = random() % kMaterialCount;
+        const std::uint32_t mesh = random() % kMeshCount;
+        const float depthSq = depthDistribution(random);
+
+        const RenderSortKeyEncoder& encoder = transparent ? transparentEncoder : opaqueEncoder;
+        entries[item].Key = encoder.Encode(
+            transparent ? RenderStage::Transparent : RenderStage::Opaque,
+            0,
+            material + 1,
+            mesh + 1,
+            depthSq);
+        entries[item].Index = item;
+
+        pointerItems[item] = PointerItem{ &materials[material], &meshes[mesh], depthSq };
+        stateIds[item] = (transparent ? 1u << 16 : 0u) | (material << 8) | mesh;
+    }
+
+    /* The radix sort must match a stable sort on the keys exactly. */
+    std::vector<RenderSortEntry> sorted = entries;
+    std::vector<RenderSortEntry> scratch;
+    RadixSortRenderEntries(sorted, scratch);
+
+    std::vector<RenderSortEntry> reference = entries;
+    std::stable_sort(reference.begin(), reference.end(),
+        [](const RenderSortEntry& left, const RenderSortEntry& right)
+        {
+            return left.Key < right.Key;
+        });
+
+    for (std::uint32_t item = 0; item < kItemCount; ++item)
+    {
+        if (sorted[item].Key != reference[item].Key || sorted[item].Index != reference[item].Index)
+        {
+            std::fprintf(stderr, "RenderSortBenchmark: radix order differs at %u\n", item);
+            return 1;
+        }
+    }
+
+    const auto compareItems = [](const PointerItem& left, const PointerItem& right)
+    {
+        if (left.DepthSq != right.DepthSq)
+        {
+            return left.DepthSq < right.DepthSq;
+        }
+        if (left.Material != right.Material)
+        {
+            return left.Material < right.Material;
+        }
+        return left.Mesh < right.Mesh;
+    };
+
+    const double radixMilliseconds = MeasureBest([&]()
+        {
+            sorted = entries;
+            RadixSortRenderEntries(sorted, scratch);
+        });
+
+    std::vector<PointerItem> pointerSorted;
+    const double comparatorMilliseconds = MeasureBest([&]()
+        {
+            pointerSorted = pointerItems;
+            std::sort(pointerSorted.begin(), pointerSorted.end(), compareItems);
+        });
+
+    /* State changes each order leaves for batching. */
+    std::uint32_t radixBatches = 1;
+    std::uint32_t comparatorBatches = 1;
+    for (std::uint32_t item = 1; item < kItemCount; ++item)
+    {
+        radixBatches += stateIds[sorted[item].Index] != stateIds[sorted[item - 1].Index] ? 1u : 0u;
+        comparatorBatches +=
+            pointerSorted[item].Material != pointerSorted[item - 1].Material ||
+            pointerSorted[item].Mesh != pointerSorted[item - 1].Mesh ? 1u : 0u;
+    }
+
+    std::printf("RenderSortBenchmark: %u items\n", kItemCount);
+    std::printf("RenderSortBenchmark: radix sort %.3f ms, %u batches\n", radixMilliseconds, radixBatches);
+    std::printf("RenderSortBenchmark: comparator sort %.3f ms, %u batches\n",
+        comparatorMilliseconds, comparatorBatches);
+
+    /* Retained order: opaque items as proxies, bucketed from two camera spots. */
+    RenderProxyTable proxies;
+    for (std::uint32_t item = 0; item < kItemCount; ++item)
+    {
+        if (stateIds[item] >> 16)
+        {
+            continue;
+        }
+
+        RenderProxy proxy{};
+        proxy.EntityId = item;
+        proxy.MaterialHandle = ((stateIds[item] >> 8) & 0xFFu) + 1;
+        proxy.MeshHandle = (stateIds[item] & 0xFFu) + 1;
+        proxy.DepthBucket = RenderProxyTable::ComputeDepthBucket(pointerItems[item].DepthSq);
+        proxies.Set(proxy);
+    }
+
+    proxies.Update();
+
+    const double idleMilliseconds = MeasureBest([&]()
+        {
+            proxies.Update();
+        });
+
+    /* Step the camera back and forth so every run moves proxies. */
+    bool stepped = false;
+    const double moveMilliseconds = MeasureBest([&]()
+        {
+            stepped = !stepped;
+            const float scale = stepped ? kCameraStepScale : 1.0f;
+            for (const std::uint32_t slot : proxies.GetSortedSlots())
+            {
+                const std::uint32_t item = proxies.GetProxy(slot).EntityId;
+                proxies.SetDepthBucket(
+                    item,
+                    RenderProxyTable::ComputeDepthBucket(pointerItems[item].DepthSq * scale));
+            }
+
+            proxies.Update();
+        });
+
+    /* State groups must stay contiguous with buckets ascending inside them. */
+    const std::vector<std::uint32_t>& retained = proxies.GetSortedSlots();
+    std::uint32_t retainedBatches = retained.empty() ? 0u : 1u;
+    for (std::size_t index = 1; index < retained.size(); ++index)
+    {
+        const RenderProxy& previous = proxies.GetProxy(retained[index - 1]);
+        const RenderProxy& current = proxies.GetProxy(retained[index]);
+        const std::uint64_t previousState =
+            (static_cast<std::uint64_t>(previous.MaterialHandle) << 32) | previous.MeshHandle;
+        const std::uint64_t currentState =
+            (static_cast<std::uint64_t>(current.MaterialHandle) << 32) | current.MeshHandle;
+        if (currentState < previousState ||
+            (currentState == previousState && current.DepthBucket < previous.DepthBucket))
+        {
+            std::fprintf(stderr, "RenderSortBenchmark: retained order broken at %zu\n", index);
+            return 1;
+        }
+
+        retainedBatches += currentState != previousState ? 1u : 0u;
+    }
+
+    std::printf("RenderSortBenchmark: retained %zu opaque proxies, %u batches\n",
+        retained.size(), retainedBatches);
+    std::printf("RenderSortBenchmark: retained idle update %.3f ms, camera step re-bucket %.3f ms\n",
+        idleMilliseconds, moveMilliseconds);
+    return 0;
+}
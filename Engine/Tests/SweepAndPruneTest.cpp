@@ -0,0 +1,246 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+/* Compares the sweep-and-prune broadphase with a brute-force overlap */
+/* check over every pair. Proxies with sparse ids are inserted, moved a */
+/* few at a time and in bulk, removed and reinserted, on each sweep */
+/* axis and with pair finding split across workers. */
+
+#include "Engine/WorkerPool.h"
+#include "Scene/Collision/SweepAndPrune.h"
+#include "TestHelpers.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    constexpr std::uint32_t kIdCount = 600;
+    constexpr float kSceneHalfSize = 40.0f;
+
+    /* Every third id is used, so the id lookup stays sparse. */
+    constexpr std::uint32_t kIdStride = 3;
+
+    /* Proxies as the test knows them, indexed by id. */
+    struct ReferenceSet
+    {
+        std::vector<AABB> Bounds;
+        std::vector<bool> Live;
+    };
+
+    /* Box of random size at a random spot; one in forty is long on every axis. */
+    AABB RandomBox(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> position(-kSceneHalfSize, kSceneHalfSize);
+        std::uniform_real_distribution<float> size(0.2f, 3.0f);
+
+        const Vec3 center(position(random), position(random), position(random));
+        const float scale = random() % 40 == 0 ? 20.0f : 1.0f;
+        const Vec3 half(size(random) * scale, size(random) * scale, size(random) * scale);
+        return AABB{ center - half, center + half };
+    }
+
+    /* Set bounds on both the broadphase and the reference. */
+    void SetBounds(SweepAndPrune& broadphase, ReferenceSet& reference, std::uint32_t id, const AABB& bounds)
+    {
+        broadphase.SetBounds(id, bounds);
+        reference.Bounds[id] = bounds;
+        reference.Live[id] = true;
+    }
+
+    /* Remove from both the broadphase and the reference. */
+    void Remove(SweepAndPrune& broadphase, ReferenceSet& reference, std::uint32_t id)
+    {
+        broadphase.Remove(id);
+        reference.Live[id] = false;
+    }
+
+    /* Order pairs so two lists compare equal regardless of sweep order. */
+    void SortPairs(std::vector<BroadphasePair>& pairs)
+    {
+        std::sort(pairs.begin(), pairs.end(),
+            [](const BroadphasePair& left, const BroadphasePair& right)
+            {
+                return left.A != right.A ? left.A < right.A : left.B < right.B;
+            });
+    }
+
+    /* Pairs and box queries must match testing every pair directly. */
+    void CheckMatchesBruteForce(SweepAndPrune& broadphase, const ReferenceSet& reference, std::mt19937& random)
+    {
+        broadphase.Update();
+
+        std::vector<BroadphasePair> expected;
+        std::uint32_t liveCount = 0;
+        for (std::uint32_t first = 0; first < reference.Live.size(); ++first)
+        {
+            if (!reference.Live[first])
+            {
+                continue;
+            }
+
+            ++liveCount;
+            for (std::uint32_t second = first + 1; second < reference.Live.size(); ++second)
+            {
+                if (reference.Live[second] && reference.Bounds[first].Overlaps(reference.Bounds[second]))
+                {
+                    expected.push_back(BroadphasePair{ first, second });
+                }
+            }
+        }
+
+        std::vector<BroadphasePair> pairs;
+        broadphase.FindPairs(pairs);
+
+        bool ordered = true;
+        for (const BroadphasePair& pair : pairs)
+        {
+            ordered = ordered && pair.A < pair.B;
+        }
+
+        SortPairs(pairs);
+        bool samePairs = pairs.size() == expected.size();
+        for (std::size_t index = 0; samePairs && index < pairs.size(); ++index)
+        {
+            samePairs = pairs[index].A == expected[index].A && pairs[index].B == expected[index].B;
+        }
+
+        Check(broadphase.GetProxyCount() == liveCount, "proxy count matches the live ids");
+        Check(ordered, "pairs have A < B");
+        Check(samePairs, "pairs match the brute-force overlap check");
+
+        std::vector<std::uint32_t> ids;
+        bool sameQueries = true;
+        for (std::uint32_t query = 0; query < 20; ++query)
+        {
+            const AABB bounds = RandomBox(random);
+            broadphase.QueryAABB(bounds, ids);
+            std::sort(ids.begin(), ids.end());
+
+            std::vector<std::uint32_t> expectedIds;
+            for (std::uint32_t id = 0; id < reference.Live.size(); ++id)
+            {
+                if (reference.Live[id] && reference.Bounds[id].Overlaps(bounds))
+                {
+                    expectedIds.push_back(id);
+                }
+            }
+
+            sameQueries = sameQueries && ids == expectedIds;
+        }
+
+        Check(sameQueries, "box queries match the brute-force overlap check");
+    }
+
+    /* Insert, move, remove and reinsert along one sweep axis. */
+    void TestAxis(std::uint32_t axis, std::uint32_t minProxiesPerWorker)
+    {
+        std::mt19937 random(17 + axis);
+        SweepAndPrune broadphase;
+        broadphase.SetAxis(axis);
+        broadphase.SetMinProxiesPerWorker(minProxiesPerWorker);
+
+        ReferenceSet reference;
+        reference.Bounds.resize(kIdCount * kIdStride);
+        reference.Live.resize(kIdCount * kIdStride, false);
+
+        for (std::uint32_t index = 0; index < kIdCount; ++index)
+        {
+            SetBounds(broadphase, reference, index * kIdStride + 1, RandomBox(random));
+        }
+        CheckMatchesBruteForce(broadphase, reference, random);
+
+        /* A few proxies drift each frame, the incremental re-sort path. */
+        for (std::uint32_t frame = 0; frame < 10; ++frame)
+        {
+            for (std::uint32_t move = 0; move < 12; ++move)
+            {
+                const std::uint32_t id = (random() % kIdCount) * kIdStride + 1;
+                const Vec3 offset(
+                    static_cast<float>(random() % 7) - 3.0f,
+                    static_cast<float>(random() % 7) - 3.0f,
+                    static_cast<float>(random() % 7) - 3.0f);
+                SetBounds(broadphase, reference, id,
+                    AABB{ reference.Bounds[id].Min + offset, reference.Bounds[id].Max + offset });
+            }
+            CheckMatchesBruteForce(broadphase, reference, random);
+        }
+
+        /* Most proxies jump at once, the full rebuild path. */
+        for (std::uint32_t index = 0; index < kIdCount; index += 2)
+        {
+            SetBounds(broadphase, reference, index * kIdStride + 1, RandomBox(random));
+        }
+        CheckMatchesBruteForce(broadphase, reference, random);
+
+        /* Remove a third, including unknown ids, then move the survivors. */
+        for (std::uint32_t index = 0; index < kIdCount; index += 3)
+        {
+            Remove(broadphase, reference, index * kIdStride + 1);
+        }
+        broadphase.Remove(kIdCount * kIdStride + 50);
+        broadphase.Remove(2);
+        CheckMatchesBruteForce(broadphase, reference, random);
+
+        for (std::uint32_t index = 1; index < kIdCount; index += 3)
+        {
+            SetBounds(broadphase, reference, index * kIdStride + 1, RandomBox(random));
+        }
+        CheckMatchesBruteForce(broadphase, reference, random);
+
+        /* Reinsert into freed slots under new ids. */
+        for (std::uint32_t index = 0; index < kIdCount; index += 3)
+        {
+            SetBounds(broadphase, reference, index * kIdStride + 2, RandomBox(random));
+        }
+        CheckMatchesBruteForce(broadphase, reference, random);
+
+        broadphase.Clear();
+        std::fill(reference.Live.begin(), reference.Live.end(), false);
+        CheckMatchesBruteForce(broadphase, reference, random);
+    }
+}
+
+int main()
+{
+    g_TestName = "SweepAndPruneTest";
+
+    for (std::uint32_t axis = 0; axis < 3; ++axis)
+    {
+        TestAxis(axis, 1024);
+    }
+
+    /* Small segments so several workers sweep and their pairs merge. */
+    g_WorkerPool.Start(3);
+    TestAxis(0, 16);
+    g_WorkerPool.Stop();
+
+    return FinishChecks();
+}
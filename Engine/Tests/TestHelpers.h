@@ -0,0 +1,83 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+/* Shared by the tests and benchmarks in this directory: checks that */
+/* report and count failures without stopping, and best-of timing. */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+/* Name printed in front of every report; main sets it first. */
+inline const char* g_TestName = "Test";
+
+/* Failed checks so far. */
+inline std::uint32_t g_FailureCount = 0;
+
+/* Timed runs per measurement. */
+constexpr std::uint32_t kRepeats = 20;
+
+/* Report a failed check without stopping the test. */
+inline void Check(bool condition, const char* description)
+{
+    if (!condition)
+    {
+        std::fprintf(stderr, "%s: FAILED %s\n", g_TestName, description);
+        ++g_FailureCount;
+    }
+}
+
+/* Print the summary and return the process exit code. */
+inline int FinishChecks()
+{
+    if (g_FailureCount > 0)
+    {
+        std::fprintf(stderr, "%s: %u check(s) failed\n", g_TestName, g_FailureCount);
+        return 1;
+    }
+
+    std::printf("%s: all checks passed\n", g_TestName);
+    return 0;
+}
+
+/* Fastest of kRepeats runs, in milliseconds. */
+template <typename Func>
+double MeasureBest(Func&& body)
+{
+    double best = 1e30;
+    for (std::uint32_t repeat = 0; repeat < kRepeats; ++repeat)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    return best;
+}
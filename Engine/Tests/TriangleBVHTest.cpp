@@ -0,0 +1,283 @@
+/*
+ * Corebryo
+ * Copyright (c) 2026 Jonathan Den Haerynck
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+/* Saves a triangle BVH and loads it back: the loaded tree must answer */
+/* ray casts and box queries exactly like the built one. Loading must */
+/* fail cleanly for a different source hash, a missing file, and files */
+/* that are truncated or carry a bad header, counts or node links. */
+
+#include "Scene/Collision/TriangleBVH.h"
+#include "TestHelpers.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+/* Local helpers. */
+namespace
+{
+    constexpr std::uint32_t kGridSize = 40;
+    constexpr std::uint32_t kRayCount = 500;
+
+    /* Magic, version, source hash, node count and triangle count. */
+    constexpr std::size_t kHeaderSize = 24;
+    constexpr std::size_t kHashOffset = 8;
+    constexpr std::size_t kNodeCountOffset = 16;
+    constexpr std::size_t kTriangleCountOffset = 20;
+
+    /* Bumpy indexed height field, two triangles per grid cell. */
+    void BuildTerrain(std::vector<Vec3>& outPositions, std::vector<std::uint32_t>& outIndices)
+    {
+        for (std::uint32_t row = 0; row <= kGridSize; ++row)
+        {
+            for (std::uint32_t column = 0; column <= kGridSize; ++column)
+            {
+                const float x = static_cast<float>(column);
+                const float z = static_cast<float>(row);
+                outPositions.push_back(Vec3(x, std::sin(x * 0.7f) * std::cos(z * 0.4f) * 2.0f, z));
+            }
+        }
+
+        for (std::uint32_t row = 0; row < kGridSize; ++row)
+        {
+            for (std::uint32_t column = 0; column < kGridSize; ++column)
+            {
+                const std::uint32_t corner = row * (kGridSize + 1) + column;
+                outIndices.insert(outIndices.end(), {
+                    corner, corner + kGridSize + 1, corner + 1,
+                    corner + 1, corner + kGridSize + 1, corner + kGridSize + 2 });
+            }
+        }
+    }
+
+    std::vector<char> ReadBytes(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void WriteBytes(const std::string& path, const std::vector<char>& bytes)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    void WriteU32(std::vector<char>& bytes, std::size_t offset, std::uint32_t value)
+    {
+        std::memcpy(&bytes[offset], &value, sizeof(value));
+    }
+
+    /* Byte offset of a node field in the saved file. */
+    std::size_t NodeFieldOffset(std::uint32_t node, std::size_t field)
+    {
+        return kHeaderSize + static_cast<std::size_t>(node) * sizeof(TriangleBVHNode) + field;
+    }
+
+    /* First node in the file with the given kind. */
+    std::uint32_t FindNode(const std::vector<char>& bytes, bool leaf)
+    {
+        std::uint32_t nodeCount = 0;
+        std::memcpy(&nodeCount, &bytes[kNodeCountOffset], sizeof(nodeCount));
+        for (std::uint32_t node = 0; node < nodeCount; ++node)
+        {
+            std::uint32_t triangleCount = 0;
+            std::memcpy(&triangleCount,
+                &bytes[NodeFieldOffset(node, offsetof(TriangleBVHNode, TriangleCount))],
+                sizeof(triangleCount));
+            if ((triangleCount != 0) == leaf)
+            {
+                return node;
+            }
+        }
+
+        return 0;
+    }
+
+    /* A damaged copy must be refused and leave the tree empty. */
+    void CheckRejected(
+        const std::string& path,
+        const std::vector<char>& bytes,
+        std::uint64_t hash,
+        const char* description)
+    {
+        WriteBytes(path, bytes);
+
+        TriangleBVH loaded;
+        const bool result = loaded.LoadFromFile(path, hash);
+        Check(!result && !loaded.IsBuilt() && loaded.GetNodeCount() == 0, description);
+    }
+}
+
+int main()
+{
+    g_TestName = "TriangleBVHTest";
+
+    std::vector<Vec3> positions;
+    std::vector<std::uint32_t> indices;
+    BuildTerrain(positions, indices);
+
+    TriangleBVH built;
+    Check(built.Build(positions, indices), "terrain builds");
+    const std::uint64_t hash = TriangleBVH::ComputeSourceHash(positions, indices);
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "Corebryo_TriangleBVHTest.bvh").string();
+    Check(built.SaveToFile(path), "tree saves");
+
+    /* Round trip: same shape and identical answers. */
+    TriangleBVH loaded;
+    Check(loaded.LoadFromFile(path, hash) && loaded.IsBuilt(), "tree loads with the source hash");
+    Check(loaded.GetNodeCount() == built.GetNodeCount() &&
+        loaded.GetTriangleCount() == built.GetTriangleCount(),
+        "loaded tree has the same node and triangle counts");
+
+    const AABB builtBounds = built.GetBounds();
+    const AABB loadedBounds = loaded.GetBounds();
+    Check(std::memcmp(&builtBounds, &loadedBounds, sizeof(AABB)) == 0, "loaded tree has the same bounds");
+
+    std::mt19937 random(31);
+    std::uniform_real_distribution<float> spread(-2.0f, static_cast<float>(kGridSize) + 2.0f);
+    std::uniform_real_distribution<float> tilt(-0.5f, 0.5f);
+
+    bool sameRaycasts = true;
+    std::uint32_t hitCount = 0;
+    for (std::uint32_t index = 0; index < kRayCount; ++index)
+    {
+        Ray ray;
+        ray.Origin = Vec3(spread(random), 10.0f, spread(random));
+        ray.Direction = Vec3(tilt(random), -1.0f, tilt(random));
+
+        float builtDistance = 0.0f;
+        float loadedDistance = 0.0f;
+        std::uint32_t builtTriangle = 0;
+        std::uint32_t loadedTriangle = 0;
+        const bool builtHit = built.Raycast(ray, builtDistance, &builtTriangle);
+        const bool loadedHit = loaded.Raycast(ray, loadedDistance, &loadedTriangle);
+
+        sameRaycasts = sameRaycasts && builtHit == loadedHit &&
+            (!builtHit || (builtDistance == loadedDistance && builtTriangle == loadedTriangle));
+        hitCount += builtHit ? 1u : 0u;
+    }
+
+    Check(hitCount > kRayCount / 2, "most rays hit the terrain");
+    Check(sameRaycasts, "loaded tree casts rays like the built one");
+
+    bool sameQueries = true;
+    std::vector<std::uint32_t> builtTriangles;
+    std::vector<std::uint32_t> loadedTriangles;
+    for (std::uint32_t index = 0; index < 50; ++index)
+    {
+        const Vec3 center(spread(random), 0.0f, spread(random));
+        const AABB box{ center - Vec3(1.5f, 3.0f, 1.5f), center + Vec3(1.5f, 3.0f, 1.5f) };
+        built.QueryAABB(box, builtTriangles);
+        loaded.QueryAABB(box, loadedTriangles);
+        sameQueries = sameQueries && builtTriangles == loadedTriangles;
+    }
+
+    Check(sameQueries, "loaded tree answers box queries like the built one");
+
+    /* Wrong geometry and missing files are refused without a message. */
+    TriangleBVH stale;
+    Check(!stale.LoadFromFile(path, hash + 1) && !stale.IsBuilt(), "a different source hash is refused");
+
+    const std::vector<char> valid = ReadBytes(path);
+    Check(valid.size() > kHeaderSize, "saved file has a payload");
+    std::filesystem::remove(path);
+    Check(!stale.LoadFromFile(path, hash), "a missing file is refused");
+
+    /* Damaged copies. */
+    CheckRejected(path, std::vector<char>(valid.begin(), valid.begin() + kHeaderSize / 2), hash,
+        "a truncated header is refused");
+    CheckRejected(path, std::vector<char>(valid.begin(), valid.end() - 1), hash,
+        "a truncated payload is refused");
+
+    std::vector<char> bytes = valid;
+    bytes[0] ^= 0x5A;
+    CheckRejected(path, bytes, hash, "a bad magic is refused");
+
+    bytes = valid;
+    WriteU32(bytes, 4, 99);
+    CheckRejected(path, bytes, hash, "an unknown version is refused");
+
+    bytes = valid;
+    bytes[kHashOffset] ^= 0x01;
+    CheckRejected(path, bytes, hash, "a damaged source hash is refused");
+
+    bytes = valid;
+    WriteU32(bytes, kNodeCountOffset, 0);
+    CheckRejected(path, bytes, hash, "a zero node count is refused");
+
+    bytes = valid;
+    WriteU32(bytes, kNodeCountOffset, 0xFFFFFFFFu);
+    CheckRejected(path, bytes, hash, "a node count larger than the file is refused");
+
+    bytes = valid;
+    WriteU32(bytes, kTriangleCountOffset, 0x40000000u);
+    CheckRejected(path, bytes, hash, "a triangle count larger than the file is refused");
+
+    const std::uint32_t inner = FindNode(valid, false);
+    const std::uint32_t leaf = FindNode(valid, true);
+    const std::size_t leftField = offsetof(TriangleBVHNode, LeftOrFirst);
+    const std::size_t countField = offsetof(TriangleBVHNode, TriangleCount);
+
+    bytes = valid;
+    WriteU32(bytes, NodeFieldOffset(inner, leftField), 0xFFFFFFFFu);
+    CheckRejected(path, bytes, hash, "a child index that wraps around is refused");
+
+    bytes = valid;
+    WriteU32(bytes, NodeFieldOffset(inner, leftField), built.GetNodeCount() - 1);
+    CheckRejected(path, bytes, hash, "a child pair past the last node is refused");
+
+    bytes = valid;
+    WriteU32(bytes, NodeFieldOffset(inner, leftField), inner);
+    CheckRejected(path, bytes, hash, "a child pointing back at its parent is refused");
+
+    bytes = valid;
+    WriteU32(bytes, NodeFieldOffset(leaf, leftField), 0xFFFFFFF0u);
+    WriteU32(bytes, NodeFieldOffset(leaf, countField), 0x20u);
+    CheckRejected(path, bytes, hash, "a leaf range that wraps around is refused");
+
+    bytes = valid;
+    WriteU32(bytes, NodeFieldOffset(leaf, leftField), built.GetTriangleCount());
+    CheckRejected(path, bytes, hash, "a leaf range past the last triangle is refused");
+
+    /* A refused load must not block a later good one into the same tree. */
+    CheckRejected(path, bytes, hash, "damaged file is refused again");
+    WriteBytes(path, valid);
+    Check(stale.LoadFromFile(path, hash) && stale.GetNodeCount() == built.GetNodeCount(),
+        "the intact file still loads after refusals");
+
+    std::filesystem::remove(path);
+    return FinishChecks();
+}